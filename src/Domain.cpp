@@ -2,6 +2,7 @@
 #include <iostream>
 #include <string>
 #include <cmath>
+#include <vector>
 
 #include "Domain.h"
 
@@ -77,6 +78,7 @@ Domain::Domain(int rank, PressureGradient* pg){
 	}
 #endif
 	this->_universalSelectiveThermostatCounter = 0;
+	this->_homogeneousLJCorrection = true;
 	this->_universalSelectiveThermostatWarning = 0;
 	this->_universalSelectiveThermostatError = 0;
 }
@@ -568,6 +570,7 @@ void Domain::writeCheckpoint( string filename,
 	}
 
 	domainDecomp->writeMoleculesToFile(filename, particleContainer); 
+	domainDecomp->writeDecompositionCheckpoint(filename);
 }
 
 void Domain::initParameterStreams(double cutoffRadius, double cutoffRadiusLJ){
@@ -613,6 +616,7 @@ void Domain::initFarFieldCorr(double cutoffRadius, double cutoffRadiusLJ) {
 			unsigned numtersoffj = cj.numTersoff();
 			// no LJ interaction between Tersoff components
 			if(numtersoffi && numtersoffj) continue;
+			if(!_homogeneousLJCorrection) continue;
 			unsigned int numljcentersj=cj.numLJcenters();
 			ParaStrm& params=_comp2params(i,j);
 			params.reset_read();
@@ -687,40 +691,18 @@ void Domain::setupProfile(unsigned xun, unsigned yun, unsigned zun)
 	{
 		_universalInvProfileUnit[d] = (double)_universalNProfileUnits[d] / _globalLength[d];
 	}
+	_localProfile.setup(_universalNProfileUnits, _globalLength);
 	this->resetProfile();
 }
 
 void Domain::considerComponentInProfile(int cid)
 {
-	this->_universalProfiledComponents[cid] = true;
+	_localProfile.considerComponent(cid);
 }
 
 void Domain::recordProfile(ParticleContainer* molCont)
 {
-	int cid;
-	unsigned xun, yun, zun, unID;
-	double mv2, Iw2;
-	for(Molecule* thismol = molCont->begin(); thismol != molCont->end(); thismol = molCont->next())
-	{
-		cid = thismol->componentid();
-		if(this->_universalProfiledComponents[cid])
-		{
-			xun = (unsigned)floor(thismol->r(0) * this->_universalInvProfileUnit[0]);
-			yun = (unsigned)floor(thismol->r(1) * this->_universalInvProfileUnit[1]);
-			zun = (unsigned)floor(thismol->r(2) * this->_universalInvProfileUnit[2]);
-			unID = xun * this->_universalNProfileUnits[1] * this->_universalNProfileUnits[2]
-				+ yun * this->_universalNProfileUnits[2] + zun;
-			this->_localNProfile[unID] += 1.0;
-			for(int d=0; d<3; d++) this->_localvProfile[d][unID] += thismol->v(d);
-			this->_localDOFProfile[unID] += 3.0 + (long double)(thismol->component()->getRotationalDegreesOfFreedom());
-
-			// record _twice_ the total (ordered + unordered) kinetic energy
-			mv2 = 0.0;
-			Iw2 = 0.0;
-			thismol->calculate_mv2_Iw2(mv2, Iw2);
-			this->_localKineticProfile[unID] += mv2+Iw2;
-		}
-	}
+	molCont->sampleProfile(_localProfile);
 	this->_globalAccumulatedDatasets++;
 }
 
@@ -728,40 +710,36 @@ void Domain::collectProfile(DomainDecompBase* dode)
 {
 	unsigned unIDs = this->_universalNProfileUnits[0] * this->_universalNProfileUnits[1]
 		* this->_universalNProfileUnits[2];
-	dode->collCommInit(10*unIDs);
+	// ten values per bin, reduced as one contiguous array to the root process
+	vector<double> profile(10*unIDs);
 	for(unsigned unID = 0; unID < unIDs; unID++)
 	{
-		dode->collCommAppendLongDouble(this->_localNProfile[unID]);
+		double* values = &profile[10*unID];
+		values[0] = _localProfile.N(unID);
 		for(int d=0; d<3; d++)
-			dode->collCommAppendLongDouble(_localvProfile[d][unID]);
-		dode->collCommAppendLongDouble(this->_localDOFProfile[unID]);
-		dode->collCommAppendLongDouble(_localKineticProfile[unID]);
-
-                dode->collCommAppendLongDouble(this->_localWidomProfile[unID]);
-                dode->collCommAppendLongDouble(this->_localWidomInstances[unID]);
-                dode->collCommAppendLongDouble(this->_localWidomProfileTloc[unID]);
-                dode->collCommAppendLongDouble(this->_localWidomInstancesTloc[unID]);
+			values[1+d] = _localProfile.v(d, unID);
+		values[4] = _localProfile.DOF(unID);
+		values[5] = _localProfile.kinetic(unID);
+
+		values[6] = this->_localWidomProfile[unID];
+		values[7] = this->_localWidomInstances[unID];
+		values[8] = this->_localWidomProfileTloc[unID];
+		values[9] = this->_localWidomInstancesTloc[unID];
 	}
-	dode->collCommAllreduceSum();
+	dode->reduceArraySum(&profile[0], &profile[0], profile.size());
 	for(unsigned unID = 0; unID < unIDs; unID++)
 	{
-		_universalNProfile[unID] = (double)dode->collCommGetLongDouble();
+		const double* values = &profile[10*unID];
+		_universalNProfile[unID] = values[0];
 		for(int d=0; d<3; d++)
-			this->_universalvProfile[d][unID]
-				= (double)dode->collCommGetLongDouble();
-		this->_universalDOFProfile[unID]
-			= (double)dode->collCommGetLongDouble();
-		this->_universalKineticProfile[unID]
-			= (double)dode->collCommGetLongDouble();
-
-		this->_globalWidomProfile[unID]
-			= (double)dode->collCommGetLongDouble();
-		this->_globalWidomInstances[unID]
-			= (double)dode->collCommGetLongDouble();
-		this->_globalWidomProfileTloc[unID]
-			= (double)dode->collCommGetLongDouble();
-		this->_globalWidomInstancesTloc[unID]
-			= (double)dode->collCommGetLongDouble();
+			this->_universalvProfile[d][unID] = values[1+d];
+		this->_universalDOFProfile[unID] = values[4];
+		this->_universalKineticProfile[unID] = values[5];
+
+		this->_globalWidomProfile[unID] = values[6];
+		this->_globalWidomInstances[unID] = values[7];
+		this->_globalWidomProfileTloc[unID] = values[8];
+		this->_globalWidomInstancesTloc[unID] = values[9];
 
 		/*
 		 * construct the temperature profile
@@ -778,10 +756,8 @@ void Domain::collectProfile(DomainDecompBase* dode)
 
 		  Tun = (twoEkin - twoEkindir) / _universalDOFProfile[unID];
 		}
-		// domainDecomp->doBroadcast(&Tun); // no longer needed, since MPI_Reduce (branch) was replaced with MPI_Allreduce (trunk)
 		this->_universalTProfile[unID] = Tun; 
 	}
-	dode->collCommFinalize();
 }
 
 void Domain::outputProfile(const char* prefix)
@@ -919,16 +895,12 @@ void Domain::resetProfile()
 		* this->_universalNProfileUnits[2];
 	for(unsigned unID = 0; unID < unIDs; unID++)
 	{
-		this->_localNProfile[unID] = 0.0;
 		this->_universalNProfile[unID] = 0.0;
 		for(int d=0; d<3; d++)
 		{
-			this->_localvProfile[d][unID] = 0.0;
 			this->_universalvProfile[d][unID] = 0.0;
 		}
-		this->_localDOFProfile[unID] = 0.0;
 		this->_universalDOFProfile[unID] = 0.0;
-		this->_localKineticProfile[unID] = 0.0;
 		this->_universalKineticProfile[unID] = 0.0;
 
 		this->_localWidomProfile[unID] = 0.0;
@@ -940,6 +912,7 @@ void Domain::resetProfile()
 		this->_localWidomInstancesTloc[unID] = 0.0;
 		this->_globalWidomInstancesTloc[unID] = 0.0;
 	}
+	_localProfile.reset();
 	this->_globalAccumulatedDatasets = 0;
 }
 
@@ -8,6 +8,7 @@
 #include "molecules/Comp2Param.h"
 #include "molecules/Component.h"
 #include "ensemble/EnsembleBase.h"
+#include "particleContainer/adapter/ProfileSampler.h"
 #include "Simulation.h"
 
 /* 
@@ -97,6 +98,14 @@ public:
 	//! @param cutoffRadiusLJ cutoff radius for the LJ potential
 	void initFarFieldCorr(double cutoffRadius, double cutoffRadiusLJ);
 
+	//! @brief leave out the homogeneous LJ terms in initFarFieldCorr
+	//!
+	//! For inhomogeneous systems, e.g. with a vapour-liquid interface, these
+	//! terms are wrong. The LJ correction is then calculated from the density
+	//! profile in each time step (see PlanarLongRangeCorrection). The dipole
+	//! terms are kept.
+	void disableHomogeneousLJCorrection() { _homogeneousLJCorrection = false; }
+
 	//! @brief initialize parameter streams
 	//!
 	//! This method should only be called, after the component information
@@ -303,6 +312,7 @@ public:
 	void setupProfile(unsigned xun, unsigned yun, unsigned zun);
 	void considerComponentInProfile(int cid);
 	void recordProfile(ParticleContainer* molCont);
+	//! @brief sums up the local profiles of all processes; the result is only valid on the root process
 	void collectProfile(DomainDecompBase* domainDecomp);
 	void outputProfile(const char* prefix);
 	void resetProfile();
@@ -401,26 +411,19 @@ private:
 	double _universalInvProfileUnit[3];
 	//! number of successive profile cuboids in x/y/z direction
 	unsigned _universalNProfileUnits[3];
-	//! local N profile map
-	std::map<unsigned, long double> _localNProfile;
+	//! local N, directed velocity, kinetic energy and degrees of freedom profiles
+	//! of the profiled components
+	ProfileSampler _localProfile;
 	//! global N profile map
 	std::map<unsigned, double> _universalNProfile;
-	//! local directed velocity profile map
-	std::map<unsigned, long double> _localvProfile[3];
 	//! global directed velocity  profile map
 	std::map<unsigned, double> _universalvProfile[3];
-	//! local kinetic energy profile map
-	std::map<unsigned, long double> _localKineticProfile;
 	//! global kinetic energy profile map
 	std::map<unsigned, double> _universalKineticProfile;
-	//! local counter w. r. t. degrees of freedom
-	std::map<unsigned, long double> _localDOFProfile;
 	//! global counter w. r. t. degrees of freedom
 	std::map<unsigned, double> _universalDOFProfile;
 	//! how many _evaluated_ timesteps are currently accumulated in the profile?
 	unsigned _globalAccumulatedDatasets;
-	//! which components should be considered?
-	std::map<unsigned, bool> _universalProfiledComponents;
         double _universalProfiledComponentMass;  // set from outside
 
         std::map<unsigned, double> _universalTProfile; 
@@ -457,6 +460,8 @@ private:
 	double _UpotCorr;
 	//! Global virial correction for the error made by the cutoff
 	double _VirialCorr;
+	//! Whether _UpotCorr and _VirialCorr contain the homogeneous LJ terms
+	bool _homogeneousLJCorrection;
 
 	//! Contains the time t in reduced units
 
@@ -40,6 +40,7 @@
 #include "ensemble/GrandCanonical.h"
 #include "ensemble/CanonicalEnsemble.h"
 #include "ensemble/PressureGradient.h"
+#include "longRange/PlanarLongRangeCorrection.h"
 
 #include "thermostats/VelocityScalingThermostat.h"
 
@@ -60,6 +61,7 @@ Simulation::Simulation()
 	_initStatistics(0),
 	_rdf(NULL),
 	_ljFlopCounter(NULL),
+	_longRangeCorrection(NULL),
 	_domainDecomposition(NULL),
 	_forced_checkpoint_time(0) {
 	_ensemble = new CanonicalEnsemble();
@@ -76,6 +78,7 @@ Simulation::~Simulation() {
 	delete _integrator;
 	delete _inputReader;
 	delete _ljFlopCounter;
+	delete _longRangeCorrection;
 }
 
 void Simulation::exit(int exitcode) {
@@ -193,6 +196,15 @@ void Simulation::readXML(XMLfileUnits& xmlconfig) {
 			this->exit(1);
 		}
 
+		/* the decomposition has to be read before the datastructure is set up with its bounding box */
+		if(xmlconfig.changecurrentnode("parallelisation")) {
+			_domainDecomposition->readXML(xmlconfig);
+			xmlconfig.changecurrentnode("..");
+		}
+		else {
+			global_log->warning() << "Parallelisation section missing." << endl;
+		}
+
 		/* datastructure */
 		string datastructuretype;
 		xmlconfig.getNodeValue("datastructure@type", datastructuretype);
@@ -233,14 +245,6 @@ void Simulation::readXML(XMLfileUnits& xmlconfig) {
 		}
 	#endif
 
-		if(xmlconfig.changecurrentnode("parallelisation")) {
-			_domainDecomposition->readXML(xmlconfig);
-			xmlconfig.changecurrentnode("..");
-		}
-		else {
-			global_log->warning() << "Parallelisation section missing." << endl;
-		}
-
 		if(xmlconfig.changecurrentnode("thermostats")) {
 			long numThermostats = 0;
 			XMLfile::Query query = xmlconfig.query("thermostat");
@@ -311,6 +315,9 @@ void Simulation::readXML(XMLfileUnits& xmlconfig) {
 		if(pluginname == "CheckpointWriter") {
 			outputPlugin = new CheckpointWriter();
 		}
+		else if(pluginname == "CompressedTrajectoryWriter") {
+			outputPlugin = new CompressedTrajectoryWriter();
+		}
 		else if(pluginname == "DecompWriter") {
 			outputPlugin = new DecompWriter();
 		}
@@ -335,6 +342,9 @@ void Simulation::readXML(XMLfileUnits& xmlconfig) {
 		else if(pluginname == "SysMonOutput") {
 			outputPlugin = new SysMonOutput();
 		}
+		else if(pluginname == "TimerWriter") {
+			outputPlugin = new TimerWriter();
+		}
 		else if(pluginname == "VISWriter") {
 			outputPlugin = new VISWriter();
 		}
@@ -428,6 +438,14 @@ void Simulation::initConfigXML(const string& inputfilename) {
 				_inputReader = (InputBase*) new InputOldstyle();
 				_inputReader->setPhaseSpaceFile(pspfile);
 			}
+			else if (pspfiletype == "binary") {
+				_inputReader = (InputBase*) new InputBinary();
+				_inputReader->setPhaseSpaceFile(pspfile);
+			}
+			else {
+				global_log->error() << "Unknown phasespacepoint file type: " << pspfiletype << endl;
+				exit(1);
+			}
 		}
 		string oldpath = inp.getcurrentnodepath();
 		if(inp.changecurrentnode("ensemble/phasespacepoint/generator")) {
@@ -542,6 +560,14 @@ void Simulation::initConfigOldstyle(const string& inputfilename) {
 	double timestepLength;
 	unsigned cosetid = 0;
         bool widom = false;
+	bool batchedInsertions = false;
+	double overlapRadius = 0.0;
+	bool cavityBias = false;
+	bool counterBasedRandom = false;
+	bool fusedIntegration = false;
+	bool periodicImages = false;
+	unsigned planarSlabs = 0;
+	int planarAxis = 1;
 
 	// The first line of the config file has to contain the token "MDProjectConfig"
 	inputfilestream >> token;
@@ -575,6 +601,13 @@ void Simulation::initConfigOldstyle(const string& inputfilename) {
 				_inputReader->setPhaseSpaceFile(phaseSpaceFileName);
 				_inputReader->setPhaseSpaceHeaderFile(phaseSpaceFileName);
 				_inputReader->readPhaseSpaceHeader(_domain, timestepLength);
+			} else if (phaseSpaceFileFormat == "Binary") {
+				string phaseSpaceFileName;
+				inputfilestream >> phaseSpaceFileName;
+				_inputReader = (InputBase*) new InputBinary();
+				_inputReader->setPhaseSpaceFile(phaseSpaceFileName);
+				_inputReader->setPhaseSpaceHeaderFile(phaseSpaceFileName);
+				_inputReader->readPhaseSpaceHeader(_domain, timestepLength);
 			} else if (phaseSpaceFileFormat == "Generator") {
 				global_log->info() << "phaseSpaceFileFormat is Generator!"
 						<< endl;
@@ -621,8 +654,13 @@ void Simulation::initConfigOldstyle(const string& inputfilename) {
 				string line;
 				getline(inputfilestream, line);
 				stringstream lineStream(line);
-				lineStream >> updateFrequency >> fullSearchThreshold;
-				_domainDecomposition = (DomainDecompBase*) new KDDecomposition(_cutoffRadius, _domain, updateFrequency, fullSearchThreshold);
+				string decompTreeFile;
+				lineStream >> updateFrequency >> fullSearchThreshold >> decompTreeFile;
+				KDDecomposition* kdd = new KDDecomposition(_cutoffRadius, _domain, updateFrequency, fullSearchThreshold);
+				if (!decompTreeFile.empty()) {
+					kdd->readDecompTree(decompTreeFile);
+				}
+				_domainDecomposition = (DomainDecompBase*) kdd;
 			}
 #endif
 		} else if (token == "datastructure") {
@@ -765,6 +803,20 @@ void Simulation::initConfigOldstyle(const string& inputfilename) {
 			      _outputPlugins.push_back(new MmspdWriter(writeFrequency, outputPathAndPrefix));
 			      global_log->debug() << "MmspdWriter " << writeFrequency << " '" << outputPathAndPrefix << "'.\n";
 			}
+			// compressed trajectory, the position precision is optional
+			else if (token == "CompressedTrajectoryWriter") {
+				unsigned long writeFrequency = 0;
+				string outputPathAndPrefix;
+				double precision = 0.001;
+				string line;
+				getline(inputfilestream, line);
+				stringstream lineStream(line);
+				lineStream >> writeFrequency >> outputPathAndPrefix >> precision;
+				_outputPlugins.push_back(new CompressedTrajectoryWriter(writeFrequency,
+						outputPathAndPrefix, precision));
+				global_log->debug() << "CompressedTrajectoryWriter " << writeFrequency
+						<< " '" << outputPathAndPrefix << "' precision " << precision << ".\n";
+			}
 			// temporary
 			else if (token == "MPICheckpointWriter") {
 				unsigned long writeFrequency;
@@ -775,6 +827,14 @@ void Simulation::initConfigOldstyle(const string& inputfilename) {
 				global_log->debug() << "MPICheckpointWriter " << writeFrequency
 						<< " '" << outputPathAndPrefix << "'.\n";
 			}
+			else if (token == "TimerWriter") {
+				unsigned long writeFrequency;
+				string outputPathAndPrefix;
+				inputfilestream >> writeFrequency >> outputPathAndPrefix;
+				_outputPlugins.push_back(new TimerWriter(writeFrequency, outputPathAndPrefix));
+				global_log->debug() << "TimerWriter " << writeFrequency << " '"
+						<< outputPathAndPrefix << "'.\n";
+			}
 			else {
 				global_log->warning() << "Unknown output plugin " << token << endl;
 			}
@@ -998,6 +1058,27 @@ void Simulation::initConfigOldstyle(const string& inputfilename) {
 			inputfilestream >> h;
 		} else if(token == "Widom") {
                         widom = true;
+		} else if (token == "batchedInsertions") { /* suboption of chemical potential */
+			batchedInsertions = true;
+		} else if (token == "overlapRadius") { /* suboption of chemical potential */
+			inputfilestream >> overlapRadius;
+		} else if (token == "cavityBias") { /* suboption of chemical potential */
+			cavityBias = true;
+		} else if (token == "counterBasedRandom") { /* suboption of chemical potential */
+			counterBasedRandom = true;
+		} else if (token == "fusedIntegration") {
+			fusedIntegration = true;
+		} else if (token == "periodicImages") {
+			periodicImages = true;
+		} else if (token == "planarLongRangeCorrection") {
+			// number of slabs and the axis (x, y or z) normal to the interfaces
+			char axis;
+			inputfilestream >> planarSlabs >> axis;
+			planarAxis = axis - 'x';
+			if (planarSlabs == 0 || planarAxis < 0 || planarAxis > 2) {
+				global_log->error() << "planarLongRangeCorrection requires the number of slabs and the axis x, y or z." << endl;
+				this->exit(1);
+			}
 		} else if (token == "NVE") {
 			/* TODO: Documentation, what it does (no "Enerstat" at the moment) */
 			_domain->thermostatOff();
@@ -1034,20 +1115,43 @@ void Simulation::initConfigOldstyle(const string& inputfilename) {
 
 	if (this->_LJCutoffRadius == 0.0)
 		_LJCutoffRadius = this->_cutoffRadius;
+	if (planarSlabs > 0) {
+		_longRangeCorrection = new PlanarLongRangeCorrection(_LJCutoffRadius, _domain, _domainDecomposition,
+				planarSlabs, planarAxis);
+		_domain->disableHomogeneousLJCorrection();
+	}
 	_domain->initFarFieldCorr(_cutoffRadius, _LJCutoffRadius);
 
 	// @todo comment
-	_integrator = new Leapfrog(timestepLength);
+	Leapfrog* leapfrog = new Leapfrog(timestepLength);
+	leapfrog->setFused(fusedIntegration);
+	_integrator = leapfrog;
+
+	if (periodicImages) {
+		LinkedCells* linkedCells = dynamic_cast<LinkedCells*>(_moleculeContainer);
+		if (linkedCells == NULL) {
+			global_log->error() << "periodicImages requires the LinkedCells datastructure." << endl;
+			this->exit(1);
+		}
+		linkedCells->setPeriodicImages(true);
+	}
 
 	// test new Decomposition
 	_moleculeContainer->update();
 	_moleculeContainer->deleteOuterParticles();
 
+	if (cavityBias && overlapRadius <= 0.0) {
+		global_log->error() << "cavityBias requires a positive overlapRadius." << endl;
+		this->exit(1);
+	}
 	unsigned idi = _lmu.size();
 	unsigned j = 0;
 	std::list<ChemicalPotential>::iterator cpit;
 	for (cpit = _lmu.begin(); cpit != _lmu.end(); cpit++) {
                 if(widom) cpit->enableWidom();
+		if (batchedInsertions) cpit->enableBatchedInsertions();
+		if (overlapRadius > 0.0) cpit->setOverlapGrid(overlapRadius, cavityBias);
+		if (counterBasedRandom) cpit->enableCounterBasedRandom();
 		cpit->setIncrement(idi);
 		double tmp_molecularMass = global_simulation->getEnsemble()->component(cpit->getComponentID())->m();
 		cpit->setSystem(_domain->getGlobalLength(0),
@@ -1080,6 +1184,7 @@ void Simulation::initConfigOldstyle(const string& inputfilename) {
 
 void Simulation::prepare_start() {
 	global_log->info() << "Initializing simulation" << endl;
+	_timers.start("initialisation");
 
 	global_log->info() << "Initialising cell processor" << endl;
 #if ENABLE_VECTORIZED_CODE
@@ -1116,6 +1221,23 @@ void Simulation::prepare_start() {
 	_cellProcessor = new LegacyCellProcessor( _cutoffRadius, _LJCutoffRadius, _tersoffCutoffRadius, _particlePairsHandler);
 #endif
 
+	if (_moleculeContainer->usesPeriodicImages()) {
+		// only the vectorized cell processor applies the periodic shifts of the halo cells,
+		// and the grand canonical trial moves insert and delete molecules in the halo
+		bool supported = (dynamic_cast<VectorizedCellProcessor*>(_cellProcessor) != NULL) && _lmu.empty();
+#ifdef ENABLE_MPI
+		supported = false;
+#endif
+		if (supported) {
+			global_log->info() << "Using periodic images instead of halo copies." << endl;
+		}
+		else {
+			global_log->warning() << "Periodic images require a single process, the vectorized cell processor "
+					<< "and no grand canonical ensemble, using halo copies." << endl;
+			static_cast<LinkedCells*>(_moleculeContainer)->setPeriodicImages(false);
+		}
+	}
+
 	global_log->info() << "Clearing halos" << endl;
 	_moleculeContainer->deleteOuterParticles();
 	global_log->info() << "Updating domain decomposition" << endl;
@@ -1133,6 +1255,12 @@ void Simulation::prepare_start() {
 	global_log->info() << "Clearing halos" << endl;
 	_moleculeContainer->deleteOuterParticles();
 
+	if (_longRangeCorrection != NULL) {
+		global_log->info() << "Initialising the planar long range correction" << endl;
+		_longRangeCorrection->init();
+		_longRangeCorrection->calculateLongRange(_moleculeContainer);
+	}
+
 	if (_pressureGradient->isAcceleratingUniformly()) {
 		global_log->info() << "Initialising uniform acceleration." << endl;
 		unsigned long uCAT = _pressureGradient->getUCAT();
@@ -1184,6 +1312,8 @@ void Simulation::prepare_start() {
 				_domain);
 	}
 
+	_timers.stop("initialisation");
+
 	global_log->info() << "System initialised\n" << endl;
 	global_log->info() << "System contains "
 			<< _domain->getglobalNumMolecules() << " molecules." << endl;
@@ -1219,28 +1349,40 @@ void Simulation::simulate() {
 	Timer perStepIoTimer;
 	Timer ioTimer;
 
+	// record hardware events for the timing regions if SysMon has been asked for them
+	const PerfCounters* perfCounters = SysMon::getSysMon()->getPerfCounters();
+	if (perfCounters != NULL) {
+		_timers.setPerfCounters(perfCounters);
+	}
+
 	loopTimer.start();
+	_timers.start("loop");
 	for (_simstep = _initSimulation; _simstep <= _numberOfTimesteps; _simstep++) {
-		if (_simstep >= _initGrandCanonical) {
+		if ((_simstep >= _initGrandCanonical) && !_lmu.empty()) {
+			_timers.start("grand_canonical");
 			unsigned j = 0;
 			list<ChemicalPotential>::iterator cpit;
 			for (cpit = _lmu.begin(); cpit != _lmu.end(); cpit++) {
 				if (!((_simstep + 2 * j + 3) % cpit->getInterval())) {
 					cpit->prepareTimestep(_moleculeContainer,
-							_domainDecomposition);
+							_domainDecomposition, _simstep);
 				}
 				j++;
 			}
+			_timers.stop("grand_canonical");
 		}
 		global_log->debug() << "timestep: " << getSimulationStep() << endl;
 		global_log->debug() << "simulation time: " << getSimulationTime() << endl;
 
+		_timers.start("integrator_begin");
 		_integrator->eventNewTimestep(_moleculeContainer, _domain);
+		_timers.stop("integrator_begin");
 
 		// activate RDF sampling
 		if ((_simstep >= this->_initStatistics) && this->_rdf != NULL) {
 			this->_rdf->tickRDF();
 			this->_particlePairsHandler->setRDF(_rdf);
+			this->_cellProcessor->setRDF(_rdf);
 			this->_rdf->accumulateNumberOfMolecules(*(global_simulation->getEnsemble()->components()));
 		}
 
@@ -1256,10 +1398,14 @@ void Simulation::simulate() {
 		global_log->debug() << "Traversing pairs" << endl;
 		//cout<<"here somehow"<<endl;
 		//_moleculeContainer->traversePairs(_particlePairsHandler);
-		_moleculeContainer->traverseCells(*_cellProcessor);
+		_timers.start("forces");
+		_cellProcessor->setComputeMacroscopicValues(macroscopicValuesRequired(_simstep));
+		_moleculeContainer->traverseCells(*_cellProcessor, &_timers);
+		_timers.stop("forces");
 
 		// test deletions and insertions
-		if (_simstep >= _initGrandCanonical) {
+		if ((_simstep >= _initGrandCanonical) && !_lmu.empty()) {
+			_timers.start("grand_canonical");
 			unsigned j = 0;
 			list<ChemicalPotential>::iterator cpit;
 			for (cpit = _lmu.begin(); cpit != _lmu.end(); cpit++) {
@@ -1289,10 +1435,19 @@ void Simulation::simulate() {
 
 				j++;
 			}
+			_timers.stop("grand_canonical");
 		}
 
 		global_log->debug() << "Delete outer particles / clearing halo" << endl;
+		_timers.start("delete_halo");
 		_moleculeContainer->deleteOuterParticles();
+		_timers.stop("delete_halo");
+
+		if (_longRangeCorrection != NULL) {
+			_timers.start("long_range");
+			_longRangeCorrection->calculateLongRange(_moleculeContainer);
+			_timers.stop("long_range");
+		}
 
 		if (_simstep >= _initGrandCanonical) {
 			_domain->evaluateRho(_moleculeContainer->getNumberOfParticles(),
@@ -1330,17 +1485,23 @@ void Simulation::simulate() {
 
 		// Inform the integrator about the calculated forces
 		global_log->debug() << "Inform the integrator" << endl;
+		_timers.start("integrator_end");
 		_integrator->eventForcesCalculated(_moleculeContainer, _domain);
+		_timers.stop("integrator_end");
 
 		// calculate the global macroscopic values from the local values
 		global_log->debug() << "Calculate macroscopic values" << endl;
+		_timers.start("global_reductions");
 		_domain->calculateGlobalValues(_domainDecomposition,
 				_moleculeContainer, (!(_simstep % _collectThermostatDirectedVelocity)), Tfactor(
 								_simstep));
+		_timers.stop("global_reductions");
 
 		// scale velocity and angular momentum
+		bool velocityScalingDeferred = false;
 		if (!_domain->NVE()) {
 			global_log->debug() << "Velocity scaling" << endl;
+			_timers.start("thermostat");
 			if (_domain->severalThermostats()) {
 				_velocityScalingThermostat.enableComponentwise();
 				for(unsigned int cid = 0; cid < global_simulation->getEnsemble()->components()->size(); cid++) {
@@ -1363,7 +1524,14 @@ void Simulation::simulate() {
 				/* TODO */
 				// Undirected global thermostat not implemented!
 			}
-			_velocityScalingThermostat.apply(_moleculeContainer);
+			// the final checkpoint is written after the last time step
+			if ((_simstep < _numberOfTimesteps) && !velocitiesRequired(_simstep)) {
+				velocityScalingDeferred = _integrator->deferVelocityScaling(&_velocityScalingThermostat);
+			}
+			if (!velocityScalingDeferred) {
+				_velocityScalingThermostat.apply(_moleculeContainer);
+			}
+			_timers.stop("thermostat");
 		}
 
 		advanceSimulationTime(_integrator->getTimestepLength());
@@ -1371,38 +1539,54 @@ void Simulation::simulate() {
 		/* BEGIN PHYSICAL SECTION:
 		 * the system is in a consistent state so we can extract global variables
 		 */
+		_timers.start("global_reductions");
 		ensemble.updateGlobalVariable(NUM_PARTICLES);
 		global_log->debug() << "Number of particles in the Ensemble: "
 				<< ensemble.N() << endl;
-		ensemble.updateGlobalVariable(ENERGY);
-		global_log->debug() << "Kinetic energy in the Ensemble: "
-				<< ensemble.E() << endl;
-		ensemble.updateGlobalVariable(TEMPERATURE);
-		global_log->debug() << "Temperature of the Ensemble: " << ensemble.T()
-			<< endl;
+		// with a deferred velocity scaling, the kinetic energy is only known after the next drift
+		if (!velocityScalingDeferred) {
+			ensemble.updateGlobalVariable(ENERGY);
+			global_log->debug() << "Kinetic energy in the Ensemble: "
+					<< ensemble.E() << endl;
+			ensemble.updateGlobalVariable(TEMPERATURE);
+			global_log->debug() << "Temperature of the Ensemble: " << ensemble.T()
+				<< endl;
+		}
+		_timers.stop("global_reductions");
 		/* END PHYSICAL SECTION */
 
 		// measure per timestep IO
+		// like the loopTimer, the "loop" region excludes the output
 		loopTimer.stop();
+		_timers.stop("loop");
 		perStepIoTimer.start();
+		_timers.start("output");
 		output(_simstep);
 		if(_forced_checkpoint_time >= 0 && (loopTimer.get_etime() + ioTimer.get_etime() + perStepIoTimer.get_etime()) >= _forced_checkpoint_time) {
 			/* force checkpoint for specified time */
+			if (velocityScalingDeferred) {
+				_integrator->deferVelocityScaling(NULL);
+				_velocityScalingThermostat.apply(_moleculeContainer);
+			}
 			string cpfile(_outputPrefix + ".timed.restart.xdr");
 			global_log->info() << "Writing timed, forced checkpoint to file '" << cpfile << "'" << endl;
 			_domain->writeCheckpoint(cpfile, _moleculeContainer, _domainDecomposition);
 			_forced_checkpoint_time = -1; /* disable for further timesteps */
 		}
+		_timers.stop("output");
 		perStepIoTimer.stop();
+		_timers.start("loop");
 		loopTimer.start();
 
 	}
+	_timers.stop("loop");
 	loopTimer.stop();
 	/***************************************************************************/
 	/* END MAIN LOOP                                                           */
 	/*****************************//**********************************************/
 
     ioTimer.start();
+    _timers.start("final_io");
     if( _finalCheckpoint ) {
         /* write final checkpoint */
         string cpfile(_outputPrefix + ".restart.xdr");
@@ -1415,6 +1599,7 @@ void Simulation::simulate() {
 		(*outputIter)->finishOutput(_moleculeContainer, _domainDecomposition, _domain);
 		delete (*outputIter);
 	}
+	_timers.stop("final_io");
 	ioTimer.stop();
 
 	global_log->info() << "Computation in main loop took: "
@@ -1433,6 +1618,8 @@ void Simulation::simulate() {
 		global_log->info() << "LJ-FLOP-Count per Iteration: " << _ljFlopCounter->getTotalFlopCount() << " FLOPs" <<endl;
 		global_log->info() << "FLOP-rate: " << flop_rate << " MFLOPS" << endl;
 	}
+
+	_timers.printStatistics(_domainDecomposition);
 }
 
 void Simulation::output(unsigned long simstep) {
@@ -1442,10 +1629,16 @@ void Simulation::output(unsigned long simstep) {
 	std::list<OutputBase*>::iterator outputIter;
 	for (outputIter = _outputPlugins.begin(); outputIter != _outputPlugins.end(); outputIter++) {
 		OutputBase* output = (*outputIter);
-		global_log->debug() << "Ouptut from " << output->getPluginName() << endl;
+		string pluginName = output->getPluginName();
+		global_log->debug() << "Ouptut from " << pluginName << endl;
+		_timers.start(pluginName);
 		output->doOutput(_moleculeContainer, _domainDecomposition, _domain, simstep, &(_lmu));
+		_timers.stop(pluginName);
 	}
 
+	if (_doRecordProfile) {
+		_timers.start("profile");
+	}
 	if ((simstep >= _initStatistics) && _doRecordProfile && !(simstep % _profileRecordingTimesteps)) {
 		_domain->recordProfile(_moleculeContainer);
 	}
@@ -1463,14 +1656,50 @@ void Simulation::output(unsigned long simstep) {
 		}
 		_domain->resetProfile();
 	}
+	if (_doRecordProfile) {
+		_timers.stop("profile");
+	}
 
 	if (_domain->thermostatWarning())
 		global_log->warning() << "Thermostat!" << endl;
 	/* TODO: thermostat */
-	global_log->info() << "Simstep = " << simstep << "\tT = "
-			<< _domain->getGlobalCurrentTemperature() << "\tU_pot = "
-			<< _domain->getAverageGlobalUpot() << "\tp = "
-			<< _domain->getGlobalPressure() << endl;
+	if (macroscopicValuesRequired(simstep)) {
+		global_log->info() << "Simstep = " << simstep << "\tT = "
+				<< _domain->getGlobalCurrentTemperature() << "\tU_pot = "
+				<< _domain->getAverageGlobalUpot() << "\tp = "
+				<< _domain->getGlobalPressure() << endl;
+	} else {
+		global_log->info() << "Simstep = " << simstep << "\tT = "
+				<< _domain->getGlobalCurrentTemperature() << endl;
+	}
+}
+
+bool Simulation::macroscopicValuesRequired(unsigned long simstep) {
+	// see Domain::record_cv() in simulate()
+	if ((simstep >= _initStatistics) && _lmu.empty()) {
+		return true;
+	}
+	std::list<OutputBase*>::iterator outputIter;
+	for (outputIter = _outputPlugins.begin(); outputIter != _outputPlugins.end(); outputIter++) {
+		if ((*outputIter)->requiresMacroscopicValues(simstep)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool Simulation::velocitiesRequired(unsigned long simstep) {
+	// see Domain::recordProfile() in output()
+	if ((simstep >= _initStatistics) && _doRecordProfile && !(simstep % _profileRecordingTimesteps)) {
+		return true;
+	}
+	std::list<OutputBase*>::iterator outputIter;
+	for (outputIter = _outputPlugins.begin(); outputIter != _outputPlugins.end(); outputIter++) {
+		if ((*outputIter)->requiresVelocities(simstep)) {
+			return true;
+		}
+	}
+	return false;
 }
 
 void Simulation::finalize() {
@@ -1482,14 +1711,22 @@ void Simulation::finalize() {
 }
 
 void Simulation::updateParticleContainerAndDecomposition() {
+	_timers.start("decomposition");
 	// The particles have moved, so the neighbourhood relations have
 	// changed and have to be adjusted
+	_timers.start("cell_update");
 	_moleculeContainer->update();
+	_timers.stop("cell_update");
 	//_domainDecomposition->exchangeMolecules(_moleculeContainer, _domain);
+	_timers.start("halo_exchange");
 	_domainDecomposition->balanceAndExchange(true, _moleculeContainer, _domain);
+	_timers.stop("halo_exchange");
 	// The cache of the molecules must be updated/build after the exchange process,
 	// as the cache itself isn't transferred
+	_timers.start("molecule_caches");
 	_moleculeContainer->updateMoleculeCaches();
+	_timers.stop("molecule_caches");
+	_timers.stop("decomposition");
 }
 
 /* FIXME: we shoud provide a more general way of doing this */
@@ -5,6 +5,7 @@
 #include "parallel/DomainDecompTypes.h"
 #include "utils/OptionParser.h"
 #include "utils/SysMon.h"
+#include "utils/TimerRegistry.h"
 #include "thermostats/VelocityScalingThermostat.h"
 
 using optparse::Values;
@@ -42,6 +43,7 @@ class InputBase;
 class Timer;
 class RDF;
 class LJFlopCounter;
+class PlanarLongRangeCorrection;
 
 /** @brief Controls the simulation process
  *  @author Martin Bernreuther <bernreuther@hlrs.de> et al. (2010)
@@ -226,6 +228,23 @@ public:
      */
 	void output(unsigned long simstep);
 
+	/** @brief whether the potential energy and the virial are needed in a time step
+	 *
+	 * They are consumed by output plugins (see OutputBase::requiresMacroscopicValues)
+	 * and by the heat capacity statistics (Domain::record_cv). In all other time
+	 * steps, the cell processor only calculates the forces.
+	 * @param[in]  simstep time step of the force calculation
+	 */
+	bool macroscopicValuesRequired(unsigned long simstep);
+
+	/** @brief whether the output of a time step reads the velocities of the molecules
+	 *
+	 * Otherwise the velocity scaling of the thermostat may be deferred to the
+	 * integrator (see Integrator::deferVelocityScaling).
+	 * @param[in]  simstep timestep of the output
+	 */
+	bool velocitiesRequired(unsigned long simstep);
+
 	/** @brief clean up simulation */
 	void finalize();
 
@@ -243,6 +262,9 @@ public:
 	/** Return a reference to the domain decomposition used in the simulation */
 	DomainDecompBase& domainDecomposition() { return *_domainDecomposition; }
 
+	/** Return a reference to the registry of the named timing regions */
+	TimerRegistry& timers() { return _timers; }
+
 	/** Get pointer to the domain */
 	Domain* getDomain() { return _domain; }
 
@@ -423,6 +445,12 @@ private:
 
 	LJFlopCounter* _ljFlopCounter;
 
+	/** Slab-resolved LJ long range correction for planar interfaces, NULL if the homogeneous one is used */
+	PlanarLongRangeCorrection* _longRangeCorrection;
+
+	/** time spent in the different parts of the simulation */
+	TimerRegistry _timers;
+
 	/** Type of the domain decomposition */
 	DomainDecompType _domainDecompositionType;
 	/** module which handles the domain decomposition */
@@ -0,0 +1,461 @@
+/** \file KernelBenchmark.cpp
+ * \brief Standalone benchmark of the force kernels (cell processors).
+ *
+ * A periodic box of synthetic molecules is set up without any input file,
+ * the molecules are sorted into LinkedCells and the cells are traversed with
+ * the LegacyCellProcessor or the VectorizedCellProcessor several times. The
+ * program reports the time per molecule pair within the cutoff radius and per
+ * molecule, and how the time is divided between the gather (preprocessCell),
+ * the kernels (processCell, processCellPair) and the scatter (postprocessCell).
+ *
+ * Build with "make kernelbench" in the src directory, see --help for the options.
+ */
+
+#ifdef ENABLE_MPI
+#include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Domain.h"
+#include "Simulation.h"
+#include "ensemble/EnsembleBase.h"
+#include "molecules/Component.h"
+#include "molecules/Molecule.h"
+#include "parallel/DomainDecompBase.h"
+#include "particleContainer/LinkedCells.h"
+#include "particleContainer/ParticleCell.h"
+#include "particleContainer/adapter/CellProcessor.h"
+#include "particleContainer/adapter/LegacyCellProcessor.h"
+#include "particleContainer/adapter/ParticlePairs2PotForceAdapter.h"
+#ifdef ENABLE_VECTORIZED_CODE
+#include "particleContainer/adapter/VectorizedCellProcessor.h"
+#endif
+#include "utils/Logger.h"
+#include "utils/OptionParser.h"
+#include "utils/Random.h"
+
+using Log::global_log;
+using optparse::OptionParser;
+using optparse::Values;
+using namespace std;
+
+
+/** high resolution clock for timing single cells */
+static inline double now() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double) t.tv_sec + 1.0e-9 * (double) t.tv_nsec;
+}
+
+
+/** @brief Forwards all calls to another CellProcessor and accumulates the time spent in each phase. */
+class TimingCellProcessor : public CellProcessor {
+public:
+	enum Phase { PREPROCESS, CELL, CELLPAIR, POSTPROCESS, TRAVERSAL, NUM_PHASES };
+
+	TimingCellProcessor(CellProcessor& processor) : _processor(processor) {
+		reset();
+	}
+
+	void reset() {
+		for (int p = 0; p < NUM_PHASES; p++) {
+			_time[p] = 0.0;
+			_calls[p] = 0;
+		}
+	}
+
+	double time(Phase phase) const { return _time[phase]; }
+	unsigned long calls(Phase phase) const { return _calls[phase]; }
+
+	void initTraversal(const size_t numCells) {
+		double start = now();
+		_processor.initTraversal(numCells);
+		add(TRAVERSAL, start);
+	}
+
+	void preprocessCell(ParticleCell& cell) {
+		double start = now();
+		_processor.preprocessCell(cell);
+		add(PREPROCESS, start);
+	}
+
+	void processCellPair(ParticleCell& cell1, ParticleCell& cell2) {
+		double start = now();
+		_processor.processCellPair(cell1, cell2);
+		add(CELLPAIR, start);
+	}
+
+	void processCell(ParticleCell& cell) {
+		double start = now();
+		_processor.processCell(cell);
+		add(CELL, start);
+	}
+
+	double processSingleMolecule(Molecule* m1, ParticleCell& cell2) {
+		return _processor.processSingleMolecule(m1, cell2);
+	}
+
+	void postprocessCell(ParticleCell& cell) {
+		double start = now();
+		_processor.postprocessCell(cell);
+		add(POSTPROCESS, start);
+	}
+
+	void endTraversal() {
+		double start = now();
+		_processor.endTraversal();
+		add(TRAVERSAL, start);
+	}
+
+private:
+	void add(Phase phase, double start) {
+		_time[phase] += now() - start;
+		_calls[phase]++;
+	}
+
+	CellProcessor& _processor;
+	double _time[NUM_PHASES];
+	unsigned long _calls[NUM_PHASES];
+};
+
+
+/** @brief Counts the molecules and the pairs of molecules within the cutoff radius
+ * which the force calculation has to consider, i.e. pairs with at least one
+ * molecule outside of the halo. */
+class PairCounter : public CellProcessor {
+public:
+	PairCounter(double cutoffRadius)
+		: _cutoffRadiusSquare(cutoffRadius * cutoffRadius), _molecules(0), _pairs(0), _sitePairs(0) {
+	}
+
+	unsigned long molecules() const { return _molecules; }
+	unsigned long pairs() const { return _pairs; }
+	/** number of site-site interactions of all pairs within the cutoff radius */
+	unsigned long sitePairs() const { return _sitePairs; }
+
+	void initTraversal(const size_t numCells) {}
+	void preprocessCell(ParticleCell& cell) {}
+	void postprocessCell(ParticleCell& cell) {}
+	void endTraversal() {}
+	double processSingleMolecule(Molecule* m1, ParticleCell& cell2) { return 0.0; }
+
+	void processCell(ParticleCell& cell) {
+		if (cell.isHaloCell()) {
+			return;
+		}
+		vector<Molecule*>& molecules = cell.getParticlePointers();
+		_molecules += molecules.size();
+		for (size_t i = 0; i < molecules.size(); i++) {
+			for (size_t j = i + 1; j < molecules.size(); j++) {
+				count(molecules[i], molecules[j]);
+			}
+		}
+	}
+
+	void processCellPair(ParticleCell& cell1, ParticleCell& cell2) {
+		if (cell1.isHaloCell() && cell2.isHaloCell()) {
+			return;
+		}
+		vector<Molecule*>& molecules1 = cell1.getParticlePointers();
+		vector<Molecule*>& molecules2 = cell2.getParticlePointers();
+		for (size_t i = 0; i < molecules1.size(); i++) {
+			for (size_t j = 0; j < molecules2.size(); j++) {
+				count(molecules1[i], molecules2[j]);
+			}
+		}
+	}
+
+private:
+	void count(Molecule* m1, Molecule* m2) {
+		double r2 = 0.0;
+		for (int d = 0; d < 3; d++) {
+			double dr = m1->r(d) - m2->r(d);
+			r2 += dr * dr;
+		}
+		if (r2 < _cutoffRadiusSquare) {
+			_pairs++;
+			_sitePairs += m1->numSites() * m2->numSites();
+		}
+	}
+
+	double _cutoffRadiusSquare;
+	unsigned long _molecules;
+	unsigned long _pairs;
+	unsigned long _sitePairs;
+};
+
+
+/** add a model molecule (in reduced units, sigma = epsilon = mass = 1) to the components */
+static void addComponent(vector<Component>& components, const string& model, double cutoffRadius) {
+	Component component;
+	component.setID(components.size());
+	if (model == "1CLJ") {
+		component.addLJcenter(0.0, 0.0, 0.0, 1.0, 1.0, 1.0, cutoffRadius, false);
+	} else if (model == "2CLJ" || model == "2CLJQ") {
+		// elongation as for nitrogen or carbon dioxide models
+		component.addLJcenter(0.0, 0.0, -0.25, 0.5, 1.0, 1.0, cutoffRadius, false);
+		component.addLJcenter(0.0, 0.0, 0.25, 0.5, 1.0, 1.0, cutoffRadius, false);
+		if (model == "2CLJQ") {
+			component.addQuadrupole(0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 1.0);
+		}
+	} else if (model == "4CLJ") {
+		// tetrahedron
+		const double a = 0.25;
+		component.addLJcenter(a, a, a, 0.25, 1.0, 1.0, cutoffRadius, false);
+		component.addLJcenter(a, -a, -a, 0.25, 1.0, 1.0, cutoffRadius, false);
+		component.addLJcenter(-a, a, -a, 0.25, 1.0, 1.0, cutoffRadius, false);
+		component.addLJcenter(-a, -a, a, 0.25, 1.0, 1.0, cutoffRadius, false);
+	} else if (model == "1CLJD") {
+		// Stockmayer fluid
+		component.addLJcenter(0.0, 0.0, 0.0, 1.0, 1.0, 1.0, cutoffRadius, false);
+		component.addDipole(0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 1.0);
+		component.setI11(0.025);
+		component.setI22(0.025);
+		component.setI33(0.025);
+	} else {
+		global_log->error() << "Unknown molecule model " << model << ", use one of 1CLJ, 2CLJ, 4CLJ, 2CLJQ, 1CLJD" << endl;
+		exit(1);
+	}
+	components.push_back(component);
+}
+
+/** random unit quaternion */
+static void randomOrientation(Random& random, double q[4]) {
+	double norm = 0.0;
+	do {
+		norm = 0.0;
+		for (int i = 0; i < 4; i++) {
+			q[i] = 2.0 * random.rnd() - 1.0;
+			norm += q[i] * q[i];
+		}
+	} while (norm > 1.0 || norm < 1e-6);
+	norm = sqrt(norm);
+	for (int i = 0; i < 4; i++) {
+		q[i] /= norm;
+	}
+}
+
+
+Values& initOptions(int argc, const char* const argv[], OptionParser& op) {
+	op = OptionParser()
+		.usage("%prog [options]")
+		.description("Times the force calculation of a cell processor on a synthetic periodic box of molecules.");
+
+	op.add_option("--components").dest("components").metavar("LIST").set_default("1CLJ").help("comma separated list of molecule models, the molecules are distributed evenly among them: 1CLJ, 2CLJ, 4CLJ (multi-center LJ), 2CLJQ (quadrupolar), 1CLJD (dipolar) (default: %default)");
+	op.add_option("--density").dest("density").type("double").set_default(0.6).help("number density in units of sigma^-3 (default: %default)");
+	op.add_option("--cutoff").dest("cutoff").type("double").set_default(3.0).help("cutoff radius in units of sigma (default: %default)");
+	op.add_option("--cells-in-cutoff").dest("cellsInCutoff").type("int").set_default(1).help("number of cells per cutoff radius (default: %default)");
+	op.add_option("--num-cells").dest("cells").type("int").set_default(8).help("number of cells per dimension (without halo) (default: %default)");
+	char const* const processorChoices[] = { "legacy", "vectorized" };
+#ifdef ENABLE_VECTORIZED_CODE
+	op.add_option("--processor").dest("processor").choices(&processorChoices[0], &processorChoices[2]).set_default("vectorized").help("cell processor: legacy or vectorized (default: %default)");
+#else
+	op.add_option("--processor").dest("processor").choices(&processorChoices[0], &processorChoices[1]).set_default("legacy").help("cell processor, the vectorized one requires VECTORIZE_CODE=1 (default: %default)");
+#endif
+	op.add_option("--forces-only").action("store_true").dest("forcesOnly").type("bool").set_default(false).help("do not sum up potential energy and virial, as in most time steps of a simulation (default: %default)");
+	op.add_option("--repetitions").dest("repetitions").type("int").set_default(10).help("number of timed traversals (default: %default)");
+	op.add_option("--seed").dest("seed").type("int").set_default(8624).help("seed of the random positions and orientations (default: %default)");
+
+	return op.parse_args(argc, argv);
+}
+
+
+int main(int argc, char** argv) {
+#ifdef ENABLE_MPI
+	MPI_Init(&argc, &argv);
+#endif
+	global_log = new Log::Logger(Log::Info);
+#ifdef ENABLE_MPI
+	global_log->set_mpi_output_root(0);
+#endif
+
+	OptionParser op;
+	Values options = initOptions(argc, argv, op);
+
+	const double density = options.get("density");
+	const double cutoffRadius = options.get("cutoff");
+	const int cellsInCutoff = options.get("cellsInCutoff");
+	const int numCells = options.get("cells");
+	const int repetitions = options.get("repetitions");
+	const string processorName(options["processor"]);
+	const bool forcesOnly = options.is_set_by_user("forcesOnly");
+	if (density <= 0.0 || cutoffRadius <= 0.0 || cellsInCutoff < 1 || numCells < 1 || repetitions < 1) {
+		global_log->error() << "density, cutoff, cells-in-cutoff, cells and repetitions have to be positive" << endl;
+		exit(1);
+	}
+
+	// the simulation is only needed for the global objects (domain, ensemble, domain decomposition)
+	Simulation* simulation = new Simulation();
+	Domain* domain = simulation->getDomain();
+	DomainDecompBase& domainDecomposition = simulation->domainDecomposition();
+	if (domainDecomposition.getNumProcs() > 1) {
+		global_log->error() << "The kernel benchmark runs on a single process" << endl;
+		exit(1);
+	}
+	simulation->setcutoffRadius(cutoffRadius);
+	simulation->setLJCutoff(cutoffRadius);
+
+	vector<Component>& components = *(simulation->getEnsemble()->components());
+	components.clear();
+	vector<string> models;
+	stringstream modelList(options["components"]);
+	string model;
+	while (getline(modelList, model, ',')) {
+		addComponent(components, model, cutoffRadius);
+		models.push_back(model);
+	}
+	if (components.empty()) {
+		global_log->error() << "No components given" << endl;
+		exit(1);
+	}
+	bool polar = false;
+	for (size_t i = 0; i < components.size(); i++) {
+		polar = polar || components[i].numCharges() > 0 || components[i].numDipoles() > 0
+				|| components[i].numQuadrupoles() > 0;
+	}
+	if (polar && processorName == "vectorized") {
+		global_log->error() << "The vectorized cell processor supports Lennard-Jones sites only, use --processor legacy" << endl;
+		exit(1);
+	}
+
+	vector<double>& mixcoeff = domain->getmixcoeff();
+	mixcoeff.clear();
+	for (size_t i = 1; i < components.size(); i++) {
+		for (size_t j = i + 1; j <= components.size(); j++) {
+			mixcoeff.push_back(1.0); // xi
+			mixcoeff.push_back(1.0); // eta
+		}
+	}
+	domain->setepsilonRF(1.0e10);
+
+	// slightly larger than the nominal length, so rounding cannot remove a cell
+	const double length = numCells * cutoffRadius / cellsInCutoff * (1.0 + 1.0e-10);
+	for (int d = 0; d < 3; d++) {
+		domain->setGlobalLength(d, length);
+	}
+	double bBoxMin[3], bBoxMax[3];
+	for (int d = 0; d < 3; d++) {
+		bBoxMin[d] = domainDecomposition.getBoundingBoxMin(d, domain);
+		bBoxMax[d] = domainDecomposition.getBoundingBoxMax(d, domain);
+	}
+	LinkedCells container(bBoxMin, bBoxMax, cutoffRadius, cutoffRadius, cellsInCutoff);
+
+	// molecules on randomly occupied, distorted lattice sites, which avoids the
+	// overlaps of completely random positions
+	const unsigned long numMolecules = (unsigned long) (density * length * length * length + 0.5);
+	const int latticeSites = (int) ceil(pow((double) numMolecules, 1.0 / 3.0) - 1.0e-9);
+	const double spacing = length / latticeSites;
+	Random random;
+	random.init(options.get("seed"));
+	vector<unsigned long> sites(latticeSites * latticeSites * latticeSites);
+	for (size_t i = 0; i < sites.size(); i++) {
+		sites[i] = i;
+	}
+	for (size_t i = sites.size() - 1; i > 0; i--) {
+		swap(sites[i], sites[min((size_t) (random.rnd() * (i + 1)), i)]);
+	}
+	for (unsigned long id = 0; id < numMolecules; id++) {
+		unsigned long site = sites[id];
+		int index[3] = { (int) (site / (latticeSites * latticeSites)), (int) (site / latticeSites % latticeSites),
+				(int) (site % latticeSites) };
+		double r[3];
+		for (int d = 0; d < 3; d++) {
+			r[d] = (index[d] + 0.5 + 0.3 * (random.rnd() - 0.5)) * spacing;
+		}
+		double q[4];
+		randomOrientation(random, q);
+		Component* component = &components[id % components.size()];
+		Molecule molecule(id + 1, component, r[0], r[1], r[2], 0.0, 0.0, 0.0, q[0], q[1], q[2], q[3], 0.0, 0.0, 0.0);
+		container.addParticle(molecule);
+		component->incNumMolecules();
+	}
+	domain->setglobalNumMolecules(numMolecules);
+
+	container.update();
+	domainDecomposition.balanceAndExchange(false, &container, domain);
+	container.updateMoleculeCaches();
+	domain->initParameterStreams(cutoffRadius, cutoffRadius);
+
+	CellProcessor* processor = NULL;
+	ParticlePairs2PotForceAdapter* pairsHandler = NULL;
+#ifdef ENABLE_VECTORIZED_CODE
+	if (processorName == "vectorized") {
+		processor = new VectorizedCellProcessor(*domain, cutoffRadius);
+	}
+#endif
+	if (processor == NULL) {
+		pairsHandler = new ParticlePairs2PotForceAdapter(*domain);
+		processor = new LegacyCellProcessor(cutoffRadius, cutoffRadius, 0.0, pairsHandler);
+	}
+	processor->setComputeMacroscopicValues(!forcesOnly);
+
+	PairCounter counter(cutoffRadius);
+	container.traverseCells(counter);
+
+	// warm up caches and branch predictors
+	container.traverseCells(*processor);
+
+	// total time of plain traversals
+	double traversalTime = 0.0;
+	for (int i = 0; i < repetitions; i++) {
+		container.updateMoleculeCaches();
+		double start = now();
+		container.traverseCells(*processor);
+		traversalTime += now() - start;
+	}
+	traversalTime /= repetitions;
+
+	// times of the single phases, including the overhead of the clock
+	TimingCellProcessor timingProcessor(*processor);
+	for (int i = 0; i < repetitions; i++) {
+		container.updateMoleculeCaches();
+		container.traverseCells(timingProcessor);
+	}
+	const double clockStart = now();
+	const int clockCalls = 100000;
+	for (int i = 0; i < clockCalls; i++) {
+		now();
+	}
+	const double clockOverhead = (now() - clockStart) / clockCalls;
+
+	ostringstream out;
+	out << "Kernel benchmark: " << processorName << " cell processor" << (forcesOnly ? " (forces only)" : "") << ", components " << options["components"]
+			<< ", density " << density << ", cutoff " << cutoffRadius << ", " << cellsInCutoff << " cells in cutoff, "
+			<< numCells << "^3 cells" << endl;
+	out << "\tmolecules: " << counter.molecules() << " (plus " << container.getNumberOfParticles() - counter.molecules()
+			<< " in the halo), pairs within cutoff: " << counter.pairs() << " (" << (double) counter.pairs() / counter.molecules()
+			<< " per molecule), site pairs: " << counter.sitePairs() << endl;
+	out << fixed << setprecision(2);
+	out << "\ttraversal: " << traversalTime * 1e3 << " ms, " << traversalTime * 1e9 / counter.pairs() << " ns per pair, "
+			<< traversalTime * 1e9 / counter.sitePairs() << " ns per site pair, "
+			<< traversalTime * 1e9 / counter.molecules() << " ns per molecule" << endl;
+	out << "\tphases per traversal (clock overhead " << clockOverhead * 1e9 << " ns per call included):" << endl;
+	const char* phaseNames[] = { "preprocessCell", "processCell", "processCellPair", "postprocessCell", "init/endTraversal" };
+	for (int p = 0; p < TimingCellProcessor::NUM_PHASES; p++) {
+		TimingCellProcessor::Phase phase = (TimingCellProcessor::Phase) p;
+		double time = timingProcessor.time(phase) / repetitions;
+		double calls = (double) timingProcessor.calls(phase) / repetitions;
+		out << "\t  " << left << setw(20) << phaseNames[p] << right << setw(10) << time * 1e3 << " ms" << setw(10)
+				<< calls << " calls" << setw(12) << (calls > 0 ? time * 1e9 / calls : 0.0) << " ns per call"
+				<< setw(10) << time * 1e9 / counter.molecules() << " ns per molecule" << endl;
+	}
+	global_log->info() << out.str();
+
+	delete processor;
+	delete pairsHandler;
+	delete simulation;
+	delete global_log;
+
+#ifdef ENABLE_MPI
+	MPI_Finalize();
+#endif
+	return 0;
+}
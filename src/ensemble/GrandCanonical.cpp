@@ -1,6 +1,9 @@
 
 #include "GrandCanonical.h"
 
+#include <algorithm>
+
+#include "ensemble/OverlapGrid.h"
 #include "parallel/DomainDecompBase.h"
 #include "particleContainer/ParticleContainer.h"
 #include "utils/Logger.h"
@@ -37,6 +40,13 @@ ChemicalPotential::ChemicalPotential()
 	 this->lambda = 1.0;
 
          this->widom = false;
+	 this->batched = false;
+	 this->exclusionRadius = 0.0;
+	 this->cavityBias = false;
+	 this->overlapGrid = NULL;
+	 this->counterBased = false;
+	 this->step = 0;
+	 this->lastInsertionID = 0;
 }
 
 void ChemicalPotential::setSubdomain(int rank, double x0, double x1, double y0, double y1, double z0, double z1)
@@ -44,6 +54,22 @@ void ChemicalPotential::setSubdomain(int rank, double x0, double x1, double y0,
 	 this->ownrank = rank;
 	 this->rnd.init(8624);
 	 this->rndmomenta.init(8623);
+	 this->counterRnd.init(8624);
+	 if((this->exclusionRadius > 0.0) && (this->overlapGrid == NULL))
+	 {
+		if(this->cavityBias && this->restrictedControlVolume)
+		{
+			global_log->error() << "Cavity bias is not supported for a restricted control volume." << endl;
+			exit(1);
+		}
+		if(this->cavityBias && this->batched)
+		{
+			global_log->warning() << "Batched insertions are not supported with cavity bias and have been disabled." << endl;
+			this->batched = false;
+		}
+		// like rnd, the generator of the cavity positions is seeded independently of the rank
+		this->overlapGrid = new OverlapGrid(this->exclusionRadius, this->cavityBias, 8625);
+	 }
 	 if(!this->restrictedControlVolume)
 	 {
 		this->globalV = this->system[0] * this->system[1] * this->system[2];
@@ -88,8 +114,9 @@ void ChemicalPotential::setSystem(double x, double y, double z, double m)
 // note that *C must not contain the halo
 // but when the decisions are evaluated, the halo must be taken into account!
 //
-void ChemicalPotential::prepareTimestep(TMoleculeContainer* cell, DomainDecompBase* comm)
+void ChemicalPotential::prepareTimestep(TMoleculeContainer* cell, DomainDecompBase* comm, unsigned long simstep)
 {
+	 this->step = simstep;
 	 this->remainingDeletions.clear();
 #ifndef NDEBUG
 	 for(int d=0; d<3; d++) 
@@ -118,6 +145,12 @@ void ChemicalPotential::prepareTimestep(TMoleculeContainer* cell, DomainDecompBa
 	         << ", the decisive density quotient equals " << (float)globalN/globalReducedVolume << "\n";
 #endif
 
+   if(this->counterBased)
+   {
+      prepareLocalTrials(localN, minrnd, maxrnd);
+      return;
+   }
+
    // construct deletions (disabled for Widom test particle method)
    //
    float sel, dec;
@@ -126,8 +159,8 @@ void ChemicalPotential::prepareTimestep(TMoleculeContainer* cell, DomainDecompBa
    {
       for(unsigned i=0; i < this->instances; i++)
       {
-         sel = this->rnd.rnd();
-         dec = this->rnd.rnd();
+         sel = trialRnd();
+         dec = trialRnd();
 #ifndef NDEBUG
          // if(!ownrank) cout << "global index " << sel << " chosen for deletion.\n";
 #endif
@@ -154,8 +187,8 @@ void ChemicalPotential::prepareTimestep(TMoleculeContainer* cell, DomainDecompBa
 	 double tc[3];
 	 for(int i=0; i < insertions; i++)
 	 {
-	    for(int d=0; d < 3; d++) redc[d] = this->rnd.rnd();
-	    dec = this->rnd.rnd();
+	    for(int d=0; d < 3; d++) redc[d] = trialRnd();
+	    dec = trialRnd();
 	    if(    (redc[0] >= minredco[0]) && (redc[1] >= minredco[1]) && (redc[2] >= minredco[2]) 
 	        && (redc[0] <  maxredco[0]) && (redc[1] <  maxredco[1]) && (redc[2] <  maxredco[2]) )
 	    {
@@ -180,6 +213,135 @@ void ChemicalPotential::prepareTimestep(TMoleculeContainer* cell, DomainDecompBa
 	 }
 }
 
+// With the counter based generator, the random numbers of a trial only depend on
+// the step, the component, the kind of move and the index of the trial (or the ID
+// of the inserted molecule), not on the trials drawn before or on the process.
+void ChemicalPotential::beginTrial(uint64_t index, TrialMove move)
+{
+	 if(!this->counterBased) return;
+	 if(move == MOMENTA_TRIAL)
+	    this->counterRnd.setStream(index, (this->componentid << 3) | move);
+	 else
+	    this->counterRnd.setStream(((uint64_t)this->step << 32) | index, (this->componentid << 3) | move);
+}
+
+// Each process only draws the trials which fall into its own subdomain. The
+// selection numbers of the deletions (in [0, 1)) and the reduced positions of the
+// insertions (in [0, 1)^3) are distributed to a binary tree, whose nodes halve the
+// interval or box of their parent (along x, y, z in turn for the insertions). The
+// number of trials in the first half of a node is binomially distributed and drawn
+// from the stream of the node; the trials of a leaf are drawn uniformly within it.
+// All of this is keyed independently of the process, so the trials are the same as
+// if they had been drawn globally, but a process only descends into the nodes which
+// overlap with its subdomain. The cost is O(local trials * tree depth) instead of
+// O(global trials). The global index of a trial follows from the numbers of trials
+// in the nodes before it, it keys the random numbers of the trial and the ID of an
+// insertion. The trials of a subdomain are processed in a random order, drawn with
+// the trial, as the order of the tree depends on their position.
+void ChemicalPotential::prepareLocalTrials(unsigned localN, float minrnd, float maxrnd)
+{
+	 // about one trial per leaf
+	 unsigned levels = 0;
+	 while((levels < 30) && ((1u << levels) < this->instances)) levels++;
+
+	 vector<LocalTrial> trials;
+	 if(!this->widom)
+	 {
+	    drawLocalDeletions(this->instances, 1, levels, 0.0, 1.0, 0, minrnd, maxrnd, trials);
+	    sort(trials.begin(), trials.end());
+	    for(vector<LocalTrial>::iterator t = trials.begin(); t != trials.end(); t++)
+	    {
+	       this->remainingDeletions.push_back((unsigned)floor(localN*(t->sel[0]-minrnd)/(maxrnd-minrnd)));
+	       this->remainingDecisions.push_back(t->dec);
+	    }
+	 }
+
+	 trials.clear();
+	 const double lo[3] = {0.0, 0.0, 0.0};
+	 const double hi[3] = {1.0, 1.0, 1.0};
+	 drawLocalInsertions(this->instances, 1, 0, levels, lo, hi, 0, trials);
+	 sort(trials.begin(), trials.end());
+	 for(vector<LocalTrial>::iterator t = trials.begin(); t != trials.end(); t++)
+	 {
+	    for(int d=0; d < 3; d++)
+	       this->remainingInsertions[d].push_back(control_bottom[d] + t->sel[d]*(control_top[d] - control_bottom[d]));
+	    this->remainingDecisions.push_back(t->dec);
+	    this->remainingInsertionIDs.push_back(this->nextid + (unsigned long)t->index * id_increment);
+	 }
+	 this->nextid += (unsigned long)this->instances * id_increment;
+}
+
+unsigned ChemicalPotential::splitTrials(unsigned n, uint64_t node, TrialMove move)
+{
+	 // binomial distribution with p = 1/2: count the set bits of n random bits
+	 beginTrial(node, move);
+	 unsigned first = 0;
+	 while(n > 0)
+	 {
+	    uint32_t bits = this->counterRnd.rnd32();
+	    if(n < 32) bits &= (1u << n) - 1;
+	    for(; bits != 0; bits &= bits - 1) first++;
+	    n = (n < 32)? 0: n - 32;
+	 }
+	 return first;
+}
+
+void ChemicalPotential::drawLocalDeletions(unsigned n, uint64_t node, unsigned levels, double lo, double hi,
+		unsigned offset, float minrnd, float maxrnd, vector<LocalTrial>& trials)
+{
+	 if((n == 0) || (lo >= maxrnd) || (hi <= minrnd)) return;
+	 if(levels > 0)
+	 {
+	    unsigned first = splitTrials(n, node, DELETION_SPLIT);
+	    double mid = 0.5 * (lo + hi);
+	    drawLocalDeletions(first, 2*node, levels-1, lo, mid, offset, minrnd, maxrnd, trials);
+	    drawLocalDeletions(n - first, 2*node + 1, levels-1, mid, hi, offset + first, minrnd, maxrnd, trials);
+	    return;
+	 }
+	 for(unsigned j=0; j < n; j++)
+	 {
+	    LocalTrial t;
+	    t.index = offset + j;
+	    beginTrial(t.index, DELETION_TRIAL);
+	    t.order = this->counterRnd.rnd32();
+	    t.sel[0] = lo + (hi - lo) * this->counterRnd.rndDouble();
+	    t.dec = trialRnd();
+	    if((t.sel[0] >= minrnd) && (t.sel[0] < maxrnd)) trials.push_back(t);
+	 }
+}
+
+void ChemicalPotential::drawLocalInsertions(unsigned n, uint64_t node, unsigned level, unsigned levels,
+		const double* lo, const double* hi, unsigned offset, vector<LocalTrial>& trials)
+{
+	 if(n == 0) return;
+	 for(int d=0; d < 3; d++)
+	    if((lo[d] >= maxredco[d]) || (hi[d] <= minredco[d])) return;
+	 if(level < levels)
+	 {
+	    unsigned first = splitTrials(n, node, INSERTION_SPLIT);
+	    int dim = level % 3;
+	    double mid[3] = {hi[0], hi[1], hi[2]};
+	    mid[dim] = 0.5 * (lo[dim] + hi[dim]);
+	    drawLocalInsertions(first, 2*node, level+1, levels, lo, mid, offset, trials);
+	    mid[0] = lo[0]; mid[1] = lo[1]; mid[2] = lo[2];
+	    mid[dim] = 0.5 * (lo[dim] + hi[dim]);
+	    drawLocalInsertions(n - first, 2*node + 1, level+1, levels, mid, hi, offset + first, trials);
+	    return;
+	 }
+	 for(unsigned j=0; j < n; j++)
+	 {
+	    LocalTrial t;
+	    t.index = offset + j;
+	    beginTrial(t.index, INSERTION_TRIAL);
+	    t.order = this->counterRnd.rnd32();
+	    for(int d=0; d < 3; d++) t.sel[d] = lo[d] + (hi[d] - lo[d]) * this->counterRnd.rndDouble();
+	    t.dec = trialRnd();
+	    if(    (t.sel[0] >= minredco[0]) && (t.sel[1] >= minredco[1]) && (t.sel[2] >= minredco[2])
+	        && (t.sel[0] <  maxredco[0]) && (t.sel[1] <  maxredco[1]) && (t.sel[2] <  maxredco[2]) )
+	       trials.push_back(t);
+	 }
+}
+
 bool ChemicalPotential::getDeletion(TMoleculeContainer* cell, double* minco, double* maxco)
 {
 	 if(this->remainingDeletions.empty()) return false; // DELETION_FALSE (always occurring for Widom)
@@ -260,6 +422,7 @@ unsigned long ChemicalPotential::getInsertion(double* ins)
 	 }
 	 unsigned long nextid = *this->remainingInsertionIDs.begin();
 	 this->remainingInsertionIDs.erase(this->remainingInsertionIDs.begin());
+	 this->lastInsertionID = nextid;
 	 return nextid;
 }
 
@@ -328,6 +491,12 @@ bool ChemicalPotential::decideInsertion(double deltaUTilde)
 	 return ans;
 }
 
+void ChemicalPotential::skipDecision()
+{
+	 if(!this->remainingDecisions.empty())
+	    this->remainingDecisions.erase(this->remainingDecisions.begin());
+}
+
 void ChemicalPotential::submitTemperature(double T_in)
 {
 	 this->T = T_in;
@@ -347,7 +516,13 @@ void ChemicalPotential::submitTemperature(double T_in)
 
 void ChemicalPotential::assertSynchronization(DomainDecompBase* comm)
 {
-	 comm->assertIntIdentity(this->rnd.getIX());
+	 if(this->counterBased)
+	 {
+	    // there is no generator state, but the key of the trials has to agree
+	    comm->assertIntIdentity((int)this->step);
+	    comm->assertIntIdentity((int)this->nextid);
+	 }
+	 else comm->assertIntIdentity(this->rnd.getIX());
 }
 
 void ChemicalPotential::setControlVolume(
@@ -382,11 +557,13 @@ Molecule ChemicalPotential::loadMolecule()
 #endif
 	if(!this->widom)
 	{
+            // the momenta of the molecule inserted with the ID returned last by getInsertion
+            beginTrial(this->lastInsertionID, MOMENTA_TRIAL);
             double v[3];
             double vv = 0.0;
             for(int d=0; d < 3; d++)
             {
-               v[d] = -0.5 + this->rndmomenta.rnd();
+               v[d] = -0.5 + momentaRnd();
                vv += v[d] * v[d];
             }
             double vnorm = sqrt(3.0*T / (vv * tmp.mass()));
@@ -398,7 +575,7 @@ Molecule ChemicalPotential::loadMolecule()
                double qqtr = 0.0;
                for(int d=0; d < 4; d++)
                {
-                  qtr[d] = -0.5 + this->rndmomenta.rnd();
+                  qtr[d] = -0.5 + momentaRnd();
                   qqtr += qtr[d] * qtr[d];
                }
                double qtrnorm = sqrt(1.0 / qqtr);
@@ -407,7 +584,7 @@ Molecule ChemicalPotential::loadMolecule()
 
                double D[3];
                double Dnorm = 0.0;
-               for(int d=0; d < 3; d++) D[d] = -0.5 + this->rndmomenta.rnd();
+               for(int d=0; d < 3; d++) D[d] = -0.5 + momentaRnd();
                double w[3];
                tqtr.rotate(D, w);
                double Iw2 = w[0]*w[0] * tmp.component()->I11()
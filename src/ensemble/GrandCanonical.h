@@ -3,11 +3,14 @@
 #define GRANDCANONICAL_H_
 
 #include <list>
+#include <vector>
 
+#include "utils/CounterRandom.h"
 #include "utils/Random.h"
 #include "molecules/Molecule.h"
 
 class DomainDecompBase;
+class OverlapGrid;
 class ParticleContainer;
 
 typedef ParticleContainer TMoleculeContainer;
@@ -27,13 +30,16 @@ public:
 	void setSubdomain(int rank, double x0, double x1, double y0, double y1, double z0, double z1);
 	void setIncrement(unsigned idi) { this->id_increment = idi; }
 
-	void prepareTimestep(TMoleculeContainer* cell, DomainDecompBase* comm);  // C must not contain the halo!
+	// C must not contain the halo! simstep is part of the key of the counter based generator
+	void prepareTimestep(TMoleculeContainer* cell, DomainDecompBase* comm, unsigned long simstep);
 
 	// false if no deletion remains for this subdomain
 	bool getDeletion(TMoleculeContainer* cell, double* minco, double* maxco);
 	unsigned long getInsertion(double* ins);  // 0 if no insertion remains for this subdomain
 	bool decideDeletion(double deltaUTilde);
 	bool decideInsertion(double deltaUTilde);
+	//! @brief discard the decision of a trial move which is rejected anyway (e.g. overlapping insertion)
+	void skipDecision();
 
 	Molecule loadMolecule();
 	void storeMolecule( Molecule& old )
@@ -68,10 +74,63 @@ public:
         void enableWidom() { this->widom = true; }
         bool isWidom() { return this->widom; }
 
+	//! @brief evaluate the energies of all test insertions of a step together (see LinkedCells::grandcanonicalStep)
+	void enableBatchedInsertions() { this->batched = true; }
+	bool isBatched() { return this->batched; }
+
+	//! @brief draw the random numbers of the trial moves from a counter based generator keyed by
+	//! (step, component, trial) instead of advancing a generator in lockstep on all processes,
+	//! and the momenta of inserted molecules keyed by their ID. Each process only draws the
+	//! trials in its own subdomain (see prepareTimestep).
+	void enableCounterBasedRandom() { this->counterBased = true; }
+	bool isCounterBasedRandom() { return this->counterBased; }
+
+	//! @brief reject test insertions closer than exclusionRadius to a molecule before their energy is calculated,
+	//! with cavityBias the test insertions are placed in the free volume only (see OverlapGrid)
+	void setOverlapGrid(double exclusionRadius, bool cavityBias) {
+		this->exclusionRadius = exclusionRadius;
+		this->cavityBias = cavityBias;
+	}
+	//! @brief NULL if no overlap grid is used
+	OverlapGrid* getOverlapGrid() { return this->overlapGrid; }
+
 	double getLambda() { return this->lambda; }
 	float getDensityCoefficient() { return this->decisive_density; }
 
 private:
+	enum TrialMove {
+		DELETION_TRIAL = 0, INSERTION_TRIAL = 1, MOMENTA_TRIAL = 2,
+		DELETION_SPLIT = 3, INSERTION_SPLIT = 4  // distribution of the trials to the nodes of the trial tree
+	};
+	//! @brief select the random stream of a trial move (only for the counter based generator)
+	void beginTrial(uint64_t index, TrialMove move);
+
+	//! @brief trial of the counter based generator which falls into the own subdomain
+	struct LocalTrial {
+		uint32_t order;  // random key, the trials of a subdomain are processed in this order
+		unsigned index;  // global index of the trial
+		double sel[3];  // selection number (deletion) or reduced position (insertion)
+		float dec;
+		bool operator<(const LocalTrial& other) const {
+			return (order < other.order) || ((order == other.order) && (index < other.index));
+		}
+	};
+	//! @brief draw the trials of the step which fall into the own subdomain
+	void prepareLocalTrials(unsigned localN, float minrnd, float maxrnd);
+	//! @brief number of the n trials of a node of the trial tree which fall into its first half
+	unsigned splitTrials(unsigned n, uint64_t node, TrialMove move);
+	//! @brief draw the deletions of the node [lo, hi) of the trial tree of the selection numbers
+	//! which fall into [minrnd, maxrnd), the first trial of the node has the global index offset
+	void drawLocalDeletions(unsigned n, uint64_t node, unsigned levels, double lo, double hi,
+			unsigned offset, float minrnd, float maxrnd, std::vector<LocalTrial>& trials);
+	//! @brief draw the insertions of the node [lo, hi) of the trial tree of the reduced positions
+	//! which fall into the own subdomain, the first trial of the node has the global index offset
+	void drawLocalInsertions(unsigned n, uint64_t node, unsigned level, unsigned levels,
+			const double* lo, const double* hi, unsigned offset, std::vector<LocalTrial>& trials);
+	//! @brief next random number of the current trial move
+	float trialRnd() { return this->counterBased ? this->counterRnd.rnd() : this->rnd.rnd(); }
+	float momentaRnd() { return this->counterBased ? this->counterRnd.rnd() : this->rndmomenta.rnd(); }
+
 	int ownrank;  // only for debugging purposes (indicate rank in console output)
 
 	double h;  // Plancksches Wirkungsquantum
@@ -83,6 +142,10 @@ private:
 	unsigned interval;  // how often?
 	unsigned instances;  // how many trial insertions and deletions?
 	Random rnd, rndmomenta;
+	CounterRandom counterRnd;
+	bool counterBased;  // draw the trial moves from counterRnd instead of rnd and rndmomenta
+	unsigned long step;  // simulation step of the last call to prepareTimestep, part of the counter of counterRnd
+	unsigned long lastInsertionID;  // ID of the insertion returned last by getInsertion
 	double system[3];  // extent of the system
 	float minredco[3];  // minimal coordinates of the subdomain reduced w. r. t. the system size
 	float maxredco[3];   // maximal coordinates of the subdomain reduced w. r. t. the system size
@@ -108,6 +171,11 @@ private:
 	double lambda;
 
         bool widom;  // Widom method -> determine mu by test insertions which are all rejected
+	bool batched;  // evaluate the test insertions of a step in one batch
+
+	double exclusionRadius;  // radius for the overlap grid (0: no overlap grid)
+	bool cavityBias;  // place the test insertions in the free volume of the overlap grid
+	OverlapGrid* overlapGrid;
 
 	Molecule* reservoir;
 };
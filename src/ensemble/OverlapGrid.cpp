@@ -0,0 +1,125 @@
+#include "ensemble/OverlapGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "molecules/Molecule.h"
+#include "particleContainer/ParticleContainer.h"
+
+using namespace std;
+
+
+OverlapGrid::OverlapGrid(double exclusionRadius, bool cavityBias, int seed)
+	: _exclusionRadius(exclusionRadius), _cavityBias(cavityBias) {
+	for (int d = 0; d < 3; d++) {
+		_min[d] = 0.0;
+		_voxelLength[d] = 1.0;
+		_numVoxels[d] = 0;
+	}
+	_rnd.init(seed);
+}
+
+void OverlapGrid::build(ParticleContainer* container) {
+	// voxels of about half the exclusion radius, so that the voxel next to a
+	// molecule is still completely within its exclusion radius
+	unsigned long numVoxels = 1;
+	for (int d = 0; d < 3; d++) {
+		_min[d] = container->getBoundingBoxMin(d);
+		double length = container->getBoundingBoxMax(d) - _min[d];
+		_numVoxels[d] = max(1, (int) floor(2.0 * length / _exclusionRadius));
+		_voxelLength[d] = length / _numVoxels[d];
+		numVoxels *= _numVoxels[d];
+	}
+
+	_count.assign(numVoxels, 0);
+	_freeVoxels.resize(numVoxels);
+	_freePosition.resize(numVoxels);
+	for (unsigned long i = 0; i < numVoxels; i++) {
+		_freeVoxels[i] = i;
+		_freePosition[i] = i;
+	}
+
+	for (Molecule* m = container->begin(); m != container->end(); m = container->next()) {
+		double r[3] = { m->r(0), m->r(1), m->r(2) };
+		add(r);
+	}
+}
+
+void OverlapGrid::update(const double r[3], int delta) {
+	int low[3], high[3];
+	for (int d = 0; d < 3; d++) {
+		low[d] = max(0, (int) floor((r[d] - _exclusionRadius - _min[d]) / _voxelLength[d]));
+		high[d] = min(_numVoxels[d] - 1, (int) floor((r[d] + _exclusionRadius - _min[d]) / _voxelLength[d]));
+		if (low[d] > high[d]) {
+			return;
+		}
+	}
+
+	const double exclusionRadiusSquare = _exclusionRadius * _exclusionRadius;
+	for (int z = low[2]; z <= high[2]; z++) {
+		// distance to the farthest corner of the voxel in each dimension
+		double dz = max(fabs(r[2] - (_min[2] + z * _voxelLength[2])), fabs(r[2] - (_min[2] + (z + 1) * _voxelLength[2])));
+		for (int y = low[1]; y <= high[1]; y++) {
+			double dy = max(fabs(r[1] - (_min[1] + y * _voxelLength[1])), fabs(r[1] - (_min[1] + (y + 1) * _voxelLength[1])));
+			for (int x = low[0]; x <= high[0]; x++) {
+				double dx = max(fabs(r[0] - (_min[0] + x * _voxelLength[0])), fabs(r[0] - (_min[0] + (x + 1) * _voxelLength[0])));
+				if (dx * dx + dy * dy + dz * dz >= exclusionRadiusSquare) {
+					continue;
+				}
+
+				unsigned voxel = (z * _numVoxels[1] + y) * _numVoxels[0] + x;
+				if (delta > 0 && _count[voxel] == 0) {
+					// remove from the free voxels by swapping with the last one
+					unsigned last = _freeVoxels.back();
+					_freeVoxels[_freePosition[voxel]] = last;
+					_freePosition[last] = _freePosition[voxel];
+					_freeVoxels.pop_back();
+				}
+				_count[voxel] += delta;
+				if (delta < 0 && _count[voxel] == 0) {
+					_freePosition[voxel] = _freeVoxels.size();
+					_freeVoxels.push_back(voxel);
+				}
+			}
+		}
+	}
+}
+
+long OverlapGrid::voxelIndex(const double r[3]) const {
+	int index[3];
+	for (int d = 0; d < 3; d++) {
+		index[d] = (int) floor((r[d] - _min[d]) / _voxelLength[d]);
+		if (index[d] < 0 || index[d] >= _numVoxels[d]) {
+			return -1;
+		}
+	}
+	return ((long) index[2] * _numVoxels[1] + index[1]) * _numVoxels[0] + index[0];
+}
+
+bool OverlapGrid::isExcluded(const double r[3]) const {
+	long voxel = voxelIndex(r);
+	return voxel >= 0 && _count[voxel] > 0;
+}
+
+double OverlapGrid::freeFraction() const {
+	if (_count.empty()) {
+		return 1.0;
+	}
+	return (double) _freeVoxels.size() / (double) _count.size();
+}
+
+bool OverlapGrid::drawCavityPosition(double r[3]) {
+	if (_freeVoxels.empty()) {
+		return false;
+	}
+	unsigned i = min((unsigned) (_rnd.rnd() * _freeVoxels.size()), (unsigned) _freeVoxels.size() - 1);
+	unsigned voxel = _freeVoxels[i];
+	int index[3];
+	index[0] = voxel % _numVoxels[0];
+	index[1] = (voxel / _numVoxels[0]) % _numVoxels[1];
+	index[2] = voxel / (_numVoxels[0] * _numVoxels[1]);
+	for (int d = 0; d < 3; d++) {
+		r[d] = _min[d] + (index[d] + _rnd.rnd()) * _voxelLength[d];
+	}
+	return true;
+}
@@ -0,0 +1,77 @@
+#ifndef OVERLAPGRID_H_
+#define OVERLAPGRID_H_
+
+#include <vector>
+
+#include "utils/Random.h"
+
+class ParticleContainer;
+
+/** @brief Coarse grid of the volume excluded by the molecules, used for grand canonical test insertions
+ *
+ * The bounding box of the particle container is divided into voxels with an
+ * edge length of about half the exclusion radius. A voxel is excluded if it
+ * lies completely within the exclusion radius of a molecule, so a test insertion
+ * in an excluded voxel certainly overlaps with that molecule and can be rejected
+ * without calculating its energy. For each voxel the number of molecules which
+ * exclude it is stored, so the grid is updated locally when a trial move has
+ * been accepted instead of being rebuilt.
+ *
+ * With cavity bias, the test insertions are placed uniformly in the free (not
+ * excluded) voxels. The acceptance rules then have to be corrected by the free
+ * volume fraction (see freeFraction()).
+ */
+class OverlapGrid {
+public:
+	/**
+	 * @param exclusionRadius test insertions closer than this to a molecule are rejected
+	 * @param cavityBias      place the test insertions in the free volume only
+	 * @param seed            seed of the generator for the positions in the free volume
+	 */
+	OverlapGrid(double exclusionRadius, bool cavityBias, int seed);
+
+	/** set up the grid for the bounding box of the container and exclude the
+	 * volume around all of its molecules, including the halo */
+	void build(ParticleContainer* container);
+
+	/** exclude the volume around a molecule at position r */
+	void add(const double r[3]) { update(r, 1); }
+
+	/** release the volume around a molecule at position r, which has been added before */
+	void remove(const double r[3]) { update(r, -1); }
+
+	/** true if r lies in an excluded voxel; positions outside of the grid are never excluded */
+	bool isExcluded(const double r[3]) const;
+
+	/** fraction of the volume of the grid which is not excluded */
+	double freeFraction() const;
+
+	/** draw a uniformly distributed position in the free volume
+	 * @return false if there is no free voxel left */
+	bool drawCavityPosition(double r[3]);
+
+	double getExclusionRadius() const { return _exclusionRadius; }
+
+	bool cavityBias() const { return _cavityBias; }
+
+private:
+	void update(const double r[3], int delta);
+
+	/** index of the voxel containing r, -1 if r is outside of the grid */
+	long voxelIndex(const double r[3]) const;
+
+	double _exclusionRadius;
+	bool _cavityBias;
+
+	double _min[3];
+	double _voxelLength[3];
+	int _numVoxels[3];
+
+	std::vector<unsigned short> _count;    //!< number of molecules excluding each voxel
+	std::vector<unsigned> _freeVoxels;     //!< indices of the free voxels (in arbitrary order)
+	std::vector<unsigned> _freePosition;   //!< position of each free voxel in _freeVoxels
+
+	Random _rnd;
+};
+
+#endif /* OVERLAPGRID_H_ */
@@ -0,0 +1,179 @@
+/**
+ * \file
+ * \brief Tests for ChemicalPotential.
+ */
+
+#include "GrandCanonicalTest.h"
+#include "ensemble/GrandCanonical.h"
+#include "molecules/Molecule.h"
+#include "parallel/DomainDecompBase.h"
+#include "particleContainer/LinkedCells.h"
+#include "particleContainer/ParticleContainer.h"
+#include "particleContainer/adapter/VectorizedCellProcessor.h"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+using namespace std;
+
+TEST_SUITE_REGISTRATION(GrandCanonicalTest);
+
+GrandCanonicalTest::GrandCanonicalTest() { }
+
+GrandCanonicalTest::~GrandCanonicalTest() { }
+
+
+void GrandCanonicalTest::setUpChemicalPotential(ChemicalPotential& mu, unsigned instances, double x0, double x1) {
+	mu.setMu(0, -3.0);
+	mu.setInstances(instances);
+	mu.setSystem(12.5, 12.5, 12.5, 1.0);
+	mu.enableWidom();
+	mu.enableCounterBasedRandom();
+	mu.setSubdomain(0, x0, x1, 0.0, 12.5, 0.0, 12.5);
+}
+
+void GrandCanonicalTest::drawInsertions(ChemicalPotential& mu, ParticleContainer* container, unsigned long step,
+		vector<double>& positions) {
+	mu.prepareTimestep(container, _domainDecomposition, step);
+	positions.clear();
+	double ins[3];
+	while (mu.getInsertion(ins) > 0) {
+		positions.insert(positions.end(), ins, ins + 3);
+	}
+}
+
+void GrandCanonicalTest::testCounterBasedTrials() {
+	ParticleContainer* container = initializeFromFile(ParticleContainerFactory::LinkedCell, "1clj-regular-12x12x12.inp", 1.0);
+	ChemicalPotential continued;
+	setUpChemicalPotential(continued, 100, 0.0, 12.5);
+
+	vector<double> positions[3];
+	for (unsigned long step = 10; step < 13; step++) {
+		drawInsertions(continued, container, step, positions[step - 10]);
+		ASSERT_EQUAL((size_t) 300, positions[step - 10].size());
+	}
+	ASSERT_TRUE(positions[1] != positions[0]);
+	ASSERT_TRUE(positions[2] != positions[1]);
+
+	// a run restarted at step 12 draws the same trials
+	ChemicalPotential restarted;
+	setUpChemicalPotential(restarted, 100, 0.0, 12.5);
+	vector<double> restartedPositions;
+	drawInsertions(restarted, container, 12, restartedPositions);
+	ASSERT_TRUE(restartedPositions == positions[2]);
+	delete container;
+}
+
+void GrandCanonicalTest::testCounterBasedSubdomains() {
+	ParticleContainer* container = initializeFromFile(ParticleContainerFactory::LinkedCell, "1clj-regular-12x12x12.inp", 1.0);
+	ChemicalPotential whole, lower, upper;
+	setUpChemicalPotential(whole, 100, 0.0, 12.5);
+	setUpChemicalPotential(lower, 100, 0.0, 5.0);
+	setUpChemicalPotential(upper, 100, 5.0, 12.5);
+
+	vector<double> wholePositions, lowerPositions, upperPositions;
+	drawInsertions(whole, container, 1, wholePositions);
+	drawInsertions(lower, container, 1, lowerPositions);
+	drawInsertions(upper, container, 1, upperPositions);
+	ASSERT_EQUAL(wholePositions.size(), lowerPositions.size() + upperPositions.size());
+	for (size_t i = 0; i < lowerPositions.size(); i += 3) {
+		ASSERT_TRUE(lowerPositions[i] < 5.0);
+	}
+	for (size_t i = 0; i < upperPositions.size(); i += 3) {
+		ASSERT_TRUE(upperPositions[i] >= 5.0);
+	}
+
+	// the insertions of each subdomain appear in the same order among those of the whole domain
+	size_t l = 0, u = 0;
+	for (size_t i = 0; i < wholePositions.size(); i += 3) {
+		vector<double>& part = (wholePositions[i] < 5.0) ? lowerPositions : upperPositions;
+		size_t& j = (wholePositions[i] < 5.0) ? l : u;
+		ASSERT_TRUE(equal(part.begin() + j, part.begin() + j + 3, wholePositions.begin() + i));
+		j += 3;
+	}
+	delete container;
+}
+
+void GrandCanonicalTest::grandcanonicalSteps(ParticleContainer* container, bool batched, unsigned steps,
+		vector<unsigned long>& ids, vector<double>& positions, unsigned& insertions, unsigned& deletions) {
+	const double cutoff = 2.5;
+	VectorizedCellProcessor cellProcessor(*_domain, cutoff);
+	ChemicalPotential mu;
+	mu.setMu(0, -3.5);
+	mu.setInstances(40);
+	mu.setSystem(12.0, 12.0, 12.0, 1.0);
+	mu.setNextID(100000);
+	mu.setSubdomain(_domainDecomposition->getRank(), container->getBoundingBoxMin(0), container->getBoundingBoxMax(0),
+			container->getBoundingBoxMin(1), container->getBoundingBoxMax(1),
+			container->getBoundingBoxMin(2), container->getBoundingBoxMax(2));
+	// the thermal wavelength is 1 at T = 1
+	mu.setPlanckConstant(2.50662827);
+	if (batched) {
+		mu.enableBatchedInsertions();
+	}
+
+	insertions = 0;
+	deletions = 0;
+	for (unsigned step = 0; step < steps; step++) {
+		container->update();
+		_domainDecomposition->balanceAndExchange(false, container, _domain);
+		container->updateMoleculeCaches();
+		set<unsigned long> previous;
+		for (Molecule* m = container->begin(); m != container->end(); m = container->next()) {
+			previous.insert(m->id());
+		}
+		mu.prepareTimestep(container, _domainDecomposition, step);
+		container->grandcanonicalStep(&mu, 1.0, _domain, cellProcessor);
+		unsigned inserted = 0;
+		for (Molecule* m = container->begin(); m != container->end(); m = container->next()) {
+			if (previous.count(m->id()) == 0) {
+				inserted++;
+			}
+			ids.push_back(m->id());
+			for (int d = 0; d < 3; d++) {
+				positions.push_back(m->r(d));
+			}
+		}
+		insertions += inserted;
+		deletions += inserted - container->localGrandcanonicalBalance();
+		container->deleteOuterParticles();
+	}
+}
+
+void GrandCanonicalTest::testBatchedInsertions() {
+	const double cutoff = 2.5;
+	ParticleContainer* source = initializeFromFile(ParticleContainerFactory::LinkedCell, "lj-mixture.inp", cutoff);
+	double bBoxMin[3], bBoxMax[3];
+	for (int d = 0; d < 3; d++) {
+		bBoxMin[d] = source->getBoundingBoxMin(d);
+		bBoxMax[d] = source->getBoundingBoxMax(d);
+	}
+	// the deletions are selected by their index, so both containers hold the molecules in the same order
+	ParticleContainer* sequential = new LinkedCells(bBoxMin, bBoxMax, cutoff, cutoff, 1.0);
+	ParticleContainer* batched = new LinkedCells(bBoxMin, bBoxMax, cutoff, cutoff, 1.0);
+	for (Molecule* m = source->begin(); m != source->end(); m = source->next()) {
+		sequential->addParticle(*m);
+		batched->addParticle(*m);
+	}
+	delete source;
+
+	const unsigned steps = 3;
+	vector<unsigned long> sequentialIDs, batchedIDs;
+	vector<double> sequentialPositions, batchedPositions;
+	unsigned sequentialInsertions, sequentialDeletions, insertions, deletions;
+	grandcanonicalSteps(sequential, false, steps, sequentialIDs, sequentialPositions,
+			sequentialInsertions, sequentialDeletions);
+	grandcanonicalSteps(batched, true, steps, batchedIDs, batchedPositions, insertions, deletions);
+	ASSERT_EQUAL(sequentialInsertions, insertions);
+	ASSERT_EQUAL(sequentialDeletions, deletions);
+	ASSERT_TRUE(sequentialIDs == batchedIDs);
+	ASSERT_TRUE(sequentialPositions == batchedPositions);
+
+	// the batch is loaded after the first deletion of a step, so with more accepted
+	// deletions than steps, some of them have invalidated energies of the batch
+	ASSERT_TRUE(insertions > 0);
+	ASSERT_TRUE(deletions > steps);
+	delete sequential;
+	delete batched;
+}
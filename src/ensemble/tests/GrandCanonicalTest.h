@@ -0,0 +1,56 @@
+/**
+ * \file
+ * \brief Tests for ChemicalPotential.
+ */
+
+#ifndef GRANDCANONICALTEST_H_
+#define GRANDCANONICALTEST_H_
+
+#include "utils/TestWithSimulationSetup.h"
+
+class ChemicalPotential;
+
+/**
+ * Tests the trial moves drawn by ChemicalPotential.
+ */
+class GrandCanonicalTest: public utils::TestWithSimulationSetup {
+
+	TEST_SUITE(GrandCanonicalTest);
+	TEST_METHOD(testCounterBasedTrials);
+	TEST_METHOD(testCounterBasedSubdomains);
+	TEST_METHOD(testBatchedInsertions);
+	TEST_SUITE_END();
+
+public:
+
+	GrandCanonicalTest();
+
+	virtual ~GrandCanonicalTest();
+
+	//! with the counter based generator, the trials of a step only depend on
+	//! the step and not on the steps drawn before
+	void testCounterBasedTrials();
+
+	//! the insertions of two subdomains together are those of the whole domain
+	void testCounterBasedSubdomains();
+
+	//! the batched evaluation of the test insertions accepts and rejects the same
+	//! trials as the sequential one, also if accepted deletions invalidate energies
+	//! of the batch
+	void testBatchedInsertions();
+
+private:
+	void setUpChemicalPotential(ChemicalPotential& mu, unsigned instances, double x0, double x1);
+
+	//! draw the insertions of the next step
+	void drawInsertions(ChemicalPotential& mu, ParticleContainer* container, unsigned long step,
+			std::vector<double>& positions);
+
+	//! carry out grand canonical steps, recording the molecules after each step
+	//! and counting the accepted insertions and deletions
+	void grandcanonicalSteps(ParticleContainer* container, bool batched, unsigned steps,
+			std::vector<unsigned long>& ids, std::vector<double>& positions,
+			unsigned& insertions, unsigned& deletions);
+};
+
+#endif /* GRANDCANONICALTEST_H_ */
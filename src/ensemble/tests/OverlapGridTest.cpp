@@ -0,0 +1,85 @@
+/**
+ * \file
+ * \brief Tests for OverlapGrid.
+ */
+
+#include "OverlapGridTest.h"
+#include "ensemble/OverlapGrid.h"
+#include "molecules/Molecule.h"
+#include "particleContainer/ParticleContainer.h"
+
+#include <vector>
+
+using namespace std;
+
+TEST_SUITE_REGISTRATION(OverlapGridTest);
+
+OverlapGridTest::OverlapGridTest() { }
+
+OverlapGridTest::~OverlapGridTest() { }
+
+
+void OverlapGridTest::testExclusion() {
+	// regular lattice with spacing 1.0 at the positions 1.0 ... 12.0
+	ParticleContainer* container = initializeFromFile(ParticleContainerFactory::LinkedCell, "1clj-regular-12x12x12.inp", 1.0);
+	OverlapGrid grid(0.5, false, 1);
+	grid.build(container);
+
+	for (Molecule* m = container->begin(); m != container->end(); m = container->next()) {
+		double r[3] = { m->r(0), m->r(1), m->r(2) };
+		ASSERT_TRUE(grid.isExcluded(r));
+	}
+	double gap[3] = { 1.5, 1.5, 1.5 };
+	ASSERT_TRUE(!grid.isExcluded(gap));
+	double outside[3] = { -1.0, 1.0, 1.0 };
+	ASSERT_TRUE(!grid.isExcluded(outside));
+
+	ASSERT_TRUE(grid.freeFraction() > 0.0);
+	ASSERT_TRUE(grid.freeFraction() < 1.0);
+	delete container;
+}
+
+void OverlapGridTest::testAddRemove() {
+	ParticleContainer* container = initializeFromFile(ParticleContainerFactory::LinkedCell, "1clj-regular-12x12x12.inp", 1.0);
+	// large enough that the excluded volumes of neighbouring molecules overlap
+	OverlapGrid grid(0.8, false, 1);
+	grid.build(container);
+	double freeFraction = grid.freeFraction();
+
+	vector<Molecule*> molecules;
+	for (Molecule* m = container->begin(); m != container->end(); m = container->next()) {
+		molecules.push_back(m);
+	}
+	for (size_t i = 0; i < molecules.size(); i++) {
+		double r[3] = { molecules[i]->r(0), molecules[i]->r(1), molecules[i]->r(2) };
+		grid.remove(r);
+	}
+	ASSERT_DOUBLES_EQUAL(1.0, grid.freeFraction(), 1e-15);
+	double r0[3] = { molecules[0]->r(0), molecules[0]->r(1), molecules[0]->r(2) };
+	ASSERT_TRUE(!grid.isExcluded(r0));
+
+	for (size_t i = 0; i < molecules.size(); i++) {
+		double r[3] = { molecules[i]->r(0), molecules[i]->r(1), molecules[i]->r(2) };
+		grid.add(r);
+	}
+	ASSERT_DOUBLES_EQUAL(freeFraction, grid.freeFraction(), 1e-15);
+	ASSERT_TRUE(grid.isExcluded(r0));
+	delete container;
+}
+
+void OverlapGridTest::testCavityPosition() {
+	ParticleContainer* container = initializeFromFile(ParticleContainerFactory::LinkedCell, "1clj-regular-12x12x12.inp", 1.0);
+	OverlapGrid grid(0.8, true, 1);
+	grid.build(container);
+
+	for (int i = 0; i < 1000; i++) {
+		double r[3];
+		ASSERT_TRUE(grid.drawCavityPosition(r));
+		ASSERT_TRUE(!grid.isExcluded(r));
+		for (int d = 0; d < 3; d++) {
+			ASSERT_TRUE(r[d] >= container->getBoundingBoxMin(d));
+			ASSERT_TRUE(r[d] < container->getBoundingBoxMax(d));
+		}
+	}
+	delete container;
+}
@@ -0,0 +1,39 @@
+/**
+ * \file
+ * \brief Tests for OverlapGrid.
+ */
+
+#ifndef OVERLAPGRIDTEST_H_
+#define OVERLAPGRIDTEST_H_
+
+#include "utils/TestWithSimulationSetup.h"
+
+/**
+ * Tests the excluded volume grid for grand canonical test insertions.
+ */
+class OverlapGridTest: public utils::TestWithSimulationSetup {
+
+	TEST_SUITE(OverlapGridTest);
+	TEST_METHOD(testExclusion);
+	TEST_METHOD(testAddRemove);
+	TEST_METHOD(testCavityPosition);
+	TEST_SUITE_END();
+
+public:
+
+	OverlapGridTest();
+
+	virtual ~OverlapGridTest();
+
+	//! molecule positions are excluded, the gaps of the lattice are not
+	void testExclusion();
+
+	//! removing and adding molecules restores the free volume
+	void testAddRemove();
+
+	//! positions drawn by the cavity bias lie in the free volume
+	void testCavityPosition();
+
+};
+
+#endif /* OVERLAPGRIDTEST_H_ */
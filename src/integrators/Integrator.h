@@ -4,6 +4,7 @@
 class ParticleContainer;
 class Domain;
 class XMLfileUnits;
+class VelocityScalingThermostat;
 
 //! @brief Update velocities and positions.
 //! @author Martin Buchholz, Martin Bernreuther, et al.
@@ -65,6 +66,17 @@ public:
 	//! @param domain needed because some macroscopic values (Thermostat) might influence the integrator
 	virtual void eventNewTimestep(ParticleContainer* moleculeContainer, Domain* domain) = 0;
 
+	//! @brief apply the velocity scaling of a thermostat with the next call of eventNewTimestep
+	//!
+	//! Integrators which sweep over all molecules at the beginning of the next time step can
+	//! scale the velocities in that sweep, saving a separate pass over the molecules. Until then
+	//! the velocities of the molecules are not scaled yet and the thermostat must not change.
+	//! Passing NULL withdraws a scaling which has been handed over before.
+	//! @return false if the scaling is not done by the integrator, the caller has to apply it then
+	virtual bool deferVelocityScaling(VelocityScalingThermostat* thermostat) {
+		return false;
+	}
+
 	//! set the time between two time steps
 	void setTimestepLength(double dt) {
 		_timestepLength = dt;
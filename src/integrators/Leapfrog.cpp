@@ -1,6 +1,8 @@
 #include "Leapfrog.h"
 
+#include <algorithm>
 #include <map>
+#include <vector>
 
 #include "Domain.h"
 #include "ensemble/EnsembleBase.h"
@@ -8,6 +10,7 @@
 #include "molecules/Molecule.h"
 #include "particleContainer/ParticleContainer.h"
 #include "Simulation.h"
+#include "thermostats/VelocityScalingThermostat.h"
 #include "utils/Logger.h"
 #include "utils/xmlfileUnits.h"
 
@@ -15,13 +18,14 @@
 using namespace std;
 using Log::global_log;
 
-Leapfrog::Leapfrog(double timestepLength) :	Integrator(timestepLength) {
+Leapfrog::Leapfrog(double timestepLength) :	Integrator(timestepLength), _fused(false), _pendingThermostat(NULL) {
 	init();
 }
 
 void Leapfrog::init() {
 	// set starting state
 	_state = STATE_POST_FORCE_CALCULATION;
+	_pendingThermostat = NULL;
 }
 
 Leapfrog::~Leapfrog() {}
@@ -31,6 +35,16 @@ void Leapfrog::readXML(XMLfileUnits& xmlconfig) {
 	xmlconfig.getNodeValueReduced("timestep", _timestepLength);
 	global_log->info() << "Timestep: " << _timestepLength << endl;
 	assert(_timestepLength > 0);
+	xmlconfig.getNodeValue("fused", _fused);
+	global_log->info() << "Fused integration: " << (_fused ? "enabled" : "disabled") << endl;
+}
+
+bool Leapfrog::deferVelocityScaling(VelocityScalingThermostat* thermostat) {
+	if (!_fused) {
+		return false;
+	}
+	_pendingThermostat = thermostat;
+	return true;
 }
 
 void Leapfrog::eventForcesCalculated(ParticleContainer* molCont, Domain* domain) {
@@ -51,9 +65,24 @@ void Leapfrog::transition1to2(ParticleContainer* molCont, Domain* domain) {
 		Molecule* tempMolecule;
 		double vcorr = 2. - 1. / domain->getGlobalBetaTrans();
 		double Dcorr = 2. - 1. / domain->getGlobalBetaRot();
+		if (_pendingThermostat != NULL) {
+			_pendingThermostat->prepare();
+		}
+		// the molecules are integrated in batches, see Molecule::upd_preF(Molecule**, ...)
+		Molecule* batch[Molecule::ROTATION_BATCH];
+		unsigned batchSize = 0;
 		for (tempMolecule = molCont->begin(); tempMolecule != molCont->end(); tempMolecule = molCont->next()) {
-			tempMolecule->upd_preF(_timestepLength, vcorr, Dcorr);
+			if (_pendingThermostat != NULL) {
+				_pendingThermostat->apply(tempMolecule);
+			}
+			batch[batchSize++] = tempMolecule;
+			if (batchSize == Molecule::ROTATION_BATCH) {
+				Molecule::upd_preF(batch, batchSize, _timestepLength, vcorr, Dcorr);
+				batchSize = 0;
+			}
 		}
+		Molecule::upd_preF(batch, batchSize, _timestepLength, vcorr, Dcorr);
+		_pendingThermostat = NULL;
 
 		this->_state = STATE_PRE_FORCE_CALCULATION;
 	}
@@ -65,19 +94,36 @@ void Leapfrog::transition1to2(ParticleContainer* molCont, Domain* domain) {
 void Leapfrog::transition2to3(ParticleContainer* molCont, Domain* domain) {
 	if (this->_state == STATE_PRE_FORCE_CALCULATION) {
 		Molecule* tM;
-		map<int, unsigned long> N;
-		map<int, unsigned long> rotDOF;
-		map<int, double> summv2;
-		map<int, double> sumIw2;
 		double dt_half = 0.5 * this->_timestepLength;
 		if (domain->severalThermostats()) {
+			// the sums are indexed by thermostat ID + 1, as components without thermostat have the ID -1
+			const unsigned numComponents = _simulation.getEnsemble()->components()->size();
+			vector<int> componentThermostat(numComponents);
+			int numThermostats = 1;
+			for (unsigned cid = 0; cid < numComponents; cid++) {
+				componentThermostat[cid] = domain->getThermostat(cid);
+				assert(componentThermostat[cid] >= -1);
+				numThermostats = max(numThermostats, componentThermostat[cid] + 2);
+			}
+			vector<unsigned long> N(numThermostats, 0);
+			vector<unsigned long> rotDOF(numThermostats, 0);
+			vector<double> summv2(numThermostats, 0.0);
+			vector<double> sumIw2(numThermostats, 0.0);
 			for (tM = molCont->begin(); tM != molCont->end(); tM = molCont->next()) {
-				int cid = tM->componentid();
-				int thermostat = domain->getThermostat(cid);
+				int thermostat = componentThermostat[tM->componentid()] + 1;
 				tM->upd_postF(dt_half, summv2[thermostat], sumIw2[thermostat]);
 				N[thermostat]++;
 				rotDOF[thermostat] += tM->component()->getRotationalDegreesOfFreedom();
 			}
+			// only thermostats with local molecules are updated
+			for (int thermostat = 0; thermostat < numThermostats; thermostat++) {
+				if (N[thermostat] == 0) {
+					continue;
+				}
+				domain->setLocalSummv2(summv2[thermostat], thermostat - 1);
+				domain->setLocalSumIw2(sumIw2[thermostat], thermostat - 1);
+				domain->setLocalNrotDOF(thermostat - 1, N[thermostat], rotDOF[thermostat]);
+			}
 		}
 		else {
 			unsigned long Ngt = 0;
@@ -90,15 +136,9 @@ void Leapfrog::transition2to3(ParticleContainer* molCont, Domain* domain) {
 				Ngt++;
 				rotDOFgt += tM->component()->getRotationalDegreesOfFreedom();
 			}
-			N[0] = Ngt;
-			rotDOF[0] = rotDOFgt;
-			summv2[0] = summv2gt;
-			sumIw2[0] = sumIw2gt;
-		}
-		for (map<int, double>::iterator thermit = summv2.begin(); thermit != summv2.end(); thermit++) {
-			domain->setLocalSummv2(thermit->second, thermit->first);
-			domain->setLocalSumIw2(sumIw2[thermit->first], thermit->first);
-			domain->setLocalNrotDOF(thermit->first, N[thermit->first], rotDOF[thermit->first]);
+			domain->setLocalSummv2(summv2gt, 0);
+			domain->setLocalSumIw2(sumIw2gt, 0);
+			domain->setLocalNrotDOF(0, Ngt, rotDOFgt);
 		}
 
 		this->_state = STATE_POST_FORCE_CALCULATION;
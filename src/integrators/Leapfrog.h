@@ -1,6 +1,8 @@
 #ifndef LEAPFROG_H_
 #define LEAPFROG_H_
 
+#include <cstddef>
+
 #include "integrators/Integrator.h"
 
 /** @brief Implementation of the rotational leapfrog integration scheme.
@@ -38,7 +40,7 @@ public:
 	};
 	//! The constructor
 	Leapfrog(double timestepLength);
-	Leapfrog(){}
+	Leapfrog() : _fused(false), _pendingThermostat(NULL) {}
 
 	//! The destructor
 	~Leapfrog();
@@ -50,6 +52,7 @@ public:
 	 * \code{.xml}
 	   <integrator type="Leapfrog" >
 	     <timestep>DOUBLE</timestep>
+	     <fused>BOOL</fused> <!-- optional, see setFused() -->
 	   </integrator>
 	   \endcode
 	 */
@@ -57,6 +60,16 @@ public:
 
 	virtual void init();
 
+	/** @brief Fuse the thermostat and the kinetic sums into the sweeps of the integrator.
+	 *
+	 * In fused mode the velocity scaling of the thermostat is done together with the drift
+	 * of the next time step (see deferVelocityScaling()), so each time step takes one sweep
+	 * over the molecules before and one after the force calculation.
+	 */
+	void setFused(bool fused) { _fused = fused; }
+
+	bool deferVelocityScaling(VelocityScalingThermostat* thermostat);
+
 	//! @brief steps between the force calculation and the end of the time step
 	//!
 	//! checks whether the current state of the integrator allows that this method is called
@@ -89,6 +102,12 @@ private:
 	//! state in which the integrator is
 	int _state;
 
+	//! whether the velocity scaling may be deferred to the next time step
+	bool _fused;
+
+	//! thermostat to apply in the next transition1to2, NULL if there is none
+	VelocityScalingThermostat* _pendingThermostat;
+
 	//! @brief calculate new positions and the first velocity halfstep
 	//!
 	//! This method also checks whether the state is 1. If so, the calculations are done and
@@ -0,0 +1,122 @@
+/**
+ * \file
+ * \brief Tests for the Leapfrog integrator.
+ */
+
+#include "LeapfrogTest.h"
+#include "Domain.h"
+#include "Simulation.h"
+#include "molecules/Molecule.h"
+#include "particleContainer/ParticleContainer.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+TEST_SUITE_REGISTRATION(LeapfrogTest);
+
+LeapfrogTest::LeapfrogTest() { }
+
+LeapfrogTest::~LeapfrogTest() { }
+
+
+void LeapfrogTest::simulate(bool fused, bool checkpoints, const string& prefix,
+		map<unsigned long, vector<double> >& state) {
+	// every run starts from a new simulation
+	tearDown();
+	setUp();
+
+	stringstream configFile;
+	configFile << "LeapfrogTest-" << _rank << ".cfg";
+	{
+		ofstream config(configFile.str().c_str());
+		config << "MDProjectConfig\n"
+				<< "timestepLength 0.004\n"
+				<< "cutoffRadius 2.5\n"
+				<< "phaseSpaceFile OldStyle " << getTestDataFilename("lj-mixture.inp") << "\n"
+				<< "datastructure LinkedCells 1\n";
+		if (checkpoints) {
+			config << "output CheckpointWriter 3 " << prefix << "\n";
+		}
+		if (fused) {
+			config << "fusedIntegration\n";
+		}
+	}
+	global_simulation->initConfigOldstyle(configFile.str());
+	remove(configFile.str().c_str());
+
+	// two thermostats far from the temperature of the input, so the velocities are scaled noticeably
+	Domain* domain = global_simulation->getDomain();
+	domain->setTargetTemperature(1, 0.9);
+	domain->setTargetTemperature(2, 0.5);
+	domain->setComponentThermostat(0, 1);
+	domain->setComponentThermostat(1, 2);
+
+	global_simulation->setNumTimesteps(9);
+	global_simulation->setOutputPrefix(prefix);
+	global_simulation->disableFinalCheckpoint();
+	// the timed checkpoint is written in the first time step
+	global_simulation->setForcedCheckpointTime(checkpoints ? -1 : 0);
+	global_simulation->prepare_start();
+	global_simulation->simulate();
+
+	state.clear();
+	ParticleContainer* container = global_simulation->getMolecules();
+	for (Molecule* m = container->begin(); m != container->end(); m = container->next()) {
+		vector<double>& values = state[m->id()];
+		for (int d = 0; d < 3; d++) {
+			values.push_back(m->r(d));
+			values.push_back(m->v(d));
+			values.push_back(m->D(d));
+		}
+		values.push_back(m->q().qw());
+		values.push_back(m->q().qx());
+		values.push_back(m->q().qy());
+		values.push_back(m->q().qz());
+	}
+}
+
+void LeapfrogTest::assertEqualFiles(const string& expected, const string& actual) {
+	stringstream expectedContent, actualContent;
+	{
+		ifstream expectedStream(expected.c_str());
+		ifstream actualStream(actual.c_str());
+		expectedContent << expectedStream.rdbuf();
+		actualContent << actualStream.rdbuf();
+	}
+	remove(expected.c_str());
+	remove(actual.c_str());
+	ASSERT_TRUE_MSG("missing output " + expected, !expectedContent.str().empty());
+	ASSERT_TRUE_MSG(actual + " differs from " + expected, expectedContent.str() == actualContent.str());
+}
+
+void LeapfrogTest::testFusedCheckpoints() {
+	map<unsigned long, vector<double> > unfused, fused;
+	simulate(false, true, "LeapfrogTest-unfused", unfused);
+	simulate(true, true, "LeapfrogTest-fused", fused);
+	ASSERT_EQUAL(unfused.size(), fused.size());
+	ASSERT_TRUE(unfused == fused);
+
+	// written in the steps 0, 3, 6 and 9
+	if (_rank == 0) {
+		for (int i = 0; i < 4; i++) {
+			stringstream suffix;
+			suffix << "-" << i << ".restart.dat";
+			assertEqualFiles("LeapfrogTest-unfused" + suffix.str(), "LeapfrogTest-fused" + suffix.str());
+		}
+	}
+}
+
+void LeapfrogTest::testFusedTimedCheckpoint() {
+	map<unsigned long, vector<double> > unfused, fused;
+	simulate(false, false, "LeapfrogTest-unfused", unfused);
+	simulate(true, false, "LeapfrogTest-fused", fused);
+	ASSERT_EQUAL(unfused.size(), fused.size());
+	ASSERT_TRUE(unfused == fused);
+
+	if (_rank == 0) {
+		assertEqualFiles("LeapfrogTest-unfused.timed.restart.xdr", "LeapfrogTest-fused.timed.restart.xdr");
+	}
+}
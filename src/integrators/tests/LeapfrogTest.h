@@ -0,0 +1,51 @@
+/**
+ * \file
+ * \brief Tests for the Leapfrog integrator.
+ */
+
+#ifndef LEAPFROGTEST_H_
+#define LEAPFROGTEST_H_
+
+#include "utils/TestWithSimulationSetup.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Runs short simulations of lj-mixture.inp with two component-wise thermostats
+ * and compares the fused integration (see Leapfrog::setFused()) with the unfused one.
+ */
+class LeapfrogTest: public utils::TestWithSimulationSetup {
+
+	TEST_SUITE(LeapfrogTest);
+	TEST_METHOD(testFusedCheckpoints);
+	TEST_METHOD(testFusedTimedCheckpoint);
+	TEST_SUITE_END();
+
+public:
+
+	LeapfrogTest();
+
+	virtual ~LeapfrogTest();
+
+	//! the steps of the CheckpointWriter apply the velocity scaling immediately,
+	//! the checkpoints and the final state are the same as without fusing
+	void testFusedCheckpoints();
+
+	//! the timed checkpoint withdraws the deferred velocity scaling and applies it,
+	//! the checkpoint and the final state are the same as without fusing
+	void testFusedTimedCheckpoint();
+
+private:
+
+	//! run a new simulation and return the positions, velocities, angular momenta and
+	//! orientations of the local molecules by their ID
+	void simulate(bool fused, bool checkpoints, const std::string& prefix,
+			std::map<unsigned long, std::vector<double> >& state);
+
+	//! assert that two output files are the same
+	void assertEqualFiles(const std::string& expected, const std::string& actual);
+};
+
+#endif /* LEAPFROGTEST_H_ */
@@ -0,0 +1,311 @@
+/** \file BinaryPhaseSpaceFormat.h
+  * \brief layout of the binary phase space format (*.bps)
+  *
+  * This header has no dependencies on the rest of MarDyn, so it can be
+  * shared between the InputBinary reader and the converter in tools/bps.
+  */
+
+#ifndef BINARYPHASESPACEFORMAT_H_
+#define BINARYPHASESPACEFORMAT_H_
+
+#include <stdint.h>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/** @brief Binary phase space files, which can be used without parsing.
+ *
+ * File layout (all numbers in the byte order of the writing host):
+ * \code
+ * header:  FileHeader (64 bytes)
+ * text:    headerTextLength bytes: the header of the text format, i.e. everything
+ *          in front of the NumberOfMolecules line (components, box, thermostats)
+ * records: starting at dataOffset (multiple of 8), numMolecules molecules
+ * \endcode
+ * The records contain the fields of the molecule format (see Field), each
+ * stored as 8 byte value. The component id is a uint32 (counting from 1 as in
+ * the text format) followed by 4 bytes of padding.
+ * - AOS: one record after the other, all fields of a molecule are contiguous
+ * - SOA: one array per field with the values of all molecules, each array
+ *        padded to a multiple of 8 bytes
+ */
+namespace bps {
+
+const char fileMagic[8] = "MDBPSP1";
+
+enum MoleculeFormat { ICRVQD = 0, ICRV = 1, IRV = 2 };
+
+enum Layout { AOS = 0, SOA = 1 };
+
+/** fields of a molecule record, in the order they are stored */
+enum Field { ID, CID, RX, RY, RZ, VX, VY, VZ, Q0, Q1, Q2, Q3, DX, DY, DZ, NUM_FIELDS };
+
+struct FileHeader {
+	char magic[8];
+	uint32_t moleculeFormat;
+	uint32_t layout;
+	uint64_t numMolecules;
+	uint32_t numComponents;
+	uint32_t headerTextLength;
+	double box[3];
+	uint64_t dataOffset;
+};
+
+inline bool hasField(uint32_t format, int field) {
+	if (field == CID) {
+		return format != IRV;
+	}
+	if (field >= Q0) {
+		return format == ICRVQD;
+	}
+	return true;
+}
+
+/** size of a value of the field without padding */
+inline size_t fieldSize(int field) {
+	return (field == CID) ? sizeof(uint32_t) : sizeof(double);
+}
+
+inline size_t padTo8(size_t bytes) {
+	return (bytes + 7) & ~size_t(7);
+}
+
+/** size of one molecule record in the AOS layout */
+inline size_t recordSize(uint32_t format) {
+	size_t size = 0;
+	for (int f = 0; f < NUM_FIELDS; f++) {
+		if (hasField(format, f)) {
+			size += 8;
+		}
+	}
+	return size;
+}
+
+/** total size of the molecule records of a file */
+inline uint64_t dataSize(const FileHeader& header) {
+	uint64_t size = 0;
+	for (int f = 0; f < NUM_FIELDS; f++) {
+		if (hasField(header.moleculeFormat, f)) {
+			size += (header.layout == SOA) ? padTo8(fieldSize(f) * header.numMolecules) : 8 * header.numMolecules;
+		}
+	}
+	return size;
+}
+
+/** @brief Random access to the fields of the molecule records in memory
+ *
+ * The records are not copied, so the view can be put directly on top of a
+ * memory mapped file. Fields which are not part of the molecule format
+ * return the defaults of the text reader (component 1, quaternion (1,0,0,0),
+ * everything else 0).
+ */
+class RecordView {
+public:
+	RecordView(const unsigned char* data, const FileHeader& header) : _data(data) {
+		size_t offset = 0;
+		for (int f = 0; f < NUM_FIELDS; f++) {
+			_has[f] = hasField(header.moleculeFormat, f);
+			if (!_has[f]) {
+				_offset[f] = _stride[f] = 0;
+			}
+			else if (header.layout == SOA) {
+				_offset[f] = offset;
+				_stride[f] = fieldSize(f);
+				offset += padTo8(fieldSize(f) * header.numMolecules);
+			}
+			else {
+				_offset[f] = offset;
+				_stride[f] = recordSize(header.moleculeFormat);
+				offset += 8;
+			}
+		}
+	}
+
+	bool has(int field) const {
+		return _has[field];
+	}
+
+	uint64_t id(uint64_t i) const {
+		return load<uint64_t>(ID, i);
+	}
+
+	uint32_t componentId(uint64_t i) const {
+		return _has[CID] ? load<uint32_t>(CID, i) : 1;
+	}
+
+	double value(int field, uint64_t i) const {
+		if (!_has[field]) {
+			return (field == Q0) ? 1.0 : 0.0;
+		}
+		return load<double>(field, i);
+	}
+
+private:
+	template<typename T>
+	T load(int field, uint64_t i) const {
+		T v;
+		memcpy(&v, _data + _offset[field] + i * _stride[field], sizeof(T));
+		return v;
+	}
+
+	const unsigned char* _data;
+	bool _has[NUM_FIELDS];
+	size_t _offset[NUM_FIELDS];
+	size_t _stride[NUM_FIELDS];
+};
+
+/** molecule as read from the text format; values are indexed by Field - RX */
+struct Record {
+	uint64_t id;
+	uint32_t cid;
+	double values[NUM_FIELDS - RX];
+};
+
+template<typename T>
+inline void writeValue(std::ostream& out, T value) {
+	out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+inline void writeField(std::ostream& out, const Record& record, int field, bool padded) {
+	if (field == ID) {
+		writeValue(out, record.id);
+	}
+	else if (field == CID) {
+		writeValue(out, record.cid);
+		if (padded) {
+			writeValue(out, uint32_t(0));
+		}
+	}
+	else {
+		writeValue(out, record.values[field - RX]);
+	}
+}
+
+/** write a complete file; headerText is the text header (without the NumberOfMolecules line) */
+inline void write(std::ostream& out, const std::string& headerText, const double box[3], uint32_t numComponents,
+		uint32_t format, uint32_t layout, const std::vector<Record>& records) {
+	FileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, fileMagic, sizeof(header.magic));
+	header.moleculeFormat = format;
+	header.layout = layout;
+	header.numMolecules = records.size();
+	header.numComponents = numComponents;
+	header.headerTextLength = headerText.size();
+	for (int d = 0; d < 3; d++) {
+		header.box[d] = box[d];
+	}
+	header.dataOffset = padTo8(sizeof(FileHeader) + headerText.size());
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(headerText.data(), headerText.size());
+	for (size_t pad = sizeof(FileHeader) + headerText.size(); pad < header.dataOffset; pad++) {
+		out.put(0);
+	}
+
+	if (layout == AOS) {
+		for (size_t i = 0; i < records.size(); i++) {
+			for (int f = 0; f < NUM_FIELDS; f++) {
+				if (hasField(format, f)) {
+					writeField(out, records[i], f, true);
+				}
+			}
+		}
+	}
+	else {
+		for (int f = 0; f < NUM_FIELDS; f++) {
+			if (!hasField(format, f)) {
+				continue;
+			}
+			for (size_t i = 0; i < records.size(); i++) {
+				writeField(out, records[i], f, false);
+			}
+			for (size_t pad = fieldSize(f) * records.size(); pad < padTo8(fieldSize(f) * records.size()); pad++) {
+				out.put(0);
+			}
+		}
+	}
+}
+
+/** @brief convert a phase space file in the text format (e.g. a checkpoint) to the binary format
+ * @return false if the input could not be parsed, the reason is stored in error
+ */
+inline bool convertText(std::istream& in, std::ostream& out, uint32_t layout, std::string& error) {
+	std::string headerText;
+	std::string line;
+	double box[3] = { 0.0, 0.0, 0.0 };
+	uint32_t numComponents = 0;
+	uint64_t numMolecules = 0;
+	bool foundNumMolecules = false;
+	while (std::getline(in, line)) {
+		std::istringstream lineStream(line);
+		std::string token;
+		lineStream >> token;
+		if (token == "NumberOfMolecules" || token == "N") {
+			lineStream >> numMolecules;
+			foundNumMolecules = true;
+			break;
+		}
+		if (token == "Length" || token == "L") {
+			lineStream >> box[0] >> box[1] >> box[2];
+		}
+		else if (token == "NumberOfComponents" || token == "C") {
+			lineStream >> numComponents;
+		}
+		headerText += line + "\n";
+	}
+	if (!foundNumMolecules) {
+		error = "missing NumberOfMolecules";
+		return false;
+	}
+
+	uint32_t format = ICRVQD;
+	std::streampos pos = in.tellg();
+	std::string token;
+	in >> token;
+	if (token == "MoleculeFormat" || token == "M") {
+		in >> token;
+		if (token == "ICRVQD") format = ICRVQD;
+		else if (token == "ICRV") format = ICRV;
+		else if (token == "IRV") format = IRV;
+		else {
+			error = "unknown molecule format " + token;
+			return false;
+		}
+	}
+	else {
+		in.seekg(pos);
+	}
+
+	std::vector<Record> records(numMolecules);
+	for (uint64_t i = 0; i < numMolecules; i++) {
+		Record& r = records[i];
+		r.cid = 1;
+		for (int f = RX; f < NUM_FIELDS; f++) {
+			r.values[f - RX] = (f == Q0) ? 1.0 : 0.0;
+		}
+		in >> r.id;
+		if (format != IRV) {
+			in >> r.cid;
+		}
+		for (int f = RX; f < NUM_FIELDS; f++) {
+			if (hasField(format, f)) {
+				in >> r.values[f - RX];
+			}
+		}
+		if (!in) {
+			std::ostringstream msg;
+			msg << "could only read " << i << " of " << numMolecules << " molecules";
+			error = msg.str();
+			return false;
+		}
+	}
+	write(out, headerText, box, numComponents, format, layout, records);
+	return out.good();
+}
+
+} // namespace bps
+
+#endif /* BINARYPHASESPACEFORMAT_H_ */
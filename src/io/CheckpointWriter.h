@@ -34,6 +34,10 @@ public:
 	void finishOutput(ParticleContainer* particleContainer,
 			DomainDecompBase* domainDecomp, Domain* domain);
 	
+	bool requiresVelocities(unsigned long simstep) {
+		return simstep % _writeFrequency == 0;
+	}
+
 	std::string getPluginName() {
 		return std::string("CheckpointWriter");
 	}
@@ -0,0 +1,291 @@
+/** \file CompressedTrajectoryCodec.h
+  * \brief bit stream and entropy coder of the compressed trajectory format
+  *
+  * This header has no dependencies on the rest of MarDyn, so it can be
+  * shared between the CompressedTrajectoryWriter output plugin and the
+  * standalone reader in tools/ctraj.
+  */
+
+#ifndef COMPRESSEDTRAJECTORYCODEC_H_
+#define COMPRESSEDTRAJECTORYCODEC_H_
+
+#include <stdint.h>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+/** @brief Building blocks of the compressed trajectory (*.ctraj) format.
+ *
+ * File layout (all numbers little endian as written by the host):
+ * \code
+ * header:  char[8] magic "MDCTRJ1", uint32 flags, double precision,
+ *          double orientationPrecision, double velocityPrecision,
+ *          double box[3], uint32 numComponents
+ * frame:   char[4] "FRAM", uint64 simstep, double time,
+ *          uint32 numBlocks, then numBlocks blocks
+ * block:   uint64 numMolecules, uint64 numBytes, numBytes payload bytes
+ * \endcode
+ * Every process writes one block per frame. Inside a block molecules are
+ * sorted along the cell ordering of the process' subdomain and encoded as
+ * - component id (adaptive Rice code)
+ * - molecule id (zigzag delta to the previous molecule, adaptive Rice code)
+ * - position quantized to precision, zigzag delta to the previous molecule
+ * - optionally the quaternion quantized to orientationPrecision
+ * - optionally the velocity quantized to velocityPrecision
+ * Each of these quantities has its own adaptive Rice model, so the code
+ * length adapts to the actual distribution of the deltas.
+ */
+namespace ctraj {
+
+const char fileMagic[8] = "MDCTRJ1";
+const char frameMagic[4] = { 'F', 'R', 'A', 'M' };
+
+enum Flags {
+	ORIENTATION = 1,
+	VELOCITY = 2
+};
+
+/** map signed to unsigned integers: 0, -1, 1, -2, 2, ... -> 0, 1, 2, 3, 4, ... */
+inline uint64_t zigzag(int64_t v) {
+	return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t unzigzag(uint64_t u) {
+	return static_cast<int64_t>(u >> 1) ^ -static_cast<int64_t>(u & 1);
+}
+
+/** quantize a value to an integer multiple of precision */
+inline int64_t quantize(double value, double precision) {
+	return static_cast<int64_t>(floor(value / precision + 0.5));
+}
+
+/** @brief Append single bits to a byte buffer, most significant bit first. */
+class BitWriter {
+public:
+	BitWriter(std::vector<unsigned char>& buffer) : _buffer(buffer), _current(0), _numBits(0) {}
+
+	void putBit(unsigned bit) {
+		_current = (_current << 1) | (bit & 1);
+		if (++_numBits == 8) {
+			_buffer.push_back(_current);
+			_current = 0;
+			_numBits = 0;
+		}
+	}
+
+	/** write the lowest n bits of value */
+	void putBits(uint64_t value, unsigned n) {
+		while (n > 0) {
+			n--;
+			putBit(static_cast<unsigned>((value >> n) & 1));
+		}
+	}
+
+	/** pad the last byte with zeros */
+	void flush() {
+		while (_numBits != 0) {
+			putBit(0);
+		}
+	}
+
+private:
+	std::vector<unsigned char>& _buffer;
+	unsigned char _current;
+	unsigned _numBits;
+};
+
+/** @brief Read single bits from a byte buffer written by BitWriter. */
+class BitReader {
+public:
+	BitReader(const unsigned char* data, size_t size) : _data(data), _size(size), _pos(0), _bit(0) {}
+
+	unsigned getBit() {
+		if (_pos >= _size) {
+			return 0;
+		}
+		unsigned bit = (_data[_pos] >> (7 - _bit)) & 1;
+		if (++_bit == 8) {
+			_bit = 0;
+			_pos++;
+		}
+		return bit;
+	}
+
+	uint64_t getBits(unsigned n) {
+		uint64_t value = 0;
+		while (n-- > 0) {
+			value = (value << 1) | getBit();
+		}
+		return value;
+	}
+
+	bool exhausted() const { return _pos >= _size; }
+
+private:
+	const unsigned char* _data;
+	size_t _size;
+	size_t _pos;
+	unsigned _bit;
+};
+
+/** @brief Adaptive Golomb-Rice coder for non-negative integers.
+ *
+ * The Rice parameter k is derived from the running mean of the coded values
+ * (as in LOCO-I), which makes the code length close to the entropy for the
+ * geometrically distributed deltas of sorted, quantized coordinates.
+ * Values whose unary part would exceed maxUnary are escaped and stored with
+ * 64 bits.
+ */
+class AdaptiveRiceModel {
+public:
+	AdaptiveRiceModel() : _sum(4), _count(1) {}
+
+	void encode(BitWriter& out, uint64_t value) {
+		unsigned k = parameter();
+		uint64_t q = value >> k;
+		if (q >= maxUnary) {
+			for (unsigned i = 0; i < maxUnary; i++) {
+				out.putBit(1);
+			}
+			out.putBits(value, 64);
+		}
+		else {
+			for (uint64_t i = 0; i < q; i++) {
+				out.putBit(1);
+			}
+			out.putBit(0);
+			out.putBits(value, k);
+		}
+		update(value);
+	}
+
+	uint64_t decode(BitReader& in) {
+		unsigned k = parameter();
+		uint64_t q = 0;
+		while (q < maxUnary && in.getBit() == 1) {
+			q++;
+		}
+		uint64_t value;
+		if (q == maxUnary) {
+			value = in.getBits(64);
+		}
+		else {
+			value = (q << k) | in.getBits(k);
+		}
+		update(value);
+		return value;
+	}
+
+private:
+	static const unsigned maxUnary = 32;
+	static const uint64_t resetCount = 64;
+
+	unsigned parameter() const {
+		unsigned k = 0;
+		while ((_count << k) < _sum && k < 62) {
+			k++;
+		}
+		return k;
+	}
+
+	void update(uint64_t value) {
+		/* saturate instead of overflowing on escaped values */
+		const uint64_t maxIncrement = ~static_cast<uint64_t>(0) >> 8;
+		_sum += (value > maxIncrement) ? maxIncrement : value;
+		if (++_count >= resetCount) {
+			_sum >>= 1;
+			_count >>= 1;
+		}
+	}
+
+	uint64_t _sum;
+	uint64_t _count;
+};
+
+/** @brief One decoded molecule record */
+struct Record {
+	unsigned long id;
+	unsigned cid;
+	double r[3];
+	double q[4];
+	double v[3];
+};
+
+/** @brief Encoder/decoder for the molecules of one block.
+ *
+ * Encoding and decoding have to be done in the same order with the same
+ * flags and precisions, as the coder state is shared between records.
+ */
+class BlockCoder {
+public:
+	BlockCoder(unsigned flags, double precision, double orientationPrecision, double velocityPrecision)
+		: _flags(flags), _precision(precision), _orientationPrecision(orientationPrecision),
+		  _velocityPrecision(velocityPrecision), _lastId(0) {
+		for (int d = 0; d < 3; d++) {
+			_lastR[d] = 0;
+		}
+	}
+
+	void encode(BitWriter& out, const Record& rec) {
+		_cidModel.encode(out, rec.cid);
+		_idModel.encode(out, zigzag(static_cast<int64_t>(rec.id) - static_cast<int64_t>(_lastId)));
+		_lastId = rec.id;
+		for (int d = 0; d < 3; d++) {
+			int64_t r = quantize(rec.r[d], _precision);
+			_rModel[d].encode(out, zigzag(r - _lastR[d]));
+			_lastR[d] = r;
+		}
+		if (_flags & ORIENTATION) {
+			for (int i = 0; i < 4; i++) {
+				_qModel[i].encode(out, zigzag(quantize(rec.q[i], _orientationPrecision)));
+			}
+		}
+		if (_flags & VELOCITY) {
+			for (int d = 0; d < 3; d++) {
+				_vModel[d].encode(out, zigzag(quantize(rec.v[d], _velocityPrecision)));
+			}
+		}
+	}
+
+	void decode(BitReader& in, Record& rec) {
+		rec.cid = static_cast<unsigned>(_cidModel.decode(in));
+		rec.id = static_cast<unsigned long>(static_cast<int64_t>(_lastId) + unzigzag(_idModel.decode(in)));
+		_lastId = rec.id;
+		for (int d = 0; d < 3; d++) {
+			_lastR[d] += unzigzag(_rModel[d].decode(in));
+			rec.r[d] = _lastR[d] * _precision;
+		}
+		rec.q[0] = 1.0;
+		rec.q[1] = rec.q[2] = rec.q[3] = 0.0;
+		if (_flags & ORIENTATION) {
+			for (int i = 0; i < 4; i++) {
+				rec.q[i] = unzigzag(_qModel[i].decode(in)) * _orientationPrecision;
+			}
+		}
+		rec.v[0] = rec.v[1] = rec.v[2] = 0.0;
+		if (_flags & VELOCITY) {
+			for (int d = 0; d < 3; d++) {
+				rec.v[d] = unzigzag(_vModel[d].decode(in)) * _velocityPrecision;
+			}
+		}
+	}
+
+private:
+	unsigned _flags;
+	double _precision;
+	double _orientationPrecision;
+	double _velocityPrecision;
+
+	unsigned long _lastId;
+	int64_t _lastR[3];
+
+	AdaptiveRiceModel _cidModel;
+	AdaptiveRiceModel _idModel;
+	AdaptiveRiceModel _rModel[3];
+	AdaptiveRiceModel _qModel[4];
+	AdaptiveRiceModel _vModel[3];
+};
+
+} /* end namespace ctraj */
+
+#endif /* COMPRESSEDTRAJECTORYCODEC_H_ */
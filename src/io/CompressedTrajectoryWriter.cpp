@@ -0,0 +1,254 @@
+#include "io/CompressedTrajectoryWriter.h"
+
+#ifdef ENABLE_MPI
+#include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#include "Common.h"
+#include "Domain.h"
+#include "io/CompressedTrajectoryCodec.h"
+#include "molecules/Molecule.h"
+#include "parallel/DomainDecompBase.h"
+#include "particleContainer/ParticleContainer.h"
+#include "Simulation.h"
+#include "utils/Logger.h"
+#include "utils/xmlfileUnits.h"
+
+using Log::global_log;
+using namespace std;
+
+CompressedTrajectoryWriter::CompressedTrajectoryWriter()
+	: _outputPrefix("mardyn"), _filename(""), _writeFrequency(1), _appendTimestamp(false),
+	  _precision(0.001), _writeOrientation(false), _orientationPrecision(1e-4),
+	  _writeVelocity(false), _velocityPrecision(1e-4) {
+}
+
+CompressedTrajectoryWriter::CompressedTrajectoryWriter(unsigned long writeFrequency, string outputPrefix, double precision)
+	: _outputPrefix(outputPrefix), _filename(""), _writeFrequency(writeFrequency), _appendTimestamp(false),
+	  _precision(precision), _writeOrientation(false), _orientationPrecision(1e-4),
+	  _writeVelocity(false), _velocityPrecision(1e-4) {
+	if (outputPrefix == "default") {
+		_appendTimestamp = true;
+	}
+}
+
+CompressedTrajectoryWriter::~CompressedTrajectoryWriter() {}
+
+void CompressedTrajectoryWriter::readXML(XMLfileUnits& xmlconfig) {
+	_writeFrequency = 1;
+	xmlconfig.getNodeValue("writefrequency", _writeFrequency);
+	global_log->info() << "Write frequency: " << _writeFrequency << endl;
+
+	_outputPrefix = "mardyn";
+	xmlconfig.getNodeValue("outputprefix", _outputPrefix);
+	global_log->info() << "Output prefix: " << _outputPrefix << endl;
+
+	xmlconfig.getNodeValueReduced("precision", _precision);
+	global_log->info() << "Position precision: " << _precision << endl;
+
+	int orientation = 0;
+	xmlconfig.getNodeValue("orientation", orientation);
+	_writeOrientation = (orientation != 0);
+	xmlconfig.getNodeValue("orientation@precision", _orientationPrecision);
+	global_log->info() << "Write orientation: " << _writeOrientation << " (precision " << _orientationPrecision << ")" << endl;
+
+	int velocity = 0;
+	xmlconfig.getNodeValue("velocity", velocity);
+	_writeVelocity = (velocity != 0);
+	xmlconfig.getNodeValue("velocity@precision", _velocityPrecision);
+	global_log->info() << "Write velocity: " << _writeVelocity << " (precision " << _velocityPrecision << ")" << endl;
+
+	int appendTimestamp = 0;
+	xmlconfig.getNodeValue("appendTimestamp", appendTimestamp);
+	if(appendTimestamp > 0) {
+		_appendTimestamp = true;
+	}
+	global_log->info() << "Append timestamp: " << _appendTimestamp << endl;
+
+	if (_precision <= 0.0 || _orientationPrecision <= 0.0 || _velocityPrecision <= 0.0) {
+		global_log->error() << "CompressedTrajectoryWriter: precisions have to be positive." << endl;
+		global_simulation->exit(1);
+	}
+}
+
+unsigned CompressedTrajectoryWriter::flags() const {
+	unsigned flags = 0;
+	if (_writeOrientation) {
+		flags |= ctraj::ORIENTATION;
+	}
+	if (_writeVelocity) {
+		flags |= ctraj::VELOCITY;
+	}
+	return flags;
+}
+
+void CompressedTrajectoryWriter::initOutput(ParticleContainer* particleContainer,
+		DomainDecompBase* domainDecomp, Domain* domain) {
+	stringstream filenamestream;
+	filenamestream << _outputPrefix;
+	if(_appendTimestamp) {
+		filenamestream << "-" << gettimestring();
+	}
+	filenamestream << ".ctraj";
+	_filename = filenamestream.str();
+
+	if (domainDecomp->getRank() != 0) {
+		return;
+	}
+
+	ofstream ctrajfstream(_filename.c_str(), ios::binary|ios::out|ios::trunc);
+	if (!ctrajfstream.is_open()) {
+		global_log->error() << "Could not open file " << _filename << endl;
+		global_simulation->exit(1);
+	}
+	uint32_t flag_bits = flags();
+	double box[3];
+	for (int d = 0; d < 3; d++) {
+		box[d] = domain->getGlobalLength(d);
+	}
+	uint32_t numComponents = domain->getNumberOfComponents();
+	ctrajfstream.write(ctraj::fileMagic, sizeof(ctraj::fileMagic));
+	ctrajfstream.write(reinterpret_cast<const char*>(&flag_bits), sizeof(flag_bits));
+	ctrajfstream.write(reinterpret_cast<const char*>(&_precision), sizeof(double));
+	ctrajfstream.write(reinterpret_cast<const char*>(&_orientationPrecision), sizeof(double));
+	ctrajfstream.write(reinterpret_cast<const char*>(&_velocityPrecision), sizeof(double));
+	ctrajfstream.write(reinterpret_cast<const char*>(box), 3 * sizeof(double));
+	ctrajfstream.write(reinterpret_cast<const char*>(&numComponents), sizeof(numComponents));
+	ctrajfstream.close();
+}
+
+static bool cellIndexLess(const pair<unsigned long, Molecule*>& a, const pair<unsigned long, Molecule*>& b) {
+	return a.first < b.first;
+}
+
+unsigned long CompressedTrajectoryWriter::compressBlock(ParticleContainer* particleContainer, vector<unsigned char>& block) {
+	/* order molecules along the cells of a grid with cutoff sized cells, so
+	 * consecutive positions are close to each other and their deltas small. */
+	double cellLength = particleContainer->getCutoff();
+	double bBoxMin[3];
+	unsigned long numCells[3];
+	for (int d = 0; d < 3; d++) {
+		bBoxMin[d] = particleContainer->getBoundingBoxMin(d);
+		double length = particleContainer->getBoundingBoxMax(d) - bBoxMin[d];
+		numCells[d] = (cellLength > 0.0) ? (unsigned long) ceil(length / cellLength) : 1;
+		if (numCells[d] == 0) {
+			numCells[d] = 1;
+		}
+	}
+
+	vector<pair<unsigned long, Molecule*> > ordered;
+	ordered.reserve(particleContainer->getNumberOfParticles());
+	for (Molecule* pos = particleContainer->begin(); pos != particleContainer->end(); pos = particleContainer->next()) {
+		bool halo = false;
+		unsigned long cell[3];
+		for (unsigned short d = 0; d < 3; d++) {
+			if ((pos->r(d) < particleContainer->getBoundingBoxMin(d)) || (pos->r(d) >= particleContainer->getBoundingBoxMax(d))) {
+				halo = true;
+				break;
+			}
+			cell[d] = (numCells[d] > 1) ? (unsigned long) ((pos->r(d) - bBoxMin[d]) / cellLength) : 0;
+			if (cell[d] >= numCells[d]) {
+				cell[d] = numCells[d] - 1;
+			}
+		}
+		if (!halo) {
+			unsigned long cellIndex = (cell[2] * numCells[1] + cell[1]) * numCells[0] + cell[0];
+			ordered.push_back(make_pair(cellIndex, pos));
+		}
+	}
+	stable_sort(ordered.begin(), ordered.end(), cellIndexLess);
+
+	block.clear();
+	ctraj::BitWriter bits(block);
+	ctraj::BlockCoder coder(flags(), _precision, _orientationPrecision, _velocityPrecision);
+	ctraj::Record rec;
+	for (size_t i = 0; i < ordered.size(); i++) {
+		Molecule* m = ordered[i].second;
+		rec.id = m->id();
+		rec.cid = m->componentid();
+		for (int d = 0; d < 3; d++) {
+			rec.r[d] = m->r(d);
+			rec.v[d] = m->v(d);
+		}
+		rec.q[0] = m->q().qw();
+		rec.q[1] = m->q().qx();
+		rec.q[2] = m->q().qy();
+		rec.q[3] = m->q().qz();
+		coder.encode(bits, rec);
+	}
+	bits.flush();
+	return ordered.size();
+}
+
+void CompressedTrajectoryWriter::doOutput(ParticleContainer* particleContainer,
+		DomainDecompBase* domainDecomp, Domain* domain,
+		unsigned long simstep, list<ChemicalPotential>* lmu) {
+	if (simstep % _writeFrequency != 0) {
+		return;
+	}
+
+	vector<unsigned char> block;
+	uint64_t numMolecules = compressBlock(particleContainer, block);
+
+	int rank = domainDecomp->getRank();
+#ifdef ENABLE_MPI
+	int tag = 4712;
+	if (rank != 0) {
+		/* first 8 bytes of the message hold the number of molecules */
+		vector<unsigned char> sendbuff(sizeof(uint64_t) + block.size());
+		memcpy(&sendbuff[0], &numMolecules, sizeof(uint64_t));
+		if (block.size() > 0) {
+			memcpy(&sendbuff[sizeof(uint64_t)], &block[0], block.size());
+		}
+		MPI_CHECK( MPI_Send(&sendbuff[0], sendbuff.size(), MPI_BYTE, 0, tag, MPI_COMM_WORLD) );
+		return;
+	}
+#endif
+	if (rank != 0) {
+		return;
+	}
+
+	ofstream ctrajfstream(_filename.c_str(), ios::binary|ios::out|ios::app);
+	uint64_t step = simstep;
+	double time = global_simulation->getSimulationTime();
+	uint32_t numBlocks = domainDecomp->getNumProcs();
+	ctrajfstream.write(ctraj::frameMagic, sizeof(ctraj::frameMagic));
+	ctrajfstream.write(reinterpret_cast<const char*>(&step), sizeof(step));
+	ctrajfstream.write(reinterpret_cast<const char*>(&time), sizeof(time));
+	ctrajfstream.write(reinterpret_cast<const char*>(&numBlocks), sizeof(numBlocks));
+
+	uint64_t numBytes = block.size();
+	ctrajfstream.write(reinterpret_cast<const char*>(&numMolecules), sizeof(numMolecules));
+	ctrajfstream.write(reinterpret_cast<const char*>(&numBytes), sizeof(numBytes));
+	if (numBytes > 0) {
+		ctrajfstream.write(reinterpret_cast<const char*>(&block[0]), numBytes);
+	}
+#ifdef ENABLE_MPI
+	for(int fromrank = 1; fromrank < domainDecomp->getNumProcs(); fromrank++) {
+		MPI_Status status_probe;
+		MPI_Status status_recv;
+		MPI_CHECK( MPI_Probe(fromrank, tag, MPI_COMM_WORLD, &status_probe) );
+		int numrecv;
+		MPI_CHECK( MPI_Get_count(&status_probe, MPI_BYTE, &numrecv) );
+		vector<unsigned char> recvbuff(numrecv);
+		MPI_CHECK( MPI_Recv(&recvbuff[0], numrecv, MPI_BYTE, fromrank, tag, MPI_COMM_WORLD, &status_recv) );
+		memcpy(&numMolecules, &recvbuff[0], sizeof(uint64_t));
+		numBytes = numrecv - sizeof(uint64_t);
+		ctrajfstream.write(reinterpret_cast<const char*>(&numMolecules), sizeof(numMolecules));
+		ctrajfstream.write(reinterpret_cast<const char*>(&numBytes), sizeof(numBytes));
+		if (numBytes > 0) {
+			ctrajfstream.write(reinterpret_cast<const char*>(&recvbuff[sizeof(uint64_t)]), numBytes);
+		}
+	}
+#endif
+	ctrajfstream.close();
+}
+
+void CompressedTrajectoryWriter::finishOutput(ParticleContainer* particleContainer,
+		DomainDecompBase* domainDecomp, Domain* domain) {}
@@ -0,0 +1,78 @@
+#ifndef COMPRESSEDTRAJECTORYWRITER_H_
+#define COMPRESSEDTRAJECTORYWRITER_H_
+
+#include <string>
+#include <vector>
+
+#include "ensemble/GrandCanonical.h"
+#include "io/OutputBase.h"
+
+//! @brief Writes a compressed trajectory (*.ctraj) with a user defined position precision.
+//!
+//! Positions are quantized to the given precision, sorted along the cell ordering
+//! of each process' subdomain, delta encoded and entropy coded with an adaptive
+//! Rice code (see io/CompressedTrajectoryCodec.h for the file layout).
+//! Orientations and velocities can optionally be stored as well.
+//! Each process compresses its own molecules, rank 0 collects the blocks and
+//! appends one frame to a single file.
+//!
+//! The trajectory can be converted to xyz or vis files with the tool in tools/ctraj.
+//!
+//! \code{.xml}
+//! <outputplugin name="CompressedTrajectoryWriter">
+//!   <writefrequency>INTEGER</writefrequency>
+//!   <outputprefix>STRING</outputprefix>
+//!   <precision>DOUBLE</precision>                     <!-- position precision, default 0.001 -->
+//!   <orientation precision="DOUBLE">0|1</orientation>  <!-- default 0, precision 1e-4 -->
+//!   <velocity precision="DOUBLE">0|1</velocity>        <!-- default 0, precision 1e-4 -->
+//!   <appendTimestamp>0|1</appendTimestamp>
+//! </outputplugin>
+//! \endcode
+class CompressedTrajectoryWriter : public OutputBase {
+public:
+	CompressedTrajectoryWriter();
+	//! @param writeFrequency Controls the frequency of writing out the data (every timestep, every 10th, 100th, ... timestep)
+	//! @param outputPrefix prefix of the *.ctraj file
+	//! @param precision positions are stored as integer multiples of this value
+	CompressedTrajectoryWriter(unsigned long writeFrequency, std::string outputPrefix, double precision);
+	~CompressedTrajectoryWriter();
+
+	void readXML(XMLfileUnits& xmlconfig);
+
+	void initOutput(ParticleContainer* particleContainer,
+			DomainDecompBase* domainDecomp, Domain* domain);
+
+	void doOutput(
+			ParticleContainer* particleContainer,
+			DomainDecompBase* domainDecomp, Domain* domain,
+			unsigned long simstep, std::list<ChemicalPotential>* lmu
+	);
+
+	void finishOutput(ParticleContainer* particleContainer,
+			DomainDecompBase* domainDecomp, Domain* domain);
+
+	std::string getPluginName() {
+		return std::string("CompressedTrajectoryWriter");
+	}
+
+	//! @brief compress all molecules inside the bounding box of the container into one block
+	//! @param[out] block compressed payload
+	//! @return number of molecules in the block
+	unsigned long compressBlock(ParticleContainer* particleContainer, std::vector<unsigned char>& block);
+
+	unsigned flags() const;
+
+private:
+	std::string _outputPrefix;
+	std::string _filename;
+	unsigned long _writeFrequency;
+	bool _appendTimestamp;
+
+	double _precision;
+	bool _writeOrientation;
+	double _orientationPrecision;
+	bool _writeVelocity;
+	double _velocityPrecision;
+};
+
+#endif /* COMPRESSEDTRAJECTORYWRITER_H_ */
@@ -6,7 +6,8 @@
 #include "molecules/Molecule.h"
 #include "particleContainer/ParticleContainer.h"
 #include "utils/Logger.h"
-#include "utils/Random.h"
+#include "parallel/DomainDecompBase.h"
+#include "utils/CounterRandom.h"
 #include "utils/xmlfileUnits.h"
 
 #include <string>
@@ -101,21 +102,37 @@ long unsigned int GridGenerator::readPhaseSpace(ParticleContainer* particleConta
 	molecule_t m; /* molecule type as provided by the generator */
 
 	Ensemble* ensemble = _simulation.getEnsemble();
-	Random rng;
+	/* the random numbers of each molecule only depend on its global index,
+	 * so the result does not depend on the number of processes */
+	CounterRandom rng;
+
+	/* only generate the part of the lattice inside the bounding box of this process,
+	 * the halo is filled by the first exchange */
+	double bBoxMin[3], bBoxMax[3];
+	for(int d = 0; d < 3; d++) {
+		bBoxMin[d] = particleContainer->getBoundingBoxMin(d);
+		bBoxMax[d] = particleContainer->getBoundingBoxMax(d);
+	}
+	_generator.setBoundingBox(bBoxMin, bBoxMax);
 
 	_simulation.getDomain()->disableComponentwiseThermostat();
 	while(_generator.getMolecule(&m) > 0) {
+		if(!particleContainer->isInBoundingBox(m.r)) {
+			continue;
+		}
+		unsigned long id = _generator.moleculeIndex();
 		Component* component = ensemble->component(m.cid);
 		Molecule molecule(0, component); /* Molecule type as provided by mardyn */
 		double v_abs = sqrt(/*kB=1*/ ensemble->T() / molecule.component()->m());
 		double phi, theta;
+		rng.setStream(id);
 		phi = rng.rnd();
 		theta = rng.rnd();
 		double v[3];
 		v[0] = v_abs * sin(phi);
 		v[1] = v_abs * cos(phi) * sin(theta);
 		v[2] = v_abs * cos(phi) * cos(theta);
-		molecule.setid(numMolecules);
+		molecule.setid(id);
 		for(int d = 0; d < 3; d++) {
 			molecule.setr(d, m.r[d]);
 			molecule.setv(d, v[d]);
@@ -125,7 +142,13 @@ long unsigned int GridGenerator::readPhaseSpace(ParticleContainer* particleConta
 		particleContainer->addParticle(molecule);
 		numMolecules++;
 	}
+	domainDecomp->collCommInit(1);
+	domainDecomp->collCommAppendUnsLong(numMolecules);
+	domainDecomp->collCommAllreduceSum();
+	numMolecules = domainDecomp->collCommGetUnsLong();
+	domainDecomp->collCommFinalize();
 	global_log->info() << "Number of inserted molecules: " << numMolecules << endl;
 	particleContainer->updateMoleculeCaches();
-	return numMolecules;
+	/* ids are the global lattice indices */
+	return _generator.numMolecules();
 }
@@ -7,6 +7,13 @@
 #include "utils/generator/Generator.h"
 
 
+/** @brief Lattice scenario generator.
+ *
+ * Each process only generates the molecules inside its bounding box, from the
+ * lattice cells overlapping with it. Molecule ids are the global molecule indices
+ * of the lattice and velocities are drawn from a counter-based random stream per
+ * molecule, so the generated scenario does not depend on the number of processes.
+ */
 class GridGenerator : public InputBase {
 public:
     GridGenerator() {};
@@ -0,0 +1,194 @@
+#include "io/InputBinary.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#include "Domain.h"
+#include "ensemble/EnsembleBase.h"
+#include "ensemble/GrandCanonical.h"
+#include "Simulation.h"
+#include "molecules/Molecule.h"
+#include "parallel/DomainDecompBase.h"
+#include "particleContainer/ParticleContainer.h"
+#include "utils/Logger.h"
+#include "utils/Timer.h"
+
+using Log::global_log;
+using namespace std;
+
+
+InputBinary::InputBinary() : _mappedData(NULL), _mappedSize(0), _header(NULL) {}
+
+InputBinary::~InputBinary() {
+	unmapFile();
+}
+
+void InputBinary::mapFile() {
+	if (_mappedData != NULL) {
+		return;
+	}
+	global_log->info() << "Mapping binary phase space file " << _phaseSpaceFile << endl;
+	int fd = open(_phaseSpaceFile.c_str(), O_RDONLY);
+	if (fd < 0) {
+		global_log->error() << "Could not open phaseSpaceFile " << _phaseSpaceFile << endl;
+		exit(1);
+	}
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0 || (size_t) fileStat.st_size < sizeof(bps::FileHeader)) {
+		global_log->error() << _phaseSpaceFile << " is too short for a binary phase space file." << endl;
+		exit(1);
+	}
+	_mappedSize = fileStat.st_size;
+	void* data = mmap(NULL, _mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		global_log->error() << "Could not map phaseSpaceFile " << _phaseSpaceFile << " into memory." << endl;
+		exit(1);
+	}
+	_mappedData = static_cast<const unsigned char*>(data);
+	_header = reinterpret_cast<const bps::FileHeader*>(_mappedData);
+
+	if (memcmp(_header->magic, bps::fileMagic, sizeof(_header->magic)) != 0) {
+		global_log->error() << _phaseSpaceFile << " is not a binary MarDyn phase space file." << endl;
+		exit(1);
+	}
+	if (_header->moleculeFormat > bps::IRV || _header->layout > bps::SOA
+			|| _header->dataOffset < sizeof(bps::FileHeader) + _header->headerTextLength
+			|| _header->dataOffset + bps::dataSize(*_header) > _mappedSize) {
+		global_log->error() << "Corrupt header in binary phase space file " << _phaseSpaceFile << endl;
+		exit(1);
+	}
+	/* the records are read front to back */
+	madvise(data, _mappedSize, MADV_SEQUENTIAL);
+}
+
+void InputBinary::unmapFile() {
+	if (_mappedData != NULL) {
+		munmap(const_cast<unsigned char*>(_mappedData), _mappedSize);
+		_mappedData = NULL;
+		_header = NULL;
+	}
+}
+
+void InputBinary::readPhaseSpaceHeader(Domain* domain, double timestep) {
+	mapFile();
+	global_log->info() << "Reading phase space header from binary file " << _phaseSpaceFile << endl;
+	const char* text = reinterpret_cast<const char*>(_mappedData + sizeof(bps::FileHeader));
+	istringstream headerStream(string(text, _header->headerTextLength));
+	parsePhaseSpaceHeader(headerStream, domain, timestep);
+}
+
+unsigned long InputBinary::readPhaseSpace(ParticleContainer* particleContainer, list<ChemicalPotential>* lmu, Domain* domain, DomainDecompBase* domainDecomp) {
+
+	Timer inputTimer;
+	inputTimer.start();
+
+	mapFile();
+	static const char* formatNames[] = { "ICRVQD", "ICRV", "IRV" };
+	global_log->info() << "Reading binary phase space file " << _phaseSpaceFile << endl;
+	global_log->info() << " number of molecules: " << _header->numMolecules << endl;
+	global_log->info() << " molecule format: " << formatNames[_header->moleculeFormat]
+			<< (_header->layout == bps::SOA ? " (SoA)" : " (AoS)") << endl;
+
+	vector<Component>& dcomponents = *(_simulation.getEnsemble()->components());
+	unsigned int numcomponents = dcomponents.size();
+	if (numcomponents < 1) {
+		global_log->warning() << "No components defined! Setting up single one-centered LJ" << endl;
+		numcomponents = 1;
+		dcomponents.resize( numcomponents );
+		dcomponents[0].setID(0);
+		dcomponents[0].addLJcenter(0., 0., 0., 1., 1., 1., 6., false);
+	}
+	if (_header->numComponents != 0 && _header->numComponents != numcomponents) {
+		global_log->warning() << "Binary phase space file has been written for " << _header->numComponents
+				<< " components, but " << numcomponents << " are defined." << endl;
+	}
+	for (int d = 0; d < 3; d++) {
+		if (_header->box[d] != 0.0 && fabs(_header->box[d] - domain->getGlobalLength(d)) > 1e-6 * domain->getGlobalLength(d)) {
+			global_log->warning() << "Box length " << _header->box[d] << " of the binary phase space file differs from the domain length "
+					<< domain->getGlobalLength(d) << " in dimension " << d << endl;
+		}
+	}
+	domain->setglobalNumMolecules(_header->numMolecules);
+
+	/* only the molecules of the own region (including halo) are created */
+	double haloMin[3], haloMax[3];
+	for (int d = 0; d < 3; d++) {
+		haloMin[d] = particleContainer->getBoundingBoxMin(d) - particleContainer->get_halo_L(d);
+		haloMax[d] = particleContainer->getBoundingBoxMax(d) + particleContainer->get_halo_L(d);
+	}
+	bool printWarnings = (domainDecomp->getRank() == 0);
+
+	const bps::RecordView records(_mappedData + _header->dataOffset, *_header);
+	vector<unsigned long> numMoleculesPerComponent(numcomponents, 0);
+	unsigned long maxid = 0;
+	unsigned long numLocal = 0;
+	for (uint64_t i = 0; i < _header->numMolecules; i++) {
+		unsigned long id = records.id(i);
+		unsigned int componentid = records.componentId(i);
+		if (componentid == 0 || componentid > numcomponents) {
+			global_log->error() << "Molecule id " << id << " has wrong componentid: " << componentid << ">" << numcomponents << endl;
+			exit(1);
+		}
+		componentid--; // TODO: Component IDs start with 0 in the program.
+		numMoleculesPerComponent[componentid]++;
+		if (id > maxid) maxid = id;
+
+		double r[3] = { records.value(bps::RX, i), records.value(bps::RY, i), records.value(bps::RZ, i) };
+		if (printWarnings && (   ( r[0] < 0.0 || r[0] >= domain->getGlobalLength(0) )
+		                      || ( r[1] < 0.0 || r[1] >= domain->getGlobalLength(1) )
+		                      || ( r[2] < 0.0 || r[2] >= domain->getGlobalLength(2) ) )) {
+			global_log->warning() << "Molecule " << id << " out of box: " << r[0] << ";" << r[1] << ";" << r[2] << endl;
+		}
+
+		bool local = ( r[0] >= haloMin[0] && r[0] < haloMax[0] )
+		          && ( r[1] >= haloMin[1] && r[1] < haloMax[1] )
+		          && ( r[2] >= haloMin[2] && r[2] < haloMax[2] );
+		bool sample = false;
+		std::list<ChemicalPotential>::iterator cpit;
+		for(cpit = lmu->begin(); cpit != lmu->end(); cpit++) {
+			sample = sample || ( !cpit->hasSample() && (componentid == cpit->getComponentID()) );
+		}
+		if (!local && !sample) {
+			continue;
+		}
+
+		Molecule m1 = Molecule(id, &dcomponents[componentid], r[0], r[1], r[2],
+				records.value(bps::VX, i), records.value(bps::VY, i), records.value(bps::VZ, i),
+				records.value(bps::Q0, i), records.value(bps::Q1, i), records.value(bps::Q2, i), records.value(bps::Q3, i),
+				records.value(bps::DX, i), records.value(bps::DY, i), records.value(bps::DZ, i));
+		if (local) {
+			particleContainer->addParticle(m1);
+			numLocal++;
+		}
+		for(cpit = lmu->begin(); cpit != lmu->end(); cpit++) {
+			if( !cpit->hasSample() && (componentid == cpit->getComponentID()) ) {
+				cpit->storeMolecule(m1);
+			}
+		}
+	}
+
+	// TODO: The following should be done by the addPartice method.
+	for (unsigned int c = 0; c < numcomponents; c++) {
+		dcomponents[c].setNumMolecules(dcomponents[c].getNumMolecules() + numMoleculesPerComponent[c]);
+		domain->setglobalRotDOF(numMoleculesPerComponent[c] * dcomponents[c].getRotationalDegreesOfFreedom() + domain->getglobalRotDOF());
+	}
+	global_log->info() << "Reading Molecules done, " << numLocal << " molecules in the local region" << endl;
+
+	// TODO: Shouldn't we always calculate this?
+	if( !domain->getglobalRho() ){
+		domain->setglobalRho( domain->getglobalNumMolecules() / domain->getGlobalVolume() );
+		global_log->info() << "Calculated Rho_global = " << domain->getglobalRho() << endl;
+	}
+
+	unmapFile();
+	inputTimer.stop();
+	global_log->info() << "Initial IO took:                 " << inputTimer.get_etime() << " sec" << endl;
+	return maxid;
+}
@@ -0,0 +1,44 @@
+#ifndef INPUTBINARY_H_
+#define INPUTBINARY_H_
+
+#include "io/InputOldstyle.h"
+#include "io/BinaryPhaseSpaceFormat.h"
+
+#include <string>
+
+//! @brief Reads the phase space from a binary file (*.bps, see BinaryPhaseSpaceFormat.h)
+//!
+//! The file is mapped into memory and the molecules are created directly from
+//! the mapped records, so there is no parsing of the molecule data at all.
+//! In parallel runs every process maps the file itself and only creates the
+//! molecules of its own region (including halo), so in contrast to InputOldstyle
+//! no molecule data has to be broadcast.
+//! The header of the text format is stored in the file as well and is parsed
+//! by InputOldstyle, if the header is read from the file (old style config).
+//!
+//! Binary files are created from text phase space files (e.g. checkpoints) with
+//! the converter tools/bps/bpsconv.
+class InputBinary : public InputOldstyle {
+public:
+	InputBinary();
+	~InputBinary();
+
+	//! @brief reads the text header stored in the binary file (see InputOldstyle::readPhaseSpaceHeader())
+	void readPhaseSpaceHeader(Domain* domain, double timestep);
+
+	//! @brief creates the molecules from the records of the mapped file
+	//! @return Highest molecule ID found in the input phase space file.
+	unsigned long readPhaseSpace(ParticleContainer* particleContainer, std::list<ChemicalPotential>* lmu, Domain* domain, DomainDecompBase* domainDecomp);
+
+private:
+	//! @brief map _phaseSpaceFile into memory and check its header (only once)
+	void mapFile();
+
+	void unmapFile();
+
+	const unsigned char* _mappedData;
+	size_t _mappedSize;
+	const bps::FileHeader* _header;
+};
+
+#endif /* INPUTBINARY_H_ */
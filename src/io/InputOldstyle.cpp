@@ -39,11 +39,17 @@ void InputOldstyle::setPhaseSpaceHeaderFile(string filename) {
 
 void InputOldstyle::readPhaseSpaceHeader(Domain* domain, double timestep)
 {
-	string token, token2;
-
 	global_log->info() << "Opening phase space header file " << _phaseSpaceHeaderFile << endl;
 	_phaseSpaceHeaderFileStream.open( _phaseSpaceHeaderFile.c_str() );
-	_phaseSpaceHeaderFileStream >> token;
+	parsePhaseSpaceHeader(_phaseSpaceHeaderFileStream, domain, timestep);
+	_phaseSpaceHeaderFileStream.close();
+}
+
+void InputOldstyle::parsePhaseSpaceHeader(istream& headerStream, Domain* domain, double timestep)
+{
+	string token, token2;
+
+	headerStream >> token;
 	if( token != "mardyn")
 	{
 		global_log->error() << _phaseSpaceHeaderFile << " not a valid mardyn input file." << endl;
@@ -51,7 +57,7 @@ void InputOldstyle::readPhaseSpaceHeader(Domain* domain, double timestep)
 	}
 
 	string inputversion;
-	_phaseSpaceHeaderFileStream >> token >> inputversion;
+	headerStream >> token >> inputversion;
 	// FIXME: remove tag trunk from file specification?
 	if(token != "trunk") {
 		global_log->error() << "Wrong input file specifier (\'" << token << "\' instead of \'trunk\')." << endl;
@@ -71,36 +77,36 @@ void InputOldstyle::readPhaseSpaceHeader(Domain* domain, double timestep)
 
 	while(header) {
 		char c;
-		_phaseSpaceHeaderFileStream >> c;
+		headerStream >> c;
 		if(c == '#') {
 			// comment line
-			_phaseSpaceHeaderFileStream.ignore( INT_MAX,'\n' );
+			headerStream.ignore( INT_MAX,'\n' );
 			continue;
 		}
-		_phaseSpaceHeaderFileStream.putback(c);
+		headerStream.putback(c);
 
 		token.clear();
-		_phaseSpaceHeaderFileStream >> token;
+		headerStream >> token;
 		global_log->info() << "{{" << token << "}}" << endl;
 
 		if((token == "currentTime") || (token == "t")) {
 			// set current simulation time
-			_phaseSpaceHeaderFileStream >> token;
+			headerStream >> token;
 			_simulation.setSimulationTime( strtod(token.c_str(), NULL) );
 		}
 		else if((token == "Temperature") || (token == "T")) {
 			// set global thermostat temperature
 			domain->disableComponentwiseThermostat(); //disable component wise thermostats
 			double targetT;
-			_phaseSpaceHeaderFileStream >> targetT;
+			headerStream >> targetT;
 			domain->setGlobalTemperature( targetT );
 		}
 		else if((token == "ThermostatTemperature") || (token == "ThT") || (token == "h")) {
 			// set up a new thermostat
 			int thermostat_id;
 			double targetT;
-			_phaseSpaceHeaderFileStream >> thermostat_id;
-			_phaseSpaceHeaderFileStream >> targetT;
+			headerStream >> thermostat_id;
+			headerStream >> targetT;
 			global_log->info() << "Thermostat number " << thermostat_id << " has T = " << targetT << ".\n";
 			domain->setTargetTemperature( thermostat_id, targetT );
 		}
@@ -110,7 +116,7 @@ void InputOldstyle::readPhaseSpaceHeader(Domain* domain, double timestep)
 				domain->enableComponentwiseThermostat();
 			int component_id;
 			int thermostat_id;
-			_phaseSpaceHeaderFileStream >> component_id >> thermostat_id;
+			headerStream >> component_id >> thermostat_id;
 			global_log->info() << "Component " << component_id << " (internally: " << component_id - 1 << ") is regulated by thermostat number " << thermostat_id << ".\n";
 			component_id--; // FIXME thermostat IDs start with 0 in the program but not in the config file?!
 			if( thermostat_id < 0 ) // thermostat IDs start with 0
@@ -120,13 +126,13 @@ void InputOldstyle::readPhaseSpaceHeader(Domain* domain, double timestep)
 		else if((token == "Undirected") || (token == "U")) {
 			// set undirected thermostat
 			int thermostat_id;
-			_phaseSpaceHeaderFileStream >> thermostat_id;
+			headerStream >> thermostat_id;
 			domain->enableUndirectedThermostat( thermostat_id );
 		}
 		else if((token == "Length") || (token == "L")) {
 			// simulation box dimensions
 			double globalLength[3];
-			_phaseSpaceHeaderFileStream >> globalLength[0] >> globalLength[1] >> globalLength[2];
+			headerStream >> globalLength[0] >> globalLength[1] >> globalLength[2];
 			_simulation.getEnsemble()->domain() = new BoxDomain();
 			for( int d = 0; d < 3; d++ ) {
 				static_cast<BoxDomain*>(_simulation.getEnsemble()->domain())->setLength(d, globalLength[d]);
@@ -146,7 +152,7 @@ void InputOldstyle::readPhaseSpaceHeader(Domain* domain, double timestep)
 
 			// components:
 			unsigned int numcomponents = 0;
-			_phaseSpaceHeaderFileStream >> numcomponents;
+			headerStream >> numcomponents;
 			global_log->info() << "Reading " << numcomponents << " components" << endl;
 			dcomponents.resize(numcomponents);
 			for( unsigned int i = 0; i < numcomponents; i++ ) {
@@ -157,46 +163,46 @@ void InputOldstyle::readPhaseSpaceHeader(Domain* domain, double timestep)
 				unsigned int numdipoles = 0;
 				unsigned int numquadrupoles = 0;
 				unsigned int numtersoff = 0;
-				_phaseSpaceHeaderFileStream >> numljcenters >> numcharges >> numdipoles 
+				headerStream >> numljcenters >> numcharges >> numdipoles 
 					>> numquadrupoles >> numtersoff;
 
 				double x, y, z, m;
 				for( unsigned int j = 0; j < numljcenters; j++ ) {
 					double eps, sigma, tcutoff, do_shift;
-					_phaseSpaceHeaderFileStream >> x >> y >> z >> m >> eps >> sigma >> tcutoff >> do_shift;
+					headerStream >> x >> y >> z >> m >> eps >> sigma >> tcutoff >> do_shift;
 					dcomponents[i].addLJcenter( x, y, z, m, eps, sigma, tcutoff, (do_shift != 0) );
                                         global_log->info() << "LJ at [" << x << " " << y << " " << z << "], mass: " << m << ", epsilon: " << eps << ", sigma: " << sigma << endl;
 				}
 				for( unsigned int j = 0; j < numcharges; j++ ) {
 					double q;
-					_phaseSpaceHeaderFileStream >> x >> y >> z >> m >> q;
+					headerStream >> x >> y >> z >> m >> q;
 					dcomponents[i].addCharge( x, y, z, m, q );
                                         global_log->info() << "charge at [" << x << " " << y << " " << z << "], mass: " << m << ", q: " << q << endl;
 				}
 				for( unsigned int j = 0; j < numdipoles; j++ ) {
 					double eMyx,eMyy,eMyz,absMy;
-					_phaseSpaceHeaderFileStream >> x >> y >> z >> eMyx >> eMyy >> eMyz >> absMy;
+					headerStream >> x >> y >> z >> eMyx >> eMyy >> eMyz >> absMy;
 					dcomponents[i].addDipole( x, y, z, eMyx, eMyy, eMyz, absMy );
                                         global_log->info() << "dipole at [" << x << " " << y << " " << z << "] " << endl;
 				}
 				for( unsigned int j = 0; j < numquadrupoles; j++ ) {
 					double eQx,eQy,eQz,absQ;
-					_phaseSpaceHeaderFileStream >> x >> y >> z >> eQx >> eQy >> eQz >> absQ;
+					headerStream >> x >> y >> z >> eQx >> eQy >> eQz >> absQ;
 					dcomponents[i].addQuadrupole(x,y,z,eQx,eQy,eQz,absQ);
                                         global_log->info() << "quad at [" << x << " " << y << " " << z << "] " << endl;
 				}
 				for( unsigned int j = 0; j < numtersoff; j++ ) {
 					double x, y, z, m, A, B, lambda, mu, R, S, c, d, h, n, beta;
-					_phaseSpaceHeaderFileStream >> x >> y >> z;
-					_phaseSpaceHeaderFileStream >> m >> A >> B;
-					_phaseSpaceHeaderFileStream >> lambda >> mu >> R >> S;
-					_phaseSpaceHeaderFileStream >> c >> d >> h >> n >> beta;
+					headerStream >> x >> y >> z;
+					headerStream >> m >> A >> B;
+					headerStream >> lambda >> mu >> R >> S;
+					headerStream >> c >> d >> h >> n >> beta;
 					dcomponents[i].addTersoff( x, y, z, m, A, B, lambda, mu, R, S, c, d, h, n, beta );
                                         global_log->info() << "solid at [" << x << " " << y << " " << z << "] " << endl;
 				}
 				double IDummy1,IDummy2,IDummy3;
 				// FIXME! Was soll das hier? Was ist mit der Initialisierung im Fall I <= 0.
-				_phaseSpaceHeaderFileStream >> IDummy1 >> IDummy2 >> IDummy3;
+				headerStream >> IDummy1 >> IDummy2 >> IDummy3;
 				if( IDummy1 > 0. ) dcomponents[i].setI11(IDummy1);
 				if( IDummy2 > 0. ) dcomponents[i].setI22(IDummy2);
 				if( IDummy3 > 0. ) dcomponents[i].setI33(IDummy3);
@@ -217,21 +223,21 @@ void InputOldstyle::readPhaseSpaceHeader(Domain* domain, double timestep)
 			for( unsigned int i = 1; i < numcomponents; i++ ) {
 				for( unsigned int j = i + 1; j <= numcomponents; j++ ) {
 					double xi, eta;
-					_phaseSpaceHeaderFileStream >> xi >> eta;
+					headerStream >> xi >> eta;
 					dmixcoeff.push_back( xi );
 					dmixcoeff.push_back( eta );
 				}
 			}
 			// read in global factor \epsilon_{RF}
 			// FIXME: Maybe this should go better to a seperate token?!
-			_phaseSpaceHeaderFileStream >> token;
+			headerStream >> token;
 			domain->setepsilonRF( strtod(token.c_str(),NULL) );
 			long int fpos;
 			if( _phaseSpaceFile == _phaseSpaceHeaderFile ) {
 				// in the case of a single phase space header + phase space file
 				// find out the actual position, because the phase space definition will follow
 				// FIXME: is there a more elegant way?
-				fpos = _phaseSpaceHeaderFileStream.tellg();
+				fpos = headerStream.tellg();
 				_phaseSpaceFileStream.seekg( fpos, ios::beg );
 			}
 			// FIXME: Is there a better solution than skipping the rest of the file?
@@ -240,26 +246,26 @@ void InputOldstyle::readPhaseSpaceHeader(Domain* domain, double timestep)
 		else if((token == "NumberOfMolecules") || (token == "N")) {
 			// set number of Molecules 
 			// FIXME: Is this part called in any case as the token is handled in the readPhaseSpace method?
-			_phaseSpaceHeaderFileStream >> token;
+			headerStream >> token;
 			domain->setglobalNumMolecules( strtoul(token.c_str(),NULL,0) );
 		}
 		else if((token == "AssignCoset") || (token == "S")) {
 			unsigned component_id, cosetid;
-			_phaseSpaceHeaderFileStream >> component_id >> cosetid;
+			headerStream >> component_id >> cosetid;
 			component_id--; // FIXME: Component ID starting with 0 in program ...
 			domain->getPG()->assignCoset( component_id, cosetid );
 		}
 		else if((token == "Accelerate") || (token == "A")) {
 			unsigned cosetid;
-			_phaseSpaceHeaderFileStream >> cosetid;
+			headerStream >> cosetid;
 			double v[3];
 			for(unsigned d = 0; d < 3; d++) 
-				_phaseSpaceHeaderFileStream >> v[d];
+				headerStream >> v[d];
 			double tau;
-			_phaseSpaceHeaderFileStream >> tau;
+			headerStream >> tau;
 			double ainit[3];
 			for(unsigned d = 0; d < 3; d++) 
-				_phaseSpaceHeaderFileStream >> ainit[d];
+				headerStream >> ainit[d];
 			domain->getPG()->specifyComponentSet(cosetid, v, tau, ainit, timestep);
 		}
 		else {
@@ -267,8 +273,6 @@ void InputOldstyle::readPhaseSpaceHeader(Domain* domain, double timestep)
 			header = false;
 		}
 	}
-
-	_phaseSpaceHeaderFileStream.close();
 }
 
 unsigned long InputOldstyle::readPhaseSpace(ParticleContainer* particleContainer, list<ChemicalPotential>* lmu, Domain* domain, DomainDecompBase* domainDecomp) {
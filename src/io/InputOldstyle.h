@@ -76,7 +76,10 @@ public:
 	//! @param particleContainer Here the Molecules from the input file are stored
 	//! @return Highest molecule ID found in the input phase space file.
 	unsigned long readPhaseSpace(ParticleContainer* particleContainer, std::list<ChemicalPotential>* lmu, Domain* domain, DomainDecompBase* domainDecomp);
-private:
+
+protected:
+	//! @brief parses the header elements described in readPhaseSpaceHeader() from the given stream
+	void parsePhaseSpaceHeader(std::istream& headerStream, Domain* domain, double timestep);
 
 	std::string  _phaseSpaceFile;
 	std::string  _phaseSpaceHeaderFile;
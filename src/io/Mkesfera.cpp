@@ -11,7 +11,8 @@
 #include "particleContainer/ParticleContainer.h"
 #include "Simulation.h"
 #include "utils/Logger.h"
-#include "utils/Random.h"
+#include "parallel/DomainDecompBase.h"
+#include "utils/CounterRandom.h"
 
 #define VARFRACTION 0.07
 #define BOXOVERLOAD 1.3333
@@ -59,24 +60,16 @@ long unsigned int MkesferaGenerator::readPhaseSpace(ParticleContainer* particleC
 	global_log->info() << "Temperature: " << T << endl;
 
 	double cutoff = _simulation.getcutoffRadius();
-	Random* rnd = new Random();
-	rnd->init(
+	/* counter based random numbers: the numbers of a slot only depend on its global
+	 * index, so each process can generate its part of the lattice on its own and
+	 * the result does not depend on the number of processes. */
+	CounterRandom rnd(
 		(int)(10000.0*R_o) - (int)(3162.3*cutoff)
 		+ (int)(1000.0*T) - (int)(316.23*rho_i)
 		+ (int)(100.0*R_i)
 	);
 
-   bool**** fill = new bool***[fl_units];
-	for (unsigned int i = 0; i < fl_units; i++) {
-		fill[i] = new bool**[fl_units];
-		for (unsigned int j = 0; j < fl_units; j++) {
-			fill[i][j] = new bool*[fl_units];
-			for (unsigned int k = 0; k < fl_units; k++) {
-					fill[i][j][k] = new bool[3];
-				}
-		}
-	}
-	unsigned slots = 3.0*fl_units*fl_units*fl_units;
+	unsigned long slots = 3ul*fl_units*fl_units*fl_units;
 	double boxdensity = (double)slots / (8.0*R_o*R_o*R_o);
 	global_log->debug() << "Box density: " << boxdensity << " (unit cell: " << fl_unit << ")" << endl;
 	double P_in = rho_i / boxdensity;
@@ -94,12 +87,42 @@ long unsigned int MkesferaGenerator::readPhaseSpace(ParticleContainer* particleC
 	goffset[0][1] = 0.5; goffset[1][1] = 0.0; goffset[2][1] = 0.5;
 	goffset[0][2] = 0.5; goffset[1][2] = 0.5; goffset[2][2] = 0.0;
 
-	unsigned N = 0;
-	unsigned idx[3];
-	for(idx[0]=0; idx[0] < fl_units; idx[0]++) {
-		for(idx[1]=0; idx[1] < fl_units; idx[1]++) {
-			for(idx[2]=0; idx[2] < fl_units; idx[2]++) {
-				for(int p=0; p < 3; p++) {
+	/* range of unit cells which may hold molecules inside the bounding box of this
+	 * process, the halo is filled by the first exchange. The slots of a unit cell lie
+	 * within [-VARFRACTION/2, 1/2 + VARFRACTION/2] unit lengths of its lower corner,
+	 * slots of the first unit cell may be wrapped to the upper end of the box, which
+	 * is index fl_units. The range is widened by another VARFRACTION/2 against rounding. */
+	long idxMin[3], idxMax[3];
+	for(int d = 0; d < 3; d++) {
+		double bBoxMin = particleContainer->getBoundingBoxMin(d);
+		double bBoxMax = particleContainer->getBoundingBoxMax(d);
+		idxMin[d] = (long) floor(bBoxMin / fl_unit - 0.5 - VARFRACTION);
+		idxMax[d] = (long) floor(bBoxMax / fl_unit + VARFRACTION);
+		if(idxMin[d] < 0) {
+			idxMin[d] = 0;
+		}
+		if(idxMax[d] - idxMin[d] + 1 >= (long) fl_units) {
+			idxMin[d] = 0;
+			idxMax[d] = fl_units - 1;
+		}
+	}
+
+	double v_avg = sqrt(3.0 * T);
+
+	Component* component = _simulation.getEnsemble()->component(0);
+	unsigned long N = 0;
+	long i[3];
+	unsigned long idx[3];
+	for(i[0] = idxMin[0]; i[0] <= idxMax[0]; i[0]++) {
+		for(i[1] = idxMin[1]; i[1] <= idxMax[1]; i[1]++) {
+			for(i[2] = idxMin[2]; i[2] <= idxMax[2]; i[2]++) {
+				for(int d = 0; d < 3; d++) {
+					idx[d] = ((i[d] % (long) fl_units) + fl_units) % fl_units;
+				}
+				for(unsigned p=0; p < 3; p++) {
+					unsigned long slot = ((idx[0]*fl_units + idx[1])*fl_units + idx[2])*3 + p;
+					rnd.setStream(slot);
+
 					double qq = 0.0;
 					double q[3];
 					for(int d = 0; d < 3; d++) {
@@ -108,15 +131,40 @@ long unsigned int MkesferaGenerator::readPhaseSpace(ParticleContainer* particleC
 						qq += q[d]*q[d];
 					}
 					double tP = (qq > R_i*R_i)? P_out: P_in;
-					bool tfill = (tP >= rnd->rnd());
-					fill[idx[0]][idx[1]][idx[2]][p] = tfill;
-					if(tfill) {
-						N++;
+					if(tP < rnd.rnd()) {
+						continue;
+					}
+
+					for(int d=0; d < 3; d++)
+					{
+						q[d] = (idx[d] + VARFRACTION*(rnd.rnd() - 0.5) + goffset[d][p])*fl_unit;
+						if(q[d] < 0.0) q[d] += 2.0*R_o;
+						else if(q[d] > 2.0*R_o) q[d] -= 2.0*R_o;
 					}
+					if(!particleContainer->isInBoundingBox(q)) {
+						continue;
+					}
+					double phi = 2*M_PI * rnd.rnd();
+					double omega = 2*M_PI * rnd.rnd();
+
+					double v[3];
+					v[0] = v_avg*cos(phi)*cos(omega);
+					v[1] = v_avg*cos(phi)*sin(omega);
+					v[2] = v_avg*sin(phi);
+					/* the global slot index is used as id */
+					Molecule molecule(slot + 1, component, q[0], q[1], q[2], v[0], v[1], v[2], 1, 0, 0, 0, 0, 0, 0);
+					particleContainer->addParticle(molecule);
+					N++;
 				}
 			}
 		}
 	}
+
+	domainDecomp->collCommInit(1);
+	domainDecomp->collCommAppendUnsLong(N);
+	domainDecomp->collCommAllreduceSum();
+	N = domainDecomp->collCommGetUnsLong();
+	domainDecomp->collCommFinalize();
 	global_log->debug() << "Filling " << N << " out of " << slots << " slots" << endl;
 	global_log->debug() << "Density: " << N / (8.0*R_o*R_o*R_o) << endl;
 
@@ -127,50 +175,7 @@ long unsigned int MkesferaGenerator::readPhaseSpace(ParticleContainer* particleC
 	domain->setglobalNumMolecules(N);
 	domain->setglobalRho(N / _simulation.getEnsemble()->V() );
 
-	double v_avg = sqrt(3.0 * T);
-
-	Component* component = _simulation.getEnsemble()->component(0);
-	unsigned ID = 1;
-	for(idx[0]=0; idx[0] < fl_units; idx[0]++) {
-		for(idx[1]=0; idx[1] < fl_units; idx[1]++) {
-			for(idx[2]=0; idx[2] < fl_units; idx[2]++) {
-				for(unsigned p=0; p < 3; p++) {
-					if(fill[idx[0]][idx[1]][idx[2]][p]) {
-						//global_log->debug() << "Inserting: " << idx[0] << "," << idx[1] << "," << idx[2] << "; " << p << endl;
-						double q[3];
-						for(int d=0; d < 3; d++)
-						{
-							q[d] = (idx[d] + VARFRACTION*(rnd->rnd() - 0.5) + goffset[d][p])*fl_unit;
-							if(q[d] < 0.0) q[d] += 2.0*R_o;
-							else if(q[d] > 2.0*R_o) q[d] -= 2.0*R_o;
-						}
-						double phi = 2*M_PI * rnd->rnd();
-						double omega = 2*M_PI * rnd->rnd();
-
-						double v[3];
-						v[0] = v_avg*cos(phi)*cos(omega);
-						v[1] = v_avg*cos(phi)*sin(omega);
-						v[2] = v_avg*sin(phi);
-						Molecule molecule(ID, component, q[0], q[1], q[2], v[0], v[1], v[2], 1, 0, 0, 0, 0, 0, 0);
-						particleContainer->addParticle(molecule);
-						ID++;
-					}
-				}
-			}
-		}
-	}
-
-	for (unsigned int i = 0; i < fl_units; i++) {
-		for (unsigned int j = 0; j < fl_units; j++) {
-			for (unsigned int k = 0; k < fl_units; k++) {
-				delete[] fill[i][j][k];
-			}
-			delete[] fill[i][j];
-		}
-		delete[] fill[i];
-	}
-	delete[] fill;
-	global_log->info() << "Inserted number of molecules: " << ID << endl;
-	return ID;
+	global_log->info() << "Inserted number of molecules: " << N << endl;
+	/* ids are slot indices, so the highest possible id is the number of slots */
+	return slots;
 }
-
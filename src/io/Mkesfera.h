@@ -9,6 +9,11 @@
  * The density of the droplet and its surrounding can be chosen seperately.
  * The droplet and its surrounding consist both out of molecules from the component
  * with ID=1 in the xml input file.
+ *
+ * Each process only generates the molecules inside its bounding box. The random
+ * numbers of each slot are drawn from a counter-based stream indexed by the slot,
+ * and the slot index is used as molecule id, so the generated scenario does not
+ * depend on the number of processes.
  */
 class MkesferaGenerator : public InputBase {
 
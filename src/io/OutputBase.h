@@ -73,6 +73,24 @@ public:
 			std::list<ChemicalPotential>* lmu
 	) = 0;
 
+	//! @brief whether doOutput uses the potential energy or the pressure in this time step
+	//!
+	//! The potential energy and the virial are only calculated in time steps where they
+	//! are needed (see Simulation::macroscopicValuesRequired). Plugins which use them
+	//! have to request them here, the default is to not use them.
+	virtual bool requiresMacroscopicValues(unsigned long simstep) {
+		return false;
+	}
+
+	//! @brief whether doOutput reads the velocities or angular momenta of the molecules in this time step
+	//!
+	//! In time steps where no plugin reads them, the velocity scaling of the thermostat may be
+	//! deferred to the next time step (see Integrator::deferVelocityScaling). To be on the safe
+	//! side, the default is to read them.
+	virtual bool requiresVelocities(unsigned long simstep) {
+		return true;
+	}
+
 	//! @brief will be called at the end of the simulation
 	//!
 	//! Some OutputPlugins will need to do some things at the end of the simulation,
@@ -44,6 +44,25 @@ void RDF::init() {
 	this->_localSiteDistribution = new unsigned long****[_numberOfComponents];
 	this->_globalSiteDistribution = new unsigned long****[_numberOfComponents];
 	this->_globalAccumulatedSiteDistribution = new unsigned long****[_numberOfComponents];
+
+	// all histograms are stored in one contiguous array each, so that they
+	// can be reduced with a single communication
+	size_t numValues = 0;
+	for(unsigned i = 0; i < _numberOfComponents; i++) {
+		unsigned ni = (*_components)[i].numSites();
+		for(unsigned k=0; i+k < _numberOfComponents; k++) {
+			unsigned nj = (*_components)[i+k].numSites();
+			numValues += _bins;
+			if(ni+nj > 2) {
+				numValues += (size_t) ni * nj * _bins;
+			}
+		}
+	}
+	_localData.assign(numValues, 0);
+	_globalData.assign(numValues, 0);
+	_globalAccumulatedData.assign(numValues, 0);
+
+	size_t offset = 0;
 	for(unsigned i = 0; i < _numberOfComponents; i++) {
 		this->_globalCtr[i] = 0;
 		this->_globalAccumulatedCtr[i] = 0;
@@ -58,15 +77,10 @@ void RDF::init() {
 		this->_globalAccumulatedSiteDistribution[i] = new unsigned long***[_numberOfComponents-i];
 
 		for(unsigned k=0; i+k < _numberOfComponents; k++) {
-			this->_localDistribution[i][k] = new unsigned long[_bins];
-			this->_globalDistribution[i][k] = new unsigned long[_bins];
-			this->_globalAccumulatedDistribution[i][k] = new unsigned long[_bins];
-
-			for(unsigned l=0; l < _bins; l++) {
-				this->_localDistribution[i][k][l] = 0;
-				this->_globalDistribution[i][k][l] = 0;
-				this->_globalAccumulatedDistribution[i][k][l] = 0;
-			}
+			this->_localDistribution[i][k] = &_localData[offset];
+			this->_globalDistribution[i][k] = &_globalData[offset];
+			this->_globalAccumulatedDistribution[i][k] = &_globalAccumulatedData[offset];
+			offset += _bins;
 
 			unsigned nj = (*_components)[i+k].numSites();
 			if(ni+nj > 2) {
@@ -81,15 +95,10 @@ void RDF::init() {
 					this->_globalSiteDistribution[i][k][m] = new unsigned long*[nj];
 					this->_globalAccumulatedSiteDistribution[i][k][m] = new unsigned long*[nj];
 					for(unsigned n=0; n < nj; n++) {
-						this->_localSiteDistribution[i][k][m][n] = new unsigned long[_bins];
-						this->_globalSiteDistribution[i][k][m][n] = new unsigned long[_bins];
-						this->_globalAccumulatedSiteDistribution[i][k][m][n] = new unsigned long[_bins];
-						for(unsigned l=0; l < _bins; l++) {
-							this->_localSiteDistribution[i][k][m][n][l] = 0;
-							this->_globalSiteDistribution[i][k][m][n][l] = 0;
-							this->_globalAccumulatedSiteDistribution[i][k][m][n][l] = 0;
-							// cout << "init " << i << "\t" << k << "\t" << m << "\t" << n << "\t" << l << "\n";
-						}
+						this->_localSiteDistribution[i][k][m][n] = &_localData[offset];
+						this->_globalSiteDistribution[i][k][m][n] = &_globalData[offset];
+						this->_globalAccumulatedSiteDistribution[i][k][m][n] = &_globalAccumulatedData[offset];
+						offset += _bins;
 					}
 				}
 			}
@@ -127,11 +136,6 @@ void RDF::finishOutput(ParticleContainer* particleContainer, DomainDecompBase* d
 
 RDF::~RDF() {
 	for(unsigned i = 0; i < _numberOfComponents; i++) {
-		for(unsigned k=0; i+k < _numberOfComponents; k++) {
-			delete[] _localDistribution[i][k];
-			delete[] _globalDistribution[i][k];
-			delete[] _globalAccumulatedDistribution[i][k];
-		}
 		delete[] _localDistribution[i];
 		delete[] _globalDistribution[i];
 		delete[] _globalAccumulatedDistribution[i];
@@ -175,56 +179,8 @@ void RDF::accumulateRDF() {
 }
 
 void RDF::collectRDF(DomainDecompBase* dode) {
-	// Communicate component-component RDFs
-	dode->collCommInit(_bins * _numberOfComponents * (_numberOfComponents+1)/2);
-
-	for(unsigned i=0; i < _numberOfComponents; i++) {
-		for(unsigned k=0; i+k < _numberOfComponents; k++) {
-			for(unsigned l=0; l < _bins; l++) {
-				dode->collCommAppendUnsLong(_localDistribution[i][k][l]);
-			}
-		}
-	}
-
-	dode->collCommAllreduceSum();
-	for(unsigned i=0; i < _numberOfComponents; i++) {
-		for(unsigned k=0; i+k < _numberOfComponents; k++) {
-			for(unsigned l=0; l < _bins; l++) {
-				_globalDistribution[i][k][l] = dode->collCommGetUnsLong();
-			}
-		}
-	}
-	dode->collCommFinalize();
-
-	// communicate site-site RDFs
-	for(unsigned i=0; i < _numberOfComponents; i++) {
-		unsigned ni = (*_components)[i].numSites();
-		for(unsigned k=0; i+k < _numberOfComponents; k++) {
-			unsigned nj = (*_components)[i+k].numSites();
-			if(ni+nj > 2) {
-				dode->collCommInit(_bins * ni * nj);
-				for(unsigned l=0; l < _bins; l++) {
-					for(unsigned m=0; m < ni; m++) {
-						for(unsigned n=0; n < nj; n++) {
-							dode->collCommAppendUnsLong(_localSiteDistribution[i][k][m][n][l]);
-						}
-					}
-				}
-
-				dode->collCommAllreduceSum();
-
-				for(unsigned l=0; l < _bins; l++) {
-					for(unsigned m=0; m < ni; m++) {
-						for(unsigned n=0; n < nj; n++) {
-							_globalSiteDistribution[i][k][m][n][l] = dode->collCommGetUnsLong();
-						}
-					}
-				}
-				dode->collCommFinalize();
-
-			}
-		}
-	}
+	// component-component and site-site RDFs are reduced together
+	dode->reduceArraySum(&_localData[0], &_globalData[0], _localData.size());
 }
 
 
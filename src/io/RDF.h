@@ -73,6 +73,11 @@ public:
 		_numberOfRDFTimesteps++;
 	}
 
+	//! true if molecule pairs are counted at the moment (see tickRDF())
+	bool isSampling() const {
+		return _numberOfRDFTimesteps > 0;
+	}
+
 	//! count the number of molecules per component
 	//! @todo: remove it and replace it by component.getNumMolecules()
 	void accumulateNumberOfMolecules(std::vector<Component>& components) const;
@@ -139,7 +144,7 @@ private:
 	void init();
 
 	//! Performs a reduction of the local rdf data of all nodes
-	//! to update the "global" fields
+	//! to update the "global" fields (on the root process only)
 	void collectRDF(DomainDecompBase* domainDecomp);
 
 	//! Update the "accumulatedXXX"-fields from the "global"-variables.
@@ -203,6 +208,12 @@ private:
 
 	unsigned long *****_globalAccumulatedSiteDistribution;
 
+	//! contiguous storage of all local, global and globally accumulated histograms,
+	//! the distribution arrays above point into these
+	std::vector<unsigned long> _localData;
+	std::vector<unsigned long> _globalData;
+	std::vector<unsigned long> _globalAccumulatedData;
+
 	/**
 	 * aggregation interval for the RDF data
 	 */
@@ -51,6 +51,16 @@ public:
 
 	void finishOutput(ParticleContainer* particleContainer,
 			DomainDecompBase* domainDecomp, Domain* domain);
+
+	/** The averages are accumulated in every time step. */
+	bool requiresMacroscopicValues(unsigned long simstep) {
+		return true;
+	}
+
+	/** Only global values of the domain are written. */
+	bool requiresVelocities(unsigned long simstep) {
+		return false;
+	}
 	
 	std::string getPluginName() {
 		return std::string("ResultWriter");
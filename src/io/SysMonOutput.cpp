@@ -1,5 +1,6 @@
 #include "io/SysMonOutput.h"
 
+#include <cstdlib>
 #include <sstream>
 
 #include "utils/Logger.h"
@@ -18,7 +19,7 @@ void SysMonOutput::readXML(XMLfileUnits& xmlconfig) {
 	global_log->info() << "Write frequency: " << _writeFrequency << endl;
 	SysMon* sysmon = SysMon::getSysMon();
 	XMLfile::Query query = xmlconfig.query("expression");
-	//string oldpath = xmlconfig.getcurrentnodepath();
+	string oldpath = xmlconfig.getcurrentnodepath();
 	for(XMLfile::Query::const_iterator exprIter = query.begin(); exprIter; exprIter++ )
 	{
 		xmlconfig.changecurrentnode(exprIter);
@@ -31,7 +32,22 @@ void SysMonOutput::readXML(XMLfileUnits& xmlconfig) {
 			sysmon->addExpression(expr,label);
 		}
 	}
-	//xmlconfig.changecurrentnode(oldpath);
+	xmlconfig.changecurrentnode(oldpath);
+	
+	// processor specific hardware events, e.g. <perfevent label="fp256d" flops="4">0x10c7</perfevent>
+	query = xmlconfig.query("perfevent");
+	for(XMLfile::Query::const_iterator eventIter = query.begin(); eventIter; eventIter++ )
+	{
+		xmlconfig.changecurrentnode(eventIter);
+		string code(xmlconfig.getNodeValue_string("."));
+		string label(xmlconfig.getNodeValue_string(string("@label")));
+		double flops=0.;
+		xmlconfig.getNodeValue("@flops", flops);
+		if(label.empty()) label="raw"+code;
+		sysmon->addPerfEvent(label,strtoull(code.c_str(),NULL,0),flops);
+		global_log->info() << "Hardware event " << label << ": " << code << " (" << flops << " FLOP per event)" << endl;
+	}
+	xmlconfig.changecurrentnode(oldpath);
 	
 	//sysmon->updateExpressionValues();
 	//global_log->info() << sysmon->InfoString("System Monitor\n","\t");
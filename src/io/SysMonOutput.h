@@ -9,6 +9,22 @@ public:
 	SysMonOutput();
 	~SysMonOutput(){}
 
+	/** @brief Read in XML configuration for SysMonOutput.
+	 *
+	 * The following xml object structure is handled by this method:
+	 * \code{.xml}
+	   <outputplugin name="SysMonOutput">
+	     <writefrequency>INTEGER</writefrequency>
+	     <expression label="STRING">EXPRESSION</expression>
+	     <perfevent label="STRING" flops="DOUBLE">RAW EVENT CODE</perfevent>
+	   </outputplugin>
+	   \endcode
+	 * Expressions may use the hardware performance counters perfevent:cycles,
+	 * perfevent:instructions, perfevent:cachemisses, perfevent:branchmisses,
+	 * perfevent:taskclock and perfevent:LABEL for each perfevent element, as well
+	 * as perfevent:flops, the sum of all perfevents weighted with their flops
+	 * attribute. If counters are used, they are recorded for the timing regions too.
+	 */
 	void readXML(XMLfileUnits& xmlconfig);
 
 	//! @todo comment
@@ -0,0 +1,56 @@
+#include "io/TimerWriter.h"
+
+#include "parallel/DomainDecompBase.h"
+#include "Simulation.h"
+#include "utils/Logger.h"
+#include "utils/TimerRegistry.h"
+#include "utils/xmlfileUnits.h"
+
+using Log::global_log;
+using namespace std;
+
+
+TimerWriter::TimerWriter(unsigned long writeFrequency, string outputPrefix)
+: _writeFrequency(writeFrequency),
+	_outputPrefix(outputPrefix)
+{
+}
+
+void TimerWriter::readXML(XMLfileUnits& xmlconfig) {
+	_writeFrequency = 1;
+	xmlconfig.getNodeValue("writefrequency", _writeFrequency);
+	global_log->info() << "Write frequency: " << _writeFrequency << endl;
+
+	_outputPrefix = "mardyn";
+	xmlconfig.getNodeValue("outputprefix", _outputPrefix);
+	global_log->info() << "Output prefix: " << _outputPrefix << endl;
+}
+
+void TimerWriter::initOutput(ParticleContainer* particleContainer,
+		DomainDecompBase* domainDecomp, Domain* domain) {
+	if (domainDecomp->getRank() == 0) {
+		string timerfile(_outputPrefix + ".timers");
+		_timerStream.open(timerfile.c_str());
+		_timerStream << "#step\tregion\tcalls\tmin\tavg\tmax\timbalance\tIPC\tGFLOP/s" << endl;
+	}
+}
+
+void TimerWriter::doOutput(ParticleContainer* particleContainer, DomainDecompBase* domainDecomp, Domain* domain,
+		unsigned long simstep, list<ChemicalPotential>* lmu) {
+	if (simstep % _writeFrequency != 0) {
+		return;
+	}
+	TimerRegistry& timers = _simulation.timers();
+	timers.collectStatistics(domainDecomp);
+	if (domainDecomp->getRank() == 0) {
+		timers.writeStatistics(_timerStream, simstep);
+		_timerStream.flush();
+	}
+}
+
+void TimerWriter::finishOutput(ParticleContainer* particleContainer,
+		DomainDecompBase* domainDecomp, Domain* domain) {
+	if (domainDecomp->getRank() == 0) {
+		_timerStream.close();
+	}
+}
@@ -0,0 +1,65 @@
+#ifndef TIMERWRITER_H_
+#define TIMERWRITER_H_
+
+#include <fstream>
+#include <string>
+
+#include "io/OutputBase.h"
+
+
+/** @brief Writes the timing statistics of all regions of the simulation's
+ * TimerRegistry to a file with the file extension '.timers'.
+ *
+ * Every writeFrequency time steps one line per region is appended, containing
+ * - simulation time step
+ * - path of the region
+ * - average number of calls per process
+ * - minimum, average and maximum time over all processes (accumulated since the start)
+ * - imbalance (maximum / average)
+ * - instructions per cycle and GFLOP/s of all processes, if hardware
+ *   performance counters are used (see SysMon), 0 otherwise
+ *
+ * Collecting the statistics is a collective operation, so a moderate
+ * frequency should be chosen for large runs.
+ */
+class TimerWriter : public OutputBase {
+public:
+	TimerWriter() : _writeFrequency(1) {}
+	TimerWriter(unsigned long writeFrequency, std::string outputPrefix);
+	~TimerWriter() {}
+
+	/** @brief Read in XML configuration for TimerWriter.
+	 *
+	 * The following xml object structure is handled by this method:
+	 * \code{.xml}
+	   <outputplugin name="TimerWriter">
+	     <writefrequency>INTEGER</writefrequency>
+	     <outputprefix>STRING</outputprefix>
+	   </outputplugin>
+	   \endcode
+	 */
+	void readXML(XMLfileUnits& xmlconfig);
+
+	void initOutput(ParticleContainer* particleContainer,
+			DomainDecompBase* domainDecomp, Domain* domain);
+
+	void doOutput(
+			ParticleContainer* particleContainer,
+			DomainDecompBase* domainDecomp, Domain* domain,
+			unsigned long simstep, std::list<ChemicalPotential>* lmu
+	);
+
+	void finishOutput(ParticleContainer* particleContainer,
+			DomainDecompBase* domainDecomp, Domain* domain);
+
+	std::string getPluginName() {
+		return std::string("TimerWriter");
+	}
+
+private:
+	std::ofstream _timerStream;
+	unsigned long _writeFrequency;
+	std::string _outputPrefix;
+};
+
+#endif /* TIMERWRITER_H_ */
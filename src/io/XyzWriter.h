@@ -38,6 +38,11 @@ public:
 	void finishOutput(ParticleContainer* particleContainer,
 			DomainDecompBase* domainDecomp, Domain* domain);
 	
+	//! only the positions are written
+	bool requiresVelocities(unsigned long simstep) {
+		return false;
+	}
+
 	std::string getPluginName() {
 		return std::string("XyzWriter");
 	}
@@ -2,13 +2,16 @@
 #define IO_H_
 
 #include "io/CheckpointWriter.h"
+#include "io/CompressedTrajectoryWriter.h"
 #include "io/DecompWriter.h"
 #include "io/GridGenerator.h"
+#include "io/InputBinary.h"
 #include "io/InputOldstyle.h"
 #include "io/MmspdWriter.h"
 #include "io/PovWriter.h"
 #include "io/ResultWriter.h"
 #include "io/SysMonOutput.h"
+#include "io/TimerWriter.h"
 #include "io/VISWriter.h"
 #ifdef VTK
 #include "io/vtk/VTKMoleculeWriter.h"
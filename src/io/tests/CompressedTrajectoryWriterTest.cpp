@@ -0,0 +1,87 @@
+/*
+ * CompressedTrajectoryWriterTest.cpp
+ */
+
+#include "io/tests/CompressedTrajectoryWriterTest.h"
+
+#include "io/CompressedTrajectoryCodec.h"
+#include "io/CompressedTrajectoryWriter.h"
+#include "molecules/Molecule.h"
+#include "parallel/DomainDecompDummy.h"
+#include "particleContainer/ParticleContainer.h"
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+using namespace std;
+
+TEST_SUITE_REGISTRATION(CompressedTrajectoryWriterTest);
+
+CompressedTrajectoryWriterTest::CompressedTrajectoryWriterTest() {
+}
+
+CompressedTrajectoryWriterTest::~CompressedTrajectoryWriterTest() {
+}
+
+void CompressedTrajectoryWriterTest::testRiceCoderRoundTrip() {
+	vector<uint64_t> values;
+	for (uint64_t i = 0; i < 200; i++) {
+		values.push_back(i % 7);
+	}
+	values.push_back(1ul << 40);
+	values.push_back(~static_cast<uint64_t>(0));
+	values.push_back(3);
+	for (int64_t i = -50; i < 50; i++) {
+		values.push_back(ctraj::zigzag(i * 1000));
+	}
+
+	vector<unsigned char> buffer;
+	ctraj::BitWriter out(buffer);
+	ctraj::AdaptiveRiceModel encoder;
+	for (size_t i = 0; i < values.size(); i++) {
+		encoder.encode(out, values[i]);
+	}
+	out.flush();
+
+	ctraj::BitReader in(&buffer[0], buffer.size());
+	ctraj::AdaptiveRiceModel decoder;
+	for (size_t i = 0; i < values.size(); i++) {
+		ASSERT_TRUE(values[i] == decoder.decode(in));
+	}
+	ASSERT_EQUAL((int64_t) -12345, ctraj::unzigzag(ctraj::zigzag(-12345)));
+}
+
+void CompressedTrajectoryWriterTest::testBlockRoundTrip() {
+	// original pointer will be freed by the tearDown()-method.
+	_domainDecomposition = new DomainDecompDummy();
+	ParticleContainer* container = initializeFromFile(ParticleContainerFactory::LinkedCell, "1clj-regular-12x12x12.inp", 1.0);
+
+	map<unsigned long, Molecule*> molecules;
+	for (Molecule* m = container->begin(); m != container->end(); m = container->next()) {
+		molecules[m->id()] = m;
+	}
+
+	const double precision = 0.001;
+	CompressedTrajectoryWriter writer(1, "test", precision);
+	vector<unsigned char> block;
+	unsigned long numMolecules = writer.compressBlock(container, block);
+	ASSERT_EQUAL(molecules.size(), (size_t) numMolecules);
+	ASSERT_TRUE(block.size() < numMolecules * 3 * sizeof(double));
+
+	ctraj::BitReader in(&block[0], block.size());
+	ctraj::BlockCoder coder(writer.flags(), precision, 1e-4, 1e-4);
+	ctraj::Record rec;
+	for (unsigned long i = 0; i < numMolecules; i++) {
+		coder.decode(in, rec);
+		ASSERT_TRUE(molecules.count(rec.id) == 1);
+		Molecule* m = molecules[rec.id];
+		ASSERT_EQUAL(m->componentid(), rec.cid);
+		for (int d = 0; d < 3; d++) {
+			ASSERT_DOUBLES_EQUAL(m->r(d), rec.r[d], 0.5 * precision + 1e-12);
+		}
+	}
+
+	delete container;
+	delete _domainDecomposition;
+}
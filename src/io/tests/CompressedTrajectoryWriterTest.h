@@ -0,0 +1,37 @@
+/*
+ * CompressedTrajectoryWriterTest.h
+ */
+
+#ifndef COMPRESSEDTRAJECTORYWRITERTEST_H_
+#define COMPRESSEDTRAJECTORYWRITERTEST_H_
+
+#include "utils/TestWithSimulationSetup.h"
+
+class CompressedTrajectoryWriterTest : public utils::TestWithSimulationSetup {
+
+	TEST_SUITE(CompressedTrajectoryWriterTest);
+	TEST_METHOD(testRiceCoderRoundTrip);
+	TEST_METHOD(testBlockRoundTrip);
+	TEST_SUITE_END();
+
+public:
+
+	CompressedTrajectoryWriterTest();
+
+	virtual ~CompressedTrajectoryWriterTest();
+
+	/**
+	 * Encode a sequence of small and huge values (forcing the escape code)
+	 * and check that they are decoded identically.
+	 */
+	void testRiceCoderRoundTrip();
+
+	/**
+	 * Compress the molecules of a 12x12x12 lattice into one block, decode it
+	 * and compare ids, components and positions within the requested precision.
+	 * Also checks that the block is smaller than the raw double coordinates.
+	 */
+	void testBlockRoundTrip();
+};
+
+#endif /* COMPRESSEDTRAJECTORYWRITERTEST_H_ */
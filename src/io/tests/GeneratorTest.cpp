@@ -0,0 +1,114 @@
+/*
+ * GeneratorTest.cpp
+ */
+
+#include "io/tests/GeneratorTest.h"
+
+#include "Domain.h"
+#include "Simulation.h"
+#include "ensemble/GrandCanonical.h"
+#include "io/GridGenerator.h"
+#include "io/Mkesfera.h"
+#include "molecules/Molecule.h"
+#include "particleContainer/LinkedCells.h"
+#include "utils/xmlfileUnits.h"
+
+#include <list>
+#include <map>
+#include <vector>
+
+using namespace std;
+
+TEST_SUITE_REGISTRATION(GeneratorTest);
+
+GeneratorTest::GeneratorTest() {
+}
+
+GeneratorTest::~GeneratorTest() {
+}
+
+void GeneratorTest::testMkesferaDecomposition() {
+	MkesferaGenerator generator;
+	compareDecomposed("GeneratorTest-mkesfera.xml", &generator);
+}
+
+void GeneratorTest::testGridGeneratorDecomposition() {
+	GridGenerator generator;
+	compareDecomposed("GeneratorTest-grid.xml", &generator);
+}
+
+namespace {
+
+/** collect the molecules of a container by id, all of them have to be inside the bounding box */
+void collectMolecules(ParticleContainer* container, map<unsigned long, vector<double> >& molecules) {
+	for (Molecule* m = container->begin(); m != container->end(); m = container->next()) {
+		double r[3] = { m->r(0), m->r(1), m->r(2) };
+		ASSERT_TRUE_MSG("molecule outside of the bounding box", container->isInBoundingBox(r));
+		ASSERT_TRUE_MSG("molecule generated twice", molecules.count(m->id()) == 0);
+		vector<double>& state = molecules[m->id()];
+		for (int d = 0; d < 3; d++) {
+			state.push_back(m->r(d));
+		}
+		for (int d = 0; d < 3; d++) {
+			state.push_back(m->v(d));
+		}
+	}
+}
+
+}
+
+void GeneratorTest::compareDecomposed(const string& fileName, InputBase* generator) {
+	// the generators take the components, temperature and box size from the simulation
+	global_simulation->initConfigXML(getTestDataFilename(fileName));
+	XMLfileUnits inp(getTestDataFilename(fileName));
+	inp.changecurrentnode("/mardyn/simulation/ensemble/phasespacepoint/generator");
+	generator->readXML(inp);
+
+	Domain* domain = global_simulation->getDomain();
+	const double cutoff = global_simulation->getcutoffRadius();
+	list<ChemicalPotential> lmu;
+
+	double boxMin[3] = { 0.0, 0.0, 0.0 };
+	double boxMax[3];
+	for (int d = 0; d < 3; d++) {
+		boxMax[d] = domain->getGlobalLength(d);
+	}
+	LinkedCells whole(boxMin, boxMax, cutoff, cutoff, 1.0);
+	generator->readPhaseSpace(&whole, &lmu, domain, _domainDecomposition);
+	map<unsigned long, vector<double> > expected;
+	collectMolecules(&whole, expected);
+	ASSERT_TRUE(expected.size() > 1000);
+
+	// split points of the decomposition, not aligned with the lattices. The first split
+	// in x lies just below a unit cell of mkesfera (20/14 long), so some of its molecules
+	// are moved into the lower box by their random displacement.
+	const double splits[3][4] = {
+		{ 0.0, 0.356, 0.7, 1.0 },
+		{ 0.0, 0.47, 1.0, 1.0 },
+		{ 0.0, 0.71, 1.0, 1.0 }
+	};
+	const int numBoxes[3] = { 3, 2, 2 };
+	map<unsigned long, vector<double> > decomposed;
+	int i[3];
+	for (i[0] = 0; i[0] < numBoxes[0]; i[0]++) {
+		for (i[1] = 0; i[1] < numBoxes[1]; i[1]++) {
+			for (i[2] = 0; i[2] < numBoxes[2]; i[2]++) {
+				double bBoxMin[3], bBoxMax[3];
+				for (int d = 0; d < 3; d++) {
+					bBoxMin[d] = splits[d][i[d]] * boxMax[d];
+					bBoxMax[d] = splits[d][i[d] + 1] * boxMax[d];
+				}
+				LinkedCells box(bBoxMin, bBoxMax, cutoff, cutoff, 1.0);
+				generator->readPhaseSpace(&box, &lmu, domain, _domainDecomposition);
+				collectMolecules(&box, decomposed);
+			}
+		}
+	}
+
+	ASSERT_EQUAL(expected.size(), decomposed.size());
+	map<unsigned long, vector<double> >::const_iterator it;
+	for (it = expected.begin(); it != expected.end(); it++) {
+		ASSERT_TRUE_MSG("molecule missing in the decomposition", decomposed.count(it->first) == 1);
+		ASSERT_TRUE_MSG("molecule differs in the decomposition", decomposed[it->first] == it->second);
+	}
+}
@@ -0,0 +1,43 @@
+/*
+ * GeneratorTest.h
+ */
+
+#ifndef GENERATORTEST_H_
+#define GENERATORTEST_H_
+
+#include "utils/TestWithSimulationSetup.h"
+
+#include <string>
+
+class InputBase;
+
+class GeneratorTest : public utils::TestWithSimulationSetup {
+
+	TEST_SUITE(GeneratorTest);
+	TEST_METHOD(testMkesferaDecomposition);
+	TEST_METHOD(testGridGeneratorDecomposition);
+	TEST_SUITE_END();
+
+public:
+
+	GeneratorTest();
+
+	virtual ~GeneratorTest();
+
+	void testMkesferaDecomposition();
+
+	void testGridGeneratorDecomposition();
+
+private:
+
+	/**
+	 * Generates the scenario of the given xml file once for the whole domain and
+	 * once for each box of an uneven 3x2x2 decomposition of the domain, as the
+	 * processes of a parallel run would do. Each box may only get the molecules
+	 * inside of it, and together the boxes have to give exactly the molecules
+	 * (ids, positions and velocities) of the whole domain.
+	 */
+	void compareDecomposed(const std::string& fileName, InputBase* generator);
+};
+
+#endif /* GENERATORTEST_H_ */
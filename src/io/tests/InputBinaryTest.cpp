@@ -0,0 +1,90 @@
+/*
+ * InputBinaryTest.cpp
+ */
+
+#include "io/tests/InputBinaryTest.h"
+
+#include "io/BinaryPhaseSpaceFormat.h"
+#include "io/InputBinary.h"
+#include "ensemble/GrandCanonical.h"
+#include "molecules/Molecule.h"
+#include "parallel/DomainDecompDummy.h"
+#include "particleContainer/LinkedCells.h"
+
+#include <cstdio>
+#include <fstream>
+#include <list>
+#include <map>
+
+using namespace std;
+
+TEST_SUITE_REGISTRATION(InputBinaryTest);
+
+InputBinaryTest::InputBinaryTest() {
+}
+
+InputBinaryTest::~InputBinaryTest() {
+}
+
+void InputBinaryTest::testReadAoS() {
+	compareWithTextInput(bps::AOS);
+}
+
+void InputBinaryTest::testReadSoA() {
+	compareWithTextInput(bps::SOA);
+}
+
+void InputBinaryTest::compareWithTextInput(unsigned layout) {
+	// original pointer will be freed by the tearDown()-method.
+	_domainDecomposition = new DomainDecompDummy();
+	const char* textFile = "1clj-regular-2x2x3.inp";
+	ParticleContainer* textContainer = initializeFromFile(ParticleContainerFactory::LinkedCell, textFile, 1.0);
+
+	const char* binaryFile = "InputBinaryTest.bps";
+	{
+		ifstream in(getTestDataFilename(textFile).c_str());
+		ofstream out(binaryFile, ios::binary);
+		string error;
+		bool converted = bps::convertText(in, out, layout, error);
+		ASSERT_TRUE_MSG(error, converted);
+	}
+
+	double bBoxMin[3], bBoxMax[3];
+	for (int d = 0; d < 3; d++) {
+		bBoxMin[d] = textContainer->getBoundingBoxMin(d);
+		bBoxMax[d] = textContainer->getBoundingBoxMax(d);
+	}
+	ParticleContainer* binaryContainer = new LinkedCells(bBoxMin, bBoxMax, 1.0, 1.0, 1.0);
+	InputBinary reader;
+	reader.setPhaseSpaceFile(binaryFile);
+	list<ChemicalPotential> chemPot;
+	unsigned long maxid = reader.readPhaseSpace(binaryContainer, &chemPot, _domain, _domainDecomposition);
+	binaryContainer->update();
+	binaryContainer->deleteOuterParticles();
+	remove(binaryFile);
+
+	map<unsigned long, Molecule*> textMolecules;
+	unsigned long textMaxid = 0;
+	for (Molecule* m = textContainer->begin(); m != textContainer->end(); m = textContainer->next()) {
+		textMolecules[m->id()] = m;
+		textMaxid = max(textMaxid, m->id());
+	}
+	ASSERT_EQUAL(textMolecules.size(), (size_t) binaryContainer->getNumberOfParticles());
+	ASSERT_EQUAL(textMaxid, maxid);
+
+	for (Molecule* m = binaryContainer->begin(); m != binaryContainer->end(); m = binaryContainer->next()) {
+		ASSERT_TRUE(textMolecules.count(m->id()) == 1);
+		Molecule* t = textMolecules[m->id()];
+		ASSERT_EQUAL(t->componentid(), m->componentid());
+		for (int d = 0; d < 3; d++) {
+			ASSERT_EQUAL(t->r(d), m->r(d));
+			ASSERT_EQUAL(t->v(d), m->v(d));
+			ASSERT_EQUAL(t->D(d), m->D(d));
+		}
+		ASSERT_EQUAL(t->q().qw(), m->q().qw());
+		ASSERT_EQUAL(t->q().qz(), m->q().qz());
+	}
+
+	delete binaryContainer;
+	delete textContainer;
+}
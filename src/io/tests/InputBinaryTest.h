@@ -0,0 +1,37 @@
+/*
+ * InputBinaryTest.h
+ */
+
+#ifndef INPUTBINARYTEST_H_
+#define INPUTBINARYTEST_H_
+
+#include "utils/TestWithSimulationSetup.h"
+
+class InputBinaryTest : public utils::TestWithSimulationSetup {
+
+	TEST_SUITE(InputBinaryTest);
+	TEST_METHOD(testReadAoS);
+	TEST_METHOD(testReadSoA);
+	TEST_SUITE_END();
+
+public:
+
+	InputBinaryTest();
+
+	virtual ~InputBinaryTest();
+
+	void testReadAoS();
+
+	void testReadSoA();
+
+private:
+
+	/**
+	 * Read a text phase space file, convert it to the binary format with the
+	 * given layout, read the binary file into a second container and compare
+	 * all molecules.
+	 */
+	void compareWithTextInput(unsigned layout);
+};
+
+#endif /* INPUTBINARYTEST_H_ */
@@ -15,6 +15,7 @@
 #include "particleContainer/LinkedCells.h"
 #include "particleContainer/adapter/ParticlePairs2PotForceAdapter.h"
 #include "particleContainer/adapter/LegacyCellProcessor.h"
+#include "particleContainer/adapter/VectorizedCellProcessor.h"
 
 #ifdef ENABLE_MPI
 #include "parallel/DomainDecomposition.h"
@@ -147,17 +148,19 @@ void RDFTest::testRDFCount(ParticleContainer* moleculeContainer) {
 	rdf.collectRDF(_domainDecomposition);
 
 	// assert number of pairs counted
-	for (int i = 0; i < 100; i++) {
-		if (i == 55) {
-			ASSERT_EQUAL(4752ul, rdf._globalDistribution[0][0][i]);
-		} else if (i == 78) {
-			ASSERT_EQUAL(8712ul, rdf._globalDistribution[0][0][i]);
-		} else if (i == 83) {
-			ASSERT_EQUAL(432ul, rdf._globalDistribution[0][0][i]);
-		} else if (i == 96) {
-			ASSERT_EQUAL(5324ul, rdf._globalDistribution[0][0][i]);
-		} else {
-			ASSERT_EQUAL(0ul, rdf._globalDistribution[0][0][i]);
+	if (_domainDecomposition->getRank() == 0) {
+		for (int i = 0; i < 100; i++) {
+			if (i == 55) {
+				ASSERT_EQUAL(4752ul, rdf._globalDistribution[0][0][i]);
+			} else if (i == 78) {
+				ASSERT_EQUAL(8712ul, rdf._globalDistribution[0][0][i]);
+			} else if (i == 83) {
+				ASSERT_EQUAL(432ul, rdf._globalDistribution[0][0][i]);
+			} else if (i == 96) {
+				ASSERT_EQUAL(5324ul, rdf._globalDistribution[0][0][i]);
+			} else {
+				ASSERT_EQUAL(0ul, rdf._globalDistribution[0][0][i]);
+			}
 		}
 	}
 
@@ -169,23 +172,25 @@ void RDFTest::testRDFCount(ParticleContainer* moleculeContainer) {
 	rdf.collectRDF(_domainDecomposition);
 	rdf.accumulateRDF();
 
-	for (int i = 0; i < 100; i++) {
-		stringstream msg;
-		msg << "at index " << i;
-		if (i == 55) {
-			ASSERT_EQUAL(4752ul, rdf._globalDistribution[0][0][i]);
-		} else if (i == 78) {
-			ASSERT_EQUAL(8712ul, rdf._globalDistribution[0][0][i]);
-		} else if (i == 83) {
-			ASSERT_EQUAL(432ul, rdf._globalDistribution[0][0][i]);
-		} else if (i == 96) {
-			ASSERT_EQUAL(5324ul, rdf._globalDistribution[0][0][i]);
-		} else {
-			ASSERT_EQUAL_MSG(msg.str(), 0ul, rdf._globalDistribution[0][0][i]);
-		}
+	if (_domainDecomposition->getRank() == 0) {
+		for (int i = 0; i < 100; i++) {
+			stringstream msg;
+			msg << "at index " << i;
+			if (i == 55) {
+				ASSERT_EQUAL(4752ul, rdf._globalDistribution[0][0][i]);
+			} else if (i == 78) {
+				ASSERT_EQUAL(8712ul, rdf._globalDistribution[0][0][i]);
+			} else if (i == 83) {
+				ASSERT_EQUAL(432ul, rdf._globalDistribution[0][0][i]);
+			} else if (i == 96) {
+				ASSERT_EQUAL(5324ul, rdf._globalDistribution[0][0][i]);
+			} else {
+				ASSERT_EQUAL_MSG(msg.str(), 0ul, rdf._globalDistribution[0][0][i]);
+			}
 
-		// the accumulated global distribution must be now twice the global distribution
-		ASSERT_EQUAL(rdf._globalAccumulatedDistribution[0][0][i], 2 * rdf._globalDistribution[0][0][i]);
+			// the accumulated global distribution must be now twice the global distribution
+			ASSERT_EQUAL(rdf._globalAccumulatedDistribution[0][0][i], 2 * rdf._globalDistribution[0][0][i]);
+		}
 	}
 }
 
@@ -220,86 +225,169 @@ void RDFTest::testSiteSiteRDF(ParticleContainer* moleculeContainer) {
 	moleculeContainer->traverseCells(cellProcessor);
 	rdf.collectRDF(_domainDecomposition);
 
-	for (int i = 0; i < 101; i++) {
+	if (_domainDecomposition->getRank() == 0) {
+		for (int i = 0; i < 101; i++) {
 //		std::cout << "Bin " << i << ": " << rdf._globalSiteDistribution[0][0][0][0][i] <<
 //					", " << rdf._globalSiteDistribution[0][0][0][1][i] <<
 //					", " << rdf._globalSiteDistribution[0][0][1][0][i] <<
 //					", " << rdf._globalSiteDistribution[0][0][1][1][i] << std::endl;
-		if (i == 20) {
-			ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][0][0][i]);
-			ASSERT_EQUAL(16ul, rdf._globalSiteDistribution[0][0][0][1][i]);
-			ASSERT_EQUAL(16ul, rdf._globalSiteDistribution[0][0][1][0][i]);
-			ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][1][1][i]);
-		} else if (i == 60) {
-			ASSERT_EQUAL(16ul, rdf._globalSiteDistribution[0][0][0][0][i]);
-			ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][0][1][i]);
-			ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][1][0][i]);
-			ASSERT_EQUAL(16ul, rdf._globalSiteDistribution[0][0][1][1][i]);
-		} else if (i == 100) {
-			ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][0][0][i]);
-			ASSERT_EQUAL(16ul, rdf._globalSiteDistribution[0][0][0][1][i]);
-			ASSERT_EQUAL(16ul, rdf._globalSiteDistribution[0][0][1][0][i]);
-			ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][1][1][i]);
-		} else {
-			ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][0][0][i]);
-			ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][0][1][i]);
-			ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][1][0][i]);
-			ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][1][1][i]);
-		}
-	}
-
-	rdf.accumulateRDF();
-	rdf.reset();
-	rdf.tickRDF();
-
-	// test the accumulation of counts...
-	moleculeContainer->traverseCells(cellProcessor);
-	rdf.collectRDF(_domainDecomposition);
-	rdf.accumulateRDF();
-
-	for (int i = 0; i < 101; i++) {
 			if (i == 20) {
 				ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][0][0][i]);
 				ASSERT_EQUAL(16ul, rdf._globalSiteDistribution[0][0][0][1][i]);
 				ASSERT_EQUAL(16ul, rdf._globalSiteDistribution[0][0][1][0][i]);
 				ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][1][1][i]);
-				// accumulated counts
-				ASSERT_EQUAL(0ul, rdf._globalAccumulatedSiteDistribution[0][0][0][0][i]);
-				ASSERT_EQUAL(32ul, rdf._globalAccumulatedSiteDistribution[0][0][0][1][i]);
-				ASSERT_EQUAL(32ul, rdf._globalAccumulatedSiteDistribution[0][0][1][0][i]);
-				ASSERT_EQUAL(0ul, rdf._globalAccumulatedSiteDistribution[0][0][1][1][i]);
 			} else if (i == 60) {
 				ASSERT_EQUAL(16ul, rdf._globalSiteDistribution[0][0][0][0][i]);
 				ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][0][1][i]);
 				ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][1][0][i]);
 				ASSERT_EQUAL(16ul, rdf._globalSiteDistribution[0][0][1][1][i]);
-				// accumulated counts
-				ASSERT_EQUAL(32ul, rdf._globalAccumulatedSiteDistribution[0][0][0][0][i]);
-				ASSERT_EQUAL(0ul, rdf._globalAccumulatedSiteDistribution[0][0][0][1][i]);
-				ASSERT_EQUAL(0ul, rdf._globalAccumulatedSiteDistribution[0][0][1][0][i]);
-				ASSERT_EQUAL(32ul, rdf._globalAccumulatedSiteDistribution[0][0][1][1][i]);
 			} else if (i == 100) {
 				ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][0][0][i]);
 				ASSERT_EQUAL(16ul, rdf._globalSiteDistribution[0][0][0][1][i]);
 				ASSERT_EQUAL(16ul, rdf._globalSiteDistribution[0][0][1][0][i]);
 				ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][1][1][i]);
-				// accumulated counts
-				ASSERT_EQUAL(0ul, rdf._globalAccumulatedSiteDistribution[0][0][0][0][i]);
-				ASSERT_EQUAL(32ul, rdf._globalAccumulatedSiteDistribution[0][0][0][1][i]);
-				ASSERT_EQUAL(32ul, rdf._globalAccumulatedSiteDistribution[0][0][1][0][i]);
-				ASSERT_EQUAL(0ul, rdf._globalAccumulatedSiteDistribution[0][0][1][1][i]);
 			} else {
 				ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][0][0][i]);
 				ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][0][1][i]);
 				ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][1][0][i]);
 				ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][1][1][i]);
-				// accumulated counts
-				ASSERT_EQUAL(0ul, rdf._globalAccumulatedSiteDistribution[0][0][0][0][i]);
-				ASSERT_EQUAL(0ul, rdf._globalAccumulatedSiteDistribution[0][0][0][1][i]);
-				ASSERT_EQUAL(0ul, rdf._globalAccumulatedSiteDistribution[0][0][1][0][i]);
-				ASSERT_EQUAL(0ul, rdf._globalAccumulatedSiteDistribution[0][0][1][1][i]);
 			}
 		}
+	}
+
+	rdf.accumulateRDF();
+	rdf.reset();
+	rdf.tickRDF();
+
+	// test the accumulation of counts...
+	moleculeContainer->traverseCells(cellProcessor);
+	rdf.collectRDF(_domainDecomposition);
+	rdf.accumulateRDF();
+
+	if (_domainDecomposition->getRank() == 0) {
+		for (int i = 0; i < 101; i++) {
+				if (i == 20) {
+					ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][0][0][i]);
+					ASSERT_EQUAL(16ul, rdf._globalSiteDistribution[0][0][0][1][i]);
+					ASSERT_EQUAL(16ul, rdf._globalSiteDistribution[0][0][1][0][i]);
+					ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][1][1][i]);
+					// accumulated counts
+					ASSERT_EQUAL(0ul, rdf._globalAccumulatedSiteDistribution[0][0][0][0][i]);
+					ASSERT_EQUAL(32ul, rdf._globalAccumulatedSiteDistribution[0][0][0][1][i]);
+					ASSERT_EQUAL(32ul, rdf._globalAccumulatedSiteDistribution[0][0][1][0][i]);
+					ASSERT_EQUAL(0ul, rdf._globalAccumulatedSiteDistribution[0][0][1][1][i]);
+				} else if (i == 60) {
+					ASSERT_EQUAL(16ul, rdf._globalSiteDistribution[0][0][0][0][i]);
+					ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][0][1][i]);
+					ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][1][0][i]);
+					ASSERT_EQUAL(16ul, rdf._globalSiteDistribution[0][0][1][1][i]);
+					// accumulated counts
+					ASSERT_EQUAL(32ul, rdf._globalAccumulatedSiteDistribution[0][0][0][0][i]);
+					ASSERT_EQUAL(0ul, rdf._globalAccumulatedSiteDistribution[0][0][0][1][i]);
+					ASSERT_EQUAL(0ul, rdf._globalAccumulatedSiteDistribution[0][0][1][0][i]);
+					ASSERT_EQUAL(32ul, rdf._globalAccumulatedSiteDistribution[0][0][1][1][i]);
+				} else if (i == 100) {
+					ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][0][0][i]);
+					ASSERT_EQUAL(16ul, rdf._globalSiteDistribution[0][0][0][1][i]);
+					ASSERT_EQUAL(16ul, rdf._globalSiteDistribution[0][0][1][0][i]);
+					ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][1][1][i]);
+					// accumulated counts
+					ASSERT_EQUAL(0ul, rdf._globalAccumulatedSiteDistribution[0][0][0][0][i]);
+					ASSERT_EQUAL(32ul, rdf._globalAccumulatedSiteDistribution[0][0][0][1][i]);
+					ASSERT_EQUAL(32ul, rdf._globalAccumulatedSiteDistribution[0][0][1][0][i]);
+					ASSERT_EQUAL(0ul, rdf._globalAccumulatedSiteDistribution[0][0][1][1][i]);
+				} else {
+					ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][0][0][i]);
+					ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][0][1][i]);
+					ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][1][0][i]);
+					ASSERT_EQUAL(0ul, rdf._globalSiteDistribution[0][0][1][1][i]);
+					// accumulated counts
+					ASSERT_EQUAL(0ul, rdf._globalAccumulatedSiteDistribution[0][0][0][0][i]);
+					ASSERT_EQUAL(0ul, rdf._globalAccumulatedSiteDistribution[0][0][0][1][i]);
+					ASSERT_EQUAL(0ul, rdf._globalAccumulatedSiteDistribution[0][0][1][0][i]);
+					ASSERT_EQUAL(0ul, rdf._globalAccumulatedSiteDistribution[0][0][1][1][i]);
+				}
+		}
+	}
+
+}
+
+
+void RDFTest::testVectorizedRDF() {
+	ParticleContainer* moleculeContainer = initializeFromFile(ParticleContainerFactory::LinkedCell, "lj-mixture.inp", 2.5);
+	double cutoff = moleculeContainer->getCutoff();
+	vector<Component>* components = global_simulation->getEnsemble()->components();
+	ASSERT_EQUAL((size_t) 2, components->size());
 
+	ParticlePairs2PotForceAdapter handler(*_domain);
+	LegacyCellProcessor legacyProcessor(cutoff, cutoff, cutoff, &handler);
+	VectorizedCellProcessor vectorizedProcessor(*_domain, cutoff);
+
+	// first without, then with the halo
+	unsigned long pairsWithoutHalo = 0;
+	for (int withHalo = 0; withHalo < 2; withHalo++) {
+		if (withHalo) {
+			_domainDecomposition->exchangeMolecules(moleculeContainer, _domain);
+		}
+		moleculeContainer->update();
+		moleculeContainer->updateMoleculeCaches();
+
+		RDF legacyRDF(0.025, 100, components);
+		ASSERT_TRUE(legacyRDF.siteRDF());
+		handler.setRDF(&legacyRDF);
+		legacyRDF.tickRDF();
+		moleculeContainer->traverseCells(legacyProcessor);
+		legacyRDF.collectRDF(_domainDecomposition);
+
+		RDF vectorizedRDF(0.025, 100, components);
+		vectorizedProcessor.setRDF(&vectorizedRDF);
+		vectorizedRDF.tickRDF();
+		moleculeContainer->traverseCells(vectorizedProcessor);
+		vectorizedRDF.collectRDF(_domainDecomposition);
+
+		if (_domainDecomposition->getRank() == 0) {
+			assertEqualRDF(legacyRDF, vectorizedRDF, 100);
+
+			unsigned long pairs = 0;
+			for (int i = 0; i < 100; i++) {
+				pairs += legacyRDF._globalDistribution[0][1][i];
+			}
+			if (withHalo) {
+				ASSERT_TRUE(pairs > pairsWithoutHalo);
+			} else {
+				ASSERT_TRUE(pairs > 0);
+				pairsWithoutHalo = pairs;
+			}
+		}
+	}
+	delete moleculeContainer;
 }
 
+void RDFTest::assertEqualRDF(RDF& expected, RDF& actual, unsigned bins) {
+	vector<Component>& components = *(expected._components);
+	for (unsigned i = 0; i < components.size(); i++) {
+		for (unsigned k = 0; i + k < components.size(); k++) {
+			for (unsigned b = 0; b < bins; b++) {
+				stringstream msg;
+				msg << "components " << i << ", " << i + k << ", bin " << b;
+				ASSERT_EQUAL_MSG(msg.str(), expected._globalDistribution[i][k][b], actual._globalDistribution[i][k][b]);
+			}
+
+			unsigned ni = components[i].numSites();
+			unsigned nj = components[i + k].numSites();
+			if (ni + nj <= 2) {
+				continue;
+			}
+			for (unsigned m = 0; m < ni; m++) {
+				for (unsigned n = 0; n < nj; n++) {
+					for (unsigned b = 0; b < bins; b++) {
+						stringstream msg;
+						msg << "components " << i << ", " << i + k << ", sites " << m << ", " << n << ", bin " << b;
+						ASSERT_EQUAL_MSG(msg.str(), expected._globalSiteDistribution[i][k][m][n][b],
+								actual._globalSiteDistribution[i][k][m][n][b]);
+					}
+				}
+			}
+		}
+	}
+}
@@ -10,6 +10,7 @@
 
 #include "utils/TestWithSimulationSetup.h"
 
+class RDF;
 
 class RDFTest : public utils::TestWithSimulationSetup {
 
@@ -19,6 +20,7 @@ class RDFTest : public utils::TestWithSimulationSetup {
 	TEST_METHOD(testRDFCountLinkedCell);
 	TEST_METHOD(testRDFCountAdaptiveCell);
 	TEST_METHOD(testSiteSiteRDFLinkedCell);
+	TEST_METHOD(testVectorizedRDF);
 	TEST_SUITE_END();
 
 public:
@@ -80,6 +82,20 @@ public:
 	 * run in parallel.
 	 */
 	void testSiteSiteRDF(ParticleContainer* moleculeContainer);
+
+	/**
+	 * Compares the component and site RDFs of a mixture of 1CLJ and 2CLJ molecules
+	 * sampled by the VectorizedCellProcessor with those sampled by the
+	 * ParticlePairs2PotForceAdapter of the LegacyCellProcessor, first with an empty
+	 * halo and then with the halo populated, where the pairs of the cell pairs with
+	 * halo cells are only counted for one side of the boundary.
+	 */
+	void testVectorizedRDF();
+
+private:
+
+	/** assert that the global component and site distributions of two RDFs are equal */
+	void assertEqualRDF(RDF& expected, RDF& actual, unsigned bins);
 };
 
 #endif /* RDFTEST_H_ */
@@ -0,0 +1,215 @@
+/*
+ * VTKAppendedDataFile.cpp
+ */
+
+#include "io/vtk/VTKAppendedDataFile.h"
+#include "utils/Logger.h"
+
+#include <stdint.h>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifdef ENABLE_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace Log;
+
+/** uncompressed size of the blocks the data is split into for compression (same as vtk uses) */
+static const size_t compressionBlockSize = 32768;
+
+bool parseVTKDataFormat(const std::string& name, VTKDataFormat& format) {
+	if (name == "ascii") {
+		format = VTK_ASCII;
+	} else if (name == "raw" || name == "binary") {
+		format = VTK_APPENDED_RAW;
+	} else if (name == "base64") {
+		format = VTK_APPENDED_BASE64;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+VTKAppendedDataFile::VTKAppendedDataFile(VTKDataFormat format, bool compress)
+	: _format(format), _compress(compress) {
+	if (_compress && !compressionAvailable()) {
+		global_log->warning() << "VTKAppendedDataFile: compiled without zlib support (ZLIB=1), writing uncompressed data." << std::endl;
+		_compress = false;
+	}
+}
+
+bool VTKAppendedDataFile::compressionAvailable() {
+#ifdef ENABLE_ZLIB
+	return true;
+#else
+	return false;
+#endif
+}
+
+int VTKAppendedDataFile::addDataArray(Section section, const std::string& type, const std::string& name, int numberOfComponents) {
+	DataArray array;
+	array.section = section;
+	array.type = type;
+	array.name = name;
+	array.numberOfComponents = numberOfComponents;
+	if (type == "Int8") array.valueType = INT8;
+	else if (type == "UInt8") array.valueType = UINT8;
+	else if (type == "Int32") array.valueType = INT32;
+	else if (type == "UInt32") array.valueType = UINT32;
+	else if (type == "Int64") array.valueType = INT64;
+	else if (type == "UInt64") array.valueType = UINT64;
+	else if (type == "Float32") array.valueType = FLOAT32;
+	else if (type == "Float64") array.valueType = FLOAT64;
+	else {
+		global_log->error() << "VTKAppendedDataFile: unsupported data type " << type << std::endl;
+		array.valueType = FLOAT64;
+		array.type = "Float64";
+	}
+	_arrays.push_back(array);
+	return _arrays.size() - 1;
+}
+
+template<typename T>
+static void appendValue(std::vector<unsigned char>& data, T value) {
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+	data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+void VTKAppendedDataFile::push_back(int arrayIndex, double value) {
+	DataArray& array = _arrays[arrayIndex];
+	switch (array.valueType) {
+	case INT8: appendValue(array.data, static_cast<int8_t>(value)); break;
+	case UINT8: appendValue(array.data, static_cast<uint8_t>(value)); break;
+	case INT32: appendValue(array.data, static_cast<int32_t>(value)); break;
+	case UINT32: appendValue(array.data, static_cast<uint32_t>(value)); break;
+	case INT64: appendValue(array.data, static_cast<int64_t>(value)); break;
+	case UINT64: appendValue(array.data, static_cast<uint64_t>(value)); break;
+	case FLOAT32: appendValue(array.data, static_cast<float>(value)); break;
+	case FLOAT64: appendValue(array.data, value); break;
+	}
+}
+
+size_t VTKAppendedDataFile::size(int arrayIndex) const {
+	static const size_t valueSize[] = { 1, 1, 4, 4, 8, 8, 4, 8 };
+	const DataArray& array = _arrays[arrayIndex];
+	return array.data.size() / valueSize[array.valueType];
+}
+
+void VTKAppendedDataFile::base64Encode(const unsigned char* data, size_t length, std::string& out) {
+	static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	size_t i = 0;
+	for (; i + 2 < length; i += 3) {
+		unsigned triple = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+		out.push_back(alphabet[(triple >> 18) & 0x3f]);
+		out.push_back(alphabet[(triple >> 12) & 0x3f]);
+		out.push_back(alphabet[(triple >> 6) & 0x3f]);
+		out.push_back(alphabet[triple & 0x3f]);
+	}
+	if (i < length) {
+		unsigned triple = data[i] << 16;
+		if (i + 1 < length) {
+			triple |= data[i + 1] << 8;
+		}
+		out.push_back(alphabet[(triple >> 18) & 0x3f]);
+		out.push_back(alphabet[(triple >> 12) & 0x3f]);
+		out.push_back((i + 1 < length) ? alphabet[(triple >> 6) & 0x3f] : '=');
+		out.push_back('=');
+	}
+}
+
+void VTKAppendedDataFile::appendEncoded(const unsigned char* data, size_t length, std::string& out) const {
+	if (_format == VTK_APPENDED_BASE64) {
+		base64Encode(data, length, out);
+	} else {
+		out.append(reinterpret_cast<const char*>(data), length);
+	}
+}
+
+void VTKAppendedDataFile::encodeArray(const DataArray& array, std::string& out) const {
+	const unsigned char* data = array.data.empty() ? NULL : &array.data[0];
+	uint64_t numBytes = array.data.size();
+
+	if (!_compress) {
+		/* header: number of bytes; header and data are encoded separately */
+		appendEncoded(reinterpret_cast<const unsigned char*>(&numBytes), sizeof(numBytes), out);
+		appendEncoded(data, numBytes, out);
+		return;
+	}
+
+#ifdef ENABLE_ZLIB
+	/* header: #blocks, block size, size of the last partial block, compressed size of each block */
+	uint64_t numFullBlocks = numBytes / compressionBlockSize;
+	uint64_t lastBlockSize = numBytes % compressionBlockSize;
+	uint64_t numBlocks = numFullBlocks + (lastBlockSize > 0 ? 1 : 0);
+	std::vector<uint64_t> header(3 + numBlocks);
+	header[0] = numBlocks;
+	header[1] = compressionBlockSize;
+	header[2] = lastBlockSize;
+
+	std::vector<unsigned char> compressed;
+	std::vector<unsigned char> buffer(compressBound(compressionBlockSize));
+	for (uint64_t b = 0; b < numBlocks; b++) {
+		uLong sourceLength = (b < numFullBlocks) ? compressionBlockSize : lastBlockSize;
+		uLongf destLength = buffer.size();
+		if (compress2(&buffer[0], &destLength, data + b * compressionBlockSize, sourceLength, Z_DEFAULT_COMPRESSION) != Z_OK) {
+			global_log->error() << "VTKAppendedDataFile: zlib compression of array " << array.name << " failed!" << std::endl;
+		}
+		header[3 + b] = destLength;
+		compressed.insert(compressed.end(), buffer.begin(), buffer.begin() + destLength);
+	}
+	appendEncoded(reinterpret_cast<const unsigned char*>(&header[0]), header.size() * sizeof(uint64_t), out);
+	appendEncoded(compressed.empty() ? NULL : &compressed[0], compressed.size(), out);
+#endif
+}
+
+void VTKAppendedDataFile::write(const std::string& fileName, unsigned long numberOfPoints, unsigned long numberOfCells) {
+	static const char* sectionNames[] = { "PointData", "CellData", "Points", "Cells" };
+
+	/* build the appended data first, as the offsets are needed in the header */
+	std::string appended;
+	std::vector<size_t> offsets(_arrays.size());
+	for (size_t i = 0; i < _arrays.size(); i++) {
+		offsets[i] = appended.size();
+		encodeArray(_arrays[i], appended);
+	}
+
+	const uint16_t endianTest = 1;
+	const bool littleEndian = *reinterpret_cast<const unsigned char*>(&endianTest) == 1;
+
+	std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary);
+	if (!file.is_open()) {
+		global_log->error() << "VTKAppendedDataFile: could not open file " << fileName << std::endl;
+		return;
+	}
+	file << "<?xml version=\"1.0\"?>\n";
+	file << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\""
+	     << (littleEndian ? "LittleEndian" : "BigEndian") << "\" header_type=\"UInt64\"";
+	if (_compress) {
+		file << " compressor=\"vtkZLibDataCompressor\"";
+	}
+	file << ">\n";
+	file << "  <UnstructuredGrid>\n";
+	file << "    <Piece NumberOfPoints=\"" << numberOfPoints << "\" NumberOfCells=\"" << numberOfCells << "\">\n";
+	for (int section = POINT_DATA; section <= CELLS; section++) {
+		file << "      <" << sectionNames[section] << ">\n";
+		for (size_t i = 0; i < _arrays.size(); i++) {
+			if (_arrays[i].section != section) {
+				continue;
+			}
+			file << "        <DataArray type=\"" << _arrays[i].type << "\" Name=\"" << _arrays[i].name
+			     << "\" NumberOfComponents=\"" << _arrays[i].numberOfComponents
+			     << "\" format=\"appended\" offset=\"" << offsets[i] << "\"/>\n";
+		}
+		file << "      </" << sectionNames[section] << ">\n";
+	}
+	file << "    </Piece>\n";
+	file << "  </UnstructuredGrid>\n";
+	file << "  <AppendedData encoding=\"" << (_format == VTK_APPENDED_BASE64 ? "base64" : "raw") << "\">\n";
+	file << "_";
+	file.write(appended.data(), appended.size());
+	file << "\n  </AppendedData>\n";
+	file << "</VTKFile>\n";
+	file.close();
+}
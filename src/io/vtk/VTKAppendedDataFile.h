@@ -0,0 +1,96 @@
+/*
+ * VTKAppendedDataFile.h
+ */
+
+#ifndef VTKAPPENDEDDATAFILE_H_
+#define VTKAPPENDEDDATAFILE_H_
+
+#include <string>
+#include <vector>
+
+/**
+ * Data format of the piece files (*.vtu) written by the vtk output plugins.
+ * - ASCII: xml data arrays written by the xsd generated serializer
+ * - APPENDED_RAW: binary data in an <AppendedData encoding="raw"> section
+ * - APPENDED_BASE64: binary data in an <AppendedData encoding="base64"> section
+ */
+enum VTKDataFormat { VTK_ASCII, VTK_APPENDED_RAW, VTK_APPENDED_BASE64 };
+
+/**
+ * Parse the data format given in the xml config ("ascii", "raw" or "base64").
+ * @return false if the string is no valid format
+ */
+bool parseVTKDataFormat(const std::string& name, VTKDataFormat& format);
+
+/**
+ * Writes a vtk unstructured grid piece with all data arrays stored as binary
+ * appended data, optionally compressed with zlib (if compiled with ZLIB=1).
+ *
+ * In contrast to the xsd generated serialization classes, the data arrays are
+ * kept as plain byte buffers and are written in one go, which makes files
+ * several times smaller and faster to write and to load.
+ * The files are written according to VTK XML file format version 1.0 with
+ * 64 bit block headers.
+ */
+class VTKAppendedDataFile {
+
+public:
+
+	enum Section { POINT_DATA = 0, CELL_DATA = 1, POINTS = 2, CELLS = 3 };
+
+	/**
+	 * @param format either VTK_APPENDED_RAW or VTK_APPENDED_BASE64
+	 * @param compress compress the data arrays with zlib
+	 */
+	VTKAppendedDataFile(VTKDataFormat format, bool compress);
+
+	/**
+	 * add a data array to the given section of the piece
+	 * @param type vtk type name: Int8, UInt8, Int32, UInt32, Int64, UInt64, Float32 or Float64
+	 * @return index of the array which has to be used for push_back()
+	 */
+	int addDataArray(Section section, const std::string& type, const std::string& name, int numberOfComponents);
+
+	/** append a value (converted to the type of the array) to the given array */
+	void push_back(int arrayIndex, double value);
+
+	/** number of values (not components) stored in the given array */
+	size_t size(int arrayIndex) const;
+
+	/**
+	 * write the piece to a file
+	 */
+	void write(const std::string& fileName, unsigned long numberOfPoints, unsigned long numberOfCells);
+
+	/** true if the code has been compiled with zlib support */
+	static bool compressionAvailable();
+
+	/** encode binary data in base64 (including padding) */
+	static void base64Encode(const unsigned char* data, size_t length, std::string& out);
+
+private:
+
+	enum ValueType { INT8, UINT8, INT32, UINT32, INT64, UINT64, FLOAT32, FLOAT64 };
+
+	struct DataArray {
+		Section section;
+		std::string type;
+		ValueType valueType;
+		std::string name;
+		int numberOfComponents;
+		std::vector<unsigned char> data;
+	};
+
+	/** build the (possibly compressed) binary block of an array, i.e. header and data */
+	void encodeArray(const DataArray& array, std::string& out) const;
+
+	void appendEncoded(const unsigned char* data, size_t length, std::string& out) const;
+
+	VTKDataFormat _format;
+
+	bool _compress;
+
+	std::vector<DataArray> _arrays;
+};
+
+#endif /* VTKAPPENDEDDATAFILE_H_ */
@@ -17,11 +17,11 @@
 using namespace Log;
 
 VTKGridWriter::VTKGridWriter()
-: _numCells(0), _numVertices(0) {
+: _format(VTK_ASCII), _compress(false), _numCells(0), _numVertices(0) {
 }
 
-VTKGridWriter::VTKGridWriter(unsigned int frequency, std::string name)
-	: _writeFrequency(frequency), _fileName(name), _numCells(0), _numVertices(0) {
+VTKGridWriter::VTKGridWriter(unsigned int frequency, std::string name, VTKDataFormat format, bool compress)
+	: _writeFrequency(frequency), _fileName(name), _format(format), _compress(compress), _numCells(0), _numVertices(0) {
 }
 
 VTKGridWriter::~VTKGridWriter() { }
@@ -35,6 +35,18 @@ void VTKGridWriter::readXML(XMLfileUnits& xmlconfig) {
 	if (_writeFrequency <= 0) {
 		Log::global_log->error() << "VTKMoleculeWriter: writeFrequency must be > 0!" << std::endl;
 	}
+
+	std::string format("ascii");
+	xmlconfig.getNodeValue("format", format);
+	if (!parseVTKDataFormat(format, _format)) {
+		global_log->error() << "VTKGridWriter: unknown format " << format << ", use ascii, raw or base64." << std::endl;
+		_format = VTK_ASCII;
+	}
+	global_log->info() << "VTKGridWriter: Format: " << format << std::endl;
+	std::string compression("none");
+	xmlconfig.getNodeValue("compression", compression);
+	_compress = (compression == "zlib") && (_format != VTK_ASCII);
+	global_log->info() << "VTKGridWriter: Compression: " << (_compress ? "zlib" : "none") << std::endl;
 }
 
 
@@ -58,7 +70,7 @@ void  VTKGridWriter::doOutput(
 
 	int rank = domainDecomp->getRank();
 
-	VTKGridWriterImplementation impl(rank);
+	VTKGridWriterImplementation impl(rank, _format, _compress);
 	impl.initializeVTKFile();
 
 	setupVTKGrid(particleContainer);
@@ -11,6 +11,7 @@
 #include "io/OutputBase.h"
 #include "io/vtk/VTKGridCell.h"
 #include "io/vtk/VTKGridVertex.h"
+#include "io/vtk/VTKAppendedDataFile.h"
 
 class LinkedCells;
 class VTKGridWriterImplementation;
@@ -19,6 +20,9 @@ class VTKGridWriterImplementation;
  * This class acts as adapter to the VTKGridWriterImplementation, which handles
  * the actual xml writing. It is a friend class of LinkedCells, but reads only
  * its internal data to generate the vtk output.
+ *
+ * The data format of the piece files can be set with <format>ascii|raw|base64</format>
+ * and <compression>none|zlib</compression> (see VTKMoleculeWriter).
  */
 class VTKGridWriter : public OutputBase {
 
@@ -28,6 +32,10 @@ private:
 
 	std::string _fileName;
 
+	VTKDataFormat _format;
+
+	bool _compress;
+
 	VTKGridCell* _cells;
 
 	VTKGridVertex* _vertices;
@@ -46,7 +54,7 @@ public:
 	 */
 	VTKGridWriter();
 
-	VTKGridWriter(unsigned int frequency, std::string name);
+	VTKGridWriter(unsigned int frequency, std::string name, VTKDataFormat format = VTK_ASCII, bool compress = false);
 
 	virtual ~VTKGridWriter();
 
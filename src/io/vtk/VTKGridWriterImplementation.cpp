@@ -15,16 +15,15 @@
 
 using namespace Log;
 
-VTKGridWriterImplementation::VTKGridWriterImplementation(int rank)
+VTKGridWriterImplementation::VTKGridWriterImplementation(int rank, VTKDataFormat format, bool compress)
 : _vtkFile(NULL), _parallelVTKFile(NULL), _numCellsPlotted(0),
-  _numVerticesPlotted(0), _rank(rank) {
+  _numVerticesPlotted(0), _rank(rank), _format(format), _compress(compress), _appendedFile(NULL) {
 }
 
 
 VTKGridWriterImplementation::~VTKGridWriterImplementation() {
-	if (isVTKFileInitialized()) {
-		delete _vtkFile;
-	}
+	delete _vtkFile;
+	delete _appendedFile;
 	if (isParallelVTKFileInitialized()) {
 		delete _parallelVTKFile;
 	}
@@ -34,6 +33,21 @@ VTKGridWriterImplementation::~VTKGridWriterImplementation() {
  * for the parallel VTK File. -> use array of structs?
  */
 void VTKGridWriterImplementation::initializeVTKFile() {
+	if (_format != VTK_ASCII) {
+		// has to match the order of enum AppendedArray
+		_appendedFile = new VTKAppendedDataFile(_format, _compress);
+		_appendedFile->addDataArray(VTKAppendedDataFile::CELL_DATA, "Int32", "numberOfMolecules", 1);
+		_appendedFile->addDataArray(VTKAppendedDataFile::CELL_DATA, "Float32", "load", 1);
+		_appendedFile->addDataArray(VTKAppendedDataFile::CELL_DATA, "Int32", "level", 1);
+		_appendedFile->addDataArray(VTKAppendedDataFile::CELL_DATA, "Int32", "node-rank", 1);
+		_appendedFile->addDataArray(VTKAppendedDataFile::CELL_DATA, "UInt32", "index", 1);
+		_appendedFile->addDataArray(VTKAppendedDataFile::POINTS, "Float32", "points", 3);
+		_appendedFile->addDataArray(VTKAppendedDataFile::CELLS, "Int32", "connectivity", 1);
+		_appendedFile->addDataArray(VTKAppendedDataFile::CELLS, "Int32", "offsets", 1);
+		_appendedFile->addDataArray(VTKAppendedDataFile::CELLS, "Int32", "types", 1);
+		return;
+	}
+
 	PointData pointData;
 	// we don't need point data at all!?
 	//DataArray_t position(type::Int32, "id", 0);
@@ -72,6 +86,33 @@ void VTKGridWriterImplementation::initializeVTKFile() {
 
 
 void VTKGridWriterImplementation::plotCell(VTKGridCell& cell) {
+	if (_appendedFile != NULL) {
+		VTKGridVertex* const * vertices = cell.getVertices();
+		for (int i = 0; i < 8; i++) {
+			if (vertices[i]->getIndex() < 0) {
+				const double* coordinates = vertices[i]->getCoordinates();
+				for (int j = 0; j < 3; j++) {
+					_appendedFile->push_back(POINTS, coordinates[j]);
+				}
+				vertices[i]->setIndex(_numVerticesPlotted);
+				_numVerticesPlotted++;
+			}
+		}
+		for (int i = 0; i < 8; i++) {
+			_appendedFile->push_back(CONNECTIVITY, vertices[i]->getIndex());
+		}
+		_numCellsPlotted++;
+		_appendedFile->push_back(OFFSETS, _numCellsPlotted * 8);
+		_appendedFile->push_back(TYPES, 11);
+
+		_appendedFile->push_back(NUMBER_OF_MOLECULES, cell.getNumberOfMolecules());
+		_appendedFile->push_back(LOAD, cell.getLoad());
+		_appendedFile->push_back(LEVEL, cell.getLevel());
+		_appendedFile->push_back(NODE_RANK, _rank);
+		_appendedFile->push_back(INDEX, cell.getIndex());
+		return;
+	}
+
 	Points::DataArray_sequence& pointsArraySequence = (*_vtkFile).UnstructuredGrid()->Piece().Points().DataArray();
 	Points::DataArray_iterator points_iterator = pointsArraySequence.begin();
 
@@ -130,6 +171,11 @@ void  VTKGridWriterImplementation::writeVTKFile(const std::string& fileName) {
 	}
 #endif
 
+	if (_appendedFile != NULL) {
+		_appendedFile->write(fileName, _numVerticesPlotted, _numCellsPlotted);
+		return;
+	}
+
 	(*_vtkFile).UnstructuredGrid()->Piece().NumberOfPoints(_numVerticesPlotted);
 	(*_vtkFile).UnstructuredGrid()->Piece().NumberOfCells(_numCellsPlotted);
 	std::ofstream file(fileName.c_str());
@@ -192,7 +238,7 @@ void VTKGridWriterImplementation::writeParallelVTKFile(const std::string& fileNa
 
 
 bool VTKGridWriterImplementation::isVTKFileInitialized() {
-	return _vtkFile != NULL;
+	return _vtkFile != NULL || _appendedFile != NULL;
 }
 
 bool VTKGridWriterImplementation::isParallelVTKFileInitialized() {
@@ -11,6 +11,8 @@
 #include <string>
 #include <vector>
 
+#include "io/vtk/VTKAppendedDataFile.h"
+
 class VTKGridCell;
 class VTKFile_t;
 
@@ -19,6 +21,7 @@ class VTKFile_t;
  * vtk unstructured grid data. The mesh is written cell wise.
  *
  * It acts as an adapter to the serialization classes generated by codesynthesis xsd.
+ * For the binary formats, the piece files are written by a VTKAppendedDataFile.
  */
 class VTKGridWriterImplementation {
 
@@ -39,13 +42,28 @@ private:
 	//! the rank of the process
 	int _rank;
 
+	//! data format of the sequential file
+	VTKDataFormat _format;
+
+	//! if binary data should be compressed
+	bool _compress;
+
+	//! sequential file for the binary formats
+	VTKAppendedDataFile* _appendedFile;
+
+	//! order of the data arrays in the appended file
+	enum AppendedArray {
+		NUMBER_OF_MOLECULES, LOAD, LEVEL, NODE_RANK, INDEX, POINTS, CONNECTIVITY, OFFSETS, TYPES
+	};
 
 public:
 
 	/**
 	 * @param rank the MPI rank of the process
+	 * @param format data format of the sequential file
+	 * @param compress compress binary data with zlib (if available)
 	 */
-	VTKGridWriterImplementation(int rank);
+	VTKGridWriterImplementation(int rank, VTKDataFormat format = VTK_ASCII, bool compress = false);
 
 	virtual ~VTKGridWriterImplementation();
 
@@ -33,6 +33,22 @@ void VTKMoleculeWriter::readXML(XMLfileUnits& xmlconfig) {
 	if (_writeFrequency <= 0) {
 		Log::global_log->error() << "VTKMoleculeWriter: writeFrequency must be > 0!" << std::endl;
 	}
+
+	std::string format("ascii");
+	xmlconfig.getNodeValue("format", format);
+	if (!parseVTKDataFormat(format, _format)) {
+		global_log->error() << "VTKMoleculeWriter: unknown format " << format << ", use ascii, raw or base64." << std::endl;
+		_format = VTK_ASCII;
+	}
+	global_log->info() << "VTKMoleculeWriter: Format: " << format << std::endl;
+	std::string compression("none");
+	xmlconfig.getNodeValue("compression", compression);
+	_compress = (compression == "zlib");
+	if (_compress && _format == VTK_ASCII) {
+		global_log->warning() << "VTKMoleculeWriter: compression is only supported for the binary formats." << std::endl;
+		_compress = false;
+	}
+	global_log->info() << "VTKMoleculeWriter: Compression: " << (_compress ? "zlib" : "none") << std::endl;
 }
 
 
@@ -47,7 +63,7 @@ void VTKMoleculeWriter::doOutput(
 
 	int rank = domainDecomp->getRank();
 
-        VTKMoleculeWriterImplementation impl(rank, true);
+	VTKMoleculeWriterImplementation impl(rank, true, _format, _compress);
 
 	impl.initializeVTKFile();
 
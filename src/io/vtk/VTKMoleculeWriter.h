@@ -14,6 +14,15 @@
 /**
  * This class is an implementation of the OutputBase for the VTK file format.
  *
+ * \code{.xml}
+ * <outputplugin name="VTKMoleculeWriter">
+ *   <writefrequency>INTEGER</writefrequency>
+ *   <outputprefix>STRING</outputprefix>
+ *   <format>ascii|raw|base64</format>       <!-- default ascii, raw and base64 write binary appended data -->
+ *   <compression>none|zlib</compression>    <!-- only for binary formats, requires ZLIB=1 -->
+ * </outputplugin>
+ * \endcode
+ *
  * @TODO Think about a way how to handle the setup of particleConainers, Domain, etc...
  *       Maybe some kind of factory?
  */
@@ -25,11 +34,15 @@ private:
 
 	std::string _fileName;
 
+	VTKDataFormat _format;
+
+	bool _compress;
+
 public:
-	VTKMoleculeWriter() {}
+	VTKMoleculeWriter() : _writeFrequency(1), _format(VTK_ASCII), _compress(false) {}
 
-	VTKMoleculeWriter(unsigned int frequency, std::string name):
-		_writeFrequency(frequency), _fileName(name) {}
+	VTKMoleculeWriter(unsigned int frequency, std::string name, VTKDataFormat format = VTK_ASCII, bool compress = false):
+		_writeFrequency(frequency), _fileName(name), _format(format), _compress(compress) {}
 
 	virtual ~VTKMoleculeWriter() {}
 
@@ -14,14 +14,14 @@
 
 using namespace Log;
 
-VTKMoleculeWriterImplementation::VTKMoleculeWriterImplementation(int rank, bool plotCenters)
-: _vtkFile(NULL), _parallelVTKFile(NULL), _numMoleculesPlotted(0), _rank(rank), _plotCenters(plotCenters) {
+VTKMoleculeWriterImplementation::VTKMoleculeWriterImplementation(int rank, bool plotCenters, VTKDataFormat format, bool compress)
+: _vtkFile(NULL), _parallelVTKFile(NULL), _numMoleculesPlotted(0), _rank(rank), _plotCenters(plotCenters),
+  _format(format), _compress(compress), _appendedFile(NULL), _centerIdArray(-1), _pointsArray(-1) {
 }
 
 VTKMoleculeWriterImplementation::~VTKMoleculeWriterImplementation() {
-	if (isVTKFileInitialized()) {
-		delete _vtkFile;
-	}
+	delete _vtkFile;
+	delete _appendedFile;
 	if (isParallelVTKFileInitialized()) {
 		delete _parallelVTKFile;
 	}
@@ -32,6 +32,22 @@ VTKMoleculeWriterImplementation::~VTKMoleculeWriterImplementation() {
  */
 void VTKMoleculeWriterImplementation::initializeVTKFile() {
 
+	if (_format != VTK_ASCII) {
+		// same arrays in the same order as for the ascii file
+		_appendedFile = new VTKAppendedDataFile(_format, _compress);
+		_appendedFile->addDataArray(VTKAppendedDataFile::POINT_DATA, "Float32", "id", 1);
+		_appendedFile->addDataArray(VTKAppendedDataFile::POINT_DATA, "Float32", "component-id", 1);
+		_appendedFile->addDataArray(VTKAppendedDataFile::POINT_DATA, "Int32", "node-rank", 1);
+		_appendedFile->addDataArray(VTKAppendedDataFile::POINT_DATA, "Float32", "forces", 3);
+		if (_plotCenters) {
+			_centerIdArray = _appendedFile->addDataArray(VTKAppendedDataFile::POINT_DATA, "Float32", "center-id", 1);
+			_appendedFile->addDataArray(VTKAppendedDataFile::POINT_DATA, "UInt8", "center-type", 1);
+		}
+		_pointsArray = _appendedFile->addDataArray(VTKAppendedDataFile::POINTS, "Float32", "points", 3);
+		_appendedFile->addDataArray(VTKAppendedDataFile::CELLS, "Float32", "types", 0);
+		return;
+	}
+
 	// Add the data we want to output for each molecule.
 	// The iterator over PointData traverses the DataArrays just in the order
 	// in which we add them here.
@@ -103,6 +119,10 @@ void VTKMoleculeWriterImplementation::plotMolecule(Molecule& molecule) {
 			centerID++;
 		}
 
+	} else if (_appendedFile != NULL) {
+		double force[3] = { molecule.F(0), molecule.F(1), molecule.F(2) };
+		double position[3] = { molecule.r(0), molecule.r(1), molecule.r(2) };
+		appendPoint(molecule, force, position, 0, LJ);
 	} else {
 		PointData::DataArray_sequence& pointDataArraySequence = (*_vtkFile).UnstructuredGrid()->Piece().PointData().DataArray();
 		PointData::DataArray_iterator data_iterator = pointDataArraySequence.begin();
@@ -131,7 +151,33 @@ void VTKMoleculeWriterImplementation::plotMolecule(Molecule& molecule) {
 }
 
 
+void VTKMoleculeWriterImplementation::appendPoint(Molecule& molecule, const double force[3], const double position[3], int centerID, CenterType centerType) {
+	// the point data arrays are the first ones in the appended file
+	_appendedFile->push_back(0, molecule.id());
+	_appendedFile->push_back(1, molecule.componentid());
+	_appendedFile->push_back(2, _rank);
+	for (int d = 0; d < 3; d++) {
+		_appendedFile->push_back(3, force[d]);
+	}
+	if (_plotCenters) {
+		_appendedFile->push_back(_centerIdArray, centerID);
+		_appendedFile->push_back(_centerIdArray + 1, centerType);
+	}
+	for (int d = 0; d < 3; d++) {
+		_appendedFile->push_back(_pointsArray, position[d]);
+	}
+	_numMoleculesPlotted++;
+}
+
 void VTKMoleculeWriterImplementation::plotCenter(Molecule& molecule, int centerID, CenterType centerType) {
+	if (_appendedFile != NULL) {
+		const double* center_force = molecule.site_F(centerID);
+		const double* curr_center = molecule.ljcenter_d(centerID);
+		double position[3] = { molecule.r(0) + curr_center[0], molecule.r(1) + curr_center[1], molecule.r(2) + curr_center[2] };
+		appendPoint(molecule, center_force, position, centerID, centerType);
+		return;
+	}
+
 	PointData::DataArray_sequence& pointDataArraySequence = (*_vtkFile).UnstructuredGrid()->Piece().PointData().DataArray();
 	PointData::DataArray_iterator data_iterator = pointDataArraySequence.begin();
 
@@ -172,6 +218,11 @@ void  VTKMoleculeWriterImplementation::writeVTKFile(const std::string& fileName)
 	}
 #endif
 
+	if (_appendedFile != NULL) {
+		_appendedFile->write(fileName, _numMoleculesPlotted, 0);
+		return;
+	}
+
 	(*_vtkFile).UnstructuredGrid()->Piece().NumberOfPoints(_numMoleculesPlotted); // sets the number of points
 	std::ofstream file(fileName.c_str());
 	VTKFile (file, *_vtkFile); //actually writes the file
@@ -232,7 +283,7 @@ void VTKMoleculeWriterImplementation::writeParallelVTKFile(const std::string& fi
 
 
 bool VTKMoleculeWriterImplementation::isVTKFileInitialized() {
-	return _vtkFile != NULL;
+	return _vtkFile != NULL || _appendedFile != NULL;
 }
 
 bool VTKMoleculeWriterImplementation::isParallelVTKFileInitialized() {
@@ -12,6 +12,8 @@
 #include <string>
 #include <vector>
 
+#include "io/vtk/VTKAppendedDataFile.h"
+
 class Molecule;
 class VTKFile_t;
 
@@ -22,6 +24,9 @@ class VTKFile_t;
  * no grid cells, as the molecules don't really form a grid.
  *
  * It acts as an adapter to the serialization classes generated by codesynthesis xsd.
+ * For the binary formats (VTK_APPENDED_RAW / VTK_APPENDED_BASE64), the piece files
+ * are written by a VTKAppendedDataFile instead, as the generated classes only
+ * support ascii data. The parallel file is the same for all formats.
  */
 class VTKMoleculeWriterImplementation {
 
@@ -42,6 +47,19 @@ private:
 	//! if all centers should be ploted separately
 	bool _plotCenters;
 
+	//! data format of the sequential file
+	VTKDataFormat _format;
+
+	//! if binary data should be compressed
+	bool _compress;
+
+	//! sequential file for the binary formats
+	VTKAppendedDataFile* _appendedFile;
+
+	//! indices of the center-id and points arrays in the appended file
+	int _centerIdArray;
+	int _pointsArray;
+
 	enum CenterType { Charge = 1, LJ = 2, Dipole = 3, Quadrupole = 4, Tersoff = 5 };
 
 	/**
@@ -49,12 +67,19 @@ private:
 	 */
 	void plotCenter(Molecule& molecule, int centerID, CenterType centerType);
 
+	/**
+	 * add one point to the appended data arrays
+	 */
+	void appendPoint(Molecule& molecule, const double force[3], const double position[3], int centerID, CenterType centerType);
+
 public:
 
 	/**
 	 * @param rank the MPI rank of the process
+	 * @param format data format of the sequential file
+	 * @param compress compress binary data with zlib (if available)
 	 */
-	VTKMoleculeWriterImplementation(int rank, bool plotCenters = false);
+	VTKMoleculeWriterImplementation(int rank, bool plotCenters = false, VTKDataFormat format = VTK_ASCII, bool compress = false);
 	virtual ~VTKMoleculeWriterImplementation();
 
 	void initializeVTKFile();
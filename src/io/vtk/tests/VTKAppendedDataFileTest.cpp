@@ -0,0 +1,95 @@
+/*
+ * VTKAppendedDataFileTest.cpp
+ */
+
+#include "VTKAppendedDataFileTest.h"
+#include "io/vtk/VTKAppendedDataFile.h"
+#include "io/vtk/VTKMoleculeWriterImplementation.h"
+#include "molecules/Molecule.h"
+#include "utils/FileUtils.h"
+
+#include <stdint.h>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+TEST_SUITE_REGISTRATION(VTKAppendedDataFileTest);
+
+VTKAppendedDataFileTest::VTKAppendedDataFileTest() {
+}
+
+VTKAppendedDataFileTest::~VTKAppendedDataFileTest() {
+}
+
+void VTKAppendedDataFileTest::testBase64Encode() {
+	const char* input = "foobar";
+	const char* expected[] = { "", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy" };
+	for (int length = 0; length <= 6; length++) {
+		std::string out;
+		VTKAppendedDataFile::base64Encode(reinterpret_cast<const unsigned char*>(input), length, out);
+		ASSERT_EQUAL(std::string(expected[length]), out);
+	}
+}
+
+void VTKAppendedDataFileTest::testWriteRawFile() {
+	VTKAppendedDataFile file(VTK_APPENDED_RAW, false);
+	int first = file.addDataArray(VTKAppendedDataFile::POINT_DATA, "Float32", "first", 1);
+	int second = file.addDataArray(VTKAppendedDataFile::POINTS, "Float64", "second", 3);
+	file.push_back(first, 1.5);
+	file.push_back(first, -2.0);
+	for (int i = 0; i < 3; i++) {
+		file.push_back(second, i);
+	}
+	ASSERT_EQUAL((size_t) 2, file.size(first));
+	ASSERT_EQUAL((size_t) 3, file.size(second));
+	file.write("VTKAppendedDataFileTest.vtu", 1, 0);
+	ASSERT_TRUE(fileExists("VTKAppendedDataFileTest.vtu"));
+
+	std::ifstream in("VTKAppendedDataFileTest.vtu", std::ios::binary);
+	std::stringstream buffer;
+	buffer << in.rdbuf();
+	std::string content = buffer.str();
+	in.close();
+	removeFile("VTKAppendedDataFileTest.vtu");
+
+	// second array starts after 8 byte header and 2 floats
+	ASSERT_TRUE(content.find("Name=\"first\" NumberOfComponents=\"1\" format=\"appended\" offset=\"0\"") != std::string::npos);
+	ASSERT_TRUE(content.find("Name=\"second\" NumberOfComponents=\"3\" format=\"appended\" offset=\"16\"") != std::string::npos);
+
+	size_t start = content.find("<AppendedData encoding=\"raw\">");
+	ASSERT_TRUE(start != std::string::npos);
+	start = content.find('_', start) + 1;
+	uint64_t numBytes;
+	float values[2];
+	memcpy(&numBytes, &content[start], sizeof(numBytes));
+	memcpy(values, &content[start + sizeof(numBytes)], sizeof(values));
+	ASSERT_EQUAL((uint64_t) 8, numBytes);
+	ASSERT_EQUAL(1.5f, values[0]);
+	ASSERT_EQUAL(-2.0f, values[1]);
+	memcpy(&numBytes, &content[start + 16], sizeof(numBytes));
+	ASSERT_EQUAL((uint64_t) 24, numBytes);
+}
+
+void VTKAppendedDataFileTest::testWriteMoleculesBinary() {
+	std::vector<Component> components;
+	Component dummyComponent(0);
+	dummyComponent.addLJcenter(0,0,0,0,0,0,0,false);
+	components.push_back(dummyComponent);
+	Molecule dummyMolecule(0,&components[0],0,0,0,0,0,0,0,0,0,0,0,0,0);
+
+	VTKDataFormat formats[] = { VTK_APPENDED_RAW, VTK_APPENDED_BASE64 };
+	for (int f = 0; f < 2; f++) {
+		for (int compress = 0; compress < 2; compress++) {
+			VTKMoleculeWriterImplementation writer(0, false, formats[f], compress != 0);
+			ASSERT_EQUAL(writer.isVTKFileInitialized(), false);
+			writer.initializeVTKFile();
+			ASSERT_EQUAL(writer.isVTKFileInitialized(), true);
+			writer.plotMolecule(dummyMolecule);
+			writer.plotMolecule(dummyMolecule);
+			ASSERT_EQUAL(writer.getNumMoleculesPlotted(), 2u);
+			writer.writeVTKFile("VTKAppendedDataFileTest.vtu");
+			ASSERT_TRUE(fileExists("VTKAppendedDataFileTest.vtu"));
+			removeFile("VTKAppendedDataFileTest.vtu");
+		}
+	}
+}
@@ -0,0 +1,38 @@
+/*
+ * VTKAppendedDataFileTest.h
+ */
+
+#ifndef VTKAPPENDEDDATAFILETEST_H_
+#define VTKAPPENDEDDATAFILETEST_H_
+
+#include "utils/Testing.h"
+
+class VTKAppendedDataFileTest : public utils::Test {
+
+	TEST_SUITE(VTKAppendedDataFileTest);
+	TEST_METHOD(testBase64Encode);
+	TEST_METHOD(testWriteRawFile);
+	TEST_METHOD(testWriteMoleculesBinary);
+	TEST_SUITE_END();
+
+public:
+
+	VTKAppendedDataFileTest();
+
+	virtual ~VTKAppendedDataFileTest();
+
+	void testBase64Encode();
+
+	/**
+	 * Write two arrays in raw format and check the offsets and the binary
+	 * block of the first array.
+	 */
+	void testWriteRawFile();
+
+	/**
+	 * Write molecules with the VTKMoleculeWriterImplementation in all binary formats.
+	 */
+	void testWriteMoleculesBinary();
+};
+
+#endif /* VTKAPPENDEDDATAFILETEST_H_ */
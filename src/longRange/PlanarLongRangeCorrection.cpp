@@ -0,0 +1,165 @@
+#include "longRange/PlanarLongRangeCorrection.h"
+
+#include <cmath>
+
+#include "Domain.h"
+#include "Simulation.h"
+#include "ensemble/EnsembleBase.h"
+#include "molecules/Molecule.h"
+#include "parallel/DomainDecompBase.h"
+#include "particleContainer/ParticleContainer.h"
+#include "utils/Logger.h"
+
+using namespace Log;
+using namespace std;
+
+PlanarLongRangeCorrection::PlanarLongRangeCorrection(double cutoffRadiusLJ, Domain* domain,
+		DomainDecompBase* domainDecomposition, unsigned numSlabs, int axis) :
+		_rc(cutoffRadiusLJ), _domain(domain), _domainDecomposition(domainDecomposition), _numSlabs(numSlabs),
+		_axis(axis), _slabWidth(0.0), _area(0.0), _numTypes(0), _upotCorr(0.0), _virialCorr(0.0) {
+	if (_numSlabs == 0 || _axis < 0 || _axis > 2) {
+		global_log->error() << "PlanarLongRangeCorrection: invalid number of slabs " << _numSlabs
+				<< " or axis " << _axis << endl;
+		exit(1);
+	}
+}
+
+void PlanarLongRangeCorrection::init() {
+	const double length = _domain->getGlobalLength(_axis);
+	_slabWidth = length / _numSlabs;
+	_area = _domain->getGlobalLength((_axis + 1) % 3) * _domain->getGlobalLength((_axis + 2) % 3);
+
+	vector<Component>* components = global_simulation->getEnsemble()->components();
+	const unsigned numComponents = components->size();
+	_typeOffset.resize(numComponents);
+	_numTypes = 0;
+	for (unsigned i = 0; i < numComponents; ++i) {
+		_typeOffset[i] = _numTypes;
+		_numTypes += (*components)[i].numLJcenters();
+	}
+
+	const double maxDistance = 1000.0 * _rc;
+	const int numImages = (int) ceil(maxDistance / length);
+	_upotKernel.assign(_numTypes * _numTypes * _numSlabs, 0.0);
+	_forceKernel.assign(_numTypes * _numTypes * _numSlabs, 0.0);
+	_virialKernel.assign(_numTypes * _numTypes * _numSlabs, 0.0);
+	for (unsigned i = 0; i < numComponents; ++i) {
+		Component& ci = (*components)[i];
+		for (unsigned j = 0; j < numComponents; ++j) {
+			Component& cj = (*components)[j];
+			// no LJ interaction between Tersoff components
+			if (ci.numTersoff() && cj.numTersoff()) continue;
+			ParaStrm& params = _domain->getComp2Params()(i, j);
+			params.reset_read();
+			for (unsigned si = 0; si < ci.numLJcenters(); ++si) {
+				for (unsigned sj = 0; sj < cj.numLJcenters(); ++sj) {
+					double eps24, sig2, shift6;
+					params >> eps24 >> sig2 >> shift6;
+					if (shift6 != 0.0) continue;  // TRUNCATED_SHIFTED
+
+					const unsigned pairOffset = ((_typeOffset[i] + si) * _numTypes + _typeOffset[j] + sj) * _numSlabs;
+					for (unsigned distance = 0; distance < _numSlabs; ++distance) {
+						double u = 0.0, f = 0.0, w = 0.0;
+						// the periodic images of the slab, the remaining tail is below 1e-9
+						for (int image = -numImages; image <= numImages; ++image) {
+							const double z = distance * _slabWidth + image * length;
+							if (fabs(z) > maxDistance) continue;
+							const double R = max(fabs(z), _rc);
+							const double sr2 = sig2 / (R * R);
+							const double sr4 = sr2 * sr2;
+							const double sr6 = sr4 * sr2;
+							const double sr10 = sr6 * sr4;
+							const double sr12 = sr6 * sr6;
+							u += sig2 * (0.4 * sr10 - sr4);
+							f += z * (sr12 - sr6);
+							w += sig2 * (1.2 * sr10 - 1.5 * sr4);
+						}
+						_upotKernel[pairOffset + distance] = M_PI / 12.0 * eps24 * u;
+						_forceKernel[pairOffset + distance] = M_PI / 3.0 * eps24 * f;
+						_virialKernel[pairOffset + distance] = M_PI / 3.0 * eps24 * w;
+					}
+				}
+			}
+		}
+	}
+
+	_profile.resize(_numTypes * _numSlabs);
+	_upot.resize(_numTypes * _numSlabs);
+	_force.resize(_numTypes * _numSlabs);
+	_virial.resize(_numTypes * _numSlabs);
+
+	global_log->info() << "Planar long range correction: " << _numSlabs << " slabs of width " << _slabWidth
+			<< " along axis " << _axis << ", " << _numTypes << " LJ center types" << endl;
+}
+
+unsigned PlanarLongRangeCorrection::slab(double x) const {
+	long s = (long) floor(x / _slabWidth);
+	s %= (long) _numSlabs;
+	if (s < 0) {
+		s += _numSlabs;
+	}
+	return (unsigned) s;
+}
+
+void PlanarLongRangeCorrection::calculateLongRange(ParticleContainer* container) {
+	// density profile of the LJ centers
+	_profile.assign(_numTypes * _numSlabs, 0.0);
+	for (Molecule* m = container->begin(); m != container->end(); m = container->next()) {
+		const unsigned type = _typeOffset[m->componentid()];
+		for (unsigned si = 0; si < m->numLJcenters(); ++si) {
+			_profile[(type + si) * _numSlabs + slab(m->r(_axis) + m->ljcenter_d(si)[_axis])] += 1.0;
+		}
+	}
+	_domainDecomposition->allreduceArraySum(&_profile[0], &_profile[0], _profile.size());
+
+	// correction for a center of each type in each slab
+	_upot.assign(_numTypes * _numSlabs, 0.0);
+	_force.assign(_numTypes * _numSlabs, 0.0);
+	_virial.assign(_numTypes * _numSlabs, 0.0);
+	const double invArea = 1.0 / _area;
+	for (unsigned a = 0; a < _numTypes; ++a) {
+		for (unsigned b = 0; b < _numTypes; ++b) {
+			const unsigned pairOffset = (a * _numTypes + b) * _numSlabs;
+			for (unsigned k = 0; k < _numSlabs; ++k) {
+				const double n = _profile[b * _numSlabs + k] * invArea;
+				if (n == 0.0) continue;
+				for (unsigned l = 0; l < _numSlabs; ++l) {
+					const unsigned distance = (l >= k) ? l - k : l + _numSlabs - k;
+					_upot[a * _numSlabs + l] += n * _upotKernel[pairOffset + distance];
+					_force[a * _numSlabs + l] += n * _forceKernel[pairOffset + distance];
+					_virial[a * _numSlabs + l] += n * _virialKernel[pairOffset + distance];
+				}
+			}
+		}
+	}
+
+	// every pair of centers is counted twice
+	_upotCorr = 0.0;
+	_virialCorr = 0.0;
+	for (unsigned i = 0; i < _profile.size(); ++i) {
+		_upotCorr += 0.5 * _profile[i] * _upot[i];
+		_virialCorr += 0.5 * _profile[i] * _virial[i];
+	}
+
+	double localUpot = 0.0;
+	double localVirial = 0.0;
+	for (Molecule* m = container->begin(); m != container->end(); m = container->next()) {
+		const unsigned type = _typeOffset[m->componentid()];
+		for (unsigned si = 0; si < m->numLJcenters(); ++si) {
+			const double* d = m->ljcenter_d(si);
+			const unsigned index = (type + si) * _numSlabs + slab(m->r(_axis) + d[_axis]);
+			double f[3] = { 0.0, 0.0, 0.0 };
+			f[_axis] = _force[index];
+			double torque[3];
+			torque[0] = d[1] * f[2] - d[2] * f[1];
+			torque[1] = d[2] * f[0] - d[0] * f[2];
+			torque[2] = d[0] * f[1] - d[1] * f[0];
+			m->Fadd(f);
+			m->Madd(torque);
+			localUpot += 0.5 * _upot[index];
+			localVirial += 0.5 * _virial[index];
+		}
+	}
+	_domain->setLocalUpot(_domain->getLocalUpot() + localUpot);
+	_domain->setLocalVirial(_domain->getLocalVirial() + localVirial);
+}
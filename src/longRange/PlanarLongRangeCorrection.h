@@ -0,0 +1,96 @@
+#ifndef PLANARLONGRANGECORRECTION_H_
+#define PLANARLONGRANGECORRECTION_H_
+
+#include <vector>
+
+class Domain;
+class DomainDecompBase;
+class ParticleContainer;
+
+/** @brief Long range correction of the LJ interactions for planar interfaces.
+ *
+ * The homogeneous far field terms of Domain::initFarFieldCorr assume a uniform
+ * density beyond the cutoff radius, which is wrong for systems with planar
+ * vapour-liquid interfaces. Following Janecek (J. Phys. Chem. B 110: 6264, 2006),
+ * the LJ centers are binned into slabs along the interface normal. Each slab is
+ * treated as a homogeneous layer, whose interactions beyond the cutoff radius
+ * are integrated analytically. For a center at distance z from a layer of
+ * n centers per area, with R = max(|z|, rc),
+ *
+ *   u(z)  =  2 pi eps n sigma^2 [ 2/5 (sigma/R)^10 - (sigma/R)^4 ]
+ *   F(z)  =  8 pi eps n z [ (sigma/R)^12 - (sigma/R)^6 ]
+ *   W(z)  =  8 pi eps n sigma^2 [ 6/5 (sigma/R)^10 - 3/2 (sigma/R)^4 ]
+ *
+ * are the potential energy, the force along the normal and the virial. The periodic
+ * images of the slabs along the normal are included. The profile
+ * is summed up over all processes, so every process knows the corrections of all
+ * slabs and applies them to its own molecules. Pairs of components with a
+ * truncated and shifted potential or with Tersoff sites only are not corrected,
+ * just as in Domain::initFarFieldCorr.
+ */
+class PlanarLongRangeCorrection {
+public:
+	/**
+	 * @param cutoffRadiusLJ cutoff radius of the LJ potential
+	 * @param numSlabs number of slabs along the interface normal
+	 * @param axis dimension of the interface normal (0, 1 or 2)
+	 */
+	PlanarLongRangeCorrection(double cutoffRadiusLJ, Domain* domain, DomainDecompBase* domainDecomposition,
+			unsigned numSlabs, int axis);
+
+	/** @brief set up the LJ parameters of the center types and the slab geometry.
+	 *
+	 * The parameter streams of the domain have to be initialized, and the box
+	 * must not change afterwards.
+	 */
+	void init();
+
+	/** @brief sample the density profile and apply the correction.
+	 *
+	 * Adds the correction forces to the molecules of the container (halo molecules
+	 * have to be deleted before), and their share of the potential energy and the
+	 * virial to the local values of the domain.
+	 */
+	void calculateLongRange(ParticleContainer* container);
+
+	/** global correction of the potential energy of the last calculateLongRange */
+	double getUpot() const { return _upotCorr; }
+	/** global correction of the virial of the last calculateLongRange */
+	double getVirial() const { return _virialCorr; }
+
+private:
+	/** slab of the coordinate x along the normal, wrapped into the box */
+	unsigned slab(double x) const;
+
+	double _rc;
+	Domain* _domain;
+	DomainDecompBase* _domainDecomposition;
+	unsigned _numSlabs;
+	int _axis;
+
+	double _slabWidth;
+	/** area of the interface, i.e. of a slab */
+	double _area;
+
+	/** first LJ center type of each component */
+	std::vector<unsigned> _typeOffset;
+	unsigned _numTypes;
+
+	/** u, F and W of a layer of one center per area for each pair of types
+	 * and distance in slabs, [(a * _numTypes + b) * _numSlabs + distance] */
+	std::vector<double> _upotKernel;
+	std::vector<double> _forceKernel;
+	std::vector<double> _virialKernel;
+
+	/** centers of each type per slab [a * _numSlabs + slab] */
+	std::vector<double> _profile;
+	/** correction for a center of each type in each slab [a * _numSlabs + slab] */
+	std::vector<double> _upot;
+	std::vector<double> _force;
+	std::vector<double> _virial;
+
+	double _upotCorr;
+	double _virialCorr;
+};
+
+#endif /* PLANARLONGRANGECORRECTION_H_ */
@@ -0,0 +1,122 @@
+/*
+ * PlanarLongRangeCorrectionTest.cpp
+ */
+
+#include "PlanarLongRangeCorrectionTest.h"
+#include "Domain.h"
+#include "longRange/PlanarLongRangeCorrection.h"
+#include "molecules/Molecule.h"
+#include "parallel/DomainDecompBase.h"
+#include "particleContainer/ParticleContainer.h"
+
+#include <cmath>
+
+TEST_SUITE_REGISTRATION(PlanarLongRangeCorrectionTest);
+
+namespace {
+// 48 lattice planes along y, the cutoff lies halfway between two of them
+const unsigned NUM_PLANES = 48;
+const double LENGTH = 12.5;
+const double SPACING = LENGTH / NUM_PLANES;
+const double CUTOFF = 11.5 * SPACING;
+}
+
+PlanarLongRangeCorrectionTest::PlanarLongRangeCorrectionTest() { }
+
+PlanarLongRangeCorrectionTest::~PlanarLongRangeCorrectionTest() { }
+
+void PlanarLongRangeCorrectionTest::fillLattice(ParticleContainer* container) {
+	Molecule* m = container->begin();
+	while (m != container->end()) {
+		m = container->deleteCurrent();
+	}
+	Component* component = global_simulation->getEnsemble()->component(0);
+	unsigned long id = 1;
+	for (unsigned i = 0; i < 4; i++) {
+		for (unsigned j = 0; j < NUM_PLANES; j++) {
+			for (unsigned k = 0; k < 4; k++, id++) {
+				double r[3] = { (i + 0.5) * LENGTH / 4, (j + 0.5) * SPACING, (k + 0.5) * LENGTH / 4 };
+				if (container->isInBoundingBox(r)) {
+					Molecule molecule(id, component, r[0], r[1], r[2], 0., 0., 0., 1., 0., 0., 0.);
+					container->addParticle(molecule);
+				}
+			}
+		}
+	}
+	container->update();
+	container->updateMoleculeCaches();
+	for (m = container->begin(); m != container->end(); m = container->next()) {
+		m->clearFM();
+	}
+}
+
+void PlanarLongRangeCorrectionTest::testHomogeneous() {
+	ParticleContainer* container = initializeFromFile(ParticleContainerFactory::LinkedCell, "1clj-regular-12x12x12.inp", CUTOFF);
+	fillLattice(container);
+
+	PlanarLongRangeCorrection correction(CUTOFF, _domain, _domainDecomposition, NUM_PLANES, 1);
+	correction.init();
+	_domain->setLocalUpot(0.0);
+	_domain->setLocalVirial(0.0);
+	correction.calculateLongRange(container);
+
+	// homogeneous far field terms with epsilon = sigma = 1
+	const double numMolecules = 16 * NUM_PLANES;
+	const double rho = numMolecules / (LENGTH * LENGTH * LENGTH);
+	const double s3 = pow(1.0 / CUTOFF, 3);
+	const double upot = numMolecules * 8.0 / 3.0 * M_PI * rho * (s3 * s3 * s3 / 3.0 - s3);
+	const double virial = numMolecules * 32.0 / 3.0 * M_PI * rho * (s3 * s3 * s3 - 1.5 * s3);
+	ASSERT_DOUBLES_EQUAL(upot, correction.getUpot(), 2e-3 * fabs(upot));
+	ASSERT_DOUBLES_EQUAL(virial, correction.getVirial(), 2e-3 * fabs(virial));
+
+	// the shares of all processes add up to the global correction
+	double values[2] = { _domain->getLocalUpot(), _domain->getLocalVirial() };
+	_domainDecomposition->allreduceArraySum(values, values, 2);
+	ASSERT_DOUBLES_EQUAL(correction.getUpot(), values[0], 1e-10 * fabs(upot));
+	ASSERT_DOUBLES_EQUAL(correction.getVirial(), values[1], 1e-10 * fabs(virial));
+
+	for (Molecule* m = container->begin(); m != container->end(); m = container->next()) {
+		for (int d = 0; d < 3; d++) {
+			ASSERT_DOUBLES_EQUAL(0.0, m->F(d), 1e-10);
+		}
+	}
+
+	delete container;
+}
+
+void PlanarLongRangeCorrectionTest::testSlab() {
+	ParticleContainer* container = initializeFromFile(ParticleContainerFactory::LinkedCell, "1clj-regular-12x12x12.inp", CUTOFF);
+	fillLattice(container);
+	Molecule* m = container->begin();
+	while (m != container->end()) {
+		if (m->r(1) >= 0.5 * LENGTH) {
+			m = container->deleteCurrent();
+		} else {
+			m = container->next();
+		}
+	}
+	container->update();
+
+	PlanarLongRangeCorrection correction(CUTOFF, _domain, _domainDecomposition, NUM_PLANES, 1);
+	correction.init();
+	correction.calculateLongRange(container);
+	ASSERT_TRUE(correction.getUpot() < 0.0);
+
+	double force[3] = { 0.0, 0.0, 0.0 };
+	for (m = container->begin(); m != container->end(); m = container->next()) {
+		ASSERT_EQUAL(0.0, m->F(0));
+		ASSERT_EQUAL(0.0, m->F(2));
+		if (m->r(1) < 0.25 * LENGTH) {
+			ASSERT_TRUE(m->F(1) > 0.0);
+		} else {
+			ASSERT_TRUE(m->F(1) < 0.0);
+		}
+		for (int d = 0; d < 3; d++) {
+			force[d] += m->F(d);
+		}
+	}
+	_domainDecomposition->allreduceArraySum(force, force, 3);
+	ASSERT_DOUBLES_EQUAL(0.0, force[1], 1e-10);
+
+	delete container;
+}
@@ -0,0 +1,40 @@
+/*
+ * PlanarLongRangeCorrectionTest.h
+ */
+
+#ifndef PLANARLONGRANGECORRECTIONTEST_H_
+#define PLANARLONGRANGECORRECTIONTEST_H_
+
+#include "utils/TestWithSimulationSetup.h"
+
+class PlanarLongRangeCorrectionTest : public utils::TestWithSimulationSetup {
+
+	TEST_SUITE(PlanarLongRangeCorrectionTest);
+	TEST_METHOD(testHomogeneous);
+	TEST_METHOD(testSlab);
+	TEST_SUITE_END();
+
+public:
+
+	PlanarLongRangeCorrectionTest();
+
+	virtual ~PlanarLongRangeCorrectionTest();
+
+	/**
+	 * For equally occupied slabs, the correction has to agree with the homogeneous
+	 * far field terms of the LJ potential, and there are no correction forces.
+	 */
+	void testHomogeneous();
+
+	/**
+	 * With only the lower half of the box occupied, the correction forces pull the
+	 * molecules towards the middle of the liquid slab, and their sum is zero.
+	 */
+	void testSlab();
+
+private:
+	/** replace the molecules of the container by a lattice of 4 x 48 x 4 molecules */
+	void fillLattice(ParticleContainer* container);
+};
+
+#endif /* PLANARLONGRANGECORRECTIONTEST_H_ */
@@ -186,6 +186,24 @@ void Comp2Param::initialize(
 		}
 	}
 
+	// flat copy of the streams
+	m_paratbl.clear();
+	m_paraoffsets.resize(m_numcomp * m_numcomp + 1);
+	for (unsigned int compi = 0; compi < m_numcomp; ++compi) {
+		for (unsigned int compj = 0; compj < m_numcomp; ++compj) {
+			m_paraoffsets[compi * m_numcomp + compj] = m_paratbl.size();
+			ParaStrm& pstrmij = m_ssparatbl(compi, compj);
+			pstrmij.reset_read();
+			while (!pstrmij.eos()) {
+				double p;
+				pstrmij >> p;
+				m_paratbl.push_back(p);
+			}
+			pstrmij.reset_read();
+		}
+	}
+	m_paraoffsets[m_numcomp * m_numcomp] = m_paratbl.size();
+
 	/*
 	// Tersoff interaction parameters
 	//
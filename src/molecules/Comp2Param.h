@@ -19,6 +19,7 @@
 #ifndef COMP2PARAM_H_
 #define COMP2PARAM_H_
 
+#include <cassert>
 #include <vector>
 
 #include "molecules/Component.h"
@@ -26,6 +27,31 @@
 #include "molecules/ParaStrm.h"
 
 
+/** Reads the interaction parameters of a component pair from a flat table,
+ * in the same order as from the ParaStrm, but without the bookkeeping of a
+ * stream object.
+ */
+class ParaTable {
+    public:
+        ParaTable(const double* begin, const double* end) : m_pos(begin), m_end(end) {}
+
+        /// read the next parameter
+        ParaTable& operator>>(double& p) {
+            assert(m_pos < m_end);
+            p = *m_pos;
+            ++m_pos;
+            return *this;
+        }
+
+        /// all parameters read?
+        bool eos() const { return m_pos >= m_end; }
+
+    private:
+        const double* m_pos;
+        const double* m_end;
+};
+
+
 /** Comp2Param provides a flexible hash table interface to interaction parameter streams.
  *
  * @author Martin Bernreuther <bernreuther@hlrs.de> et al. (2010)
@@ -51,6 +77,14 @@ class Comp2Param {
             return m_ssparatbl(i,j);
         }
 
+        /** Get the flat parameter table for the interaction between component i and j,
+         * which holds the values of the parameter stream contiguously. */
+        ParaTable table(unsigned int i, unsigned int j) const {
+            const double* base = m_paratbl.empty() ? NULL : &m_paratbl[0];
+            const unsigned int pair = i * m_numcomp + j;
+            return ParaTable(base + m_paraoffsets[pair], base + m_paraoffsets[pair + 1]);
+        }
+
         /** @brief Initialize the parameter streams for each component-component table entry.
          *
          *   The order of the entries must correspond to the
@@ -71,5 +105,8 @@ class Comp2Param {
          * 0.75*absQ1*absQ1,0.75*absQ1*absQ2,...
          */
         Array2D<ParaStrm> m_ssparatbl;  /**< table for parameter streams */
+
+        std::vector<double> m_paratbl;  /**< all parameter streams concatenated, pair (i,j) at position i*m_numcomp+j */
+        std::vector<std::size_t> m_paraoffsets;  /**< start of each component pair in m_paratbl, plus the total size */
 };
 #endif /* COMP2PARAM_H_ */
@@ -4,6 +4,7 @@
 #include <cmath>
 #include <fstream>
 
+#include "molecules/SiteCachePool.h"
 #include "utils/Logger.h"
 
 using namespace std;
@@ -27,10 +28,9 @@ Molecule::Molecule(unsigned long id, Component *component,
 	_L[0] = Dx;
 	_L[1] = Dy;
 	_L[2] = Dz;
+	_Iw2 = -1.;
 	_sites_d = _sites_F =_osites_e = NULL;
-	_numTersoffNeighbours = 0;
-	fixedx = rx;
-	fixedy = ry;
+	_tersoffData = NULL;
 
 	if(_component != NULL) {
 		setupCache();
@@ -50,6 +50,7 @@ Molecule::Molecule(const Molecule& m) {
 	_L[0] = m._L[0];
 	_L[1] = m._L[1];
 	_L[2] = m._L[2];
+	_Iw2 = m._Iw2;
 	_F[0] = m._F[0];
 	_F[1] = m._F[1];
 	_F[2] = m._F[2];
@@ -57,10 +58,20 @@ Molecule::Molecule(const Molecule& m) {
 	_M[1] = m._M[1];
 	_M[2] = m._M[2];
 	_sites_d = _sites_F =_osites_e = NULL;
-	_numTersoffNeighbours = 0;
-	fixedx = m.fixedx;
-	fixedy = m.fixedy;
+	_tersoffData = NULL;
 
+	if(_component != NULL) {
+		setupCache();
+		if (_tersoffData != NULL && m._tersoffData != NULL) {
+			_tersoffData->fixedx = m._tersoffData->fixedx;
+			_tersoffData->fixedy = m._tersoffData->fixedy;
+		}
+	}
+}
+
+void Molecule::setComponent(Component *component) {
+	releaseCache();
+	_component = component;
 	if(_component != NULL) {
 		setupCache();
 	}
@@ -97,7 +108,7 @@ void Molecule::upd_preF(double dt, double vcorr, double Dcorr) {
 	_q.add(qincr);
 	qcorr = 1. / sqrt(_q.magnitude2());
 	_q.scale(qcorr);
-
+	_Iw2 = -1.;
 }
 
 
@@ -131,6 +142,208 @@ void Molecule::upd_cache() {
 }
 
 
+const unsigned Molecule::ROTATION_BATCH;
+
+namespace {
+
+/* The quaternion arithmetic of Quaternion::rotate and Quaternion::differentiate on plain
+ * doubles, with the same order of operations, so loops over a batch can be vectorized. */
+inline void rotate(double qw, double qx, double qy, double qz,
+		double d0, double d1, double d2, double& drot0, double& drot1, double& drot2) {
+	double ww = qw * qw;
+	double xx = qx * qx;
+	double yy = qy * qy;
+	double zz = qz * qz;
+	double xy = qx * qy;
+	double zw = qz * qw;
+	double xz = qx * qz;
+	double yw = qy * qw;
+	double yz = qy * qz;
+	double xw = qx * qw;
+	drot0 = (ww + xx - yy - zz) * d0 + 2. * (xy + zw) * d1 + 2. * (xz - yw) * d2;
+	drot1 = 2. * (xy - zw) * d0 + (ww - xx + yy - zz) * d1 + 2. * (yz + xw) * d2;
+	drot2 = 2. * (xz + yw) * d0 + 2. * (yz - xw) * d1 + (ww - xx - yy + zz) * d2;
+}
+
+inline void differentiate(double qw, double qx, double qy, double qz,
+		double w0, double w1, double w2, double& dw, double& dx, double& dy, double& dz) {
+	dw = .5 * (-qx * w0 - qy * w1 - qz * w2);
+	dx = .5 * (qw * w0 - qz * w1 + qy * w2);
+	dy = .5 * (qz * w0 + qw * w1 - qx * w2);
+	dz = .5 * (-qy * w0 + qx * w1 + qw * w2);
+}
+
+/* apply the inverse rotation matrices R of a batch to the body fixed vector d and store
+ * the result in the i-th entry of the given site cache of each molecule */
+inline void rotateinvBatch(const double R[9][Molecule::ROTATION_BATCH], Molecule** molecules, unsigned num,
+		const double d[3], double* Molecule::*cache, unsigned i) {
+	for (unsigned k = 0; k < num; ++k) {
+		double* drot = molecules[k]->*cache + 3 * i;
+		drot[0] = R[0][k] * d[0] + R[1][k] * d[1] + R[2][k] * d[2];
+		drot[1] = R[3][k] * d[0] + R[4][k] * d[1] + R[5][k] * d[2];
+		drot[2] = R[6][k] * d[0] + R[7][k] * d[1] + R[8][k] * d[2];
+	}
+}
+
+} // namespace
+
+void Molecule::upd_preF(Molecule** molecules, unsigned num, double dt, double vcorr, double Dcorr) {
+	assert(num <= ROTATION_BATCH);
+	double dt_halve = .5 * dt;
+
+	// translation, and gather the rotational state of the batch
+	double qw[ROTATION_BATCH], qx[ROTATION_BATCH], qy[ROTATION_BATCH], qz[ROTATION_BATCH];
+	double L[3][ROTATION_BATCH], M[3][ROTATION_BATCH], invI[3][ROTATION_BATCH];
+	for (unsigned k = 0; k < num; ++k) {
+		Molecule* m = molecules[k];
+		assert(m->_m > 0);
+		double dtInv2m = dt_halve / m->_m;
+		for (unsigned short d = 0; d < 3; ++d) {
+			m->_v[d] = vcorr * m->_v[d] + dtInv2m * m->_F[d];
+			m->_r[d] += dt * m->_v[d];
+		}
+		qw[k] = m->_q.qw();
+		qx[k] = m->_q.qx();
+		qy[k] = m->_q.qy();
+		qz[k] = m->_q.qz();
+		for (unsigned short d = 0; d < 3; ++d) {
+			L[d][k] = m->_L[d];
+			M[d][k] = m->_M[d];
+			invI[d][k] = m->_invI[d];
+		}
+	}
+
+	// rotation, see upd_preF(double, double, double). The square roots are taken in separate
+	// loops, as their error handling would keep the compiler from vectorizing the other loops.
+	double h[4][ROTATION_BATCH], qcorr[ROTATION_BATCH];
+	for (unsigned k = 0; k < num; ++k) {
+		double w0, w1, w2;
+		rotate(qw[k], qx[k], qy[k], qz[k], L[0][k], L[1][k], L[2][k], w0, w1, w2);
+		w0 *= invI[0][k];
+		w1 *= invI[1][k];
+		w2 *= invI[2][k];
+		double hw, hx, hy, hz;
+		differentiate(qw[k], qx[k], qy[k], qz[k], w0, w1, w2, hw, hx, hy, hz);
+		h[0][k] = hw * dt_halve + qw[k];
+		h[1][k] = hx * dt_halve + qx[k];
+		h[2][k] = hy * dt_halve + qy[k];
+		h[3][k] = hz * dt_halve + qz[k];
+		qcorr[k] = h[0][k] * h[0][k] + h[1][k] * h[1][k] + h[2][k] * h[2][k] + h[3][k] * h[3][k];
+	}
+	for (unsigned k = 0; k < num; ++k)
+		qcorr[k] = 1. / sqrt(qcorr[k]);
+	for (unsigned k = 0; k < num; ++k) {
+		double hw = h[0][k] * qcorr[k];
+		double hx = h[1][k] * qcorr[k];
+		double hy = h[2][k] * qcorr[k];
+		double hz = h[3][k] * qcorr[k];
+		for (unsigned short d = 0; d < 3; ++d)
+			L[d][k] = Dcorr * L[d][k] + dt_halve * M[d][k];
+		double w0, w1, w2;
+		rotate(hw, hx, hy, hz, L[0][k], L[1][k], L[2][k], w0, w1, w2);
+		w0 *= invI[0][k];
+		w1 *= invI[1][k];
+		w2 *= invI[2][k];
+		double iw, ix, iy, iz;
+		differentiate(hw, hx, hy, hz, w0, w1, w2, iw, ix, iy, iz);
+		qw[k] += iw * dt;
+		qx[k] += ix * dt;
+		qy[k] += iy * dt;
+		qz[k] += iz * dt;
+		qcorr[k] = qw[k] * qw[k] + qx[k] * qx[k] + qy[k] * qy[k] + qz[k] * qz[k];
+	}
+	for (unsigned k = 0; k < num; ++k)
+		qcorr[k] = 1. / sqrt(qcorr[k]);
+	for (unsigned k = 0; k < num; ++k) {
+		qw[k] *= qcorr[k];
+		qx[k] *= qcorr[k];
+		qy[k] *= qcorr[k];
+		qz[k] *= qcorr[k];
+	}
+
+	for (unsigned k = 0; k < num; ++k) {
+		Molecule* m = molecules[k];
+		m->_q = Quaternion(qw[k], qx[k], qy[k], qz[k]);
+		for (unsigned short d = 0; d < 3; ++d)
+			m->_L[d] = L[d][k];
+		m->_Iw2 = -1.;
+	}
+}
+
+void Molecule::upd_cache(Molecule** molecules, unsigned num) {
+	assert(num <= ROTATION_BATCH);
+	if (num == 0)
+		return;
+	const Component* component = molecules[0]->_component;
+
+	// normalize the orientations and set up the inverse rotation matrices (see Quaternion::getRotinvMatrix)
+	double R[9][ROTATION_BATCH];
+	double qw[ROTATION_BATCH], qx[ROTATION_BATCH], qy[ROTATION_BATCH], qz[ROTATION_BATCH];
+	for (unsigned k = 0; k < num; ++k) {
+		assert(molecules[k]->_component == component);
+		qw[k] = molecules[k]->_q.qw();
+		qx[k] = molecules[k]->_q.qx();
+		qy[k] = molecules[k]->_q.qy();
+		qz[k] = molecules[k]->_q.qz();
+	}
+	double s[ROTATION_BATCH];
+	for (unsigned k = 0; k < num; ++k)
+		s[k] = 1. / sqrt(qw[k] * qw[k] + qx[k] * qx[k] + qy[k] * qy[k] + qz[k] * qz[k]);
+	for (unsigned k = 0; k < num; ++k) {
+		qw[k] *= s[k];
+		qx[k] *= s[k];
+		qy[k] *= s[k];
+		qz[k] *= s[k];
+		double ww = qw[k] * qw[k];
+		double xx = qx[k] * qx[k];
+		double yy = qy[k] * qy[k];
+		double zz = qz[k] * qz[k];
+		double xy = qx[k] * qy[k];
+		double zw = qz[k] * qw[k];
+		double xz = qx[k] * qz[k];
+		double yw = qy[k] * qw[k];
+		double yz = qy[k] * qz[k];
+		double xw = qx[k] * qw[k];
+		R[0][k] = ww + xx - yy - zz;
+		R[1][k] = 2. * (xy - zw);
+		R[2][k] = 2. * (xz + yw);
+		R[3][k] = 2. * (xy + zw);
+		R[4][k] = ww - xx + yy - zz;
+		R[5][k] = 2. * (yz - xw);
+		R[6][k] = 2. * (xz - yw);
+		R[7][k] = 2. * (yz + xw);
+		R[8][k] = ww - xx - yy + zz;
+	}
+	for (unsigned k = 0; k < num; ++k) {
+		molecules[k]->_q = Quaternion(qw[k], qx[k], qy[k], qz[k]);
+	}
+
+	unsigned int i;
+	unsigned int ns;
+	ns = component->numLJcenters();
+	for (i = 0; i < ns; ++i)
+		rotateinvBatch(R, molecules, num, component->ljcenter(i).r(), &Molecule::_ljcenters_d, i);
+	ns = component->numCharges();
+	for (i = 0; i < ns; ++i)
+		rotateinvBatch(R, molecules, num, component->charge(i).r(), &Molecule::_charges_d, i);
+	ns = component->numDipoles();
+	for (i = 0; i < ns; ++i) {
+		const Dipole& di = component->dipole(i);
+		rotateinvBatch(R, molecules, num, di.r(), &Molecule::_dipoles_d, i);
+		rotateinvBatch(R, molecules, num, di.e(), &Molecule::_dipoles_e, i);
+	}
+	ns = component->numQuadrupoles();
+	for (i = 0; i < ns; ++i) {
+		const Quadrupole& qi = component->quadrupole(i);
+		rotateinvBatch(R, molecules, num, qi.r(), &Molecule::_quadrupoles_d, i);
+		rotateinvBatch(R, molecules, num, qi.e(), &Molecule::_quadrupoles_e, i);
+	}
+	ns = component->numTersoff();
+	for (i = 0; i < ns; i++)
+		rotateinvBatch(R, molecules, num, component->tersoff(i).r(), &Molecule::_tersoff_d, i);
+}
+
+
 void Molecule::upd_postF(double dt_halve, double& summv2, double& sumIw2) {
 	double dtInv2m = dt_halve / _m;
 	double v2 = 0.;
@@ -142,39 +355,26 @@ void Molecule::upd_postF(double dt_halve, double& summv2, double& sumIw2) {
     assert(!isnan(v2)); // catches NaN
     summv2 += _m * v2;
 
-	double w[3];
-	_q.rotate(_L, w); // L = D = Iw
-	double Iw2 = 0.;
-	for (unsigned short d = 0; d < 3; ++d) {
-		w[d] *= _invI[d];
-		Iw2 += _I[d] * w[d] * w[d];
-	}
-    assert(!isnan(Iw2)); // catches NaN
-	sumIw2 += Iw2;
+	_Iw2 = calculateIw2();
+    assert(!isnan(_Iw2)); // catches NaN
+	sumIw2 += _Iw2;
 }
 
 
-double Molecule::U_rot() {
+double Molecule::calculateIw2() const {
 	double w[3];
-	_q.rotate(_L, w);
+	_q.rotate(_L, w); // L = D = Iw
 	double Iw2 = 0.;
 	for (unsigned short d = 0; d < 3; ++d) {
 		w[d] *= _invI[d];
 		Iw2 += _I[d] * w[d] * w[d];
 	}
-	return 0.5 * Iw2;
+	return Iw2;
 }
 
 void Molecule::calculate_mv2_Iw2(double& summv2, double& sumIw2) {
 	summv2 += _m * v2();
-	double w[3];
-	_q.rotate(_L, w);
-	double Iw2 = 0.;
-	for (unsigned short d = 0; d < 3; ++d) {
-		w[d] *= _invI[d];
-		Iw2 += _I[d] * w[d] * w[d];
-	}
-	sumIw2 += Iw2;
+	sumIw2 += Iw2();
 }
 
 void Molecule::calculate_mv2_Iw2(double& summv2, double& sumIw2, double offx, double offy, double offz) {
@@ -182,15 +382,7 @@ void Molecule::calculate_mv2_Iw2(double& summv2, double& sumIw2, double offx, do
 	double vcy = _v[1] - offy;
 	double vcz = _v[2] - offz;
 	summv2 += _m * (vcx*vcx + vcy*vcy + vcz*vcz);
-
-	double w[3];
-	_q.rotate(_L, w);
-	double Iw2 = 0.;
-	for (unsigned short d = 0; d < 3; ++d) {
-		w[d] *= _invI[d];
-		Iw2 += _I[d] * w[d] * w[d];
-	}
-	sumIw2 += Iw2;
+	sumIw2 += Iw2();
 }
 
 void Molecule::scale_v(double s, double offx, double offy, double offz) {
@@ -209,22 +401,23 @@ void Molecule::write(ostream& ostrm) const {
 }
 
 void Molecule::addTersoffNeighbour(Molecule* m, bool pairType) {
-	// this->_Tersoff_neighbours.insert(pair<Molecule*, bool>(m, (pairType > 0)));
-	for (int j = 0; j < _numTersoffNeighbours; j++) {
-		if (m->_id == _Tersoff_neighbours_first[j]->id()) {
-			this->_Tersoff_neighbours_first[j] = m;
-			this->_Tersoff_neighbours_second[j] = pairType;
+	assert(_tersoffData != NULL);
+	TersoffData& tersoff = *_tersoffData;
+	for (int j = 0; j < tersoff.numNeighbours; j++) {
+		if (m->_id == tersoff.neighbours[j]->id()) {
+			tersoff.neighbours[j] = m;
+			tersoff.pairCodes[j] = pairType;
 			return;
 		}
 	}
 
-	this->_Tersoff_neighbours_first[_numTersoffNeighbours] = m;
-	this->_Tersoff_neighbours_second[_numTersoffNeighbours] = pairType;
-	this->_numTersoffNeighbours++;
-	if (_numTersoffNeighbours > MAX_TERSOFF_NEIGHBOURS) {
+	if (tersoff.numNeighbours >= MAX_TERSOFF_NEIGHBOURS) {
 		global_log->error() << "Tersoff neighbour list overflow: Molecule " << m->_id << " has more than " << MAX_TERSOFF_NEIGHBOURS << " Tersoff neighbours." << endl;
 		exit(1);
 	}
+	tersoff.neighbours[tersoff.numNeighbours] = m;
+	tersoff.pairCodes[tersoff.numNeighbours] = pairType;
+	tersoff.numNeighbours++;
 }
 
 double Molecule::tersoffParameters(double params[15]) //returns delta_r
@@ -266,32 +459,47 @@ inline void Molecule::setupCache() {
 			_invI[d] = 0.;
 	}
 
+	// one block for the site positions, orientations and forces
 	int numsites = _component->numSites();
-	_sites_d = new double[3*numsites];
-	assert(_sites_d);
+	int numorientedsites = _component->numOrientedSites();
+	_sites_d = SiteCachePool::allocate(siteCacheSize());
+	assert(_sites_d || numsites == 0);
 	_ljcenters_d = &(_sites_d[0]);
 	_charges_d = &(_ljcenters_d[3*numLJcenters()]);
 	_dipoles_d = &(_charges_d[3*numCharges()]);
 	_quadrupoles_d = &(_dipoles_d[3*numDipoles()]);
 	_tersoff_d = &(_quadrupoles_d[3*numQuadrupoles()]);
 
-	int numorientedsites = _component->numOrientedSites();
-	_osites_e = new double[3*numorientedsites];
-	assert(_osites_e);
+	_osites_e = &(_sites_d[3*numsites]);
 	_dipoles_e = &(_osites_e[0]);
 	_quadrupoles_e = &(_dipoles_e[3*numDipoles()]);
 
-	_sites_F = new double[3*numsites];
-	assert(_sites_F);
+	_sites_F = &(_osites_e[3*numorientedsites]);
 	_ljcenters_F = &(_sites_F[0]);
 	_charges_F = &(_ljcenters_F[3*numLJcenters()]);
 	_dipoles_F = &(_charges_F[3*numCharges()]);
 	_quadrupoles_F = &(_dipoles_F[3*numDipoles()]);
 	_tersoff_F = &(_quadrupoles_F[3*numQuadrupoles()]);
 
+	if (numTersoff() > 0) {
+		_tersoffData = new TersoffData;
+		_tersoffData->numNeighbours = 0;
+		_tersoffData->fixedx = _r[0];
+		_tersoffData->fixedy = _r[1];
+	}
+
 	this->clearFM();
 }
 
+void Molecule::releaseCache() {
+	if (_component != NULL) {
+		SiteCachePool::release(_sites_d, siteCacheSize());
+	}
+	_sites_d = _sites_F = _osites_e = NULL;
+	delete _tersoffData;
+	_tersoffData = NULL;
+}
+
 void Molecule::clearFM() {
 	int numSites = _component->numSites();
 	for (int i = 0; i < 3*numSites; i++) {
@@ -393,13 +601,11 @@ std::ostream& operator<<( std::ostream& os, const Molecule& m ) {
 unsigned long Molecule::totalMemsize() const {
 	unsigned long size = sizeof (*this);
 
-	//_sites_d
-	size += sizeof(double) * _component->numSites()* 3;
-	// site orientation _osites_e
-	size += sizeof(double) * _component->numOrientedSites() * 4;
-	// site Forces _sites_F
-	// row order: Fx1,Fy1,Fz1,Fx2,Fy2,Fz2,...
-	size += sizeof(double) * _component->numSites() * 3;
+	// site positions _sites_d, orientations _osites_e and forces _sites_F
+	size += sizeof(double) * siteCacheSize();
+	if (_tersoffData != NULL) {
+		size += sizeof(TersoffData);
+	}
 
 	return size;
 }
@@ -18,6 +18,8 @@ class Domain;
 //! @brief Molecule modeled as LJ sphere with point polarities + Tersoff potential
 class Molecule {
 
+	friend class MoleculeTest;
+
 public:
 	// TODO Correct this constructor: the components vector is optional,
 	// but if it is left away, all pointer data is not initialized (which is not
@@ -36,9 +38,7 @@ private:
 
 public:
 	~Molecule() {
-		delete[] _sites_d;
-		delete[] _osites_e;
-		delete[] _sites_F;
+		releaseCache();
 	}
 
 	/** get molecule ID */
@@ -47,8 +47,8 @@ public:
 	void setid(unsigned long id) { _id = id; }
 	/** get the molecule's component ID */
 	unsigned int componentid() const { return _component->ID(); }
-	/** set the molecule's component */
-	void setComponent(Component *component) { _component = component; }
+	/** set the molecule's component, the caches are set up for the new component */
+	void setComponent(Component *component);
 	/** return pointer to component to which the molecule belongs */
 	Component* component() const { return _component; }
 	/** get position coordinate */
@@ -69,14 +69,14 @@ public:
 
 
 	/** set molecule's orientation */
-	void setq(Quaternion q){ _q = q; }
+	void setq(Quaternion q){ _q = q; _Iw2 = -1.; }
 
 	/** get coordinate of the rotatational speed */
 	double D(unsigned short d) const { return _L[d]; }
 	/** get coordinate of the current angular momentum  onto molecule */ 
 	double M(unsigned short d) const { return _M[d]; }
 
-        void setD(unsigned short d, double D) { this->_L[d] = D; }
+        void setD(unsigned short d, double D) { this->_L[d] = D; _Iw2 = -1.; }
 	inline void move(int d, double dr) { _r[d] += dr; } /* TODO: is this realy needed? */
 
 
@@ -86,7 +86,16 @@ public:
 	/** return the translational energy of the molecule */
 	double U_trans() const { return 0.5 * _m * v2(); }
 	/** return the rotational energy of the molecule */
-	double U_rot();
+	double U_rot() { return 0.5 * Iw2(); }
+	/** return twice the rotational energy of the molecule. The value from the
+	 *  last upd_postF is reused as long as the orientation and angular momentum
+	 *  have not been changed otherwise (except by scale_D). */
+	double Iw2() {
+		if (_Iw2 < 0.) {
+			_Iw2 = calculateIw2();
+		}
+		return _Iw2;
+	}
 	/** return total kinetic energy of the molecule */
 	double U_kin() { return U_trans() + U_rot(); }
 	
@@ -148,7 +157,7 @@ public:
 	void scale_v(double s) { for(unsigned short d=0;d<3;++d) _v[d]*=s; }
 	void scale_v(double s, double offx, double offy, double offz);
 	void scale_F(double s) { for(unsigned short d=0;d<3;++d) _F[d]*=s; }
-	void scale_D(double s) { for(unsigned short d=0;d<3;++d) _L[d]*=s; }
+	void scale_D(double s) { for(unsigned short d=0;d<3;++d) _L[d]*=s; if (_Iw2 >= 0.) _Iw2 *= s*s; }
 	void scale_M(double s) { for(unsigned short d=0;d<3;++d) _M[d]*=s; }
 
 	void Fadd(const double a[]) { for(unsigned short d=0;d<3;++d) _F[d]+=a[d]; }
@@ -161,15 +170,16 @@ public:
 	void vsub(const double ax, const double ay, const double az) {
 		_v[0] -= ax; _v[1] -= ay; _v[2] -= az;
 	}
-	void setXY() { fixedx = _r[0]; fixedy = _r[1]; }
+	void setXY() { assert(_tersoffData != NULL); _tersoffData->fixedx = _r[0]; _tersoffData->fixedy = _r[1]; }
 	void resetXY()
 	{
+		assert(_tersoffData != NULL);
 		_v[0] = 0.0;
 		_v[1] = 0.0;
 		_F[1] = 0.0;
 		_F[0] = 0.0;
-		_r[0] = fixedx;
-		_r[1] = fixedy;
+		_r[0] = _tersoffData->fixedx;
+		_r[1] = _tersoffData->fixedy;
 	}
 
 	void Fljcenteradd(unsigned int i, double a[])
@@ -195,6 +205,18 @@ public:
 	void upd_preF(double dt, double vcorr=1., double Dcorr=1.);
 	/** update the molecules site position caches (rotate sites and save relative positions) */
 	void upd_cache();
+
+	/** maximal number of molecules which are rotated together by the batched updates */
+	static const unsigned ROTATION_BATCH = 16;
+	/** First step of the leap frog integrator for a batch of molecules. Gives the same results
+	 *  as upd_preF for each molecule, but the quaternion integration of the batch is done in
+	 *  structure of arrays layout, so it runs in SIMD lanes.
+	 *  @param molecules  at most ROTATION_BATCH molecules */
+	static void upd_preF(Molecule** molecules, unsigned num, double dt, double vcorr=1., double Dcorr=1.);
+	/** update the site position caches of a batch of molecules, see upd_preF(Molecule**, ...).
+	 *  The rotation matrix of each molecule is set up once and applied to all its sites.
+	 *  @param molecules  at most ROTATION_BATCH molecules, all of the same component */
+	static void upd_cache(Molecule** molecules, unsigned num);
 	/** second step of the leap frog integrator */
 	void upd_postF(double dt_halve, double& summv2, double& sumIw2);
 
@@ -208,10 +230,10 @@ public:
 	/** write information to stream */
 	void write(std::ostream& ostrm) const;
 
-	inline unsigned getCurTN() { return this->_numTersoffNeighbours; }
-	inline Molecule* getTersoffNeighbour(unsigned i) { return this->_Tersoff_neighbours_first[i]; }
-	inline bool getPairCode(unsigned i) { return this->_Tersoff_neighbours_second[i]; }
-	inline void clearTersoffNeighbourList() { this->_numTersoffNeighbours = 0; }
+	inline unsigned getCurTN() { return (_tersoffData != NULL) ? _tersoffData->numNeighbours : 0; }
+	inline Molecule* getTersoffNeighbour(unsigned i) { return _tersoffData->neighbours[i]; }
+	inline bool getPairCode(unsigned i) { return _tersoffData->pairCodes[i]; }
+	inline void clearTersoffNeighbourList() { if (_tersoffData != NULL) _tersoffData->numNeighbours = 0; }
 	void addTersoffNeighbour(Molecule* m, bool pairType);
 	double tersoffParameters(double params[15]); //returns delta_r
 
@@ -250,6 +272,7 @@ private:
 	Quaternion _q; /**< angular orientation */
 	double _M[3];  /**< torsional moment */
 	double _L[3];  /**< angular momentum */
+	double _Iw2;   /**< twice the rotational energy, negative if it has to be recalculated */
     unsigned long _id;  /**< IDentification number of that molecule */
 
 	double _m; /**< total mass */
@@ -269,13 +292,26 @@ private:
 	double *_ljcenters_F, *_charges_F, *_dipoles_F,
 	       *_quadrupoles_F, *_tersoff_F;
 
-	Molecule* _Tersoff_neighbours_first[MAX_TERSOFF_NEIGHBOURS];
-	bool _Tersoff_neighbours_second[MAX_TERSOFF_NEIGHBOURS]; /* TODO: Comment */
-	int _numTersoffNeighbours;
-	double fixedx, fixedy;
+	//! state which only molecules of components with Tersoff sites need
+	struct TersoffData {
+		Molecule* neighbours[MAX_TERSOFF_NEIGHBOURS];
+		bool pairCodes[MAX_TERSOFF_NEIGHBOURS]; /* TODO: Comment */
+		int numNeighbours;
+		double fixedx, fixedy; /**< position kept by the z-oscillators, see Integrator::zOscillation */
+	};
+	TersoffData* _tersoffData; /**< NULL for molecules without Tersoff sites */
 
 	// setup cache values/properties
 	void setupCache();
+	// return the caches to the pool
+	void releaseCache();
+	// number of doubles in the block holding the site caches
+	size_t siteCacheSize() const {
+		return 3 * (2 * _component->numSites() + _component->numOrientedSites());
+	}
+
+	//! twice the rotational energy from the current orientation and angular momentum
+	double calculateIw2() const;
 };
 
 
@@ -0,0 +1,46 @@
+#include "molecules/SiteCachePool.h"
+
+#include <cassert>
+#include <cstring>
+
+using namespace std;
+
+const size_t SiteCachePool::BLOCKS_PER_CHUNK;
+
+vector<double*>& SiteCachePool::freeLists() {
+	// constructed on first use, molecules may be created during static initialization
+	static vector<double*> lists;
+	return lists;
+}
+
+double* SiteCachePool::allocate(size_t size) {
+	if (size == 0) {
+		return NULL;
+	}
+	vector<double*>& lists = freeLists();
+	if (lists.size() <= size) {
+		lists.resize(size + 1, NULL);
+	}
+	if (lists[size] == NULL) {
+		double* chunk = new double[size * BLOCKS_PER_CHUNK];
+		for (size_t i = 0; i < BLOCKS_PER_CHUNK; i++) {
+			double* block = &chunk[size * i];
+			double* next = (i + 1 < BLOCKS_PER_CHUNK) ? &chunk[size * (i + 1)] : NULL;
+			memcpy(block, &next, sizeof(double*));
+		}
+		lists[size] = chunk;
+	}
+	double* block = lists[size];
+	memcpy(&lists[size], block, sizeof(double*));
+	return block;
+}
+
+void SiteCachePool::release(double* block, size_t size) {
+	if (block == NULL) {
+		return;
+	}
+	vector<double*>& lists = freeLists();
+	assert(size > 0 && size < lists.size());
+	memcpy(block, &lists[size], sizeof(double*));
+	lists[size] = block;
+}
@@ -0,0 +1,33 @@
+#ifndef SITECACHEPOOL_H_
+#define SITECACHEPOOL_H_
+
+#include <cstddef>
+#include <vector>
+
+/** @brief Memory pool for the site caches of the molecules.
+ *
+ * Every molecule keeps the positions, orientations and forces of its sites in one
+ * block of doubles, whose size only depends on the component of the molecule. The
+ * blocks are carved out of large chunks, one free list per block size, so creating,
+ * copying and deleting molecules (e.g. in the halo exchange or for grand canonical
+ * insertions) does not go through the general purpose allocator. Released blocks are
+ * reused for molecules of the same size, the chunks are kept until the program ends.
+ */
+class SiteCachePool {
+public:
+	/** get a block of size doubles, NULL if size is 0 */
+	static double* allocate(size_t size);
+
+	/** return a block obtained from allocate(size) with the same size */
+	static void release(double* block, size_t size);
+
+private:
+	//! number of blocks allocated at once if a free list is empty
+	static const size_t BLOCKS_PER_CHUNK = 1024;
+
+	//! heads of the free lists, indexed by block size. The first double of
+	//! a free block holds the pointer to the next free block of the same size.
+	static std::vector<double*>& freeLists();
+};
+
+#endif /* SITECACHEPOOL_H_ */
@@ -244,14 +244,34 @@ inline void PotForceChargeDipole(const double dr[3], const double& dr2,
 }
 
 
+/** @brief Site types which may occur in the molecules of a simulation.
+ *
+ * PotForce() is instantiated for a combination of site types; the loops over
+ * site types which are absent are removed at compile time. LJ centers are
+ * always considered.
+ */
+template <bool Charges, bool Dipoles, bool Quadrupoles, bool Tersoff>
+struct SiteTypes {
+	static const bool charges = Charges;
+	static const bool dipoles = Dipoles;
+	static const bool quadrupoles = Quadrupoles;
+	static const bool tersoff = Tersoff;
+};
+
+typedef SiteTypes<true, true, true, true> AllSiteTypes;
+
+
 /** @brief Calculate potential and force between two molecules including all site-site interactions.
  *
  * Calculates the potential energy and force between two molecules i and j.
- * The interaction paramters are held in precomputed streams, which are initialized in Comp2Param::initialize
+ * The interaction paramters are precomputed in Comp2Param::initialize and read
+ * either from the parameter stream or from the flat table (ParaTable) of the
+ * component pair.
  *
+ * @tparam     Sites  site types present in the simulation (see SiteTypes)
  * @param[in]  mi   molecule i
  * @param[in]  mj   molecule j
- * @param[in]  params    reference to the corresponding interaction parameter stream initialized via Comp2Param::initialize
+ * @param[in]  params    interaction parameters of the component pair, ParaStrm or ParaTable
  * @param[in]  drm   distance vector from molecule j to molecule i
  * @param[out] Upot6LJ   potential energy resulting from Lennard Jones interactions
  * @param[out] UpotXpoles   potential energy resulting from Charge, Dipole and Quadrupole interactions
@@ -260,7 +280,8 @@ inline void PotForceChargeDipole(const double dr[3], const double& dr2,
  * @param[out] Virial   Virial
  * @param[in]  caculateLJ    enable or disable calculation of Lennard Jones interactions
  */
-inline void PotForce(Molecule& mi, Molecule& mj, ParaStrm& params, double drm[3], double& Upot6LJ, double& UpotXpoles, double& MyRF, double& Virial, bool calculateLJ)
+template <class Sites, class Params>
+inline void PotForce(Molecule& mi, Molecule& mj, Params& params, double drm[3], double& Upot6LJ, double& UpotXpoles, double& MyRF, double& Virial, bool calculateLJ)
 // ???better calc Virial, when molecule forces are calculated:
 //    summing up molecule virials instead of site virials???
 { // Force Calculation
@@ -269,7 +290,7 @@ inline void PotForce(Molecule& mi, Molecule& mj, ParaStrm& params, double drm[3]
 	double drs[3], dr2; // site distance vector & length^2
 	// LJ centers
 	// no LJ interaction between solid atoms of the same component
-	if ((mi.numTersoff() == 0) || (mi.componentid() != mj.componentid())) {
+	if (!Sites::tersoff || (mi.numTersoff() == 0) || (mi.componentid() != mj.componentid())) {
 		const unsigned int nc1 = mi.numLJcenters();
 		const unsigned int nc2 = mj.numLJcenters();
 		for (unsigned int si = 0; si < nc1; ++si) {
@@ -287,19 +308,11 @@ inline void PotForce(Molecule& mi, Molecule& mj, ParaStrm& params, double drm[3]
 					PotForceLJ(drs, dr2, eps24, sig2, f, u);
 					u += shift6;
 
-// even for interactions within the cell a neighbor might try to add/subtract
-// better use atomic...
-// and even better use a order where critical sections occure only at some boundary cells...
-#if defined(ENABLE_OPENMP)
-#pragma omp critical
-#endif
-					{
-						mi.Fljcenteradd(si, f);
-						mj.Fljcentersub(sj, f);
-						Upot6LJ += u;
-						for (unsigned short d = 0; d < 3; ++d)
-							Virial += drm[d] * f[d];
-					}
+					mi.Fljcenteradd(si, f);
+					mj.Fljcentersub(sj, f);
+					Upot6LJ += u;
+					for (unsigned short d = 0; d < 3; ++d)
+						Virial += drm[d] * f[d];
 				}
 			}
 		}
@@ -307,12 +320,13 @@ inline void PotForce(Molecule& mi, Molecule& mj, ParaStrm& params, double drm[3]
 
 	double m1[3], m2[3]; // angular momenta
 
-	const unsigned ne1 = mi.numCharges();
-	const unsigned ne2 = mj.numCharges();
-	const unsigned int nq1 = mi.numQuadrupoles();
-	const unsigned int nq2 = mj.numQuadrupoles();
-	const unsigned int nd1 = mi.numDipoles();
-	const unsigned int nd2 = mj.numDipoles();
+	// constant zero for absent site types, which removes their loops
+	const unsigned ne1 = Sites::charges ? mi.numCharges() : 0;
+	const unsigned ne2 = Sites::charges ? mj.numCharges() : 0;
+	const unsigned int nq1 = Sites::quadrupoles ? mi.numQuadrupoles() : 0;
+	const unsigned int nq2 = Sites::quadrupoles ? mj.numQuadrupoles() : 0;
+	const unsigned int nd1 = Sites::dipoles ? mi.numDipoles() : 0;
+	const unsigned int nd2 = Sites::dipoles ? mj.numDipoles() : 0;
 	for (unsigned si = 0; si < ne1; si++) {
 		const double* dii = mi.charge_d(si);
 		// Charge-Charge
@@ -485,6 +499,12 @@ inline void PotForce(Molecule& mi, Molecule& mj, ParaStrm& params, double drm[3]
 	assert(params.eos());
 }
 
+/** @brief PotForce() for all site types, reading the parameter stream. */
+inline void PotForce(Molecule& mi, Molecule& mj, ParaStrm& params, double drm[3], double& Upot6LJ, double& UpotXpoles, double& MyRF, double& Virial, bool calculateLJ)
+{
+	PotForce<AllSiteTypes>(mi, mj, params, drm, Upot6LJ, UpotXpoles, MyRF, Virial, calculateLJ);
+}
+
 /** @brief Calculates the LJ and electrostatic potential energy of the mi-mj interaction (no multi-body potentials are considered) */
 inline void FluidPot(Molecule& mi, Molecule& mj, ParaStrm& params, double drm[3], double& Upot6LJ, double& UpotXpoles, double& MyRF, bool calculateLJ)
 {
@@ -8,6 +8,8 @@
 #include "MoleculeTest.h"
 #include "molecules/Molecule.h"
 
+#include <cmath>
+
 TEST_SUITE_REGISTRATION(MoleculeTest);
 
 MoleculeTest::MoleculeTest() {
@@ -53,3 +55,204 @@ void MoleculeTest::testIsLessThan() {
 	ASSERT_TRUE(!a.isLessThan(b));
 	ASSERT_TRUE(b.isLessThan(a));
 }
+
+void MoleculeTest::testBatchedRotation() {
+	std::vector<Component> components;
+	Component component(0);
+	component.addLJcenter(0.2, 0.0, -0.1, 1.0, 1.0, 1.0);
+	component.addLJcenter(-0.2, 0.1, 0.1, 1.0, 1.0, 1.0);
+	component.addDipole(0.0, 0.0, 0.3, 0.0, 0.6, 0.8, 1.0);
+	component.addQuadrupole(0.1, -0.3, 0.0, 1.0, 0.0, 0.0, 1.0);
+	component.setI11(0.5);
+	component.setI22(0.7);
+	component.setI33(0.3);
+	components.push_back(component);
+
+	// more molecules than fit into one batch
+	const unsigned numMolecules = Molecule::ROTATION_BATCH + 3;
+	std::vector<Molecule> single;
+	std::vector<Molecule> batched;
+	for (unsigned i = 0; i < numMolecules; i++) {
+		double q[4] = { cos(0.1 * i), sin(0.1 * i), 0.5 * sin(0.3 * i), 0.2 };
+		Molecule molecule(i, &components[0], 0.1 * i, 0.2, 0.3, 0.5, -0.1 * i, 0.2,
+				q[0], q[1], q[2], q[3], 0.3, 0.1 * i, -0.4);
+		single.push_back(molecule);
+		batched.push_back(molecule);
+	}
+	// copies of molecules start without forces and moments
+	for (unsigned i = 0; i < numMolecules; i++) {
+		double F[3] = { 1.0, -0.5 * i, 2.0 };
+		double M[3] = { 0.1 * i, 0.4, -0.2 };
+		single[i].setF(F);
+		single[i].setM(M);
+		batched[i].setF(F);
+		batched[i].setM(M);
+	}
+
+	for (unsigned i = 0; i < numMolecules; i++) {
+		single[i].upd_preF(0.01, 0.9, 1.1);
+		single[i].upd_cache();
+	}
+	Molecule* batch[Molecule::ROTATION_BATCH];
+	for (unsigned first = 0; first < numMolecules; first += Molecule::ROTATION_BATCH) {
+		unsigned num = 0;
+		for (unsigned i = first; i < numMolecules && num < Molecule::ROTATION_BATCH; i++) {
+			batch[num++] = &batched[i];
+		}
+		Molecule::upd_preF(batch, num, 0.01, 0.9, 1.1);
+		Molecule::upd_cache(batch, num);
+	}
+
+	for (unsigned i = 0; i < numMolecules; i++) {
+		for (unsigned short d = 0; d < 3; d++) {
+			ASSERT_DOUBLES_EQUAL(single[i].r(d), batched[i].r(d), 1e-14);
+			ASSERT_DOUBLES_EQUAL(single[i].v(d), batched[i].v(d), 1e-14);
+			ASSERT_DOUBLES_EQUAL(single[i].D(d), batched[i].D(d), 1e-14);
+		}
+		ASSERT_DOUBLES_EQUAL(single[i].q().qw(), batched[i].q().qw(), 1e-14);
+		ASSERT_DOUBLES_EQUAL(single[i].q().qx(), batched[i].q().qx(), 1e-14);
+		ASSERT_DOUBLES_EQUAL(single[i].q().qy(), batched[i].q().qy(), 1e-14);
+		ASSERT_DOUBLES_EQUAL(single[i].q().qz(), batched[i].q().qz(), 1e-14);
+		for (unsigned s = 0; s < single[i].numSites(); s++) {
+			for (unsigned short d = 0; d < 3; d++) {
+				ASSERT_DOUBLES_EQUAL(single[i].site_d(s)[d], batched[i].site_d(s)[d], 1e-14);
+			}
+		}
+		for (unsigned short d = 0; d < 3; d++) {
+			ASSERT_DOUBLES_EQUAL(single[i].dipole_e(0)[d], batched[i].dipole_e(0)[d], 1e-14);
+			ASSERT_DOUBLES_EQUAL(single[i].quadrupole_e(0)[d], batched[i].quadrupole_e(0)[d], 1e-14);
+		}
+	}
+}
+
+namespace {
+
+void addTersoffSite(Component& component) {
+	component.addTersoff(0.0, 0.0, 0.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.5, 1.0, 1.0, 1.0, 1.0, 1.0);
+}
+
+}
+
+void MoleculeTest::testTersoffCopy() {
+	std::vector<Component> components;
+	Component tersoff(0);
+	addTersoffSite(tersoff);
+	components.push_back(tersoff);
+
+	Molecule a(1, &components[0], 1.0, 2.0, 3.0, 0.5, 0.5, 0.5, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0);
+	Molecule b(2, &components[0], 1.5, 2.0, 3.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0);
+	a.addTersoffNeighbour(&b, true);
+	ASSERT_EQUAL(1u, a.getCurTN());
+
+	// moved away from the anchor set in the constructor
+	a.setr(0, 4.0);
+	a.setr(1, 5.0);
+	Molecule copy(a);
+	ASSERT_TRUE(copy._tersoffData != NULL);
+	ASSERT_TRUE(copy._tersoffData != a._tersoffData);
+	ASSERT_EQUAL(0u, copy.getCurTN());
+	copy.resetXY();
+	ASSERT_DOUBLES_EQUAL(1.0, copy.r(0), 0.0);
+	ASSERT_DOUBLES_EQUAL(2.0, copy.r(1), 0.0);
+	ASSERT_DOUBLES_EQUAL(0.0, copy.v(0), 0.0);
+
+	// anchor moved by setXY
+	a.setXY();
+	Molecule copy2(a);
+	a.setr(0, 7.0);
+	copy2.setr(0, 8.0);
+	copy2.resetXY();
+	ASSERT_DOUBLES_EQUAL(4.0, copy2.r(0), 0.0);
+	ASSERT_DOUBLES_EQUAL(5.0, copy2.r(1), 0.0);
+	a.resetXY();
+	ASSERT_DOUBLES_EQUAL(4.0, a.r(0), 0.0);
+	ASSERT_EQUAL(1u, a.getCurTN());
+}
+
+void MoleculeTest::testSetComponent() {
+	std::vector<Component> components;
+	Component small(0);
+	small.addLJcenter(0.0, 0.0, 0.0, 1.0, 1.0, 1.0);
+	components.push_back(small);
+	Component large(1);
+	large.addLJcenter(0.2, 0.0, 0.0, 1.0, 1.0, 1.0);
+	large.addLJcenter(-0.2, 0.0, 0.0, 1.0, 1.0, 1.0);
+	large.addDipole(0.0, 0.1, 0.0, 0.0, 0.0, 1.0, 1.0);
+	large.addQuadrupole(0.0, -0.1, 0.0, 1.0, 0.0, 0.0, 1.0);
+	addTersoffSite(large);
+	large.setI11(0.5);
+	large.setI22(0.5);
+	large.setI33(0.5);
+	components.push_back(large);
+
+	Molecule m(1, &components[0], 1.0, 2.0, 3.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0);
+	double* smallBlock = m._sites_d;
+	ASSERT_TRUE(m._tersoffData == NULL);
+
+	m.setComponent(&components[1]);
+	ASSERT_EQUAL(1u, m.componentid());
+	ASSERT_EQUAL(5u, m.numSites());
+	ASSERT_TRUE(m._sites_d != smallBlock);
+	ASSERT_TRUE(m._tersoffData != NULL);
+	ASSERT_EQUAL(0u, m.getCurTN());
+	ASSERT_TRUE(m._osites_e == m._sites_d + 3 * m.numSites());
+	ASSERT_TRUE(m._sites_F == m._osites_e + 3 * m.numOrientedSites());
+
+	// the caches of all sites are usable and start with zero forces
+	for (unsigned i = 0; i < m.numSites(); i++) {
+		for (int d = 0; d < 3; d++) {
+			ASSERT_DOUBLES_EQUAL(0.0, m.site_F(i)[d], 0.0);
+		}
+	}
+	double f[3] = { 1.0, 2.0, 3.0 };
+	m.Fljcenteradd(1, f);
+	m.Fdipoleadd(0, f);
+	m.Fquadrupoleadd(0, f);
+	m.Ftersoffadd(0, f);
+	m.upd_cache();
+	m.calcFM();
+	ASSERT_DOUBLES_EQUAL(4.0, m.F(0), 1e-12);
+	ASSERT_DOUBLES_EQUAL(12.0, m.F(2), 1e-12);
+
+	// the block of the small component went back to its own free list
+	Molecule other(2, &components[0], 1.0, 2.0, 3.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0);
+	ASSERT_TRUE(other._sites_d == smallBlock);
+
+	m.setComponent(&components[0]);
+	ASSERT_EQUAL(1u, m.numSites());
+	ASSERT_TRUE(m._tersoffData == NULL);
+	ASSERT_EQUAL(0u, m.getCurTN());
+	ASSERT_TRUE(m._sites_d != other._sites_d);
+}
+
+void MoleculeTest::testTotalMemsize() {
+	std::vector<Component> components;
+	Component lj(0);
+	lj.addLJcenter(0.0, 0.0, 0.0, 1.0, 1.0, 1.0);
+	components.push_back(lj);
+	Component dipolar(1);
+	dipolar.addLJcenter(0.0, 0.0, 0.0, 1.0, 1.0, 1.0);
+	dipolar.addDipole(0.0, 0.0, 0.1, 0.0, 0.0, 1.0, 1.0);
+	components.push_back(dipolar);
+	Component tersoff(2);
+	addTersoffSite(tersoff);
+	tersoff.addLJcenter(0.0, 0.0, 0.0, 1.0, 1.0, 1.0);
+	components.push_back(tersoff);
+
+	// positions and forces of one site
+	Molecule a(1, &components[0]);
+	ASSERT_EQUAL((unsigned long) (sizeof(Molecule) + 6 * sizeof(double)), a.totalMemsize());
+
+	// positions and forces of two sites, orientation of the dipole
+	Molecule b(2, &components[1]);
+	ASSERT_EQUAL((unsigned long) (sizeof(Molecule) + 15 * sizeof(double)), b.totalMemsize());
+
+	Molecule c(3, &components[2]);
+	ASSERT_EQUAL((unsigned long) (sizeof(Molecule) + 12 * sizeof(double) + sizeof(Molecule::TersoffData)),
+			c.totalMemsize());
+	Molecule copy(c);
+	ASSERT_EQUAL(c.totalMemsize(), copy.totalMemsize());
+
+	a.setComponent(&components[1]);
+	ASSERT_EQUAL(b.totalMemsize(), a.totalMemsize());
+}
@@ -14,6 +14,10 @@ class MoleculeTest : public utils::Test {
 
 	TEST_SUITE(MoleculeTest);
 	TEST_METHOD(testIsLessThan);
+	TEST_METHOD(testBatchedRotation);
+	TEST_METHOD(testTersoffCopy);
+	TEST_METHOD(testSetComponent);
+	TEST_METHOD(testTotalMemsize);
 	TEST_SUITE_END();
 
 public:
@@ -24,6 +28,21 @@ public:
 
 	void testIsLessThan();
 
+	/** The batched integration and cache update have to give the same results as
+	 *  the updates of the single molecules. */
+	void testBatchedRotation();
+
+	/** Copies of Tersoff molecules keep the position anchored by the z-oscillators,
+	 *  but start with an empty Tersoff neighbour list. */
+	void testTersoffCopy();
+
+	/** After a change to a component with a different number of sites, the site
+	 *  caches fit the new component and the old block is returned to the pool. */
+	void testSetComponent();
+
+	/** totalMemsize() counts the pooled site caches and the Tersoff data. */
+	void testTotalMemsize();
+
 };
 
 #endif /* MOLECULETEST_H_ */
@@ -0,0 +1,92 @@
+/**
+ * \file
+ * \brief Tests for the SiteCachePool.
+ */
+
+#include "SiteCachePoolTest.h"
+#include "molecules/SiteCachePool.h"
+
+#include <set>
+#include <vector>
+
+TEST_SUITE_REGISTRATION(SiteCachePoolTest);
+
+SiteCachePoolTest::SiteCachePoolTest() {
+}
+
+SiteCachePoolTest::~SiteCachePoolTest() {
+}
+
+void SiteCachePoolTest::testEmptyBlock() {
+	ASSERT_TRUE(SiteCachePool::allocate(0) == NULL);
+	SiteCachePool::release(NULL, 0);
+
+	double* block = SiteCachePool::allocate(3);
+	ASSERT_TRUE(block != NULL);
+	SiteCachePool::release(block, 3);
+	ASSERT_TRUE(SiteCachePool::allocate(0) == NULL);
+	ASSERT_EQUAL(block, SiteCachePool::allocate(3));
+	SiteCachePool::release(block, 3);
+}
+
+void SiteCachePoolTest::testReuse() {
+	const size_t size = 5;
+	double* block = SiteCachePool::allocate(size);
+	SiteCachePool::release(block, size);
+	ASSERT_EQUAL(block, SiteCachePool::allocate(size));
+	SiteCachePool::release(block, size);
+
+	// more blocks than fit into one chunk
+	const size_t numBlocks = 3000;
+	std::vector<double*> blocks;
+	for (size_t i = 0; i < numBlocks; i++) {
+		blocks.push_back(SiteCachePool::allocate(size));
+		for (size_t j = 0; j < size; j++) {
+			blocks[i][j] = i * size + j;
+		}
+	}
+	for (size_t i = 0; i < numBlocks; i++) {
+		for (size_t j = 0; j < size; j++) {
+			ASSERT_DOUBLES_EQUAL(i * size + j, blocks[i][j], 0.0);
+		}
+	}
+
+	for (size_t i = 0; i < numBlocks; i++) {
+		SiteCachePool::release(blocks[i], size);
+	}
+	// all blocks are taken from the free list again before a new chunk is allocated
+	std::set<double*> released(blocks.begin(), blocks.end());
+	ASSERT_EQUAL(numBlocks, released.size());
+	std::vector<double*> reused;
+	for (size_t i = 0; i < numBlocks; i++) {
+		reused.push_back(SiteCachePool::allocate(size));
+		ASSERT_TRUE(released.erase(reused[i]) == 1);
+	}
+	for (size_t i = 0; i < numBlocks; i++) {
+		SiteCachePool::release(reused[i], size);
+	}
+}
+
+void SiteCachePoolTest::testSizes() {
+	double* small = SiteCachePool::allocate(6);
+	double* large = SiteCachePool::allocate(9);
+	ASSERT_TRUE(small != large);
+	SiteCachePool::release(small, 6);
+	SiteCachePool::release(large, 9);
+
+	double* other = SiteCachePool::allocate(12);
+	ASSERT_TRUE(other != small && other != large);
+	ASSERT_EQUAL(large, SiteCachePool::allocate(9));
+	ASSERT_EQUAL(small, SiteCachePool::allocate(6));
+
+	// writing a whole block does not touch the blocks of the other sizes
+	for (int i = 0; i < 6; i++) small[i] = 1.0;
+	for (int i = 0; i < 12; i++) other[i] = 3.0;
+	for (int i = 0; i < 9; i++) large[i] = 2.0;
+	for (int i = 0; i < 6; i++) ASSERT_DOUBLES_EQUAL(1.0, small[i], 0.0);
+	for (int i = 0; i < 12; i++) ASSERT_DOUBLES_EQUAL(3.0, other[i], 0.0);
+
+	SiteCachePool::release(small, 6);
+	SiteCachePool::release(large, 9);
+	SiteCachePool::release(other, 12);
+}
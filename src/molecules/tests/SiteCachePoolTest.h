@@ -0,0 +1,37 @@
+/**
+ * \file
+ * \brief Tests for the SiteCachePool.
+ */
+
+#ifndef SITECACHEPOOLTEST_H_
+#define SITECACHEPOOLTEST_H_
+
+#include "utils/Testing.h"
+
+class SiteCachePoolTest : public utils::Test {
+
+	TEST_SUITE(SiteCachePoolTest);
+	TEST_METHOD(testEmptyBlock);
+	TEST_METHOD(testReuse);
+	TEST_METHOD(testSizes);
+	TEST_SUITE_END();
+
+public:
+
+	SiteCachePoolTest();
+
+	virtual ~SiteCachePoolTest();
+
+	/** blocks of size 0 are NULL, releasing them does nothing */
+	void testEmptyBlock();
+
+	/** released blocks are handed out again, also beyond the first chunk
+	 *  the blocks do not overlap */
+	void testReuse();
+
+	/** a released block is only reused for blocks of the same size */
+	void testSizes();
+
+};
+
+#endif /* SITECACHEPOOLTEST_H_ */
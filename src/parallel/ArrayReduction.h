@@ -0,0 +1,109 @@
+#ifndef ARRAYREDUCTION_H_
+#define ARRAYREDUCTION_H_
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <vector>
+
+#include "utils/Logger.h"
+
+//! @brief element-wise sum of large contiguous arrays over all processes
+//!
+//! In contrast to CollectiveCommunication, which packs a few values of different
+//! types into one derived datatype, this class is meant for long arrays of a
+//! single type like profiles and histograms. These are reduced with the builtin
+//! MPI_SUM operation on a plain datatype, so the MPI library can use its optimised
+//! reduction algorithms instead of a user defined operation decoding a struct type.
+//!
+//! The result is only available on the root process, except for allreduceSum(). Non-blocking reductions are
+//! started with startReduceSum() and have to be completed with wait() before any
+//! of their buffers is accessed again; with MPI versions before 3.0 they are
+//! executed blocking.
+class ArrayReduction {
+public:
+	~ArrayReduction() {
+		wait();
+	}
+
+	//! sum up sendBuffer of all processes into recvBuffer of the root process.
+	//! Both may be the same array.
+	template<typename T>
+	void reduceSum(const T* sendBuffer, T* recvBuffer, size_t count, int root, MPI_Comm comm) {
+		reduce(sendBuffer, recvBuffer, count, MPI_SUM, root, comm);
+	}
+
+	//! element-wise maximum of sendBuffer over all processes, stored in recvBuffer of the root process
+	template<typename T>
+	void reduceMax(const T* sendBuffer, T* recvBuffer, size_t count, int root, MPI_Comm comm) {
+		reduce(sendBuffer, recvBuffer, count, MPI_MAX, root, comm);
+	}
+
+	//! sum up sendBuffer of all processes into recvBuffer of every process.
+	//! Both may be the same array.
+	template<typename T>
+	void allreduceSum(const T* sendBuffer, T* recvBuffer, size_t count, MPI_Comm comm) {
+		for (size_t offset = 0; offset < count; offset += INT_MAX) {
+			int n = (int) std::min(count - offset, (size_t) INT_MAX);
+			MPI_CHECK( MPI_Allreduce(sendArgument(sendBuffer, recvBuffer, offset, true), recvBuffer + offset,
+					n, type(sendBuffer), MPI_SUM, comm) );
+		}
+	}
+
+	//! non-blocking version of reduceSum()
+	template<typename T>
+	void startReduceSum(const T* sendBuffer, T* recvBuffer, size_t count, int root, MPI_Comm comm) {
+#if MPI_VERSION >= 3
+		int rank;
+		MPI_CHECK( MPI_Comm_rank(comm, &rank) );
+		for (size_t offset = 0; offset < count; offset += INT_MAX) {
+			int n = (int) std::min(count - offset, (size_t) INT_MAX);
+			MPI_Request request;
+			MPI_CHECK( MPI_Ireduce(sendArgument(sendBuffer, recvBuffer, offset, rank == root), recvBuffer + offset,
+					n, type(sendBuffer), MPI_SUM, root, comm, &request) );
+			_requests.push_back(request);
+		}
+#else
+		reduceSum(sendBuffer, recvBuffer, count, root, comm);
+#endif
+	}
+
+	//! complete all reductions started with startReduceSum()
+	void wait() {
+		if (_requests.empty()) {
+			return;
+		}
+		MPI_CHECK( MPI_Waitall((int) _requests.size(), &_requests[0], MPI_STATUSES_IGNORE) );
+		_requests.clear();
+	}
+
+private:
+	template<typename T>
+	void reduce(const T* sendBuffer, T* recvBuffer, size_t count, MPI_Op op, int root, MPI_Comm comm) {
+		int rank;
+		MPI_CHECK( MPI_Comm_rank(comm, &rank) );
+		for (size_t offset = 0; offset < count; offset += INT_MAX) {
+			int n = (int) std::min(count - offset, (size_t) INT_MAX);
+			MPI_CHECK( MPI_Reduce(sendArgument(sendBuffer, recvBuffer, offset, rank == root), recvBuffer + offset,
+					n, type(sendBuffer), op, root, comm) );
+		}
+	}
+
+	static MPI_Datatype type(const double*) { return MPI_DOUBLE; }
+	static MPI_Datatype type(const unsigned long*) { return MPI_UNSIGNED_LONG; }
+
+	//! the root process has to pass MPI_IN_PLACE if the result overwrites the local values
+	template<typename T>
+	static void* sendArgument(const T* sendBuffer, T* recvBuffer, size_t offset, bool isRoot) {
+		if (isRoot && sendBuffer == recvBuffer) {
+			return MPI_IN_PLACE;
+		}
+		return const_cast<T*>(sendBuffer + offset);
+	}
+
+	std::vector<MPI_Request> _requests;
+};
+
+#endif /* ARRAYREDUCTION_H_ */
@@ -1,6 +1,7 @@
 #ifndef DOMAINDECOMPBASE_H_
 #define DOMAINDECOMPBASE_H_
 
+#include <cstddef>
 #include <string>
 
 class Molecule;
@@ -137,6 +138,12 @@ public:
 	//! @param moleculeContainer all Particles from this container will be written to the file
 	void writeMoleculesToFile(std::string filename, ParticleContainer* moleculeContainer);
 
+	//! @brief stores the current decomposition along with a checkpoint, so that a restart
+	//!        can start with it instead of an initial (not yet balanced) decomposition.
+	//!        Decompositions without such state don't write anything.
+	//! @param filename name of the checkpoint file
+	virtual void writeDecompositionCheckpoint(std::string filename) {}
+
 
 	//##################################################################
 	// The following methods with prefix "collComm" are all used
@@ -174,6 +181,26 @@ public:
 	virtual void collCommAllreduceSum() = 0;
 	//! has to call broadcast method of a CollComm class (none in sequential version)
 	virtual void collCommBroadcast(int root = 0) = 0;
+
+	//##################################################################
+	// The following methods reduce large contiguous arrays (profiles,
+	// histograms), for which packing every value into a collComm
+	// would be far too expensive. The result is only valid on the
+	// root process. sendBuffer and recvBuffer may be the same array.
+	//##################################################################
+	//! @brief sums up the arrays of all processes element-wise into recvBuffer on the root process
+	virtual void reduceArraySum(const double* sendBuffer, double* recvBuffer, size_t count, int root = 0) = 0;
+	virtual void reduceArraySum(const unsigned long* sendBuffer, unsigned long* recvBuffer, size_t count, int root = 0) = 0;
+	//! @brief non-blocking version of reduceArraySum. Neither buffer may be
+	//!        accessed before waitArrayReductions() has returned.
+	virtual void startReduceArraySum(const double* sendBuffer, double* recvBuffer, size_t count, int root = 0) = 0;
+	virtual void startReduceArraySum(const unsigned long* sendBuffer, unsigned long* recvBuffer, size_t count, int root = 0) = 0;
+	//! @brief completes all reductions started with startReduceArraySum
+	virtual void waitArrayReductions() = 0;
+	//! @brief element-wise maximum of the arrays of all processes, stored in recvBuffer on the root process
+	virtual void reduceArrayMax(const double* sendBuffer, double* recvBuffer, size_t count, int root = 0) = 0;
+	//! @brief like reduceArraySum, but the sum is stored in recvBuffer on all processes
+	virtual void allreduceArraySum(const double* sendBuffer, double* recvBuffer, size_t count) = 0;
 };
 
 #endif /* DOMAINDECOMPBASE_H_ */
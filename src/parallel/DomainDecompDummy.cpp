@@ -21,6 +21,10 @@ void DomainDecompDummy::readXML(XMLfileUnits& xmlconfig) {
 }
 
 void DomainDecompDummy::exchangeMolecules(ParticleContainer* moleculeContainer, Domain* domain) {
+	if (moleculeContainer->usesPeriodicImages()) {
+		// the container applies the periodic boundary conditions without halo copies
+		return;
+	}
 
 	double rmin[3]; // lower corner of the process-specific domain //ENABLE_MPI
 	double rmax[3];
@@ -1,6 +1,8 @@
 #ifndef DOMAINDECOMPDUMMY_H_
 #define DOMAINDECOMPDUMMY_H_
 
+#include <algorithm>
+
 #include "parallel/DomainDecompBase.h"
 #include "parallel/CollectiveCommDummy.h"
 
@@ -145,7 +147,41 @@ public:
 	void collCommBroadcast(int root = 0) {
 	}
 
+	void reduceArraySum(const double* sendBuffer, double* recvBuffer, size_t count, int root = 0) {
+		copyArray(sendBuffer, recvBuffer, count);
+	}
+
+	void reduceArraySum(const unsigned long* sendBuffer, unsigned long* recvBuffer, size_t count, int root = 0) {
+		copyArray(sendBuffer, recvBuffer, count);
+	}
+
+	void startReduceArraySum(const double* sendBuffer, double* recvBuffer, size_t count, int root = 0) {
+		copyArray(sendBuffer, recvBuffer, count);
+	}
+
+	void startReduceArraySum(const unsigned long* sendBuffer, unsigned long* recvBuffer, size_t count, int root = 0) {
+		copyArray(sendBuffer, recvBuffer, count);
+	}
+
+	void waitArrayReductions() {
+	}
+
+	void reduceArrayMax(const double* sendBuffer, double* recvBuffer, size_t count, int root = 0) {
+		copyArray(sendBuffer, recvBuffer, count);
+	}
+
+	void allreduceArraySum(const double* sendBuffer, double* recvBuffer, size_t count) {
+		copyArray(sendBuffer, recvBuffer, count);
+	}
+
 private:
+	template<typename T>
+	static void copyArray(const T* sendBuffer, T* recvBuffer, size_t count) {
+		if (sendBuffer != recvBuffer) {
+			std::copy(sendBuffer, sendBuffer + count, recvBuffer);
+		}
+	}
+
 	//! Dummy variable for sequential "collective" communication, basically only
 	//! needed to store values and read them again.
 	CollectiveCommDummy _collComm;
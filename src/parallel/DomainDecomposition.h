@@ -3,6 +3,7 @@
 
 #include <mpi.h>
 
+#include "parallel/ArrayReduction.h"
 #include "parallel/CollectiveCommunication.h"
 #include "parallel/DomainDecompBase.h"
 
@@ -200,6 +201,34 @@ public:
 		_collComm.broadcast(root);
 	}
 
+	void reduceArraySum(const double* sendBuffer, double* recvBuffer, size_t count, int root = 0) {
+		_arrayReduction.reduceSum(sendBuffer, recvBuffer, count, root, _comm);
+	}
+
+	void reduceArraySum(const unsigned long* sendBuffer, unsigned long* recvBuffer, size_t count, int root = 0) {
+		_arrayReduction.reduceSum(sendBuffer, recvBuffer, count, root, _comm);
+	}
+
+	void startReduceArraySum(const double* sendBuffer, double* recvBuffer, size_t count, int root = 0) {
+		_arrayReduction.startReduceSum(sendBuffer, recvBuffer, count, root, _comm);
+	}
+
+	void startReduceArraySum(const unsigned long* sendBuffer, unsigned long* recvBuffer, size_t count, int root = 0) {
+		_arrayReduction.startReduceSum(sendBuffer, recvBuffer, count, root, _comm);
+	}
+
+	void waitArrayReductions() {
+		_arrayReduction.wait();
+	}
+
+	void reduceArrayMax(const double* sendBuffer, double* recvBuffer, size_t count, int root = 0) {
+		_arrayReduction.reduceMax(sendBuffer, recvBuffer, count, root, _comm);
+	}
+
+	void allreduceArraySum(const double* sendBuffer, double* recvBuffer, size_t count) {
+		_arrayReduction.allreduceSum(sendBuffer, recvBuffer, count, _comm);
+	}
+
 private:
 	//! determines and returns the rank of the process at the given coordinates
 	int getRank(int x, int y, int z);
@@ -226,6 +255,9 @@ private:
 
 	//! variable used for different kinds of collective operations
 	CollectiveCommunication _collComm;
+
+	//! reductions of large arrays
+	ArrayReduction _arrayReduction;
 };
 
 #endif /* DOMAINDECOMPOSITION_H_ */
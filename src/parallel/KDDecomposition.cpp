@@ -22,7 +22,7 @@ using Log::global_log;
 #define DEBUG_DECOMP
 
 KDDecomposition::KDDecomposition(double cutoffRadius, Domain* domain, int updateFrequency, int fullSearchThreshold)
-		: _steps(0), _frequency(updateFrequency), _fullSearchThreshold(fullSearchThreshold) {
+		: _steps(0), _frequency(updateFrequency), _fullSearchThreshold(fullSearchThreshold), _decompTreeLoaded(false) {
 
 	MPI_CHECK( MPI_Comm_rank(MPI_COMM_WORLD, &_ownRank) );
 	MPI_CHECK( MPI_Comm_size(MPI_COMM_WORLD, &_numProcs) );
@@ -85,6 +85,62 @@ void KDDecomposition::readXML(XMLfileUnits& xmlconfig) {
 	global_log->info() << "KDDecomposition update frequency: " << _frequency << endl;
 	xmlconfig.getNodeValue("fullSearchThreshold", _fullSearchThreshold);
 	global_log->info() << "KDDecomposition full search threshold: " << _fullSearchThreshold << endl;
+	string decompTreeFile;
+	if (xmlconfig.getNodeValue("decompTree", decompTreeFile)) {
+		decompTreeFile.insert(0, xmlconfig.getDir());
+		readDecompTree(decompTreeFile);
+	}
+}
+
+bool KDDecomposition::readDecompTree(const string& filename) {
+	global_log->info() << "KDDecomposition: reading decomposition tree from " << filename << endl;
+	KDNode* tree = NULL;
+	int valid = 0;
+	ifstream test(filename.c_str());
+	if (test.good()) {
+		test.close();
+		tree = new KDNode();
+		tree->deserialize(filename);
+		valid = (tree->_numProcs == _numProcs);
+		for (int dim = 0; dim < KDDIM; dim++) {
+			valid = valid && (tree->_lowCorner[dim] == 0) && (tree->_highCorner[dim] == _globalCellsPerDim[dim] - 1);
+		}
+		for (int rank = 0; valid && rank < _numProcs; rank++) {
+			valid = (tree->findAreaForProcess(rank) != NULL);
+		}
+		if (!valid) {
+			global_log->warning() << "KDDecomposition: decomposition tree in " << filename
+					<< " does not match the number of processes or the cell grid." << endl;
+		}
+	}
+	else {
+		global_log->warning() << "KDDecomposition: could not open decomposition tree file " << filename << endl;
+	}
+	// all processes have to agree, otherwise the neighbour relations are inconsistent
+	int allValid = 0;
+	MPI_CHECK( MPI_Allreduce(&valid, &allValid, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD) );
+	if (!allValid) {
+		global_log->warning() << "KDDecomposition: keeping the initial decomposition." << endl;
+		delete tree;
+		return false;
+	}
+
+	delete _decompTree;
+	_decompTree = tree;
+	_ownArea = _decompTree->findAreaForProcess(_ownRank);
+	_decompTreeLoaded = true;
+#ifdef DEBUG_DECOMP
+	if (_ownRank == 0) {
+		_decompTree->printTree("");
+	}
+#endif
+	return true;
+}
+
+void KDDecomposition::writeDecompositionCheckpoint(string filename) {
+	if (_ownRank == 0) {
+		_decompTree->serialize(filename + ".kdtree");
+	}
 }
 
 void KDDecomposition::exchangeMolecules(ParticleContainer* moleculeContainer, Domain* domain) {
@@ -101,7 +157,11 @@ void KDDecomposition::balanceAndExchange(bool balance, ParticleContainer* molecu
 	KDNode* newDecompTree = NULL;
 	KDNode* newOwnArea = NULL;
 
-	if (_steps % _frequency == 0 || _steps <= 1) {
+	// a decomposition tree read from a checkpoint is already balanced, so the
+	// rebalancing of the first two steps is not necessary
+	const bool rebalance = (_steps % _frequency == 0 || _steps <= 1) && !(_decompTreeLoaded && _steps <= 1);
+
+	if (rebalance) {
 		global_log->info() << "KDDecomposition: rebalancing..." << endl;
 		getNumParticles(moleculeContainer);
 		newDecompTree = new KDNode(_numProcs, &(_decompTree->_lowCorner[0]), &(_decompTree->_highCorner[0]), 0, 0, _decompTree->_coversWholeDomain, 0);
@@ -127,7 +187,7 @@ void KDDecomposition::balanceAndExchange(bool balance, ParticleContainer* molecu
 	vector<int> numMolsToSend; // number of particles to be send to other procs
 	vector<int> numMolsToRecv; // number of particles to be recieved from other procs
 	// collect particles to be send and find out number of particles to be recieved
-	if (_steps % _frequency == 0 || _steps <= 1) {
+	if (rebalance) {
 		int haloCellIdxMin[3]; // Assuming a global 3D Cell index, haloCellIdxMin[3] gives the position
 		// of the low local domain corner within this global 3D cell index
 		int haloCellIdxMax[3]; // same as heloCellIdxMax, only high instead of low Corner
@@ -148,7 +208,7 @@ void KDDecomposition::balanceAndExchange(bool balance, ParticleContainer* molecu
 
 	sendReceiveParticleData(procsToSendTo, procsToRecvFrom, numMolsToSend, numMolsToRecv, particlePtrsToSend, particlesRecvBufs);
 
-	if (_steps % _frequency == 0 || _steps <= 1) {
+	if (rebalance) {
 		// find out new bounding boxes (of newOwnArea)
 		double bBoxMin[3];
 		double bBoxMax[3];
@@ -215,7 +275,7 @@ void KDDecomposition::balanceAndExchange(bool balance, ParticleContainer* molecu
 			continue; // don't exchange data with the own process
 		delete[] particlesRecvBufs[neighbCount];
 	}
-	if (_steps % _frequency == 0 || _steps <= 1) {
+	if (rebalance) {
 		moleculeContainer->update();
 	}
 	particlesRecvBufs.resize(0);
@@ -9,6 +9,7 @@
 #define KDDIM 3
 
 #include "DomainDecompBase.h"
+#include "parallel/ArrayReduction.h"
 #include "parallel/CollectiveCommunication.h"
 
 class ParticleData;
@@ -64,11 +65,28 @@ class KDDecomposition: public DomainDecompBase{
 	   <parallelisation type="KDDecomposition">
 	     <updateFrequency>INTEGER</updateFrequency>
 	     <fullSearchThreshold>INTEGER</fullSearchThreshold>
+	     <decompTree>FILENAME</decompTree> <!-- optional, see readDecompTree() -->
 	   </parallelisation>
 	   \endcode
 	 */
 	virtual void readXML(XMLfileUnits& xmlconfig);
 
+	/** @brief start with a decomposition tree stored along with a checkpoint
+	 *
+	 * Replaces the initial decomposition by the tree in the given file (written by
+	 * writeDecompositionCheckpoint()), so that each process only keeps the particles
+	 * of its already balanced region while reading the phase space, and the
+	 * rebalancing and particle migration of the first two steps are skipped.
+	 * The tree is only used if it was computed for the same number of processes and
+	 * the same cell grid, otherwise the initial decomposition is kept.
+	 * Has to be called before the particle container is created.
+	 * @return true if the tree has been read
+	 */
+	bool readDecompTree(const std::string& filename);
+
+	//! @brief writes the current decomposition tree to <filename>.kdtree (only on rank 0)
+	virtual void writeDecompositionCheckpoint(std::string filename);
+
 	//###############################################
 	//### The following methods are those of the  ###
 	//### base class which have to be implemented ###
@@ -178,6 +196,14 @@ class KDDecomposition: public DomainDecompBase{
 	void collCommAllreduceSum(){ _collComm.allreduceSum(); };
 	void collCommBroadcast(int root = 0){ _collComm.broadcast(root); };
 
+	void reduceArraySum(const double* sendBuffer, double* recvBuffer, size_t count, int root = 0){ _arrayReduction.reduceSum(sendBuffer, recvBuffer, count, root, MPI_COMM_WORLD); };
+	void reduceArraySum(const unsigned long* sendBuffer, unsigned long* recvBuffer, size_t count, int root = 0){ _arrayReduction.reduceSum(sendBuffer, recvBuffer, count, root, MPI_COMM_WORLD); };
+	void startReduceArraySum(const double* sendBuffer, double* recvBuffer, size_t count, int root = 0){ _arrayReduction.startReduceSum(sendBuffer, recvBuffer, count, root, MPI_COMM_WORLD); };
+	void startReduceArraySum(const unsigned long* sendBuffer, unsigned long* recvBuffer, size_t count, int root = 0){ _arrayReduction.startReduceSum(sendBuffer, recvBuffer, count, root, MPI_COMM_WORLD); };
+	void waitArrayReductions(){ _arrayReduction.wait(); };
+	void reduceArrayMax(const double* sendBuffer, double* recvBuffer, size_t count, int root = 0){ _arrayReduction.reduceMax(sendBuffer, recvBuffer, count, root, MPI_COMM_WORLD); };
+	void allreduceArraySum(const double* sendBuffer, double* recvBuffer, size_t count){ _arrayReduction.allreduceSum(sendBuffer, recvBuffer, count, MPI_COMM_WORLD); };
+
 	int getUpdateFrequency() { return _frequency; }
 	void getUpdateFrequency(int frequency) { _frequency = frequency; }
 
@@ -382,6 +408,9 @@ class KDDecomposition: public DomainDecompBase{
 	//! variable used for different kinds of collective operations
 	CollectiveCommunication _collComm;
 
+	//! reductions of large arrays
+	ArrayReduction _arrayReduction;
+
 	/* TODO: This may not be equal to the number simulation steps if balanceAndExchange 
 	 * is not called exactly once in every simulatin step! */
 	//! number of simulation steps. Can be used to trigger load-balancing every _frequency steps
@@ -397,6 +426,9 @@ class KDDecomposition: public DomainDecompBase{
 	 */
 	int _fullSearchThreshold;
 
+	//! true if the decomposition tree has been read from a file (see readDecompTree())
+	bool _decompTreeLoaded;
+
 	// mpi data type for particle data
 	MPI_Datatype _mpi_Particle_data;
 
@@ -6,6 +6,9 @@
  */
 
 #include "parallel/tests/DomainDecompBaseTest.h"
+
+#include <vector>
+
 #include "parallel/DomainDecompDummy.h"
 #include "particleContainer/ParticleContainer.h"
 #include "molecules/Component.h"
@@ -60,3 +63,52 @@ void DomainDecompBaseTest::testExchangeMolecules() {
 	delete container;
 	delete _domainDecomposition;
 }
+
+void DomainDecompBaseTest::testReduceArraySum() {
+	const int rank = _domainDecomposition->getRank();
+	const int numProcs = _domainDecomposition->getNumProcs();
+	const size_t count = 1000;
+
+	std::vector<double> values(count);
+	std::vector<unsigned long> counts(count);
+	std::vector<unsigned long> countsSum(count);
+	for (size_t i = 0; i < count; i++) {
+		values[i] = 0.5 * (rank + 1) + i;
+		counts[i] = rank + i;
+	}
+	_domainDecomposition->reduceArraySum(&values[0], &values[0], count);
+	_domainDecomposition->reduceArraySum(&counts[0], &countsSum[0], count);
+
+	if (rank == 0) {
+		for (size_t i = 0; i < count; i++) {
+			ASSERT_DOUBLES_EQUAL(0.25 * numProcs * (numProcs + 1) + (double) numProcs * i, values[i], 1e-9);
+			ASSERT_EQUAL(numProcs * (numProcs - 1) / 2 + numProcs * i, countsSum[i]);
+		}
+	}
+	// the send buffer must not have been modified
+	ASSERT_EQUAL((unsigned long) rank + 5, counts[5]);
+
+	for (size_t i = 0; i < count; i++) {
+		values[i] = 1.0;
+		counts[i] = 2;
+	}
+	_domainDecomposition->startReduceArraySum(&values[0], &values[0], count);
+	_domainDecomposition->startReduceArraySum(&counts[0], &counts[0], count);
+	_domainDecomposition->waitArrayReductions();
+
+	if (rank == 0) {
+		for (size_t i = 0; i < count; i++) {
+			ASSERT_DOUBLES_EQUAL((double) numProcs, values[i], 1e-12);
+			ASSERT_EQUAL(2ul * numProcs, counts[i]);
+		}
+	}
+
+	// the all-reduction stores the sum on every process
+	for (size_t i = 0; i < count; i++) {
+		values[i] = rank + 1.0;
+	}
+	_domainDecomposition->allreduceArraySum(&values[0], &values[0], count);
+	for (size_t i = 0; i < count; i++) {
+		ASSERT_DOUBLES_EQUAL(0.5 * numProcs * (numProcs + 1), values[i], 1e-12);
+	}
+}
@@ -14,6 +14,7 @@ class DomainDecompBaseTest: public utils::TestWithSimulationSetup {
 
 	TEST_SUITE(DomainDecompBaseTest);
 	TEST_METHOD(testExchangeMolecules);
+	TEST_METHOD(testReduceArraySum);
 	TEST_SUITE_END();
 
 public:
@@ -22,6 +23,12 @@ public:
 	virtual ~DomainDecompBaseTest();
 
 	void testExchangeMolecules();
+
+	/**
+	 * Test the blocking and non-blocking array reductions, both in place and
+	 * into a separate receive buffer, and the all-reduction.
+	 */
+	void testReduceArraySum();
 };
 
 #endif /* DOMAINDECOMPBASETEST_H_ */
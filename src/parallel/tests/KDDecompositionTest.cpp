@@ -8,6 +8,8 @@
 #include "KDDecompositionTest.h"
 #include "Domain.h"
 
+#include <cstdio>
+
 TEST_SUITE_REGISTRATION(KDDecompositionTest);
 
 using namespace std;
@@ -49,3 +51,100 @@ void KDDecompositionTest::testCompleteTreeInfo() {
 	}
 }
 
+
+KDNode* KDDecompositionTest::createUnbalancedTree(int numProcs) {
+	int lowerEnd[] = {0, 0, 0};
+	int upperEnd[] = {19, 19, 19};
+	bool coversAll[] = {true, true, true};
+	KDNode* root = new KDNode(numProcs, lowerEnd, upperEnd, 0, 0, coversAll, 0);
+	if (numProcs > 1) {
+		root->split(0, 2, 1);
+		root->_child2->buildKDTree();
+	}
+	return root;
+}
+
+void KDDecompositionTest::testDecompTreeCheckpoint() {
+	_domain->setGlobalLength(0, 50);
+	_domain->setGlobalLength(1, 50);
+	_domain->setGlobalLength(2, 50);
+	const int numProcs = _domainDecomposition->getNumProcs();
+	const std::string checkpoint("KDDecompositionTest.restart.xdr");
+
+	{
+		KDDecomposition decomposition(2.5, _domain, 1, 10);
+		delete decomposition._decompTree;
+		decomposition._decompTree = createUnbalancedTree(numProcs);
+		decomposition._ownArea = decomposition._decompTree->findAreaForProcess(_rank);
+		decomposition.writeDecompositionCheckpoint(checkpoint);
+		decomposition.barrier();
+	}
+
+	KDNode* expected = createUnbalancedTree(numProcs);
+	KDNode* expectedOwnArea = expected->findAreaForProcess(_rank);
+	{
+		KDDecomposition decomposition(2.5, _domain, 1, 10);
+		ASSERT_TRUE(decomposition.readDecompTree(checkpoint + ".kdtree"));
+		ASSERT_TRUE(decomposition._decompTreeLoaded);
+		ASSERT_TRUE(expected->equals(*decomposition._decompTree));
+		ASSERT_TRUE(expectedOwnArea->equals(*decomposition._ownArea));
+		ASSERT_EQUAL(_rank, decomposition._ownArea->_owningProc);
+		for (int dim = 0; dim < 3; dim++) {
+			ASSERT_DOUBLES_EQUAL(2.5 * expectedOwnArea->_lowCorner[dim], decomposition.getBoundingBoxMin(dim, _domain), 1e-12);
+			ASSERT_DOUBLES_EQUAL(2.5 * (expectedOwnArea->_highCorner[dim] + 1), decomposition.getBoundingBoxMax(dim, _domain), 1e-12);
+		}
+		for (int rank = 0; rank < numProcs; rank++) {
+			ASSERT_TRUE(expected->findAreaForProcess(rank)->equals(*decomposition._decompTree->findAreaForProcess(rank)));
+		}
+		decomposition.barrier();
+	}
+	delete expected;
+
+	if (_rank == 0) {
+		remove((checkpoint + ".kdtree").c_str());
+	}
+}
+
+void KDDecompositionTest::testDecompTreeMismatch() {
+	_domain->setGlobalLength(0, 50);
+	_domain->setGlobalLength(1, 50);
+	_domain->setGlobalLength(2, 50);
+	const int numProcs = _domainDecomposition->getNumProcs();
+	const std::string otherProcs("KDDecompositionTest_procs.kdtree");
+	const std::string otherGrid("KDDecompositionTest_grid.kdtree");
+
+	if (_rank == 0) {
+		KDNode* tree = createUnbalancedTree(numProcs + 1);
+		tree->serialize(otherProcs);
+		delete tree;
+		// the grid of a cutoff radius of 5.0 instead of 2.5
+		int lowerEnd[] = {0, 0, 0};
+		int upperEnd[] = {9, 9, 9};
+		bool coversAll[] = {true, true, true};
+		KDNode grid(numProcs, lowerEnd, upperEnd, 0, 0, coversAll, 0);
+		grid.buildKDTree();
+		grid.serialize(otherGrid);
+	}
+
+	const std::string files[] = { otherProcs, otherGrid, "KDDecompositionTest_missing.kdtree" };
+	for (int i = 0; i < 3; i++) {
+		KDDecomposition decomposition(2.5, _domain, 1, 10);
+		decomposition.barrier();
+		int lowerEnd[] = {0, 0, 0};
+		int upperEnd[] = {19, 19, 19};
+		bool coversAll[] = {true, true, true};
+		KDNode expected(numProcs, lowerEnd, upperEnd, 0, 0, coversAll, 0);
+		expected.buildKDTree();
+
+		ASSERT_TRUE(! decomposition.readDecompTree(files[i]));
+		ASSERT_TRUE(! decomposition._decompTreeLoaded);
+		ASSERT_TRUE(expected.equals(*decomposition._decompTree));
+		ASSERT_TRUE(decomposition._ownArea == decomposition._decompTree->findAreaForProcess(_rank));
+		decomposition.barrier();
+	}
+
+	if (_rank == 0) {
+		remove(otherProcs.c_str());
+		remove(otherGrid.c_str());
+	}
+}
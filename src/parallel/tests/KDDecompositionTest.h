@@ -15,6 +15,8 @@ class KDDecompositionTest : public utils::TestWithSimulationSetup {
 
 	TEST_SUITE(KDDecompositionTest);
 	TEST_METHOD(testCompleteTreeInfo);
+	TEST_METHOD(testDecompTreeCheckpoint);
+	TEST_METHOD(testDecompTreeMismatch);
 	TEST_SUITE_END();
 
 public:
@@ -25,11 +27,33 @@ public:
 
 	void testCompleteTreeInfo();
 
+	/**
+	 * Writes an unbalanced tree with writeDecompositionCheckpoint() and reads it
+	 * with readDecompTree() into a new decomposition, which then has to have the
+	 * same tree, own area and bounding box.
+	 */
+	void testDecompTreeCheckpoint();
+
+	/**
+	 * Trees for a different number of processes or a different cell grid, and
+	 * missing files, are rejected and the initial decomposition is kept.
+	 */
+	void testDecompTreeMismatch();
+
 	/**
 	 * Initial implementation of completeTreeInfo(). Kept to test the new / current
 	 * implementation against it.
 	 */
 	void completeTreeInfo(KDNode*& root, KDNode*& ownArea, int ownRank);
+
+private:
+
+	/**
+	 * A tree of 20x20x20 cells which is not the initial decomposition: process 0
+	 * gets the first three layers of cells in x direction, the other processes
+	 * share the rest.
+	 */
+	KDNode* createUnbalancedTree(int numProcs);
 };
 
 #endif /* KDDECOMPOSITIONTEST_H_ */
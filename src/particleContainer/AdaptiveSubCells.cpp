@@ -74,6 +74,7 @@ AdaptiveSubCells::AdaptiveSubCells(
 	// initially, zero updates were performed:
 	_numberOfUpdates = 0;
 	_cellsValid = false;
+	_fullUpdateRequired = true;
 }
 
 
@@ -159,11 +160,18 @@ void AdaptiveSubCells::rebuild(double bBoxMin[3], double bBoxMax[3]) {
 		}
 	}
 	_cellsValid = false;
+	_fullUpdateRequired = true;
 }
 
 
 void AdaptiveSubCells::update() {
 
+	if (_cellsValid && !_fullUpdateRequired && _numberOfUpdates % 1000 != 0) {
+		updateMovedParticles();
+		_numberOfUpdates++;
+		return;
+	}
+
 	// the _cells vector is only needed in order to compute _localRho[] for each coarse grid cell. So we need to initialize _cells in 1 of 1000 timesteps only
 	// FIXME: introduce global variabel instead of fixed numer '1000'
 	if (_numberOfUpdates % 1000 == 0) {
@@ -217,6 +225,29 @@ void AdaptiveSubCells::update() {
 	// increas number of performed updates
 	_numberOfUpdates++;
 	_cellsValid = true;
+	_fullUpdateRequired = false;
+}
+
+void AdaptiveSubCells::updateMovedParticles() {
+	for (unsigned long subIndex = 0; subIndex < _subCells.size(); subIndex++) {
+		std::vector<Molecule*>& molecules = _subCells[subIndex].getParticlePointers();
+		// compact the particles staying in this subCell, keeping their order
+		size_t numStaying = 0;
+		for (size_t i = 0; i < molecules.size(); i++) {
+			Molecule* molecule = molecules[i];
+			int newSubIndex = getSubCellIndexOfMolecule(molecule);
+			if (newSubIndex == (int) subIndex) {
+				molecules[numStaying++] = molecule;
+				continue;
+			}
+			if (newSubIndex < (int) 0 || newSubIndex >= (int) _subCells.size()) {
+				global_log->error() << "Found invalid index in AdaptiveSubCells::updateMovedParticles()." << endl;
+				exit(1);
+			}
+			_subCells[newSubIndex].addParticle(molecule);
+		}
+		molecules.resize(numStaying);
+	}
 }
 
 void AdaptiveSubCells::addParticle(Molecule& particle) {
@@ -338,7 +369,7 @@ void AdaptiveSubCells::deleteMolecule(unsigned long molid, double x, double y, d
 }
 
 
-void AdaptiveSubCells::traverseCells(CellProcessor& cellProcessor) {
+void AdaptiveSubCells::traverseCells(CellProcessor& cellProcessor, TimerRegistry* /* timers */) {
 	if (_cellsValid == false) {
 		global_log->error() << "Cell structure in LinkedCells (traversePairs) invalid, call update first" << endl;
 		exit(1);
@@ -438,44 +469,26 @@ void AdaptiveSubCells::traverseCells(CellProcessor& cellProcessor) {
 
 double AdaptiveSubCells::getEnergy(ParticlePairsHandler* particlePairsHandler, Molecule* m1, CellProcessor& cellProcessor)
 {
-	double u = 0.0;
-
 	unsigned long subCellIndex = getSubCellIndexOfMolecule(m1);
-	ParticleCell& currentSubCell = _subCells[subCellIndex];
 	vector<unsigned long>::iterator neighbourOffsetsIter;
-	cellProcessor.initTraversal(_maxNeighbourOffset + _minNeighbourOffset + 1);
-
-	// extend the window of cells with cache activated
-	for (unsigned int windowCellIndex = subCellIndex - _minNeighbourOffset; windowCellIndex < subCellIndex + _maxNeighbourOffset+1 ; windowCellIndex++) {
-		cellProcessor.preprocessCell(_cells[windowCellIndex]);
-	}
 
 	if (m1->numTersoff() > 0) {
 		global_log->error() << "The grand canonical ensemble is not implemented for solids.\n";
 		exit(848);
 	}
-	u += cellProcessor.processSingleMolecule(m1, currentSubCell);
 
-	// forward neighbours
-	for (neighbourOffsetsIter = _forwardNeighbourSubOffsets[subCellIndex].begin(); neighbourOffsetsIter != _forwardNeighbourSubOffsets[subCellIndex].end(); neighbourOffsetsIter++)
-	{
-		ParticleCell& neighbourCell = _subCells[subCellIndex + *neighbourOffsetsIter];
-		u += cellProcessor.processSingleMolecule(m1, neighbourCell);
+	// only the sub cell of the molecule and its neighbours are handed to the cell processor
+	vector<ParticleCell*> cells;
+	cells.reserve(_forwardNeighbourSubOffsets[subCellIndex].size() + _backwardNeighbourSubOffsets[subCellIndex].size() + 1);
+	cells.push_back(&_subCells[subCellIndex]);
+	for (neighbourOffsetsIter = _forwardNeighbourSubOffsets[subCellIndex].begin(); neighbourOffsetsIter != _forwardNeighbourSubOffsets[subCellIndex].end(); neighbourOffsetsIter++) {
+		cells.push_back(&_subCells[subCellIndex + *neighbourOffsetsIter]);
 	}
-	// backward neighbours
-	for (neighbourOffsetsIter = _backwardNeighbourSubOffsets[subCellIndex].begin(); neighbourOffsetsIter != _backwardNeighbourSubOffsets[subCellIndex].end(); neighbourOffsetsIter++)
-	{
-		ParticleCell& neighbourCell = _subCells[subCellIndex + *neighbourOffsetsIter];  // minus oder plus?
-		u += cellProcessor.processSingleMolecule(m1, neighbourCell);
-	}
-	
-	// close the window of cells activated
-	for (unsigned int windowCellIndex = subCellIndex - _minNeighbourOffset; windowCellIndex < subCellIndex + _maxNeighbourOffset+1; windowCellIndex++) {
-		cellProcessor.postprocessCell(_cells[windowCellIndex]);
+	for (neighbourOffsetsIter = _backwardNeighbourSubOffsets[subCellIndex].begin(); neighbourOffsetsIter != _backwardNeighbourSubOffsets[subCellIndex].end(); neighbourOffsetsIter++) {
+		cells.push_back(&_subCells[subCellIndex + *neighbourOffsetsIter]);  // minus oder plus?
 	}
 
-	cellProcessor.endTraversal();
-	return u;
+	return cellProcessor.trialEnergy(m1, cells);
 }
 
 unsigned long AdaptiveSubCells::getNumberOfParticles() {
@@ -515,6 +528,8 @@ Molecule* AdaptiveSubCells::end() {
 // this method remains unchanged
 
 Molecule* AdaptiveSubCells::deleteCurrent() {
+	// the subCell of the particle still points to it
+	_fullUpdateRequired = true;
 	_particleIter = _particles.erase(_particleIter);
 	if (_particleIter != _particles.end()) {
 		return &(*_particleIter);
@@ -536,6 +551,13 @@ void AdaptiveSubCells::deleteOuterParticles() {
 	//std::list<Molecule*>::iterator molIter1;
 	for (subCellIndexIter = _haloSubCellIndices.begin(); subCellIndexIter != _haloSubCellIndices.end(); subCellIndexIter++) {
 		ParticleCell& currentSubCell = _subCells[*subCellIndexIter];
+		// a molecule on the boundary of the bounding box may be sorted into a halo cell by
+		// rounding. It is not deleted below, so the next update has to sort it again.
+		std::vector<Molecule*>& molecules = currentSubCell.getParticlePointers();
+		for (size_t i = 0; i < molecules.size() && !_fullUpdateRequired; i++) {
+			double r[3] = { molecules[i]->r(0), molecules[i]->r(1), molecules[i]->r(2) };
+			_fullUpdateRequired = isInBoundingBox(r);
+		}
 		currentSubCell.removeAllParticles();
 	}
 
@@ -1169,6 +1191,7 @@ void AdaptiveSubCells::grandcanonicalStep(ChemicalPotential* mu, double T, Domai
 	bool hasInsertion = true;
 	double ins[3];
 	unsigned nextid = 0;
+	cellProcessor.initTrials();
 	while (hasDeletion || hasInsertion) {
 		if (hasDeletion)
 			hasDeletion = mu->getDeletion(this, minco, maxco);
@@ -1182,6 +1205,7 @@ void AdaptiveSubCells::grandcanonicalStep(ChemicalPotential* mu, double T, Domai
 			else global_log->debug() << "   (r" << mu->rank() << "-d" << m->id() << ")" << endl;
 #endif
 			if (accept) {
+				cellProcessor.invalidateTrialCell(_subCells[getSubCellIndexOfMolecule(m)]);
 				m->upd_cache();
 				// reset forces and momenta to zero
 				{
@@ -1230,8 +1254,9 @@ void AdaptiveSubCells::grandcanonicalStep(ChemicalPotential* mu, double T, Domai
 			<< " at the reduced position (" << ins[0] << "/" << ins[1] << "/" << ins[2] << ")? " << endl;
 #endif
 
+			// the test molecule is only added to its cell if the insertion is accepted,
+			// so the data the cell processor keeps for the cells stays valid otherwise
 			unsigned long cellid = this->getCellIndexOfMolecule(m);
-			_cells[cellid].addParticle(m);
 			DeltaUpot = getEnergy(&particlePairsHandler, m, cellProcessor);
                         domain->submitDU(mu->getComponentID(), DeltaUpot, ins);
 			accept = mu->decideInsertion(DeltaUpot / T);
@@ -1241,17 +1266,17 @@ void AdaptiveSubCells::grandcanonicalStep(ChemicalPotential* mu, double T, Domai
 			else global_log->debug() << "   (r" << mu->rank() << "-i" << mit->id() << ")" << endl;
 #endif
 			if (accept) {
+				_cells[cellid].addParticle(m);
+				cellProcessor.invalidateTrialCell(_subCells[getSubCellIndexOfMolecule(m)]);
 				_localInsertionsMinusDeletions++;
 			}
 			else {
-			//	deleteMolecule(m->id(), m->r(0), m->r(1), m->r(2));
-				this->_cells[cellid].deleteMolecule(m->id());
-
 				mit->check(m->id());
 				_particles.erase(mit);
 			}
 		}
 	}
+	cellProcessor.endTrials();
 	for (m = this->begin(); m != this->end(); m = this->next()) {
 #ifndef NDEBUG
 		m->check(m->id());
@@ -77,6 +77,9 @@ public:
 	//! first all cells are cleared and then filled again depending on the spacial position
 	//! of the molecules. After the update, exactly one pointer for each particle in this
 	//! ParticleContainer is in it's corresponding cell.
+	//! Between two adaptions of the datastructure, only the particles which left their
+	//! subCell are moved to their new subCell if the subCells were valid before
+	//! (see updateMovedParticles()).
 	void update();
 
 	//! @brief Insert a single molecule.
@@ -98,7 +101,7 @@ public:
 	//! @param particlePairsHandler specified concrete action to be done for each pair
 //	void traversePairs(ParticlePairsHandler* particlePairsHandler);
 
-	void traverseCells(CellProcessor& cellProcessor);
+	void traverseCells(CellProcessor& cellProcessor, TimerRegistry* timers = NULL);
 
 	//! @return the number of particles stored in the Linked Cells
 	unsigned long getNumberOfParticles();
@@ -232,6 +235,13 @@ private:
 	//! the index offset of two coarse of "meta" cellsin the vector _subCells
 	void calculateMetaCellIndex();
 
+	//! @brief Move the particles which left their subCell to their new subCell.
+	//!
+	//! Each particle is checked against the subCell it is stored in, the
+	//! others keep their place and order. Only valid if every particle is in
+	//! exactly one subCell and the subCells did not change since the last update.
+	void updateMovedParticles();
+
 	//! @brief calculates the density for each coarse Cell separately
 	//! @todo: currently, not the density but the number of particles
 	//!        is calculated. To change that (or even if it is not changed),
@@ -318,6 +328,11 @@ private:
 	//! should be set to true.
 	bool _cellsValid;
 
+	//! True if update() has to sort all particles into the subCells again, e.g. after
+	//! rebuild() or deleteCurrent(), which leaves the pointer in the subCell, or if
+	//! deleteOuterParticles() removed a particle inside the bounding box from a halo subCell.
+	bool _fullUpdateRequired;
+
 	//! Vector containing the density value of each coarse cell
 	std::vector<double> _localRho;
 
@@ -1,17 +1,22 @@
 
 #include "particleContainer/LinkedCells.h"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 #include "Domain.h"
 #include "ensemble/GrandCanonical.h"
+#include "ensemble/OverlapGrid.h"
 #include "parallel/DomainDecompBase.h"
 #include "particleContainer/adapter/ParticlePairs2PotForceAdapter.h"
 #include "particleContainer/handlerInterfaces/ParticlePairsHandler.h"
 #include "particleContainer/adapter/CellProcessor.h"
+#include "particleContainer/adapter/ProfileSampler.h"
 #include "ParticleCell.h"
 #include "molecules/Molecule.h"
 #include "utils/Logger.h"
+#include "utils/TimerRegistry.h"
 
 using namespace std;
 using Log::global_log;
@@ -27,6 +32,7 @@ LinkedCells::LinkedCells(
 )
 		: ParticleContainer(bBoxMin, bBoxMax) {
 	int numberOfCells = 1;
+	_periodicImages = false;
 	_cutoffRadius = cutoffRadius;
 	_LJCutoffRadius = LJCutoffRadius;
 
@@ -73,6 +79,7 @@ LinkedCells::LinkedCells(
 	initializeCells();
 	calculateNeighbourIndices();
 	_cellsValid = false;
+	_fullUpdateRequired = true;
 }
 
 
@@ -82,6 +89,9 @@ LinkedCells::~LinkedCells() {
 void LinkedCells::readXML(XMLfileUnits& xmlconfig) {
 	xmlconfig.getNodeValue("cellsInCutoffRadius", _cellsInCutoff);
 	global_log->info() << "Cells in cut-off radius: " << _cellsInCutoff << endl;
+	// the cells are set up by rebuild() afterwards
+	xmlconfig.getNodeValue("periodicImages", _periodicImages);
+	global_log->info() << "Periodic images in the halo cells: " << (_periodicImages ? "enabled" : "disabled") << endl;
 }
 
 void LinkedCells::rebuild(double bBoxMin[3], double bBoxMax[3]) {
@@ -154,23 +164,102 @@ void LinkedCells::rebuild(double bBoxMin[3], double bBoxMax[3]) {
 		}
 	}
 	_cellsValid = false;
+	_fullUpdateRequired = true;
 }
 
 void LinkedCells::update() {
-	// clear all Cells
-	std::vector<ParticleCell>::iterator celliter;
-	for (celliter = (_cells).begin(); celliter != (_cells).end(); ++celliter) {
-		(*celliter).removeAllParticles();
+	if (_periodicImages) {
+		// the halo cells only hold the periodic images, which are set up again below
+		for (size_t i = 0; i < _haloCellIndices.size(); i++) {
+			_cells[_haloCellIndices[i]].removeAllParticles();
+		}
+	}
+
+	if (_cellsValid && !_fullUpdateRequired) {
+		updateMovedParticles();
+	}
+	else {
+		// clear all Cells
+		std::vector<ParticleCell>::iterator celliter;
+		for (celliter = (_cells).begin(); celliter != (_cells).end(); ++celliter) {
+			(*celliter).removeAllParticles();
+		}
+
+		std::list<Molecule>::iterator pos;
+		for (pos = _particles.begin(); pos != _particles.end(); ++pos) {
+			// determine the cell into which the particle belongs
+			Molecule &m = *pos;
+			unsigned long index = getCellIndexOfMolecule(&m);
+			_cells[index].addParticle(&(*pos));
+		}
+		_cellsValid = true;
+		_fullUpdateRequired = false;
+	}
+
+	if (_periodicImages) {
+		updatePeriodicImages();
+	}
+}
+
+void LinkedCells::updateMovedParticles() {
+	for (unsigned long cellIndex = 0; cellIndex < _cells.size(); cellIndex++) {
+		std::vector<Molecule*>& molecules = _cells[cellIndex].getParticlePointers();
+		// compact the particles staying in this cell, keeping their order
+		size_t numStaying = 0;
+		for (size_t i = 0; i < molecules.size(); i++) {
+			Molecule* molecule = molecules[i];
+			unsigned long index = getCellIndexOfMolecule(molecule);
+			if (index == cellIndex) {
+				molecules[numStaying++] = molecule;
+			}
+			else {
+				// a particle moved to a cell not yet visited is checked there again, which is harmless
+				_cells[index].addParticle(molecule);
+			}
+		}
+		molecules.resize(numStaying);
 	}
+}
 
-	std::list<Molecule>::iterator pos;
-	for (pos = _particles.begin(); pos != _particles.end(); ++pos) {
-		// determine the cell into which the particle belongs
-		Molecule &m = *pos;
-		unsigned long index = getCellIndexOfMolecule(&m);
-		_cells[index].addParticle(&(*pos));
+void LinkedCells::updatePeriodicImages() {
+	// the molecules in the halo cells left the bounding box since the last update
+	for (size_t i = 0; i < _haloCellIndices.size(); i++) {
+		std::vector<Molecule*>& molecules = _cells[_haloCellIndices[i]].getParticlePointers();
+		for (size_t j = 0; j < molecules.size(); j++) {
+			unsigned long index = moveIntoBoundingBox(molecules[j]);
+			_cells[index].addParticle(molecules[j]);
+		}
+		molecules.clear();
+	}
+
+	for (size_t i = 0; i < _haloCellIndices.size(); i++) {
+		_cells[_haloCellIndices[i]].getParticlePointers() = _cells[_periodicImageIndices[i]].getParticlePointers();
 	}
-	_cellsValid = true;
+}
+
+unsigned long LinkedCells::moveIntoBoundingBox(Molecule* molecule) {
+	int cellIndex[3];
+	for (int d = 0; d < 3; d++) {
+		// the same shift as for the copies of the molecules created by DomainDecompDummy
+		const double length = _boundingBoxMax[d] - _boundingBoxMin[d];
+		if (molecule->r(d) < _boundingBoxMin[d]) {
+			molecule->setr(d, molecule->r(d) + length);
+		}
+		if (molecule->r(d) >= _boundingBoxMax[d]) {
+			molecule->setr(d, molecule->r(d) - length);
+		}
+		// a molecule on the boundary of the bounding box may be sorted into a halo cell by rounding
+		cellIndex[d] = (int) floor((molecule->r(d) - _haloBoundingBoxMin[d]) / _cellLength[d]);
+		cellIndex[d] = max(cellIndex[d], _haloWidthInNumCells[d]);
+		cellIndex[d] = min(cellIndex[d], _cellsPerDimension[d] - _haloWidthInNumCells[d] - 1);
+	}
+	return cellIndexOf3DIndex(cellIndex[0], cellIndex[1], cellIndex[2]);
+}
+
+void LinkedCells::setPeriodicImages(bool periodicImages) {
+	_periodicImages = periodicImages;
+	initializePeriodicImages();
+	_fullUpdateRequired = true;
 }
 
 void LinkedCells::addParticle(Molecule& particle) {
@@ -190,7 +279,14 @@ void LinkedCells::addParticle(Molecule& particle) {
 		 * container anyway, it is just not sorted into the cells. But as the container is not valid,
 		 * update() has to be called anyway.
 		 */
-		if (_cellsValid) {
+		if (_periodicImages) {
+			// the halo cells only hold periodic images
+			unsigned long cellIndex = moveIntoBoundingBox(&(_particles.front()));
+			if (_cellsValid) {
+				_cells[cellIndex].addParticle(&(_particles.front()));
+			}
+		}
+		else if (_cellsValid) {
 			int cellIndex = getCellIndexOfMolecule(&particle);
 			_cells[cellIndex].addParticle(&(_particles.front()));
 		}
@@ -284,7 +380,7 @@ unsigned LinkedCells::countParticles(unsigned int cid, double* cbottom, double*
 }
 
 
-void LinkedCells::traverseCells(CellProcessor& cellProcessor) {
+void LinkedCells::traverseCells(CellProcessor& cellProcessor, TimerRegistry* timers) {
 	if (_cellsValid == false) {
 		global_log->error() << "Cell structure in LinkedCells (traversePairs) invalid, call update first" << endl;
 		exit(1);
@@ -297,6 +393,12 @@ void LinkedCells::traverseCells(CellProcessor& cellProcessor) {
 	global_log->debug() << "_minNeighbourOffset=" << _minNeighbourOffset << "; _maxNeighbourOffset=" << _maxNeighbourOffset<< endl;
 #endif
 
+	// the time spent on boundary and halo cells is measured separately,
+	// the remainder of the traversal is attributed to the inner cells
+	double traversalStart = TimerRegistry::wallTime();
+	double boundaryTime = 0.0;
+	double haloTime = 0.0;
+
 	cellProcessor.initTraversal(_maxNeighbourOffset + _minNeighbourOffset +1);
 	// open the window of cells activated
 	for (long int cellIndex = 0; cellIndex < _maxNeighbourOffset; cellIndex++) {
@@ -322,6 +424,7 @@ void LinkedCells::traverseCells(CellProcessor& cellProcessor) {
 		}
 
 		if (currentCell.isHaloCell()) {
+			double haloStart = TimerRegistry::wallTime();
 			cellProcessor.processCell(currentCell);
 			for (neighbourOffsetsIter = _forwardNeighbourOffsets.begin(); neighbourOffsetsIter != _forwardNeighbourOffsets.end(); neighbourOffsetsIter++) {
 				long int neighbourCellIndex = cellIndex + *neighbourOffsetsIter;
@@ -333,10 +436,12 @@ void LinkedCells::traverseCells(CellProcessor& cellProcessor) {
 
 				cellProcessor.processCellPair(currentCell, neighbourCell);
 			}
+			haloTime += TimerRegistry::wallTime() - haloStart;
 		}
 
 		// loop over all boundary cells and calculate forces to forward and backward neighbours
 		if (currentCell.isBoundaryCell()) {
+			double boundaryStart = TimerRegistry::wallTime();
 			cellProcessor.processCell(currentCell);
 
 			// loop over all forward neighbours
@@ -353,6 +458,7 @@ void LinkedCells::traverseCells(CellProcessor& cellProcessor) {
 					cellProcessor.processCellPair(currentCell, neighbourCell);
 				}
 			}
+			boundaryTime += TimerRegistry::wallTime() - boundaryStart;
 		} // if ( isBoundaryCell() )
 
 		// narrow the window of cells activated
@@ -366,6 +472,38 @@ void LinkedCells::traverseCells(CellProcessor& cellProcessor) {
 			cellProcessor.postprocessCell(_cells[cellIndex]);
 	}
 	cellProcessor.endTraversal();
+
+	if (timers != NULL) {
+		timers->addTime("inner_cells", TimerRegistry::wallTime() - traversalStart - boundaryTime - haloTime);
+		timers->addTime("boundary_cells", boundaryTime);
+		timers->addTime("halo_cells", haloTime);
+	}
+}
+
+void LinkedCells::sampleProfile(ProfileSampler& sampler) {
+	if (_cellsValid == false) {
+		ParticleContainer::sampleProfile(sampler);
+		return;
+	}
+
+	double cellMin[3], cellMax[3];
+	for (int iz = _haloWidthInNumCells[2]; iz < _cellsPerDimension[2] - _haloWidthInNumCells[2]; iz++) {
+		cellMin[2] = _haloBoundingBoxMin[2] + iz * _cellLength[2];
+		cellMax[2] = cellMin[2] + _cellLength[2];
+		for (int iy = _haloWidthInNumCells[1]; iy < _cellsPerDimension[1] - _haloWidthInNumCells[1]; iy++) {
+			cellMin[1] = _haloBoundingBoxMin[1] + iy * _cellLength[1];
+			cellMax[1] = cellMin[1] + _cellLength[1];
+			for (int ix = _haloWidthInNumCells[0]; ix < _cellsPerDimension[0] - _haloWidthInNumCells[0]; ix++) {
+				ParticleCell& cell = _cells[cellIndexOf3DIndex(ix, iy, iz)];
+				if (cell.getMoleculeCount() == 0) {
+					continue;
+				}
+				cellMin[0] = _haloBoundingBoxMin[0] + ix * _cellLength[0];
+				cellMax[0] = cellMin[0] + _cellLength[0];
+				sampler.sampleCell(cell.getParticlePointers(), cellMin, cellMax);
+			}
+		}
+	}
 }
 
 unsigned long LinkedCells::getNumberOfParticles() {
@@ -406,6 +544,8 @@ void LinkedCells::clear() {
 
 
 Molecule* LinkedCells::deleteCurrent() {
+	// the cell of the particle still points to it
+	_fullUpdateRequired = true;
 	_particleIter = _particles.erase(_particleIter);
 	if (_particleIter != _particles.end()) {
 		return &(*_particleIter);
@@ -425,6 +565,14 @@ void LinkedCells::deleteOuterParticles() {
 	//std::list<Molecule*>::iterator molIter1;
 	for (cellIndexIter = _haloCellIndices.begin(); cellIndexIter != _haloCellIndices.end(); cellIndexIter++) {
 		ParticleCell& currentCell = _cells[*cellIndexIter];
+		// a molecule on the boundary of the bounding box may be sorted into a halo cell by
+		// rounding. It is not deleted below, so the next update has to sort it again.
+		// The periodic images are the molecules of the boundary cells anyway.
+		std::vector<Molecule*>& molecules = currentCell.getParticlePointers();
+		for (size_t i = 0; i < molecules.size() && !_fullUpdateRequired && !_periodicImages; i++) {
+			double r[3] = { molecules[i]->r(0), molecules[i]->r(1), molecules[i]->r(2) };
+			_fullUpdateRequired = isInBoundingBox(r);
+		}
 		currentCell.removeAllParticles();
 	}
 
@@ -560,6 +708,37 @@ void LinkedCells::initializeCells() {
 			}
 		}
 	}
+	initializePeriodicImages();
+}
+
+void LinkedCells::initializePeriodicImages() {
+	_periodicImageIndices.resize(_haloCellIndices.size());
+	for (size_t i = 0; i < _haloCellIndices.size(); i++) {
+		long int cellIndex = _haloCellIndices[i];
+		int index[3];
+		index[0] = cellIndex % _cellsPerDimension[0];
+		index[1] = (cellIndex / _cellsPerDimension[0]) % _cellsPerDimension[1];
+		index[2] = cellIndex / (_cellsPerDimension[0] * _cellsPerDimension[1]);
+		double shift[3];
+		for (int d = 0; d < 3; d++) {
+			const int innerWidth = _cellsPerDimension[d] - 2 * _haloWidthInNumCells[d];
+			const double length = _boundingBoxMax[d] - _boundingBoxMin[d];
+			shift[d] = 0.0;
+			if (index[d] < _haloWidthInNumCells[d]) {
+				index[d] += innerWidth;
+				shift[d] = -length;
+			}
+			else if (index[d] >= _cellsPerDimension[d] - _haloWidthInNumCells[d]) {
+				index[d] -= innerWidth;
+				shift[d] = length;
+			}
+		}
+		_periodicImageIndices[i] = cellIndexOf3DIndex(index[0], index[1], index[2]);
+		if (!_periodicImages) {
+			shift[0] = shift[1] = shift[2] = 0.0;
+		}
+		_cells[cellIndex].setPeriodicShift(shift);
+	}
 }
 
 void LinkedCells::calculateNeighbourIndices() {
@@ -661,47 +840,97 @@ void LinkedCells::deleteMolecule(unsigned long molid, double x, double y, double
 }
 
 
-double LinkedCells::getEnergy(ParticlePairsHandler* particlePairsHandler, Molecule* m1, CellProcessor& cellProcessor) {
-
-	double u = 0.0;
+void LinkedCells::getTrialCells(unsigned long cellIndex, vector<ParticleCell*>& cells) {
 	vector<long int>::iterator neighbourOffsetsIter;
 
-	unsigned long cellIndex = getCellIndexOfMolecule(m1);
-	ParticleCell& currentCell = _cells[cellIndex];
-
-	cellProcessor.initTraversal(_maxNeighbourOffset + _minNeighbourOffset + 1);
+	cells.clear();
+	cells.reserve(_forwardNeighbourOffsets.size() + _backwardNeighbourOffsets.size() + 1);
+	cells.push_back(&_cells[cellIndex]);
+	for (neighbourOffsetsIter = _forwardNeighbourOffsets.begin(); neighbourOffsetsIter != _forwardNeighbourOffsets.end(); neighbourOffsetsIter++) {
+		cells.push_back(&_cells[cellIndex + *neighbourOffsetsIter]);
+	}
+	for (neighbourOffsetsIter = _backwardNeighbourOffsets.begin(); neighbourOffsetsIter != _backwardNeighbourOffsets.end(); neighbourOffsetsIter++) {
+		cells.push_back(&_cells[cellIndex - *neighbourOffsetsIter]);
+	}
+}
 
-	// extend the window of cells with cache activated
-	for (unsigned int windowCellIndex = cellIndex - _minNeighbourOffset; windowCellIndex < cellIndex + _maxNeighbourOffset+1 ; windowCellIndex++) {
-		cellProcessor.preprocessCell(_cells[windowCellIndex]);
+bool LinkedCells::inNeighbourhood(unsigned long cellIndex1, unsigned long cellIndex2) const {
+	long int index1 = cellIndex1;
+	long int index2 = cellIndex2;
+	for (int d = 0; d < 3; d++) {
+		long int diff = index1 % _cellsPerDimension[d] - index2 % _cellsPerDimension[d];
+		if (abs(diff) > _haloWidthInNumCells[d]) {
+			return false;
+		}
+		index1 /= _cellsPerDimension[d];
+		index2 /= _cellsPerDimension[d];
 	}
+	return true;
+}
+
+double LinkedCells::getEnergy(ParticlePairsHandler* particlePairsHandler, Molecule* m1, CellProcessor& cellProcessor) {
+
+	unsigned long cellIndex = getCellIndexOfMolecule(m1);
 
 	if (m1->numTersoff() > 0) {
 		global_log->error() << "The grand canonical ensemble is not implemented for solids." << endl;
 		exit(484);
 	}
-	u += cellProcessor.processSingleMolecule(m1, currentCell);
 
-	// forward neighbours
-	for (neighbourOffsetsIter = _forwardNeighbourOffsets.begin(); neighbourOffsetsIter != _forwardNeighbourOffsets.end(); neighbourOffsetsIter++)
-	{
-		ParticleCell& neighbourCell = _cells[cellIndex + *neighbourOffsetsIter];
-		u += cellProcessor.processSingleMolecule(m1, neighbourCell);
-	}
-	// backward neighbours
-	for (neighbourOffsetsIter = _backwardNeighbourOffsets.begin(); neighbourOffsetsIter != _backwardNeighbourOffsets.end(); neighbourOffsetsIter++)
-	{
-		ParticleCell& neighbourCell = _cells[cellIndex - *neighbourOffsetsIter];  // minus oder plus?
-		u += cellProcessor.processSingleMolecule(m1, neighbourCell);
+	// only the cell of the molecule and its neighbours are handed to the cell processor
+	vector<ParticleCell*> cells;
+	getTrialCells(cellIndex, cells);
+
+	return cellProcessor.trialEnergy(m1, cells);
+}
+
+void LinkedCells::loadInsertionBatch(ChemicalPotential* mu, CellProcessor& cellProcessor, vector<Molecule>& batch,
+		vector<double>& energies, vector<unsigned long>& cellIndices, vector<bool>& valid) {
+	double ins[3];
+	unsigned long nextid;
+	while ((nextid = mu->getInsertion(ins)) > 0) {
+		Molecule tmp = mu->loadMolecule();
+		for (int d = 0; d < 3; d++)
+			tmp.setr(d, ins[d]);
+		tmp.setid(nextid);
+		batch.push_back(tmp);
 	}
 
-	// close the window of cells activated
-	for (unsigned int windowCellIndex = cellIndex - _minNeighbourOffset; windowCellIndex < cellIndex + _maxNeighbourOffset+1; windowCellIndex++) {
-		cellProcessor.postprocessCell(_cells[windowCellIndex]);
+	// test insertions which overlap with a molecule are not evaluated,
+	// their energy is calculated later if they are no longer excluded then
+	OverlapGrid* grid = mu->getOverlapGrid();
+	vector<Molecule*> molecules;
+	vector<vector<ParticleCell*> > cells;
+	vector<size_t> evaluated;
+	cellIndices.resize(batch.size());
+	valid.assign(batch.size(), false);
+	for (size_t i = 0; i < batch.size(); i++) {
+		batch[i].upd_cache();
+		cellIndices[i] = getCellIndexOfMolecule(&batch[i]);
+		double r[3] = { batch[i].r(0), batch[i].r(1), batch[i].r(2) };
+		if (grid != NULL && grid->isExcluded(r))
+			continue;
+		molecules.push_back(&batch[i]);
+		cells.push_back(vector<ParticleCell*>());
+		getTrialCells(cellIndices[i], cells.back());
+		evaluated.push_back(i);
 	}
+	vector<double> evaluatedEnergies;
+	cellProcessor.trialEnergies(molecules, cells, evaluatedEnergies);
+	energies.assign(batch.size(), 0.0);
+	for (size_t j = 0; j < evaluated.size(); j++) {
+		energies[evaluated[j]] = evaluatedEnergies[j];
+		valid[evaluated[j]] = true;
+	}
+}
 
-	cellProcessor.endTraversal();
-	return u;
+void LinkedCells::invalidateInsertionBatch(unsigned long cellIndex, const vector<unsigned long>& cellIndices,
+		vector<bool>& valid, size_t first) {
+	for (size_t i = first; i < cellIndices.size(); i++) {
+		if (valid[i] && inNeighbourhood(cellIndices[i], cellIndex)) {
+			valid[i] = false;
+		}
+	}
 }
 
 int LinkedCells::grandcanonicalBalance(DomainDecompBase* comm) {
@@ -733,6 +962,37 @@ void LinkedCells::grandcanonicalStep(ChemicalPotential* mu, double T, Domain* do
 	bool hasInsertion = true;
 	double ins[3];
 	unsigned nextid = 0;
+
+	// batched mode: when the first insertion is due, all test insertions of the
+	// step are drawn and their energies are evaluated in one go. They are still
+	// decided one after the other; an energy is only recalculated if an accepted
+	// move has changed one of the cells it depends on, so the results are the
+	// same as in the sequential mode.
+	const bool batched = mu->isBatched();
+
+	// overlap grid: test insertions into the excluded volume are rejected without
+	// calculating their energy. With cavity bias, the test insertions are drawn from
+	// the free volume only, so the probability to propose a given insertion is higher
+	// by 1/p_free, where p_free is the free volume fraction. Detailed balance then
+	// requires the acceptance rules
+	//   insertion: min(1, V/(N+1) exp(mu - dU/T) p_free),
+	//   deletion:  min(1, N/V exp(-mu - dU/T) / p_free'),
+	// where p_free' is the free volume fraction without the deleted molecule. A
+	// deletion is rejected if the position of the molecule is excluded by others,
+	// as the reverse insertion could not be proposed.
+	OverlapGrid* grid = mu->getOverlapGrid();
+	const bool cavityBias = (grid != NULL) && grid->cavityBias();
+	if (grid != NULL)
+		grid->build(this);
+
+	bool batchLoaded = false;
+	vector<Molecule> batch;
+	vector<double> batchEnergies;
+	vector<unsigned long> batchCells;
+	vector<bool> batchValid;
+	size_t batchIndex = 0;
+
+	cellProcessor.initTrials();
 	while (hasDeletion || hasInsertion) {
 		if (hasDeletion)
 			hasDeletion = mu->getDeletion(this, minco, maxco);
@@ -740,12 +1000,27 @@ void LinkedCells::grandcanonicalStep(ChemicalPotential* mu, double T, Domain* do
 			m = &(*(this->_particleIter));
 			DeltaUpot = -1.0 * getEnergy(&particlePairsHandler, m, cellProcessor);
 
-			accept = mu->decideDeletion(DeltaUpot / T);
+			double mr[3] = { m->r(0), m->r(1), m->r(2) };
+			if (grid != NULL)
+				grid->remove(mr);
+			if (cavityBias && grid->isExcluded(mr)) {
+				mu->skipDecision();
+				accept = false;
+			}
+			else if (cavityBias)
+				accept = mu->decideDeletion(DeltaUpot / T + log(grid->freeFraction()));
+			else
+				accept = mu->decideDeletion(DeltaUpot / T);
+			if (grid != NULL && !accept)
+				grid->add(mr);
 #ifndef NDEBUG
 			if(accept) global_log->debug() << "r" << mu->rank() << "d" << m->id() << endl;
 			else global_log->debug() << "   (r" << mu->rank() << "-d" << m->id() << ")" << endl;
 #endif
 			if (accept) {
+				unsigned long cellid = this->getCellIndexOfMolecule(m);
+				cellProcessor.invalidateTrialCell(this->_cells[cellid]);
+				invalidateInsertionBatch(cellid, batchCells, batchValid, batchIndex);
 				m->upd_cache();
 				// reset forces and momenta to zero
 				{
@@ -765,12 +1040,41 @@ void LinkedCells::grandcanonicalStep(ChemicalPotential* mu, double T, Domain* do
 			m = &(*(_particles.begin()));
 			mu->storeMolecule(*m);
 		}
-		if (hasInsertion) {
+		if (hasInsertion && batched) {
+			if (!batchLoaded) {
+				loadInsertionBatch(mu, cellProcessor, batch, batchEnergies, batchCells, batchValid);
+				batchLoaded = true;
+			}
+			hasInsertion = (batchIndex < batch.size());
+			if (hasInsertion) {
+				nextid = batch[batchIndex].id();
+				for (int d = 0; d < 3; d++)
+					ins[d] = batch[batchIndex].r(d);
+			}
+		}
+		else if (hasInsertion) {
 			nextid = mu->getInsertion(ins);
 			hasInsertion = (nextid > 0);
 		}
+		double logFreeFraction = 0.0;
+		if (hasInsertion && cavityBias) {
+			logFreeFraction = log(grid->freeFraction());
+			if (!grid->drawCavityPosition(ins)) {
+				// no free volume left, the insertion overlaps anyway
+				domain->submitDU(mu->getComponentID(), numeric_limits<double>::infinity(), ins);
+				mu->skipDecision();
+				continue;
+			}
+		}
+		else if (hasInsertion && grid != NULL && grid->isExcluded(ins)) {
+			domain->submitDU(mu->getComponentID(), numeric_limits<double>::infinity(), ins);
+			mu->skipDecision();
+			if (batched)
+				batchIndex++;
+			continue;
+		}
 		if (hasInsertion) {
-			Molecule tmp = mu->loadMolecule();
+			Molecule tmp = batched ? batch[batchIndex] : mu->loadMolecule();
 			for (int d = 0; d < 3; d++)
 				tmp.setr(d, ins[d]);
 			tmp.setid(nextid);
@@ -792,28 +1096,37 @@ void LinkedCells::grandcanonicalStep(ChemicalPotential* mu, double T, Domain* do
 			<< " at the reduced position (" << ins[0] << "/" << ins[1] << "/" << ins[2] << ")? " << endl;
 #endif
 
+			// the test molecule is only added to its cell if the insertion is accepted,
+			// so the data the cell processor keeps for the cells stays valid otherwise
 			unsigned long cellid = this->getCellIndexOfMolecule(m);
-			this->_cells[cellid].addParticle(m);
-			DeltaUpot = getEnergy(&particlePairsHandler, m, cellProcessor);
-                        domain->submitDU(mu->getComponentID(), DeltaUpot, ins);
-			accept = mu->decideInsertion(DeltaUpot / T);
+			if (batched && batchValid[batchIndex])
+				DeltaUpot = batchEnergies[batchIndex];
+			else
+				DeltaUpot = getEnergy(&particlePairsHandler, m, cellProcessor);
+			if (batched)
+				batchIndex++;
+                        domain->submitDU(mu->getComponentID(), DeltaUpot - T * logFreeFraction, ins);
+			accept = mu->decideInsertion(DeltaUpot / T - logFreeFraction);
 
 #ifndef NDEBUG
 			if(accept) global_log->debug() << "r" << mu->rank() << "i" << mit->id() << ")" << endl;
 			else global_log->debug() << "   (r" << mu->rank() << "-i" << mit->id() << ")" << endl;
 #endif
 			if (accept) {
+				this->_cells[cellid].addParticle(m);
+				cellProcessor.invalidateTrialCell(this->_cells[cellid]);
+				invalidateInsertionBatch(cellid, batchCells, batchValid, batchIndex);
+				if (grid != NULL)
+					grid->add(ins);
 				this->_localInsertionsMinusDeletions++;
 			}
 			else {
-				// this->deleteMolecule(m->id(), m->r(0), m->r(1), m->r(2));
-				this->_cells[cellid].deleteMolecule(m->id());
-
 				mit->check(m->id());
 				this->_particles.erase(mit);
 			}
 		}
 	}
+	cellProcessor.endTrials();
 	for (m = this->begin(); m != this->end(); m = this->next()) {
 #ifndef NDEBUG
 		m->check(m->id());
@@ -1,6 +1,7 @@
 #ifndef LINKEDCELLS_H_
 #define LINKEDCELLS_H_
 
+#include <cstddef>
 #include <vector>
 
 #include "particleContainer/ParticleContainer.h"
@@ -76,7 +77,7 @@ public:
 	);
 
 	//! Default constructor
-	LinkedCells(){}
+	LinkedCells() : _periodicImages(false) {}
 	//! Destructor
 	~LinkedCells();
 
@@ -86,8 +87,10 @@ public:
 	 * \code{.xml}
 	   <datastructure type="LinkedCells">
 	     <cellsInCutoffRadius>INTEGER</cellsInCutoffRadius>
+	     <periodicImages>BOOL</periodicImages>
 	   </datastructure>
 	   \endcode
+	 * periodicImages: see setPeriodicImages(), disabled by default.
 	 */
 	virtual void readXML(XMLfileUnits& xmlconfig);
 
@@ -105,6 +108,8 @@ public:
 	//! first all cells are cleared and then filled again depending on the spacial position
 	//! of the molecules. After the update, exactly one pointer for each particle in this
 	//! ParticleContainer is it's corresponding cell.
+	//! If the cells were valid before the particles moved, only the particles which
+	//! left their cell are moved to their new cell (see updateMovedParticles()).
 	void update();
 
 	//! @brief Insert a single molecule.
@@ -127,7 +132,10 @@ public:
 	//! @param particlePairsHandler specified concrete action to be done for each pair
 //	void traversePairs(ParticlePairsHandler* particlePairsHandler);
 
-	void traverseCells(CellProcessor& cellProcessor);
+	void traverseCells(CellProcessor& cellProcessor, TimerRegistry* timers = NULL);
+
+	//! @brief samples the profile cell by cell, see ProfileSampler::sampleCell
+	void sampleProfile(ProfileSampler& sampler);
 
 	//! @return the number of particles stored in the Linked Cells
 	unsigned long getNumberOfParticles();
@@ -167,6 +175,24 @@ public:
 	//! @brief appends pointers to all particles in the halo region to the list
 	void getHaloParticles(std::list<Molecule*> &haloParticlePtrs);
 
+	//! @brief Let the halo cells reference the molecules of their periodic image.
+	//!
+	//! If enabled, the bounding box is periodic in all dimensions and the container
+	//! applies the periodic boundary conditions itself, so no halo copies of the
+	//! molecules are created: update() moves molecules which left the bounding box
+	//! to the opposite side and lets each halo cell point to the molecules of the
+	//! boundary cell it is the periodic image of, with the shift between both as
+	//! periodic shift of the halo cell (see ParticleCell::getPeriodicShift()).
+	//! This is only correct for a single process owning the whole domain and for
+	//! cell processors which apply the shift and do not store forces on halo
+	//! molecules (i.e. the VectorizedCellProcessor), and it has to be set while
+	//! the container holds no halo copies.
+	void setPeriodicImages(bool periodicImages);
+
+	bool usesPeriodicImages() const {
+		return _periodicImages;
+	}
+
 	// documentation see father class (ParticleContainer.h)
 	void getRegion(double lowCorner[3], double highCorner[3], std::list<Molecule*> &particlePtrs);
 
@@ -218,6 +244,7 @@ public:
 
 
 	friend class StatisticsWriter;
+	friend class LinkedCellsTest;
 
 
 	//! @brief Get the index in the cell vector to which this Molecule belong
@@ -263,6 +290,33 @@ private:
 	//! of cells between the two cells (this is received by substracting one of the difference).
 	void calculateNeighbourIndices();
 
+	//! @brief Move the particles which left their cell to their new cell.
+	//!
+	//! Each particle is checked against the cell it is stored in, so only
+	//! the few particles crossing a cell boundary in one time step are touched,
+	//! the others keep their place and order in their cell. This requires
+	//! that every particle is in exactly one cell, i.e. _cellsValid is true
+	//! and no particle was removed from _particles without its cell.
+	void updateMovedParticles();
+
+	//! @brief Set up the halo cells as periodic images of the boundary cells.
+	//!
+	//! The molecules which left the bounding box (i.e. were sorted into a halo cell)
+	//! are moved to the opposite side, then each halo cell gets the molecule pointers
+	//! of its periodic image (see setPeriodicImages()).
+	void updatePeriodicImages();
+
+	//! @brief Move a molecule outside of the bounding box to the opposite side.
+	//!
+	//! @return index of the (inner or boundary) cell the molecule belongs to
+	unsigned long moveIntoBoundingBox(Molecule* molecule);
+
+	//! @brief Determine the boundary cell each halo cell is the periodic image of.
+	//!
+	//! Fills _periodicImageIndices and sets the periodic shifts of the halo cells,
+	//! which are zero if the periodic images are not used.
+	void initializePeriodicImages();
+
 	
 
 	//! @brief given the 3D index of a cell, return the index in the cell vector.
@@ -275,6 +329,24 @@ private:
 	//! y: two cells back, z: one cell up,...)
 	long int cellIndexOf3DIndex(long int xIndex, long int yIndex, long int zIndex) const;
 
+	//! @brief collect the cell with the given index and its neighbour cells (for trial energies)
+	void getTrialCells(unsigned long cellIndex, std::vector<ParticleCell*>& cells);
+
+	//! @brief true if the cells are at most a halo width apart in each dimension,
+	//! i.e. if one of them may be a neighbour cell of the other
+	bool inNeighbourhood(unsigned long cellIndex1, unsigned long cellIndex2) const;
+
+	//! @brief draw all remaining test insertions of mu and evaluate their energies
+	//! against the current state (batched grand canonical mode); the energies of
+	//! test insertions excluded by the overlap grid are not evaluated and marked invalid
+	void loadInsertionBatch(ChemicalPotential* mu, CellProcessor& cellProcessor, std::vector<Molecule>& batch,
+			std::vector<double>& energies, std::vector<unsigned long>& cellIndices, std::vector<bool>& valid);
+
+	//! @brief mark the energies of the test insertions from index first on as invalid,
+	//! which depend on the cell with index cellIndex
+	void invalidateInsertionBatch(unsigned long cellIndex, const std::vector<unsigned long>& cellIndices,
+			std::vector<bool>& valid, size_t first);
+
 
 
 	//####################################
@@ -290,6 +362,7 @@ private:
 	std::vector<unsigned long> _innerCellIndices; //!< Vector containing the indices (for the cells vector) of all inner cells (without boundary)
 	std::vector<unsigned long> _boundaryCellIndices; //!< Vector containing the indices (for the cells vector) of all boundary cells
 	std::vector<unsigned long> _haloCellIndices; //!< Vector containing the indices (for the cells vector) of all halo cells
+	std::vector<unsigned long> _periodicImageIndices; //!< For each halo cell, the index of the boundary cell it is the periodic image of
 
 	std::vector<long> _forwardNeighbourOffsets; //!< Neighbours that come in the total ordering after a cell
 	std::vector<long> _backwardNeighbourOffsets; //!< Neighbours that come in the total ordering before a cell
@@ -323,6 +396,18 @@ private:
 	//! should be set to true.
 	bool _cellsValid;
 
+	//! @brief True if update() has to sort all particles into the cells again
+	//!
+	//! This is the case if the cells were set up anew (constructor, rebuild)
+	//! or if particles were removed from _particles but not from their cell
+	//! (deleteCurrent), so the cells may hold pointers to deleted particles.
+	//! It is also the case if deleteOuterParticles() removed a particle inside the
+	//! bounding box from a halo cell, into which it was sorted by rounding.
+	bool _fullUpdateRequired;
+
+	//! True if the halo cells reference the molecules of their periodic image, see setPeriodicImages()
+	bool _periodicImages;
+
 };
 
 #endif /* LINKEDCELLS_H_ */
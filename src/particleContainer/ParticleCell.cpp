@@ -9,6 +9,7 @@ using namespace std;
 
 ParticleCell::ParticleCell() :
 		_cellDataSoA(0) {
+	_periodicShift[0] = _periodicShift[1] = _periodicShift[2] = 0.0;
 }
 
 ParticleCell::~ParticleCell() {
@@ -31,6 +32,12 @@ int ParticleCell::getMoleculeCount() const {
 	return molecules.size();
 }
 
+void ParticleCell::setPeriodicShift(const double shift[3]) {
+	for (int d = 0; d < 3; d++) {
+		_periodicShift[d] = shift[d];
+	}
+}
+
 bool ParticleCell::deleteMolecule(unsigned long molecule_id) {
 	bool found = false;
 	vector<Molecule*>::iterator molecule_iter;
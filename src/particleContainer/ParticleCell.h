@@ -64,6 +64,16 @@ public:
 
 	//! return the number of molecules contained in this cell
 	int getMoleculeCount() const;
+
+	//! @brief shift to be added to the positions of the molecules in this cell
+	//!
+	//! Zero, unless this is a halo cell referencing the molecules of its periodic
+	//! image instead of holding copies of them (see LinkedCells::setPeriodicImages()).
+	const double* getPeriodicShift() const {
+		return _periodicShift;
+	}
+
+	void setPeriodicShift(const double shift[3]);
 	
 	/**
 	 * \brief Get the structure of arrays for VectorizedCellProcessor.
@@ -91,6 +101,9 @@ private:
 	 * \author Johannes Heckl
 	 */
 	CellDataSoA * _cellDataSoA;
+
+	//! shift of the molecule positions, see getPeriodicShift()
+	double _periodicShift[3];
 };
 
 #endif /* PARTICLE CELL_H_ */
@@ -1,6 +1,7 @@
 #include "particleContainer/ParticleContainer.h"
 
 #include "molecules/Molecule.h"
+#include "particleContainer/adapter/ProfileSampler.h"
 #include "utils/Logger.h"
 
 using namespace std;
@@ -31,13 +32,36 @@ double ParticleContainer::getBoundingBoxMin(int dimension) const {
 double ParticleContainer::getBoundingBoxMax(int dimension) const {
 	return this->_boundingBoxMax[dimension];
 }
+bool ParticleContainer::isInBoundingBox(const double r[3]) const {
+	for (int d = 0; d < 3; d++) {
+		if (r[d] < _boundingBoxMin[d] || r[d] >= _boundingBoxMax[d]) {
+			return false;
+		}
+	}
+	return true;
+}
+
 double ParticleContainer::getHaloWidthNumCells() {
 	return 0;
 }
+void ParticleContainer::sampleProfile(ProfileSampler& sampler) {
+	for (Molecule* tM = this->begin(); tM != this->end(); tM = this->next()) {
+		sampler.sampleMolecule(tM);
+	}
+}
+
 void ParticleContainer::updateMoleculeCaches() {
+	// the sites of consecutive molecules of the same component are rotated in batches
+	Molecule* batch[Molecule::ROTATION_BATCH];
+	unsigned batchSize = 0;
 	Molecule *tM;
 	for (tM = this->begin(); tM != this->end(); tM = this->next() ) {
-		tM->upd_cache();
+		if (batchSize == Molecule::ROTATION_BATCH || (batchSize > 0 && batch[0]->component() != tM->component())) {
+			Molecule::upd_cache(batch, batchSize);
+			batchSize = 0;
+		}
+		batch[batchSize++] = tM;
 		tM->clearFM();
 	}
+	Molecule::upd_cache(batch, batchSize);
 }
@@ -20,6 +20,7 @@
 #ifndef PARTICLECONTAINER_H_
 #define PARTICLECONTAINER_H_
 
+#include <cstddef>
 #include <list>
 
 class CellProcessor;
@@ -29,6 +30,8 @@ class DomainDecompBase;
 class Molecule;
 class ParticleContainer;
 class ParticlePairsHandler;
+class ProfileSampler;
+class TimerRegistry;
 class XMLfileUnits;
 
 //! @brief This Interface is used to get access to particles and pairs of particles
@@ -128,7 +131,17 @@ public:
 	//! @param particlePairsHandler specified concrete action to be done for each pair
 //	virtual void traversePairs(ParticlePairsHandler* particlePairsHandler) = 0;
 
-	virtual void traverseCells(CellProcessor& cellProcessor) = 0;
+	//! @brief traverse all cells and pairs of neighbouring cells with the cell processor
+	//! @param timers if not NULL, the time spent on the inner, boundary and halo cells
+	//!        is added to the regions "inner_cells", "boundary_cells" and "halo_cells"
+	//!        (only measured by LinkedCells)
+	virtual void traverseCells(CellProcessor& cellProcessor, TimerRegistry* timers = NULL) = 0;
+
+	//! @brief add all particles (without the halo) to the profile.
+	//!
+	//! The default implementation samples the particles one by one, containers
+	//! with a cell structure can hand over whole cells instead.
+	virtual void sampleProfile(ProfileSampler& sampler);
 
 	//! @return the number of particles stored in this container
 	//!
@@ -148,6 +161,9 @@ public:
 	//! @param dimension the coordinate which should be returned
 	double getBoundingBoxMax(int dimension) const;
 
+	//! @brief checks if a position lies inside the bounding box (excluding the halo)
+	bool isInBoundingBox(const double r[3]) const;
+
 	//! @brief Returns a pointer to the first particle in the Container
 	virtual Molecule* begin() = 0;
 
@@ -178,6 +194,14 @@ public:
 	//! @brief appends pointers to all particles in the halo region to the list
 	virtual void getHaloParticles(std::list<Molecule*> &haloParticlePtrs) = 0;
 
+	//! @brief true if the container applies the periodic boundary conditions itself
+	//!
+	//! In this case, the halo region holds no copies of the molecules, so the domain
+	//! decomposition must not create them (see LinkedCells::setPeriodicImages()).
+	virtual bool usesPeriodicImages() const {
+		return false;
+	}
+
 	//! @brief fills the given list with pointers to all particles in the given region
 	//! @param lowCorner minimum x-, y- and z-coordinate of the region
 	//! @param highwCorner maximum x-, y- and z-coordinate of the region
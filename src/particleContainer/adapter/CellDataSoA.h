@@ -27,7 +27,7 @@ public:
 		_mol_pos_x(_molecules_size), _mol_pos_y(_molecules_size), _mol_pos_z(_molecules_size), _mol_num_ljc(_molecules_size),
 		_m_r_x(_ljcenters_size), _m_r_y(_ljcenters_size), _m_r_z(
 		_ljcenters_size), _ljc_r_x(_ljcenters_size), _ljc_r_y(_ljcenters_size), _ljc_r_z(_ljcenters_size), _ljc_f_x(
-		_ljcenters_size), _ljc_f_y(_ljcenters_size), _ljc_f_z(_ljcenters_size), _ljc_id(_ljcenters_size) {
+		_ljcenters_size), _ljc_f_y(_ljcenters_size), _ljc_f_z(_ljcenters_size), _ljc_id(_ljcenters_size), _ljc_type_mask(_ljcenters_size) {
 
 	}
 
@@ -52,6 +52,12 @@ public:
 	DoubleArray _ljc_f_y;
 	DoubleArray _ljc_f_z;
 	IndexArray _ljc_id;
+	// all bits set for the centers of the second type of the MIXTURE kernel, 0.0 otherwise
+	DoubleArray _ljc_type_mask;
+
+	// bounding box of the molecule positions, empty (min > max) for an empty cell
+	double _mol_pos_min[3];
+	double _mol_pos_max[3];
 
 	void resize(size_t molecules_arg, size_t centers_arg) {
 			if (centers_arg > _ljcenters_size) {
@@ -66,6 +72,7 @@ public:
 				_ljc_f_y.resize(_ljcenters_size);
 				_ljc_f_z.resize(_ljcenters_size);
 				_ljc_id.resize(_ljcenters_size);
+				_ljc_type_mask.resize(_ljcenters_size);
 			}
 
 			if (molecules_arg > _molecules_size) {
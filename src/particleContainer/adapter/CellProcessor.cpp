@@ -0,0 +1,32 @@
+/*
+ * CellProcessor.cpp
+ */
+
+#include "CellProcessor.h"
+#include "particleContainer/ParticleCell.h"
+
+double CellProcessor::trialEnergy(Molecule* m1, const std::vector<ParticleCell*>& cells) {
+	initTraversal(cells.size());
+	for (size_t i = 0; i < cells.size(); i++) {
+		preprocessCell(*cells[i]);
+	}
+
+	double u = 0.0;
+	for (size_t i = 0; i < cells.size(); i++) {
+		u += processSingleMolecule(m1, *cells[i]);
+	}
+
+	for (size_t i = 0; i < cells.size(); i++) {
+		postprocessCell(*cells[i]);
+	}
+	endTraversal();
+	return u;
+}
+
+void CellProcessor::trialEnergies(const std::vector<Molecule*>& molecules,
+		const std::vector<std::vector<ParticleCell*> >& cells, std::vector<double>& energies) {
+	energies.resize(molecules.size());
+	for (size_t i = 0; i < molecules.size(); i++) {
+		energies[i] = trialEnergy(molecules[i], cells[i]);
+	}
+}
@@ -3,10 +3,12 @@
 #define CELLPROCESSOR_H_
 
 #include <cstddef>
+#include <vector>
 
 class Molecule;
 
 class ParticleCell;
+class RDF;
 
 /**
  * Interface for traversal of cells to allow a cell-wise treatment of molecules.
@@ -63,6 +65,60 @@ public:
 
 	virtual double processSingleMolecule(Molecule* m1, ParticleCell& cell2) = 0;
 
+	/**
+	 * Called before the trial moves (test insertions and deletions) of a grand
+	 * canonical step are evaluated with trialEnergy().
+	 */
+	virtual void initTrials() {}
+
+	/**
+	 * Interaction energy of the (test) molecule m1 with the molecules in the
+	 * given cells, i.e. the cell of m1 and its neighbour cells. m1 itself is
+	 * not taken into account, even if it is contained in one of the cells.
+	 *
+	 * In contrast to processSingleMolecule(), the cells do not have to be in
+	 * the active window. Implementations may keep data of the cells (e.g. a
+	 * packed SoA) from one trial to the next, until the cell is invalidated
+	 * or endTrials() is called. The default implementation opens a window
+	 * on the given cells only and uses processSingleMolecule().
+	 */
+	virtual double trialEnergy(Molecule* m1, const std::vector<ParticleCell*>& cells);
+
+	/**
+	 * Energies of several test molecules (see trialEnergy()) against the same
+	 * state, cells[i] being the cells of molecules[i]. This allows to load all
+	 * cells first and to evaluate the energies in one go afterwards.
+	 * The default implementation calls trialEnergy() for each molecule.
+	 */
+	virtual void trialEnergies(const std::vector<Molecule*>& molecules,
+			const std::vector<std::vector<ParticleCell*> >& cells, std::vector<double>& energies);
+
+	/**
+	 * Called when molecules have been added to or removed from the cell
+	 * between trials, i.e. when a trial move has been accepted.
+	 */
+	virtual void invalidateTrialCell(ParticleCell& cell) {}
+
+	/**
+	 * Called after the last trial of a grand canonical step.
+	 */
+	virtual void endTrials() {}
+
+	/**
+	 * Sample the RDF while calculating the forces. Cell processors which
+	 * calculate the forces with a ParticlePairsHandler do not need this, as
+	 * the RDF is passed to the handler (see ParticlePairsHandler::setRDF()).
+	 */
+	virtual void setRDF(RDF* rdf) {}
+
+	/**
+	 * Whether the following traversals have to sum up the potential energy and
+	 * the virial. If not, cell processors may calculate the forces only and
+	 * store zero values in the domain. The default implementation always
+	 * calculates all values.
+	 */
+	virtual void setComputeMacroscopicValues(bool compute) {}
+
 	/**
 	 * Called after the cell has been considered for the last time during the traversal.
 	 */
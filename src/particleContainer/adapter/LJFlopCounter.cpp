@@ -121,6 +121,10 @@ double LJFlopCounter::processSingleMolecule(Molecule* m1, ParticleCell& cell2)
 void LJFlopCounter::processCellPair(ParticleCell & c1, ParticleCell & c2) {
 	const MoleculeList & molecules1 = c1.getParticlePointers();
 	const MoleculeList & molecules2 = c2.getParticlePointers();
+	// difference of the periodic shifts, if one of the cells is a periodic image
+	const double s_x = c1.getPeriodicShift()[0] - c2.getPeriodicShift()[0];
+	const double s_y = c1.getPeriodicShift()[1] - c2.getPeriodicShift()[1];
+	const double s_z = c1.getPeriodicShift()[2] - c2.getPeriodicShift()[2];
 	if ((molecules1.size() > 0) && (molecules2.size() > 0)) {
 		const MoleculeList::const_iterator end_i = molecules1.end();
 		const MoleculeList::const_iterator end_j = molecules2.end();
@@ -133,9 +137,9 @@ void LJFlopCounter::processCellPair(ParticleCell & c1, ParticleCell & c2) {
 				// Have to compare the distance between 2 molecules.
 				_currentCounts.calc_molDist += 1;
 
-				const double d_x = (*i)->r(0) - (*j)->r(0);
-				const double d_y = (*i)->r(1) - (*j)->r(1);
-				const double d_z = (*i)->r(2) - (*j)->r(2);
+				const double d_x = (*i)->r(0) - (*j)->r(0) + s_x;
+				const double d_y = (*i)->r(1) - (*j)->r(1) + s_y;
+				const double d_z = (*i)->r(2) - (*j)->r(2) + s_z;
 				const double d2 = d_x * d_x + d_y * d_y + d_z * d_z;
 				if (d2 < _rc2) {
 					const size_t centers_i = (*i)->numLJcenters();
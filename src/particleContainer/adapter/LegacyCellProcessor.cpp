@@ -6,7 +6,10 @@
  */
 
 #include "LegacyCellProcessor.h"
+#include "Simulation.h"
+#include "ensemble/EnsembleBase.h"
 #include "particleContainer/ParticleCell.h"
+#include "particleContainer/adapter/ParticlePairs2PotForceAdapter.h"
 #include "particleContainer/handlerInterfaces/ParticlePairsHandler.h"
 #include "molecules/Molecule.h"
 #include "utils/Logger.h"
@@ -15,12 +18,59 @@
 using namespace std;
 using namespace Log;
 
+namespace {
+
+/** Pair kernel calling the virtual methods of an arbitrary ParticlePairsHandler. */
+class GenericPairKernel {
+public:
+	static const bool tersoff = true;
+
+	GenericPairKernel(ParticlePairsHandler* handler, ParticlePairs2PotForceAdapter*) : _handler(*handler) {}
+
+	void processPair(Molecule& molecule1, Molecule& molecule2, double distanceVector[3], PairType pairType, double dd, bool calculateLJ) {
+		_handler.processPair(molecule1, molecule2, distanceVector, pairType, dd, calculateLJ);
+	}
+
+	void preprocessTersoffPair(Molecule& molecule1, Molecule& molecule2, bool pairType) {
+		_handler.preprocessTersoffPair(molecule1, molecule2, pairType);
+	}
+
+private:
+	ParticlePairsHandler& _handler;
+};
+
+/** Pair kernel calling the force calculation of the ParticlePairs2PotForceAdapter
+ * specialised for the given site types (see SiteTypes) without virtual calls. */
+template <class Sites>
+class PotForcePairKernel {
+public:
+	static const bool tersoff = Sites::tersoff;
+
+	PotForcePairKernel(ParticlePairsHandler*, ParticlePairs2PotForceAdapter* adapter) : _adapter(*adapter) {}
+
+	void processPair(Molecule& molecule1, Molecule& molecule2, double distanceVector[3], PairType pairType, double dd, bool calculateLJ) {
+		_adapter.processPairSpecialized<Sites>(molecule1, molecule2, distanceVector, pairType, dd, calculateLJ);
+	}
+
+	void preprocessTersoffPair(Molecule& molecule1, Molecule& molecule2, bool pairType) {
+		_adapter.ParticlePairs2PotForceAdapter::preprocessTersoffPair(molecule1, molecule2, pairType);
+	}
+
+private:
+	ParticlePairs2PotForceAdapter& _adapter;
+};
+
+} // namespace
+
+
 LegacyCellProcessor::LegacyCellProcessor(const double cutoffRadius, const double LJCutoffRadius,
 		const double tersoffCutoffRadius, ParticlePairsHandler* particlePairsHandler)
 : _cutoffRadiusSquare(cutoffRadius * cutoffRadius), _LJCutoffRadiusSquare(LJCutoffRadius * LJCutoffRadius),
-  _tersoffCutoffRadiusSquare(tersoffCutoffRadius*tersoffCutoffRadius), _particlePairsHandler(particlePairsHandler){
+  _tersoffCutoffRadiusSquare(tersoffCutoffRadius*tersoffCutoffRadius), _particlePairsHandler(particlePairsHandler),
+  _potForceAdapter(dynamic_cast<ParticlePairs2PotForceAdapter*>(particlePairsHandler)) {
 	  /** @todo Check for multiple tersoff potentials with different parameters as the LegacyCellProcessor::postprocessCell() does only use one parameter set. */
 	  global_log->warning() << "Note: The LegacyCellProcessor does not support multiple Tersoff sites with different parameters." << endl;
+	  useKernel<GenericPairKernel>();
 }
 
 
@@ -31,6 +81,49 @@ LegacyCellProcessor::~LegacyCellProcessor() {
 void LegacyCellProcessor::initTraversal(const size_t numCells)
 {
 	_particlePairsHandler->init();
+	selectKernel();
+}
+
+template <class Kernel>
+void LegacyCellProcessor::useKernel() {
+	_processCellPair = &LegacyCellProcessor::processCellPairKernel<Kernel>;
+	_processCell = &LegacyCellProcessor::processCellKernel<Kernel>;
+}
+
+void LegacyCellProcessor::selectKernel() {
+	if (_potForceAdapter == NULL || global_simulation == NULL) {
+		useKernel<GenericPairKernel>();
+		return;
+	}
+
+	bool charges = false, dipoles = false, quadrupoles = false, tersoff = false;
+	const vector<Component>& components = *(_simulation.getEnsemble()->components());
+	for (size_t i = 0; i < components.size(); i++) {
+		charges |= components[i].numCharges() > 0;
+		dipoles |= components[i].numDipoles() > 0;
+		quadrupoles |= components[i].numQuadrupoles() > 0;
+		tersoff |= components[i].numTersoff() > 0;
+	}
+
+	if (tersoff) {
+		useKernel<GenericPairKernel>();
+	} else if (!charges && !dipoles && !quadrupoles) {
+		useKernel<PotForcePairKernel<SiteTypes<false, false, false, false> > >();
+	} else if (charges && !dipoles && !quadrupoles) {
+		useKernel<PotForcePairKernel<SiteTypes<true, false, false, false> > >();
+	} else if (!charges && dipoles && !quadrupoles) {
+		useKernel<PotForcePairKernel<SiteTypes<false, true, false, false> > >();
+	} else if (!charges && !dipoles && quadrupoles) {
+		useKernel<PotForcePairKernel<SiteTypes<false, false, true, false> > >();
+	} else if (charges && dipoles && !quadrupoles) {
+		useKernel<PotForcePairKernel<SiteTypes<true, true, false, false> > >();
+	} else if (charges && !dipoles && quadrupoles) {
+		useKernel<PotForcePairKernel<SiteTypes<true, false, true, false> > >();
+	} else if (!charges && dipoles && quadrupoles) {
+		useKernel<PotForcePairKernel<SiteTypes<false, true, true, false> > >();
+	} else {
+		useKernel<PotForcePairKernel<SiteTypes<true, true, true, false> > >();
+	}
 }
 
 
@@ -54,6 +147,20 @@ void LegacyCellProcessor::preprocessCell(ParticleCell& cell) {
 double LegacyCellProcessor::processSingleMolecule(Molecule* m1, ParticleCell& cell2)
 {
 	assert(cell2.isInActiveWindow());
+	return singleMoleculeEnergy(m1, cell2);
+}
+
+double LegacyCellProcessor::trialEnergy(Molecule* m1, const std::vector<ParticleCell*>& cells)
+{
+	double u = 0.0;
+	for (size_t i = 0; i < cells.size(); i++) {
+		u += singleMoleculeEnergy(m1, *cells[i]);
+	}
+	return u;
+}
+
+double LegacyCellProcessor::singleMoleculeEnergy(Molecule* m1, ParticleCell& cell2)
+{
 	double distanceVector[3];
 
 	std::vector<Molecule*>& neighbourCellParticles = cell2.getParticlePointers();
@@ -74,6 +181,16 @@ double LegacyCellProcessor::processSingleMolecule(Molecule* m1, ParticleCell& ce
 }
 
 void LegacyCellProcessor::processCellPair(ParticleCell& cell1, ParticleCell& cell2) {
+	(this->*_processCellPair)(cell1, cell2);
+}
+
+void LegacyCellProcessor::processCell(ParticleCell& cell) {
+	(this->*_processCell)(cell);
+}
+
+template <class Kernel>
+void LegacyCellProcessor::processCellPairKernel(ParticleCell& cell1, ParticleCell& cell2) {
+	Kernel kernel(_particlePairsHandler, _potForceAdapter);
 	assert(cell1.isInActiveWindow());
 	assert(cell2.isInActiveWindow());
 	double distanceVector[3];
@@ -93,9 +210,9 @@ void LegacyCellProcessor::processCellPair(ParticleCell& cell1, ParticleCell& cel
 				Molecule& molecule2 = *neighbourCellParticles[j];
 				double dd = molecule2.dist2(molecule1, distanceVector);
 				if (dd < _cutoffRadiusSquare) {
-					_particlePairsHandler->processPair(molecule1, molecule2, distanceVector, MOLECULE_MOLECULE, dd, (dd < _LJCutoffRadiusSquare));
-					if ((num_tersoff > 0) && (molecule2.numTersoff() > 0) && (dd < _tersoffCutoffRadiusSquare)) {
-						_particlePairsHandler->preprocessTersoffPair(molecule1, molecule2, false);
+					kernel.processPair(molecule1, molecule2, distanceVector, MOLECULE_MOLECULE, dd, (dd < _LJCutoffRadiusSquare));
+					if (Kernel::tersoff && (num_tersoff > 0) && (molecule2.numTersoff() > 0) && (dd < _tersoffCutoffRadiusSquare)) {
+						kernel.preprocessTersoffPair(molecule1, molecule2, false);
 					}
 				}
 			}
@@ -104,7 +221,7 @@ void LegacyCellProcessor::processCellPair(ParticleCell& cell1, ParticleCell& cel
 	} // inner cell
 
 
-	if (cell1.isHaloCell()) {
+	if (Kernel::tersoff && cell1.isHaloCell()) {
 		assert(cell2.isHaloCell());
 		for (int i = 0; i < currentParticleCount; i++) {
 			Molecule& molecule1 = *currentCellParticles[i];
@@ -117,7 +234,7 @@ void LegacyCellProcessor::processCellPair(ParticleCell& cell1, ParticleCell& cel
 				if (molecule2.numTersoff() > 0) {
 					double dd = molecule2.dist2(molecule1, distanceVector);
 					if (dd < _tersoffCutoffRadiusSquare) {
-						_particlePairsHandler->preprocessTersoffPair(molecule1, molecule2, true);
+						kernel.preprocessTersoffPair(molecule1, molecule2, true);
 					}
 				}
 			}
@@ -141,9 +258,9 @@ void LegacyCellProcessor::processCellPair(ParticleCell& cell1, ParticleCell& cel
 						/* Do not sum up values twice. */
 						pairType = MOLECULE_HALOMOLECULE;
 					}
-					_particlePairsHandler->processPair(molecule1, molecule2, distanceVector, pairType, dd, (dd < _LJCutoffRadiusSquare));
-					if ((num_tersoff > 0) && (molecule2.numTersoff() > 0) && (dd < _tersoffCutoffRadiusSquare)) {
-						_particlePairsHandler->preprocessTersoffPair(molecule1, molecule2, (pairType == MOLECULE_HALOMOLECULE));
+					kernel.processPair(molecule1, molecule2, distanceVector, pairType, dd, (dd < _LJCutoffRadiusSquare));
+					if (Kernel::tersoff && (num_tersoff > 0) && (molecule2.numTersoff() > 0) && (dd < _tersoffCutoffRadiusSquare)) {
+						kernel.preprocessTersoffPair(molecule1, molecule2, (pairType == MOLECULE_HALOMOLECULE));
 					}
 				}
 			}
@@ -151,7 +268,9 @@ void LegacyCellProcessor::processCellPair(ParticleCell& cell1, ParticleCell& cel
 	} // if ( isBoundaryCell() )
 }
 
-void LegacyCellProcessor::processCell(ParticleCell& cell) {
+template <class Kernel>
+void LegacyCellProcessor::processCellKernel(ParticleCell& cell) {
+	Kernel kernel(_particlePairsHandler, _potForceAdapter);
 	assert(cell.isInActiveWindow());
 	double distanceVector[3];
 	std::vector<Molecule*>& currentCellParticles = cell.getParticlePointers();
@@ -168,16 +287,16 @@ void LegacyCellProcessor::processCell(ParticleCell& cell) {
 				double dd = molecule2.dist2(molecule1, distanceVector);
 
 				if (dd < _cutoffRadiusSquare) {
-					_particlePairsHandler->processPair(molecule1, molecule2, distanceVector, MOLECULE_MOLECULE, dd, (dd < _LJCutoffRadiusSquare));
-					if ((num_tersoff > 0) && (molecule2.numTersoff() > 0) && (dd < _tersoffCutoffRadiusSquare)) {
-						_particlePairsHandler->preprocessTersoffPair(molecule1, molecule2, false);
+					kernel.processPair(molecule1, molecule2, distanceVector, MOLECULE_MOLECULE, dd, (dd < _LJCutoffRadiusSquare));
+					if (Kernel::tersoff && (num_tersoff > 0) && (molecule2.numTersoff() > 0) && (dd < _tersoffCutoffRadiusSquare)) {
+						kernel.preprocessTersoffPair(molecule1, molecule2, false);
 					}
 				}
 			}
 		}
 	} // if (isInnerCell())
 
-	if (cell.isHaloCell()) {
+	if (Kernel::tersoff && cell.isHaloCell()) {
 		for (int i = 0; i < currentParticleCount; i++) {
 			Molecule& molecule1 = *currentCellParticles[i];
 			if (molecule1.numTersoff() == 0)
@@ -189,7 +308,7 @@ void LegacyCellProcessor::processCell(ParticleCell& cell) {
 				if (molecule2.numTersoff() > 0) {
 					double dd = molecule2.dist2(molecule1, distanceVector);
 					if (dd < _tersoffCutoffRadiusSquare)
-						_particlePairsHandler->preprocessTersoffPair(molecule1, molecule2, true);
+						kernel.preprocessTersoffPair(molecule1, molecule2, true);
 				}
 			}
 		}
@@ -11,12 +11,19 @@
 #include "particleContainer/adapter/CellProcessor.h"
 
 class ParticlePairsHandler;
+class ParticlePairs2PotForceAdapter;
 class ParticleCell;
 
 /**
  * This class is a simple extraction of the cell handling from the old
  * class Blocktraverse.
  * I expect it to be slightly refactored one day...
+ *
+ * The loops over the molecule pairs are templates of a pair kernel, which
+ * either calls the (virtual) ParticlePairsHandler, or, if the handler is a
+ * ParticlePairs2PotForceAdapter and there are no Tersoff sites, the force
+ * calculation specialised for the site types present in the simulation.
+ * The kernel is chosen in initTraversal().
  */
 class LegacyCellProcessor : public CellProcessor {
 
@@ -25,6 +32,27 @@ private:
 	const double _LJCutoffRadiusSquare;
 	const double _tersoffCutoffRadiusSquare;
 	ParticlePairsHandler* const _particlePairsHandler;
+	//! _particlePairsHandler if it is a ParticlePairs2PotForceAdapter, NULL otherwise
+	ParticlePairs2PotForceAdapter* const _potForceAdapter;
+
+	//! cell loops of the kernel chosen in initTraversal()
+	void (LegacyCellProcessor::*_processCellPair)(ParticleCell& cell1, ParticleCell& cell2);
+	void (LegacyCellProcessor::*_processCell)(ParticleCell& cell);
+
+	//! energy of m1 with the molecules of cell2 (m1 itself excluded)
+	double singleMoleculeEnergy(Molecule* m1, ParticleCell& cell2);
+
+	//! choose the kernel for the site types of the current components
+	void selectKernel();
+
+	template <class Kernel>
+	void useKernel();
+
+	template <class Kernel>
+	void processCellPairKernel(ParticleCell& cell1, ParticleCell& cell2);
+
+	template <class Kernel>
+	void processCellKernel(ParticleCell& cell);
 
 public:
 
@@ -41,6 +69,9 @@ public:
 
 	double processSingleMolecule(Molecule* m1, ParticleCell& cell2);
 
+	//! The pair handler is used directly, so no window is opened for the trials.
+	double trialEnergy(Molecule* m1, const std::vector<ParticleCell*>& cells);
+
 	void processCell(ParticleCell& cell);
 
 	void postprocessCell(ParticleCell& cell);
@@ -96,6 +96,31 @@ public:
         return 0.0;
 	}
 
+	/** processPair() for the pair types MOLECULE_MOLECULE and MOLECULE_HALOMOLECULE
+	 * of molecules consisting only of the given site types.
+	 *
+	 * The parameters are read from the flat tables of Comp2Param. As this method
+	 * is not virtual, it is inlined into the loops of the LegacyCellProcessor.
+	 *
+	 * @tparam Sites  site types present in the simulation (see SiteTypes)
+	 */
+	template <class Sites>
+	double processPairSpecialized(Molecule& molecule1, Molecule& molecule2, double distanceVector[3], PairType pairType, double dd, bool calculateLJ) {
+		ParaTable params = _domain.getComp2Params().table(molecule1.componentid(), molecule2.componentid());
+
+		if (pairType == MOLECULE_MOLECULE) {
+			if ( _rdf != NULL )
+				_rdf->observeRDF(molecule1, molecule2, dd, distanceVector);
+
+			PotForce<Sites>(molecule1, molecule2, params, distanceVector, _upot6LJ, _upotXpoles, _myRF, _virial, calculateLJ);
+			return _upot6LJ + _upotXpoles;
+		}
+
+		double dummy1, dummy2, dummy3, dummy4;
+		PotForce<Sites>(molecule1, molecule2, params, distanceVector, dummy1, dummy2, dummy3, dummy4, calculateLJ);
+		return 0.0;
+	}
+
 	//! Only for so-called original pairs (pair type 0) the contributions
 	//! to the macroscopic values have to be collected
 	//!
@@ -0,0 +1,136 @@
+#include "particleContainer/adapter/ProfileSampler.h"
+
+#include <cmath>
+
+#include "molecules/Molecule.h"
+
+using namespace std;
+
+
+ProfileSampler::ProfileSampler() {
+	for (int d = 0; d < 3; d++) {
+		_numBins[d] = 1;
+		_invBinLength[d] = 0.0;
+	}
+}
+
+void ProfileSampler::setup(const unsigned numBins[3], const double globalLength[3]) {
+	for (int d = 0; d < 3; d++) {
+		_numBins[d] = numBins[d];
+		_invBinLength[d] = (double) numBins[d] / globalLength[d];
+	}
+	reset();
+}
+
+void ProfileSampler::considerComponent(unsigned cid) {
+	if (_profiledComponents.size() <= cid) {
+		_profiledComponents.resize(cid + 1, false);
+	}
+	_profiledComponents[cid] = true;
+}
+
+void ProfileSampler::reset() {
+	_N.assign(numBins(), 0.0);
+	for (int d = 0; d < 3; d++) {
+		_v[d].assign(numBins(), 0.0);
+	}
+	_DOF.assign(numBins(), 0.0);
+	_kinetic.assign(numBins(), 0.0);
+}
+
+bool ProfileSampler::isProfiled(const Molecule* molecule) const {
+	unsigned cid = molecule->componentid();
+	return cid < _profiledComponents.size() && _profiledComponents[cid];
+}
+
+int ProfileSampler::binCoordinate(int d, double x) const {
+	int bin = (int) floor(x * _invBinLength[d]);
+	if (bin < 0) {
+		return 0;
+	}
+	if (bin >= (int) _numBins[d]) {
+		return _numBins[d] - 1;
+	}
+	return bin;
+}
+
+int ProfileSampler::binOfInterval(int d, double low, double high) const {
+	// cell boundaries which coincide with bin boundaries must not be
+	// spoiled by rounding, so allow for a small tolerance (in units of bins)
+	const double tolerance = 1e-9;
+	int lowBin = (int) floor(low * _invBinLength[d] + tolerance);
+	int highBin = (int) floor(high * _invBinLength[d] - tolerance);
+	if (lowBin != highBin || lowBin < 0 || lowBin >= (int) _numBins[d]) {
+		return -1;
+	}
+	return lowBin;
+}
+
+unsigned ProfileSampler::binIndex(const double r[3]) const {
+	return (binCoordinate(0, r[0]) * _numBins[1] + binCoordinate(1, r[1])) * _numBins[2] + binCoordinate(2, r[2]);
+}
+
+void ProfileSampler::add(unsigned bin, double N, const double v[3], double DOF, double kinetic) {
+	_N[bin] += N;
+	for (int d = 0; d < 3; d++) {
+		_v[d][bin] += v[d];
+	}
+	_DOF[bin] += DOF;
+	_kinetic[bin] += kinetic;
+}
+
+void ProfileSampler::sampleMolecule(Molecule* molecule) {
+	if (!isProfiled(molecule)) {
+		return;
+	}
+	const double r[3] = { molecule->r(0), molecule->r(1), molecule->r(2) };
+	const double v[3] = { molecule->v(0), molecule->v(1), molecule->v(2) };
+	// record _twice_ the total (ordered + unordered) kinetic energy
+	add(binIndex(r), 1.0, v, 3.0 + molecule->component()->getRotationalDegreesOfFreedom(),
+			molecule->mass() * molecule->v2() + molecule->Iw2());
+}
+
+void ProfileSampler::sampleCell(const vector<Molecule*>& molecules, const double cellMin[3], const double cellMax[3]) {
+	int cellBin[3];
+	bool singleBin = true;
+	for (int d = 0; d < 3; d++) {
+		cellBin[d] = binOfInterval(d, cellMin[d], cellMax[d]);
+		singleBin = singleBin && (cellBin[d] >= 0);
+	}
+
+	if (singleBin) {
+		double N = 0.0, DOF = 0.0, kinetic = 0.0;
+		double v[3] = { 0.0, 0.0, 0.0 };
+		for (vector<Molecule*>::const_iterator it = molecules.begin(); it != molecules.end(); ++it) {
+			Molecule* molecule = *it;
+			if (!isProfiled(molecule)) {
+				continue;
+			}
+			N += 1.0;
+			for (int d = 0; d < 3; d++) {
+				v[d] += molecule->v(d);
+			}
+			DOF += 3.0 + molecule->component()->getRotationalDegreesOfFreedom();
+			kinetic += molecule->mass() * molecule->v2() + molecule->Iw2();
+		}
+		if (N > 0.0) {
+			add((cellBin[0] * _numBins[1] + cellBin[1]) * _numBins[2] + cellBin[2], N, v, DOF, kinetic);
+		}
+		return;
+	}
+
+	for (vector<Molecule*>::const_iterator it = molecules.begin(); it != molecules.end(); ++it) {
+		Molecule* molecule = *it;
+		if (!isProfiled(molecule)) {
+			continue;
+		}
+		int bin[3];
+		for (int d = 0; d < 3; d++) {
+			bin[d] = (cellBin[d] >= 0) ? cellBin[d] : binCoordinate(d, molecule->r(d));
+		}
+		const double v[3] = { molecule->v(0), molecule->v(1), molecule->v(2) };
+		add((bin[0] * _numBins[1] + bin[1]) * _numBins[2] + bin[2], 1.0, v,
+				3.0 + molecule->component()->getRotationalDegreesOfFreedom(),
+				molecule->mass() * molecule->v2() + molecule->Iw2());
+	}
+}
@@ -0,0 +1,84 @@
+#ifndef PROFILESAMPLER_H_
+#define PROFILESAMPLER_H_
+
+#include <vector>
+
+class Molecule;
+
+/**
+ * @brief Accumulates the local density, velocity and kinetic energy profiles
+ * on a regular grid of bins covering the global domain.
+ *
+ * The bins are numbered x-major, i.e. bin (x, y, z) has the index
+ * x * numBins[1] * numBins[2] + y * numBins[2] + z.
+ *
+ * Molecules can either be sampled one by one (sampleMolecule()) or cell-wise
+ * (sampleCell()). For a cell which lies completely within one bin the sums over
+ * its molecules are formed first and added to that bin at once; for cells
+ * covering several bins, the bin index is only calculated in the dimensions in
+ * which the cell is not contained in a single bin. The kinetic energy is taken
+ * from the rotational energy cached by the integrator (see Molecule::Iw2()).
+ */
+class ProfileSampler {
+public:
+	ProfileSampler();
+
+	/** set up the bins and clear all profiles
+	 * @param numBins      number of bins in each dimension
+	 * @param globalLength size of the global domain
+	 */
+	void setup(const unsigned numBins[3], const double globalLength[3]);
+
+	/** record molecules of component cid in the profile */
+	void considerComponent(unsigned cid);
+
+	/** set all profiles to zero */
+	void reset();
+
+	/** total number of bins */
+	unsigned numBins() const { return _numBins[0] * _numBins[1] * _numBins[2]; }
+
+	/** bin containing the position r; positions outside of the domain are
+	 * attributed to the nearest bin */
+	unsigned binIndex(const double r[3]) const;
+
+	/** add a molecule to the profile, if its component is profiled */
+	void sampleMolecule(Molecule* molecule);
+
+	/** add the molecules of a cell to the profile
+	 * @param molecules all molecules in the cell
+	 * @param cellMin   low corner of the cell
+	 * @param cellMax   high corner of the cell
+	 */
+	void sampleCell(const std::vector<Molecule*>& molecules, const double cellMin[3], const double cellMax[3]);
+
+	long double N(unsigned bin) const { return _N[bin]; }
+	long double v(int d, unsigned bin) const { return _v[d][bin]; }
+	long double DOF(unsigned bin) const { return _DOF[bin]; }
+	//! twice the kinetic energy (translational and rotational)
+	long double kinetic(unsigned bin) const { return _kinetic[bin]; }
+
+private:
+	bool isProfiled(const Molecule* molecule) const;
+
+	/** bin index in dimension d of the coordinate x */
+	int binCoordinate(int d, double x) const;
+
+	/** bin index in dimension d which contains the complete interval [low, high],
+	 * -1 if the interval covers more than one bin */
+	int binOfInterval(int d, double low, double high) const;
+
+	void add(unsigned bin, double N, const double v[3], double DOF, double kinetic);
+
+	unsigned _numBins[3];
+	double _invBinLength[3];
+
+	std::vector<bool> _profiledComponents;
+
+	std::vector<long double> _N;
+	std::vector<long double> _v[3];
+	std::vector<long double> _DOF;
+	std::vector<long double> _kinetic;
+};
+
+#endif /* PROFILESAMPLER_H_ */
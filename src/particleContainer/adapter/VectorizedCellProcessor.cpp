@@ -8,18 +8,25 @@
 #include "molecules/Molecule.h"
 #include "particleContainer/ParticleCell.h"
 #include "Domain.h"
+#include "io/RDF.h"
 #include "utils/Logger.h"
 #include "ensemble/EnsembleBase.h"
 #include "Simulation.h"
 
 #include <algorithm>
+#include <limits>
 
 using namespace Log;
 
+// The kernels may round the molecule distance differently (e.g. with fused multiply-adds),
+// a cell pair is only culled if its bounding boxes are clearly beyond the cutoff.
+static const double BOUNDING_BOX_TOLERANCE = 1.0 + 1e-10;
+
 VectorizedCellProcessor::VectorizedCellProcessor(Domain & domain,
 		double cutoffRadius) :
-		_domain(domain), _rc2(cutoffRadius * cutoffRadius), _compIDs(), _eps_sig(), _shift6(), _upot6lj(
-				0.0), _virial(0.0), _center_dist_lookup(128) {
+		_domain(domain), _rc2(cutoffRadius * cutoffRadius), _compIDs(), _eps_sig(), _shift6(), _kernel(GENERIC), _uniformLJ(false), _mixture(false), _singleCenter(false),
+		_centersPerMolecule(0), _uniformEps24(0.0), _uniformSig2(0.0), _uniformShift6(0.0), _centerTypes(), _upot6lj(0.0), _virial(0.0), _center_dist_lookup(128), _center_dist2_lookup(128), _rdf(NULL), _rdfActive(false),
+		_computeMacroscopicValues(true), _forcesOnly(false), _boundingBoxCulling(true) {
 #if VLJCP_VEC_TYPE==VLJCP_NOVEC
 	Log::global_log->info() << "VectorizedLJCellProcessor: no vectorization."
 	<< std::endl;
@@ -44,6 +51,7 @@ VectorizedCellProcessor::VectorizedCellProcessor(Domain & domain,
 	for (ComponentList::const_iterator c = components.begin(); c != end; ++c) {
 		_compIDs[c->ID()] = centers;
 		centers += c->numLJcenters();
+		_centerCompIDs.resize(centers, c->ID());
 	}
 
 	// One row for each LJ Center, one pair (epsilon*24, sigma^2) for each LJ Center in each row.
@@ -78,6 +86,119 @@ VectorizedCellProcessor::VectorizedCellProcessor(Domain & domain,
 			}
 		}
 	}
+
+	// Choose the kernel specialization matching the components.
+	_uniformLJ = centers > 0;
+	for (size_t i = 0; i < centers && _uniformLJ; ++i) {
+		for (size_t j = 0; j < centers && _uniformLJ; ++j) {
+			_uniformLJ = _eps_sig[i][2 * j] == _eps_sig[0][0]
+					&& _eps_sig[i][2 * j + 1] == _eps_sig[0][1]
+					&& _shift6[i][j] == _shift6[0][0];
+		}
+	}
+	if (_uniformLJ) {
+		_uniformEps24 = _eps_sig[0][0];
+		_uniformSig2 = _eps_sig[0][1];
+		_uniformShift6 = _shift6[0][0];
+	}
+	// Assign the centers to types of equal parameters, the first center of each type is its representative.
+	_centerTypes.resize(centers, 0);
+	std::vector<size_t> typeCenters;
+	for (size_t i = 0; i < centers; ++i) {
+		size_t t = 0;
+		while (t < typeCenters.size() && !_equalCenters(typeCenters[t], i)) {
+			++t;
+		}
+		if (t == typeCenters.size()) {
+			typeCenters.push_back(i);
+		}
+		_centerTypes[i] = t;
+	}
+	_mixture = centers > 0 && typeCenters.size() <= 2;
+	if (_mixture) {
+		typeCenters.resize(2, typeCenters[0]);
+	}
+	for (int t1 = 0; t1 < 2; ++t1) {
+		for (int t2 = 0; t2 < 2; ++t2) {
+			_mixtureEps24[t1][t2] = _mixture ? _eps_sig[typeCenters[t1]][2 * typeCenters[t2]] : 0.0;
+			_mixtureSig2[t1][t2] = _mixture ? _eps_sig[typeCenters[t1]][2 * typeCenters[t2] + 1] : 0.0;
+			_mixtureShift6[t1][t2] = _mixture ? _shift6[typeCenters[t1]][typeCenters[t2]] : 0.0;
+		}
+	}
+	_singleCenter = true;
+	_centersPerMolecule = components.empty() ? 0 : components[0].numLJcenters();
+	for (ComponentList::const_iterator c = components.begin(); c != end; ++c) {
+		if (c->numLJcenters() > 1 || (c->numLJcenters() == 1
+				&& (c->ljcenter(0).rx() != 0.0 || c->ljcenter(0).ry() != 0.0 || c->ljcenter(0).rz() != 0.0))) {
+			_singleCenter = false;
+		}
+		if (static_cast<int>(c->numLJcenters()) != _centersPerMolecule) {
+			_centersPerMolecule = 0;
+		}
+	}
+	int kernel = _uniformLJ ? UNIFORM_LJ : (_mixture ? MIXTURE : GENERIC);
+	if (_singleCenter) {
+		kernel |= SINGLE_CENTER;
+	} else if (_centersPerMolecule == 2) {
+		kernel |= TWO_CENTERS;
+	} else if (_centersPerMolecule == 3) {
+		kernel |= THREE_CENTERS;
+	}
+	setKernel(static_cast<Kernel>(kernel));
+}
+
+bool VectorizedCellProcessor::_equalCenters(size_t a, size_t b) const {
+	for (size_t j = 0; j < _eps_sig.size(); ++j) {
+		if (_eps_sig[a][2 * j] != _eps_sig[b][2 * j] || _eps_sig[a][2 * j + 1] != _eps_sig[b][2 * j + 1]
+				|| _shift6[a][j] != _shift6[b][j]
+				|| _eps_sig[j][2 * a] != _eps_sig[j][2 * b] || _eps_sig[j][2 * a + 1] != _eps_sig[j][2 * b + 1]
+				|| _shift6[j][a] != _shift6[j][b]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool VectorizedCellProcessor::isKernelApplicable(Kernel kernel) const {
+	switch (kernel & PARAMETERS_MASK) {
+	case UNIFORM_LJ:
+		if (!_uniformLJ) {
+			return false;
+		}
+		break;
+	case MIXTURE:
+		if (!_mixture) {
+			return false;
+		}
+		break;
+	case GENERIC:
+		break;
+	default:
+		return false;
+	}
+	switch (kernel & CENTERS_MASK) {
+	case SINGLE_CENTER:
+		return _singleCenter;
+	case TWO_CENTERS:
+		return _centersPerMolecule == 2;
+	case THREE_CENTERS:
+		return _centersPerMolecule == 3;
+	default:
+		return true;
+	}
+}
+
+void VectorizedCellProcessor::setKernel(Kernel kernel) {
+	if (!isKernelApplicable(kernel)) {
+		Log::global_log->error() << "VectorizedLJCellProcessor: kernel " << kernel
+				<< " is not applicable to the components." << std::endl;
+		exit(1);
+	}
+	_kernel = kernel;
+	const char* parameterNames[] = { "generic LJ parameters", "uniform LJ parameters", "two LJ center types" };
+	const char* centerNames[] = { "any number of", "a single", "two", "three" };
+	Log::global_log->info() << "VectorizedLJCellProcessor: using the kernel for " << parameterNames[_kernel & PARAMETERS_MASK]
+			<< " and " << centerNames[(_kernel & CENTERS_MASK) >> 2] << " centers per molecule." << std::endl;
 }
 
 VectorizedCellProcessor :: ~VectorizedCellProcessor () {
@@ -91,6 +212,9 @@ VectorizedCellProcessor :: ~VectorizedCellProcessor () {
 void VectorizedCellProcessor::initTraversal(const size_t numCells) {
 	_virial = 0.0;
 	_upot6lj = 0.0;
+	_rdfActive = (_rdf != NULL) && _rdf->isSampling();
+	// the RDF counts each pair once by the MacroPolicy, so it needs all values
+	_forcesOnly = !_computeMacroscopicValues && !_rdfActive;
 
 	global_log->debug() << "VectorizedLJCellProcessor::initTraversal() to " << numCells << " cells." << std::endl;
 
@@ -134,18 +258,37 @@ void VectorizedCellProcessor::preprocessCell(ParticleCell & c) {
 	_particleCellDataVector.pop_back();
 	CellDataSoA & soa = *soaPtr;
 
+	// the molecules of a halo cell may be those of its periodic image
+	const double* shift = c.getPeriodicShift();
+	for (int d = 0; d < 3; ++d) {
+		soa._mol_pos_min[d] = std::numeric_limits<double>::max();
+		soa._mol_pos_max[d] = -std::numeric_limits<double>::max();
+	}
+
+	// the type mask of the second center type for the MIXTURE kernels, all bits set
+	const signed long typeMask_l = ~0l;
+	// this casting via void* is required for gcc
+	const void* typeMask_tmp = reinterpret_cast<const void*>(&typeMask_l);
+	const double typeMask = *reinterpret_cast<double const* const>(typeMask_tmp);
+
 	size_t n = 0;
 	// For each molecule iterate over all its LJ centers.
 	for (size_t i = 0; i < molecules.size(); ++i) {
 		const size_t nLJC = molecules[i]->numLJcenters();
-		const double mol_pos_x = molecules[i]->r(0);
-		const double mol_pos_y = molecules[i]->r(1);
-		const double mol_pos_z = molecules[i]->r(2);
+		const double mol_pos_x = molecules[i]->r(0) + shift[0];
+		const double mol_pos_y = molecules[i]->r(1) + shift[1];
+		const double mol_pos_z = molecules[i]->r(2) + shift[2];
 
 		soa._mol_pos_x[i] = mol_pos_x;
 		soa._mol_pos_y[i] = mol_pos_y;
 		soa._mol_pos_z[i] = mol_pos_z;
 		soa._mol_num_ljc[i] = nLJC;
+		soa._mol_pos_min[0] = std::min(soa._mol_pos_min[0], mol_pos_x);
+		soa._mol_pos_min[1] = std::min(soa._mol_pos_min[1], mol_pos_y);
+		soa._mol_pos_min[2] = std::min(soa._mol_pos_min[2], mol_pos_z);
+		soa._mol_pos_max[0] = std::max(soa._mol_pos_max[0], mol_pos_x);
+		soa._mol_pos_max[1] = std::max(soa._mol_pos_max[1], mol_pos_y);
+		soa._mol_pos_max[2] = std::max(soa._mol_pos_max[2], mol_pos_z);
 
 		for (size_t j = 0; j < nLJC; ++j, ++n) {
 			// Store a copy of the molecule position for each center, and the position of
@@ -160,11 +303,13 @@ void VectorizedCellProcessor::preprocessCell(ParticleCell & c) {
 			soa._ljc_f_y[n] = 0.0;
 			soa._ljc_f_z[n] = 0.0;
 			soa._ljc_id[n] = _compIDs[molecules[i]->componentid()] + j;
+			soa._ljc_type_mask[n] = _centerTypes[soa._ljc_id[n]] ? typeMask : 0.0;
 		}
 	}
 
 	if (_center_dist_lookup.get_size() < nLJCenters) {
 		_center_dist_lookup.resize(nLJCenters);
+		_center_dist2_lookup.resize(nLJCenters);
 	}
 }
 
@@ -175,9 +320,10 @@ void VectorizedCellProcessor::postprocessCell(ParticleCell & c) {
 
 	MoleculeList & molecules = c.getParticlePointers();
 
-	// For each molecule iterate over all its centers.
+	// For each molecule iterate over all its centers. The forces on halo molecules
+	// are not needed, and for periodic images they are the molecules of another cell.
 	size_t n = 0;
-	size_t numMols = molecules.size();
+	size_t numMols = c.isHaloCell() ? 0 : molecules.size();
 	for (size_t m = 0; m < numMols; ++m) {
 		const size_t end = molecules[m]->numLJcenters();
 		for (size_t i = 0; i < end; ++i) {
@@ -199,7 +345,7 @@ void VectorizedCellProcessor::postprocessCell(ParticleCell & c) {
 	c.setCellDataSoA(0);
 }
 
-template<class ForcePolicy, class MacroPolicy>
+template<class ForcePolicy, class MacroPolicy, int Parameters>
 inline
 void VectorizedCellProcessor :: _loopBodyNovec (const CellDataSoA& soa1, size_t i, const CellDataSoA& soa2, size_t j, const double *const forceMask)
 {
@@ -215,8 +361,9 @@ void VectorizedCellProcessor :: _loopBodyNovec (const CellDataSoA& soa1, size_t
 		const double c_r2 = c_dx * c_dx + c_dy * c_dy + c_dz * c_dz;
 		const double r2_inv = 1.0 / c_r2;
 
-		const double eps_24 = _eps_sig[soa1._ljc_id[i]][2 * soa2._ljc_id[j]];
-		const double sig2 = _eps_sig[soa1._ljc_id[i]][2 * soa2._ljc_id[j] + 1];
+		// a single pair gathers its parameters from the table also for MIXTURE
+		const double eps_24 = (Parameters == UNIFORM_LJ) ? _uniformEps24 : _eps_sig[soa1._ljc_id[i]][2 * soa2._ljc_id[j]];
+		const double sig2 = (Parameters == UNIFORM_LJ) ? _uniformSig2 : _eps_sig[soa1._ljc_id[i]][2 * soa2._ljc_id[j] + 1];
 
 		const double lj2 = sig2 * r2_inv;
 		const double lj6 = lj2 * lj2 * lj2;
@@ -235,7 +382,8 @@ void VectorizedCellProcessor :: _loopBodyNovec (const CellDataSoA& soa1, size_t
 
 		// Check if we have to add the macroscopic values up for this pair.
 		if (MacroPolicy :: MacroscopicValueCondition(m_dx, m_dy, m_dz)) {
-			_upot6lj += eps_24 * lj12m6 + _shift6[soa1._ljc_id[i]][soa2._ljc_id[j]];
+			const double shift6 = (Parameters == UNIFORM_LJ) ? _uniformShift6 : _shift6[soa1._ljc_id[i]][soa2._ljc_id[j]];
+			_upot6lj += eps_24 * lj12m6 + shift6;
 			_virial += m_dx * fx + m_dy * fy + m_dz * fz;
 		}
 		// Add the force to center 1, and subtract it from center 2.
@@ -250,6 +398,51 @@ void VectorizedCellProcessor :: _loopBodyNovec (const CellDataSoA& soa1, size_t
 }  /* end of method VectorizedLJCellProcessor :: _loopBodyNovec */
 
 template<class ForcePolicy, class MacroPolicy>
+void VectorizedCellProcessor::_observeRDF(const CellDataSoA & soa1, size_t i, size_t i_center_idx, const CellDataSoA & soa2) {
+	const int num_ljc1 = soa1._mol_num_ljc[i];
+	if (num_ljc1 == 0) {
+		return;
+	}
+	const unsigned cid1 = _centerCompIDs[soa1._ljc_id[i_center_idx]];
+	const bool siteRDF = _rdf->siteRDF();
+
+	size_t j = 0;
+	for (size_t k = 0; k < soa2._num_molecules; j += soa2._mol_num_ljc[k], ++k) {
+		// in a single cell, each pair is counted by its first molecule; for the others,
+		// the cutoff check has not stored any distance
+		if (soa2._mol_num_ljc[k] == 0 || (ForcePolicy::DetectSingleCell() && j <= i_center_idx)) {
+			continue;
+		}
+		if (_center_dist_lookup[j] == 0.0) {
+			continue;
+		}
+		const double m_dx = soa1._mol_pos_x[i] - soa2._m_r_x[j];
+		const double m_dy = soa1._mol_pos_y[i] - soa2._m_r_y[j];
+		const double m_dz = soa1._mol_pos_z[i] - soa2._m_r_z[j];
+		if (!MacroPolicy::MacroscopicValueCondition(m_dx, m_dy, m_dz)) {
+			continue;
+		}
+
+		const unsigned cid2 = _centerCompIDs[soa2._ljc_id[j]];
+		_rdf->observeRDF(_center_dist2_lookup[j], cid1, cid2);
+
+		const int num_ljc2 = soa2._mol_num_ljc[k];
+		if (siteRDF && num_ljc1 + num_ljc2 > 2) {
+			for (int m = 0; m < num_ljc1; ++m) {
+				const size_t c1 = i_center_idx + m;
+				for (int n = 0; n < num_ljc2; ++n) {
+					const size_t c2 = j + n;
+					const double c_dx = soa1._ljc_r_x[c1] - soa2._ljc_r_x[c2];
+					const double c_dy = soa1._ljc_r_y[c1] - soa2._ljc_r_y[c2];
+					const double c_dz = soa1._ljc_r_z[c1] - soa2._ljc_r_z[c2];
+					_rdf->observeRDF(c_dx * c_dx + c_dy * c_dy + c_dz * c_dz, cid1, cid2, m, n);
+				}
+			}
+		}
+	}
+}
+
+template<class ForcePolicy, class MacroPolicy, int Parameters, bool SingleCenter, bool CalculateRDF>
 void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 		const CellDataSoA & soa2) {
 #if VLJCP_VEC_TYPE==VLJCP_NOVEC
@@ -269,6 +462,9 @@ void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 			const signed long forceMask = ForcePolicy :: Condition(m_r2, _rc2) ? (~0l) : 0l;
 			compute_molecule |= forceMask;
 			*(_center_dist_lookup + j) = forceMask;
+			if (CalculateRDF) {
+				*(_center_dist2_lookup + j) = m_r2;
+			}
 		}
 
 		if (!compute_molecule) {
@@ -276,9 +472,13 @@ void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 			continue;
 		}
 
+		if (CalculateRDF) {
+			_observeRDF<ForcePolicy, MacroPolicy>(soa1, i, i_center_idx, soa2);
+		}
+
 		for (int local_i = 0; local_i < soa1._mol_num_ljc[i]; local_i++ ) {
 			for (size_t j = ForcePolicy :: InitJ(i_center_idx); j < soa2._num_ljcenters; ++j) {
-				_loopBodyNovec<CellPairPolicy_, MacroPolicy>(soa1, i_center_idx, soa2, j, _center_dist_lookup + j);
+				_loopBodyNovec<CellPairPolicy_, MacroPolicy, Parameters>(soa1, i_center_idx, soa2, j, _center_dist_lookup + j);
 			}
 			i_center_idx++;
 		}
@@ -307,11 +507,20 @@ void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 	double * const p_cfy2 = soa2._ljc_f_y;
 	double * const p_cfz2 = soa2._ljc_f_z;
 	const size_t * const p_cid2 = soa2._ljc_id;
+	const double * const p_ctype2 = soa2._ljc_type_mask;
 
 	double* const p_center_dist_lookup = _center_dist_lookup;
+	double* const p_center_dist2_lookup = _center_dist2_lookup;
 	const size_t end_j = soa2._num_ljcenters & (~1);
 	const __m128d one = _mm_set1_pd(1.0);
 	const __m128d rc2 = _mm_set1_pd(_rc2);
+	const __m128d ones = _mm_castsi128_pd(_mm_set1_epi32(~0));
+	const __m128d uniform_eps_24 = _mm_set1_pd(_uniformEps24);
+	const __m128d uniform_sig2 = _mm_set1_pd(_uniformSig2);
+	const __m128d uniform_shift6 = _mm_set1_pd(_uniformShift6);
+	// With a single center per molecule, the force mask is calculated in the force loop,
+	// only the leftover centers and the distances for the RDF are stored beforehand.
+	const bool maskInForceLoop = SingleCenter && !CalculateRDF;
 	__m128d sum_upot = _mm_setzero_pd();
 	__m128d sum_virial = _mm_setzero_pd();
 
@@ -326,6 +535,9 @@ void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 		// distance and forca mask computation
 		__m128d compute_molecule = _mm_setzero_pd();
 		size_t j = ForcePolicy :: InitJ(i_center_idx);
+		if (maskInForceLoop) {
+			j = std::max(j, end_j);
+		}
 		for (; j < end_j; j+=2) {
 			const __m128d m_r_x2 = _mm_load_pd(p_mrx2 + j);
 			const __m128d m_dx = _mm_sub_pd(m_r_x1, m_r_x2);
@@ -340,6 +552,9 @@ void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 			const __m128d m_r2 = _mm_add_pd(m_dxdx_dydy, m_dzdz);
 			const __m128d forceMask = ForcePolicy::GetForceMask(m_r2, rc2);
 			_mm_store_pd(p_center_dist_lookup + j, forceMask);
+			if (CalculateRDF) {
+				_mm_store_pd(p_center_dist2_lookup + j, m_r2);
+			}
 			compute_molecule = _mm_or_pd(compute_molecule, forceMask);
 		}
 		for (; j < soa2._num_ljcenters; ++j) {
@@ -354,15 +569,22 @@ void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 			double forceMask = *reinterpret_cast<double const* const>(forceMask_tmp);
 
 			*(p_center_dist_lookup + j) = forceMask;
+			if (CalculateRDF) {
+				*(p_center_dist2_lookup + j) = m_r2;
+			}
 			const __m128d forceMask_128 = _mm_set1_pd(forceMask);
 			compute_molecule = _mm_or_pd(compute_molecule, forceMask_128);
 		}
 
-		if (!_mm_movemask_pd(compute_molecule)) {
+		if (!maskInForceLoop && !_mm_movemask_pd(compute_molecule)) {
 			i_center_idx += soa1._mol_num_ljc[i];
 			continue;
 		}
 
+		if (CalculateRDF) {
+			_observeRDF<ForcePolicy, MacroPolicy>(soa1, i, i_center_idx, soa2);
+		}
+
 
 
 		// actual force computation
@@ -373,12 +595,20 @@ void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 			const __m128d c_r_x1 = _mm_loaddup_pd(p_crx1 + i_center_idx);
 			const __m128d c_r_y1 = _mm_loaddup_pd(p_cry1 + i_center_idx);
 			const __m128d c_r_z1 = _mm_loaddup_pd(p_crz1 + i_center_idx);
+			// MIXTURE: the parameters of center i with both center types
+			const unsigned type_i = (Parameters == MIXTURE) ? _centerTypes[p_cid1[i_center_idx]] : 0;
+			const __m128d mixture_eps_24_0 = _mm_set1_pd(_mixtureEps24[type_i][0]);
+			const __m128d mixture_eps_24_1 = _mm_set1_pd(_mixtureEps24[type_i][1]);
+			const __m128d mixture_sig2_0 = _mm_set1_pd(_mixtureSig2[type_i][0]);
+			const __m128d mixture_sig2_1 = _mm_set1_pd(_mixtureSig2[type_i][1]);
+			const __m128d mixture_shift6_0 = _mm_set1_pd(_mixtureShift6[type_i][0]);
+			const __m128d mixture_shift6_1 = _mm_set1_pd(_mixtureShift6[type_i][1]);
 			// Iterate over each pair of centers in the second cell.
 			size_t j = ForcePolicy::InitJ(i_center_idx);
 			for (; j < end_j; j += 2) {
-				const __m128d forceMask = _mm_load_pd(p_center_dist_lookup + j);
+				const __m128d storedMask = maskInForceLoop ? ones : _mm_load_pd(p_center_dist_lookup + j);
 				// Only go on if at least 1 of the forces has to be calculated.
-				if (_mm_movemask_pd(forceMask) > 0) {
+				if (_mm_movemask_pd(storedMask) > 0) {
 					const __m128d c_r_x2 = _mm_load_pd(p_crx2 + j);
 					const __m128d c_dx = _mm_sub_pd(c_r_x1, c_r_x2);
 					const __m128d c_r_y2 = _mm_load_pd(p_cry2 + j);
@@ -390,15 +620,28 @@ void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 					const __m128d c_dzdz = _mm_mul_pd(c_dz, c_dz);
 					const __m128d c_dxdx_dydy = _mm_add_pd(c_dxdx, c_dydy);
 					const __m128d c_r2 = _mm_add_pd(c_dxdx_dydy, c_dzdz);
+					// the center is the center of mass, so c_r2 is the molecule distance
+					const __m128d forceMask = maskInForceLoop ? ForcePolicy::GetForceMask(c_r2, rc2) : storedMask;
+					if (maskInForceLoop && !_mm_movemask_pd(forceMask)) {
+						continue;
+					}
 					const __m128d r2_inv_unmasked = _mm_div_pd(one, c_r2);
 					const __m128d r2_inv = _mm_and_pd(r2_inv_unmasked, forceMask);
 					const size_t id_i = p_cid1[i_center_idx];
 					const size_t id_j0 = p_cid2[j];
 					const size_t id_j1 = p_cid2[j + 1];
-					const __m128d e1s1 = _mm_load_pd(_eps_sig[id_i] + 2 * id_j0);
-					const __m128d e2s2 = _mm_load_pd(_eps_sig[id_i] + 2 * id_j1);
-					const __m128d eps_24 = _mm_unpacklo_pd(e1s1, e2s2);
-					const __m128d sig2 = _mm_unpackhi_pd(e1s1, e2s2);
+					__m128d eps_24 = uniform_eps_24;
+					__m128d sig2 = uniform_sig2;
+					const __m128d type_j = (Parameters == MIXTURE) ? _mm_load_pd(p_ctype2 + j) : _mm_setzero_pd();
+					if (Parameters == MIXTURE) {
+						eps_24 = _mm_or_pd(_mm_and_pd(type_j, mixture_eps_24_1), _mm_andnot_pd(type_j, mixture_eps_24_0));
+						sig2 = _mm_or_pd(_mm_and_pd(type_j, mixture_sig2_1), _mm_andnot_pd(type_j, mixture_sig2_0));
+					} else if (Parameters == GENERIC) {
+						const __m128d e1s1 = _mm_load_pd(_eps_sig[id_i] + 2 * id_j0);
+						const __m128d e2s2 = _mm_load_pd(_eps_sig[id_i] + 2 * id_j1);
+						eps_24 = _mm_unpacklo_pd(e1s1, e2s2);
+						sig2 = _mm_unpackhi_pd(e1s1, e2s2);
+					}
 					const __m128d lj2 = _mm_mul_pd(sig2, r2_inv);
 					const __m128d lj4 = _mm_mul_pd(lj2, lj2);
 					const __m128d lj6 = _mm_mul_pd(lj4, lj2);
@@ -411,19 +654,21 @@ void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 					const __m128d fy = _mm_mul_pd(c_dy, scale);
 					const __m128d fz = _mm_mul_pd(c_dz, scale);
 
-					const __m128d m_r_x2 = _mm_load_pd(p_mrx2 + j);
-					const __m128d m_dx = _mm_sub_pd(m_r_x1, m_r_x2);
-					const __m128d m_r_y2 = _mm_load_pd(p_mry2 + j);
-					const __m128d m_dy = _mm_sub_pd(m_r_y1, m_r_y2);
-					const __m128d m_r_z2 = _mm_load_pd(p_mrz2 + j);
-					const __m128d m_dz = _mm_sub_pd(m_r_z1, m_r_z2);
+					const __m128d m_dx = SingleCenter ? c_dx : _mm_sub_pd(m_r_x1, _mm_load_pd(p_mrx2 + j));
+					const __m128d m_dy = SingleCenter ? c_dy : _mm_sub_pd(m_r_y1, _mm_load_pd(p_mry2 + j));
+					const __m128d m_dz = SingleCenter ? c_dz : _mm_sub_pd(m_r_z1, _mm_load_pd(p_mrz2 + j));
 
 					const __m128d macroMask = MacroPolicy::GetMacroMask(forceMask, m_dx, m_dy, m_dz);
 					// Only go on if at least 1 macroscopic value has to be calculated.
 					if (_mm_movemask_pd(macroMask) > 0) {
-						const __m128d sh1 = _mm_load_sd(_shift6[id_i] + id_j0);
-						const __m128d sh2 = _mm_load_sd(_shift6[id_i] + id_j1);
-						const __m128d shift6 = _mm_unpacklo_pd(sh1, sh2);
+						__m128d shift6 = uniform_shift6;
+						if (Parameters == MIXTURE) {
+							shift6 = _mm_or_pd(_mm_and_pd(type_j, mixture_shift6_1), _mm_andnot_pd(type_j, mixture_shift6_0));
+						} else if (Parameters == GENERIC) {
+							const __m128d sh1 = _mm_load_sd(_shift6[id_i] + id_j0);
+							const __m128d sh2 = _mm_load_sd(_shift6[id_i] + id_j1);
+							shift6 = _mm_unpacklo_pd(sh1, sh2);
+						}
 						const __m128d upot = _mm_mul_pd(eps_24, lj12m6);
 						const __m128d upot_sh = _mm_add_pd(shift6, upot);
 						const __m128d upot_masked = _mm_and_pd(upot_sh, macroMask);
@@ -466,7 +711,7 @@ void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 			// Unvectorized calculation for leftover pairs.
 			switch (soa2._num_ljcenters & 1) {
 				case 1: {
-					_loopBodyNovec<ForcePolicy, MacroPolicy>(soa1, i_center_idx, soa2, end_j, p_center_dist_lookup + j);
+					_loopBodyNovec<ForcePolicy, MacroPolicy, Parameters>(soa1, i_center_idx, soa2, end_j, p_center_dist_lookup + j);
 				}
 				break;
 			}
@@ -506,11 +751,20 @@ void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 	double * const p_cfy2 = soa2._ljc_f_y;
 	double * const p_cfz2 = soa2._ljc_f_z;
 	const size_t * const p_cid2 = soa2._ljc_id;
+	const double * const p_ctype2 = soa2._ljc_type_mask;
 
 	double* const p_center_dist_lookup = _center_dist_lookup;
+	double* const p_center_dist2_lookup = _center_dist2_lookup;
 	const size_t end_j = soa2._num_ljcenters & ~static_cast<size_t>(3);
 	const __m256d one = _mm256_set1_pd(1.0);
 	const __m256d rc2 = _mm256_set1_pd(_rc2);
+	const __m256d ones = _mm256_castsi256_pd(_mm256_set1_epi32(~0));
+	const __m256d uniform_eps_24 = _mm256_set1_pd(_uniformEps24);
+	const __m256d uniform_sig2 = _mm256_set1_pd(_uniformSig2);
+	const __m256d uniform_shift6 = _mm256_set1_pd(_uniformShift6);
+	// With a single center per molecule, the force mask is calculated in the force loop,
+	// only the leftover centers and the distances for the RDF are stored beforehand.
+	const bool maskInForceLoop = SingleCenter && !CalculateRDF;
 
 	__m256d sum_upot = _mm256_setzero_pd();
 	__m256d sum_virial = _mm256_setzero_pd();
@@ -531,6 +785,9 @@ void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 		__m256d compute_molecule = _mm256_setzero_pd();
 		size_t j = ForcePolicy :: InitJ(i_center_idx);
 		__m256d initJ_mask = ForcePolicy::InitJ_Mask(i_center_idx);
+		if (maskInForceLoop) {
+			j = std::max(j, end_j);
+		}
 		for (; j < end_j; j+=4) {
 			const __m256d m_r_x2 = _mm256_load_pd(p_mrx2 + j);
 			const __m256d m_dx = _mm256_sub_pd(m_r_x1, m_r_x2);
@@ -545,6 +802,9 @@ void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 			const __m256d m_r2 = _mm256_add_pd(m_dxdx_dydy, m_dzdz);
 			const __m256d forceMask = ForcePolicy::GetForceMask(m_r2, rc2, initJ_mask);
 			_mm256_store_pd(p_center_dist_lookup + j, forceMask);
+			if (CalculateRDF) {
+				_mm256_store_pd(p_center_dist2_lookup + j, m_r2);
+			}
 			compute_molecule = _mm256_or_pd(compute_molecule, forceMask);
 		}
 		for (; j < soa2._num_ljcenters; ++j) {
@@ -565,15 +825,22 @@ void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 			double forceMask = *reinterpret_cast<double const* const>(forceMask_tmp);
 
 			*(p_center_dist_lookup + j) = forceMask;
+			if (CalculateRDF) {
+				*(p_center_dist2_lookup + j) = m_r2;
+			}
 			const __m256d forceMask_256 = _mm256_set1_pd(forceMask);
 			compute_molecule = _mm256_or_pd(compute_molecule, forceMask_256);
 		}
 
-		if (!_mm256_movemask_pd(compute_molecule)) {
+		if (!maskInForceLoop && !_mm256_movemask_pd(compute_molecule)) {
 			i_center_idx += soa1._mol_num_ljc[i];
 			continue;
 		}
 
+		if (CalculateRDF) {
+			_observeRDF<ForcePolicy, MacroPolicy>(soa1, i, i_center_idx, soa2);
+		}
+
 		// actual force computation
 		for (int local_i = 0; local_i < soa1._mol_num_ljc[i]; local_i++ ) {
 			__m256d sum_fx1 = _mm256_setzero_pd();
@@ -582,12 +849,21 @@ void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 			const __m256d c_r_x1 = _mm256_broadcast_sd(p_crx1 + i_center_idx);
 			const __m256d c_r_y1 = _mm256_broadcast_sd(p_cry1 + i_center_idx);
 			const __m256d c_r_z1 = _mm256_broadcast_sd(p_crz1 + i_center_idx);
+			// MIXTURE: the parameters of center i with both center types
+			const unsigned type_i = (Parameters == MIXTURE) ? _centerTypes[p_cid1[i_center_idx]] : 0;
+			const __m256d mixture_eps_24_0 = _mm256_set1_pd(_mixtureEps24[type_i][0]);
+			const __m256d mixture_eps_24_1 = _mm256_set1_pd(_mixtureEps24[type_i][1]);
+			const __m256d mixture_sig2_0 = _mm256_set1_pd(_mixtureSig2[type_i][0]);
+			const __m256d mixture_sig2_1 = _mm256_set1_pd(_mixtureSig2[type_i][1]);
+			const __m256d mixture_shift6_0 = _mm256_set1_pd(_mixtureShift6[type_i][0]);
+			const __m256d mixture_shift6_1 = _mm256_set1_pd(_mixtureShift6[type_i][1]);
 			// Iterate over each pair of centers in the second cell.
 			size_t j = ForcePolicy::InitJ(i_center_idx);
+			__m256d initJ_forceMask = ForcePolicy::InitJ_Mask(i_center_idx);
 			for (; j < end_j; j += 4) {
-				const __m256d forceMask = _mm256_load_pd(p_center_dist_lookup + j);
+				const __m256d storedMask = maskInForceLoop ? ones : _mm256_load_pd(p_center_dist_lookup + j);
 				// Only go on if at least 1 of the forces has to be calculated.
-				if (_mm256_movemask_pd(forceMask) > 0) {
+				if (_mm256_movemask_pd(storedMask) > 0) {
 					const __m256d c_r_x2 = _mm256_load_pd(p_crx2 + j);
 					const __m256d c_dx = _mm256_sub_pd(c_r_x1, c_r_x2);
 					const __m256d c_r_y2 = _mm256_load_pd(p_cry2 + j);
@@ -599,6 +875,11 @@ void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 					const __m256d c_dzdz = _mm256_mul_pd(c_dz, c_dz);
 					const __m256d c_dxdx_dydy = _mm256_add_pd(c_dxdx, c_dydy);
 					const __m256d c_r2 = _mm256_add_pd(c_dxdx_dydy, c_dzdz);
+					// the center is the center of mass, so c_r2 is the molecule distance
+					const __m256d forceMask = maskInForceLoop ? ForcePolicy::GetForceMask(c_r2, rc2, initJ_forceMask) : storedMask;
+					if (maskInForceLoop && !_mm256_movemask_pd(forceMask)) {
+						continue;
+					}
 					const __m256d r2_inv_unmasked = _mm256_div_pd(one, c_r2);
 					const __m256d r2_inv = _mm256_and_pd(r2_inv_unmasked, forceMask);
 
@@ -608,18 +889,26 @@ void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 					const size_t id_j2 = p_cid2[j + 2];
 					const size_t id_j3 = p_cid2[j + 3];
 
-					const __m256d e0s0 = _mm256_maskload_pd(_eps_sig[id_i] + 2 * id_j0, memoryMask_first_second);
-					const __m256d e1s1 = _mm256_maskload_pd(_eps_sig[id_i] + 2 * id_j1, memoryMask_first_second);
-					const __m256d e2s2 = _mm256_maskload_pd(_eps_sig[id_i] + 2 * id_j2, memoryMask_first_second);
-					const __m256d e3s3 = _mm256_maskload_pd(_eps_sig[id_i] + 2 * id_j3, memoryMask_first_second);
-
-					const __m256d e0e1 = _mm256_unpacklo_pd(e0s0, e1s1);
-					const __m256d s0s1 = _mm256_unpackhi_pd(e0s0, e1s1);
-					const __m256d e2e3 = _mm256_unpacklo_pd(e2s2, e3s3);
-					const __m256d s2s3 = _mm256_unpackhi_pd(e2s2, e3s3);
-
-					const __m256d eps_24 = _mm256_permute2f128_pd(e0e1, e2e3, 1<<5);
-					const __m256d sig2 = _mm256_permute2f128_pd(s0s1, s2s3, 1<<5);
+					__m256d eps_24 = uniform_eps_24;
+					__m256d sig2 = uniform_sig2;
+					const __m256d type_j = (Parameters == MIXTURE) ? _mm256_load_pd(p_ctype2 + j) : _mm256_setzero_pd();
+					if (Parameters == MIXTURE) {
+						eps_24 = _mm256_blendv_pd(mixture_eps_24_0, mixture_eps_24_1, type_j);
+						sig2 = _mm256_blendv_pd(mixture_sig2_0, mixture_sig2_1, type_j);
+					} else if (Parameters == GENERIC) {
+						const __m256d e0s0 = _mm256_maskload_pd(_eps_sig[id_i] + 2 * id_j0, memoryMask_first_second);
+						const __m256d e1s1 = _mm256_maskload_pd(_eps_sig[id_i] + 2 * id_j1, memoryMask_first_second);
+						const __m256d e2s2 = _mm256_maskload_pd(_eps_sig[id_i] + 2 * id_j2, memoryMask_first_second);
+						const __m256d e3s3 = _mm256_maskload_pd(_eps_sig[id_i] + 2 * id_j3, memoryMask_first_second);
+
+						const __m256d e0e1 = _mm256_unpacklo_pd(e0s0, e1s1);
+						const __m256d s0s1 = _mm256_unpackhi_pd(e0s0, e1s1);
+						const __m256d e2e3 = _mm256_unpacklo_pd(e2s2, e3s3);
+						const __m256d s2s3 = _mm256_unpackhi_pd(e2s2, e3s3);
+
+						eps_24 = _mm256_permute2f128_pd(e0e1, e2e3, 1<<5);
+						sig2 = _mm256_permute2f128_pd(s0s1, s2s3, 1<<5);
+					}
 
 					const __m256d lj2 = _mm256_mul_pd(sig2, r2_inv);
 					const __m256d lj4 = _mm256_mul_pd(lj2, lj2);
@@ -635,26 +924,28 @@ void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 					const __m256d fy = _mm256_mul_pd(c_dy, scale);
 					const __m256d fz = _mm256_mul_pd(c_dz, scale);
 
-					const __m256d m_r_x2 = _mm256_load_pd(p_mrx2 + j);
-					const __m256d m_dx = _mm256_sub_pd(m_r_x1, m_r_x2);
-					const __m256d m_r_y2 = _mm256_load_pd(p_mry2 + j);
-					const __m256d m_dy = _mm256_sub_pd(m_r_y1, m_r_y2);
-					const __m256d m_r_z2 = _mm256_load_pd(p_mrz2 + j);
-					const __m256d m_dz = _mm256_sub_pd(m_r_z1, m_r_z2);
+					const __m256d m_dx = SingleCenter ? c_dx : _mm256_sub_pd(m_r_x1, _mm256_load_pd(p_mrx2 + j));
+					const __m256d m_dy = SingleCenter ? c_dy : _mm256_sub_pd(m_r_y1, _mm256_load_pd(p_mry2 + j));
+					const __m256d m_dz = SingleCenter ? c_dz : _mm256_sub_pd(m_r_z1, _mm256_load_pd(p_mrz2 + j));
 
 					const __m256d macroMask = MacroPolicy::GetMacroMask(forceMask, m_dx, m_dy, m_dz);
 
 					// Only go on if at least 1 macroscopic value has to be calculated.
 					if (_mm256_movemask_pd(macroMask) > 0) {
-						const __m256d sh0 = _mm256_maskload_pd(_shift6[id_i] + id_j0, memoryMask_first);
-						const __m256d sh1 = _mm256_maskload_pd(_shift6[id_i] + id_j1, memoryMask_first);
-						const __m256d sh2 = _mm256_maskload_pd(_shift6[id_i] + id_j2, memoryMask_first);
-						const __m256d sh3 = _mm256_maskload_pd(_shift6[id_i] + id_j3, memoryMask_first);
+						__m256d shift6 = uniform_shift6;
+						if (Parameters == MIXTURE) {
+							shift6 = _mm256_blendv_pd(mixture_shift6_0, mixture_shift6_1, type_j);
+						} else if (Parameters == GENERIC) {
+							const __m256d sh0 = _mm256_maskload_pd(_shift6[id_i] + id_j0, memoryMask_first);
+							const __m256d sh1 = _mm256_maskload_pd(_shift6[id_i] + id_j1, memoryMask_first);
+							const __m256d sh2 = _mm256_maskload_pd(_shift6[id_i] + id_j2, memoryMask_first);
+							const __m256d sh3 = _mm256_maskload_pd(_shift6[id_i] + id_j3, memoryMask_first);
 
-						const __m256d sh0sh1 = _mm256_unpacklo_pd(sh0, sh1);
-						const __m256d sh2sh3 = _mm256_unpacklo_pd(sh2, sh3);
+							const __m256d sh0sh1 = _mm256_unpacklo_pd(sh0, sh1);
+							const __m256d sh2sh3 = _mm256_unpacklo_pd(sh2, sh3);
 
-						const __m256d shift6 = _mm256_permute2f128_pd(sh0sh1, sh2sh3, 1<<5);
+							shift6 = _mm256_permute2f128_pd(sh0sh1, sh2sh3, 1<<5);
+						}
 
 						const __m256d upot = _mm256_mul_pd(eps_24, lj12m6);
 						const __m256d upot_sh = _mm256_add_pd(shift6, upot);
@@ -726,7 +1017,7 @@ void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 
 			// Unvectorized calculation for leftover pairs.
 			for (; j < soa2._num_ljcenters; ++j) {
-				_loopBodyNovec<ForcePolicy, MacroPolicy>(soa1, i_center_idx, soa2, j, p_center_dist_lookup + j);
+				_loopBodyNovec<ForcePolicy, MacroPolicy, Parameters>(soa1, i_center_idx, soa2, j, p_center_dist_lookup + j);
 			}
 			
 			i_center_idx++;
@@ -761,12 +1052,419 @@ void VectorizedCellProcessor::_calculatePairs(const CellDataSoA & soa1,
 #endif
 } // void LennardJonesCellHandler::CalculatePairs_(LJSoA & soa1, LJSoA & soa2)
 
+template<class ForcePolicy, class MacroPolicy, int Parameters, int NumCenters>
+void VectorizedCellProcessor::_calculatePairsFixedCenters(const CellDataSoA & soa1,
+		const CellDataSoA & soa2) {
+	assert(soa1._num_ljcenters == NumCenters * soa1._num_molecules);
+	assert(soa2._num_ljcenters == NumCenters * soa2._num_molecules);
+	// the leftover pairs are calculated by _loopBodyNovec with this mask
+	const double computePair = 1.0;
+#if VLJCP_VEC_TYPE==VLJCP_NOVEC
+	// Iterate over the pairs of molecules, the center pairs of each are known at compile time.
+	for (size_t i = 0; i < soa1._num_molecules; ++i) {
+		const size_t i_center_idx = NumCenters * i;
+		// in a single cell, molecule i is paired with the following molecules
+		for (size_t k = ForcePolicy::DetectSingleCell() ? i + 1 : 0; k < soa2._num_molecules; ++k) {
+			const double m_dx = soa1._mol_pos_x[i] - soa2._mol_pos_x[k];
+			const double m_dy = soa1._mol_pos_y[i] - soa2._mol_pos_y[k];
+			const double m_dz = soa1._mol_pos_z[i] - soa2._mol_pos_z[k];
+			const double m_r2 = m_dx * m_dx + m_dy * m_dy + m_dz * m_dz;
+			if (!ForcePolicy::Condition(m_r2, _rc2)) {
+				continue;
+			}
+			for (int local_i = 0; local_i < NumCenters; ++local_i) {
+				for (int local_j = 0; local_j < NumCenters; ++local_j) {
+					_loopBodyNovec<ForcePolicy, MacroPolicy, Parameters>(soa1, i_center_idx + local_i, soa2, NumCenters * k + local_j, &computePair);
+				}
+			}
+		}
+	}
+
+#elif VLJCP_VEC_TYPE==VLJCP_VEC_SSE3
+	const double * const p_mol_rx1 = soa1._mol_pos_x;
+	const double * const p_mol_ry1 = soa1._mol_pos_y;
+	const double * const p_mol_rz1 = soa1._mol_pos_z;
+	const double * const p_crx1 = soa1._ljc_r_x;
+	const double * const p_cry1 = soa1._ljc_r_y;
+	const double * const p_crz1 = soa1._ljc_r_z;
+	double * const p_cfx1 = soa1._ljc_f_x;
+	double * const p_cfy1 = soa1._ljc_f_y;
+	double * const p_cfz1 = soa1._ljc_f_z;
+	const size_t * const p_cid1 = soa1._ljc_id;
+
+	const double * const p_mrx2 = soa2._m_r_x;
+	const double * const p_mry2 = soa2._m_r_y;
+	const double * const p_mrz2 = soa2._m_r_z;
+	const double * const p_crx2 = soa2._ljc_r_x;
+	const double * const p_cry2 = soa2._ljc_r_y;
+	const double * const p_crz2 = soa2._ljc_r_z;
+	double * const p_cfx2 = soa2._ljc_f_x;
+	double * const p_cfy2 = soa2._ljc_f_y;
+	double * const p_cfz2 = soa2._ljc_f_z;
+	const size_t * const p_cid2 = soa2._ljc_id;
+	const double * const p_ctype2 = soa2._ljc_type_mask;
+
+	const size_t end_j = soa2._num_ljcenters & (~1);
+	const __m128d one = _mm_set1_pd(1.0);
+	const __m128d rc2 = _mm_set1_pd(_rc2);
+	const __m128d uniform_eps_24 = _mm_set1_pd(_uniformEps24);
+	const __m128d uniform_sig2 = _mm_set1_pd(_uniformSig2);
+	const __m128d uniform_shift6 = _mm_set1_pd(_uniformShift6);
+	__m128d sum_upot = _mm_setzero_pd();
+	__m128d sum_virial = _mm_setzero_pd();
+
+	for (size_t i = 0; i < soa1._num_molecules; ++i) {
+		const size_t i_center_idx = NumCenters * i;
+		// in a single cell, the centers j follow the last center of molecule i
+		const size_t i_last_center_idx = i_center_idx + NumCenters - 1;
+		const __m128d m_r_x1 = _mm_loaddup_pd(p_mol_rx1 + i);
+		const __m128d m_r_y1 = _mm_loaddup_pd(p_mol_ry1 + i);
+		const __m128d m_r_z1 = _mm_loaddup_pd(p_mol_rz1 + i);
+
+		__m128d c_r_x1[NumCenters], c_r_y1[NumCenters], c_r_z1[NumCenters];
+		__m128d sum_fx1[NumCenters], sum_fy1[NumCenters], sum_fz1[NumCenters];
+		// MIXTURE: the parameters of the centers of molecule i with both center types
+		__m128d mixture_eps_24_0[NumCenters], mixture_eps_24_1[NumCenters];
+		__m128d mixture_sig2_0[NumCenters], mixture_sig2_1[NumCenters];
+		__m128d mixture_shift6_0[NumCenters], mixture_shift6_1[NumCenters];
+		size_t id_i[NumCenters];
+		for (int k = 0; k < NumCenters; ++k) {
+			c_r_x1[k] = _mm_loaddup_pd(p_crx1 + i_center_idx + k);
+			c_r_y1[k] = _mm_loaddup_pd(p_cry1 + i_center_idx + k);
+			c_r_z1[k] = _mm_loaddup_pd(p_crz1 + i_center_idx + k);
+			sum_fx1[k] = _mm_setzero_pd();
+			sum_fy1[k] = _mm_setzero_pd();
+			sum_fz1[k] = _mm_setzero_pd();
+			id_i[k] = p_cid1[i_center_idx + k];
+			const unsigned type_i = (Parameters == MIXTURE) ? _centerTypes[id_i[k]] : 0;
+			mixture_eps_24_0[k] = _mm_set1_pd(_mixtureEps24[type_i][0]);
+			mixture_eps_24_1[k] = _mm_set1_pd(_mixtureEps24[type_i][1]);
+			mixture_sig2_0[k] = _mm_set1_pd(_mixtureSig2[type_i][0]);
+			mixture_sig2_1[k] = _mm_set1_pd(_mixtureSig2[type_i][1]);
+			mixture_shift6_0[k] = _mm_set1_pd(_mixtureShift6[type_i][0]);
+			mixture_shift6_1[k] = _mm_set1_pd(_mixtureShift6[type_i][1]);
+		}
+
+		size_t j = ForcePolicy::InitJ(i_last_center_idx);
+		for (; j < end_j; j += 2) {
+			const __m128d m_dx = _mm_sub_pd(m_r_x1, _mm_load_pd(p_mrx2 + j));
+			const __m128d m_dy = _mm_sub_pd(m_r_y1, _mm_load_pd(p_mry2 + j));
+			const __m128d m_dz = _mm_sub_pd(m_r_z1, _mm_load_pd(p_mrz2 + j));
+			const __m128d m_dxdx_dydy = _mm_add_pd(_mm_mul_pd(m_dx, m_dx), _mm_mul_pd(m_dy, m_dy));
+			const __m128d m_r2 = _mm_add_pd(m_dxdx_dydy, _mm_mul_pd(m_dz, m_dz));
+			// one force mask for all centers of molecule i
+			const __m128d forceMask = ForcePolicy::GetForceMask(m_r2, rc2);
+			if (!_mm_movemask_pd(forceMask)) {
+				continue;
+			}
+			const __m128d macroMask = MacroPolicy::GetMacroMask(forceMask, m_dx, m_dy, m_dz);
+			const bool calculateMacro = _mm_movemask_pd(macroMask) > 0;
+
+			const size_t id_j0 = p_cid2[j];
+			const size_t id_j1 = p_cid2[j + 1];
+			const __m128d type_j = (Parameters == MIXTURE) ? _mm_load_pd(p_ctype2 + j) : _mm_setzero_pd();
+			const __m128d c_r_x2 = _mm_load_pd(p_crx2 + j);
+			const __m128d c_r_y2 = _mm_load_pd(p_cry2 + j);
+			const __m128d c_r_z2 = _mm_load_pd(p_crz2 + j);
+			__m128d f_x2 = _mm_load_pd(p_cfx2 + j);
+			__m128d f_y2 = _mm_load_pd(p_cfy2 + j);
+			__m128d f_z2 = _mm_load_pd(p_cfz2 + j);
+
+			for (int k = 0; k < NumCenters; ++k) {
+				const __m128d c_dx = _mm_sub_pd(c_r_x1[k], c_r_x2);
+				const __m128d c_dy = _mm_sub_pd(c_r_y1[k], c_r_y2);
+				const __m128d c_dz = _mm_sub_pd(c_r_z1[k], c_r_z2);
+				const __m128d c_dxdx_dydy = _mm_add_pd(_mm_mul_pd(c_dx, c_dx), _mm_mul_pd(c_dy, c_dy));
+				const __m128d c_r2 = _mm_add_pd(c_dxdx_dydy, _mm_mul_pd(c_dz, c_dz));
+				const __m128d r2_inv = _mm_and_pd(_mm_div_pd(one, c_r2), forceMask);
+
+				__m128d eps_24 = uniform_eps_24;
+				__m128d sig2 = uniform_sig2;
+				if (Parameters == MIXTURE) {
+					eps_24 = _mm_or_pd(_mm_and_pd(type_j, mixture_eps_24_1[k]), _mm_andnot_pd(type_j, mixture_eps_24_0[k]));
+					sig2 = _mm_or_pd(_mm_and_pd(type_j, mixture_sig2_1[k]), _mm_andnot_pd(type_j, mixture_sig2_0[k]));
+				} else if (Parameters == GENERIC) {
+					const __m128d e1s1 = _mm_load_pd(_eps_sig[id_i[k]] + 2 * id_j0);
+					const __m128d e2s2 = _mm_load_pd(_eps_sig[id_i[k]] + 2 * id_j1);
+					eps_24 = _mm_unpacklo_pd(e1s1, e2s2);
+					sig2 = _mm_unpackhi_pd(e1s1, e2s2);
+				}
+				const __m128d lj2 = _mm_mul_pd(sig2, r2_inv);
+				const __m128d lj4 = _mm_mul_pd(lj2, lj2);
+				const __m128d lj6 = _mm_mul_pd(lj4, lj2);
+				const __m128d lj12 = _mm_mul_pd(lj6, lj6);
+				const __m128d lj12m6 = _mm_sub_pd(lj12, lj6);
+				const __m128d eps24r2inv = _mm_mul_pd(eps_24, r2_inv);
+				const __m128d lj12lj12m6 = _mm_add_pd(lj12, lj12m6);
+				const __m128d scale = _mm_mul_pd(eps24r2inv, lj12lj12m6);
+				const __m128d fx = _mm_mul_pd(c_dx, scale);
+				const __m128d fy = _mm_mul_pd(c_dy, scale);
+				const __m128d fz = _mm_mul_pd(c_dz, scale);
+
+				if (calculateMacro) {
+					__m128d shift6 = uniform_shift6;
+					if (Parameters == MIXTURE) {
+						shift6 = _mm_or_pd(_mm_and_pd(type_j, mixture_shift6_1[k]), _mm_andnot_pd(type_j, mixture_shift6_0[k]));
+					} else if (Parameters == GENERIC) {
+						const __m128d sh1 = _mm_load_sd(_shift6[id_i[k]] + id_j0);
+						const __m128d sh2 = _mm_load_sd(_shift6[id_i[k]] + id_j1);
+						shift6 = _mm_unpacklo_pd(sh1, sh2);
+					}
+					const __m128d upot_sh = _mm_add_pd(shift6, _mm_mul_pd(eps_24, lj12m6));
+					sum_upot = _mm_add_pd(sum_upot, _mm_and_pd(upot_sh, macroMask));
+					const __m128d vir_xy = _mm_add_pd(_mm_mul_pd(m_dx, fx), _mm_mul_pd(m_dy, fy));
+					const __m128d virial = _mm_add_pd(vir_xy, _mm_mul_pd(m_dz, fz));
+					sum_virial = _mm_add_pd(sum_virial, _mm_and_pd(virial, macroMask));
+				}
+				f_x2 = _mm_sub_pd(f_x2, fx);
+				f_y2 = _mm_sub_pd(f_y2, fy);
+				f_z2 = _mm_sub_pd(f_z2, fz);
+				sum_fx1[k] = _mm_add_pd(sum_fx1[k], fx);
+				sum_fy1[k] = _mm_add_pd(sum_fy1[k], fy);
+				sum_fz1[k] = _mm_add_pd(sum_fz1[k], fz);
+			}
+			_mm_store_pd(p_cfx2 + j, f_x2);
+			_mm_store_pd(p_cfy2 + j, f_y2);
+			_mm_store_pd(p_cfz2 + j, f_z2);
+		}
+		for (int k = 0; k < NumCenters; ++k) {
+			_mm_store_sd(p_cfx1 + i_center_idx + k,
+					_mm_add_sd(_mm_hadd_pd(sum_fx1[k], sum_fx1[k]), _mm_load_sd(p_cfx1 + i_center_idx + k)));
+			_mm_store_sd(p_cfy1 + i_center_idx + k,
+					_mm_add_sd(_mm_hadd_pd(sum_fy1[k], sum_fy1[k]), _mm_load_sd(p_cfy1 + i_center_idx + k)));
+			_mm_store_sd(p_cfz1 + i_center_idx + k,
+					_mm_add_sd(_mm_hadd_pd(sum_fz1[k], sum_fz1[k]), _mm_load_sd(p_cfz1 + i_center_idx + k)));
+		}
+
+		// Unvectorized calculation for leftover pairs.
+		for (j = std::max(j, end_j); j < soa2._num_ljcenters; ++j) {
+			const double m_dx = soa1._mol_pos_x[i] - soa2._m_r_x[j];
+			const double m_dy = soa1._mol_pos_y[i] - soa2._m_r_y[j];
+			const double m_dz = soa1._mol_pos_z[i] - soa2._m_r_z[j];
+			const double m_r2 = m_dx * m_dx + m_dy * m_dy + m_dz * m_dz;
+			if (!ForcePolicy::Condition(m_r2, _rc2) || (ForcePolicy::DetectSingleCell() && j <= i_last_center_idx)) {
+				continue;
+			}
+			for (int k = 0; k < NumCenters; ++k) {
+				_loopBodyNovec<ForcePolicy, MacroPolicy, Parameters>(soa1, i_center_idx + k, soa2, j, &computePair);
+			}
+		}
+	}
+	_mm_store_sd(
+			&_upot6lj,
+			_mm_add_sd(_mm_hadd_pd(sum_upot, sum_upot),
+					_mm_load_sd(&_upot6lj)));
+	_mm_store_sd(
+			&_virial,
+			_mm_add_sd(_mm_hadd_pd(sum_virial, sum_virial),
+					_mm_load_sd(&_virial)));
+
+#elif VLJCP_VEC_TYPE==VLJCP_VEC_AVX
+	const double * const p_mol_rx1 = soa1._mol_pos_x;
+	const double * const p_mol_ry1 = soa1._mol_pos_y;
+	const double * const p_mol_rz1 = soa1._mol_pos_z;
+	const double * const p_crx1 = soa1._ljc_r_x;
+	const double * const p_cry1 = soa1._ljc_r_y;
+	const double * const p_crz1 = soa1._ljc_r_z;
+	double * const p_cfx1 = soa1._ljc_f_x;
+	double * const p_cfy1 = soa1._ljc_f_y;
+	double * const p_cfz1 = soa1._ljc_f_z;
+	const size_t * const p_cid1 = soa1._ljc_id;
+
+	const double * const p_mrx2 = soa2._m_r_x;
+	const double * const p_mry2 = soa2._m_r_y;
+	const double * const p_mrz2 = soa2._m_r_z;
+	const double * const p_crx2 = soa2._ljc_r_x;
+	const double * const p_cry2 = soa2._ljc_r_y;
+	const double * const p_crz2 = soa2._ljc_r_z;
+	double * const p_cfx2 = soa2._ljc_f_x;
+	double * const p_cfy2 = soa2._ljc_f_y;
+	double * const p_cfz2 = soa2._ljc_f_z;
+	const size_t * const p_cid2 = soa2._ljc_id;
+	const double * const p_ctype2 = soa2._ljc_type_mask;
+
+	const size_t end_j = soa2._num_ljcenters & ~static_cast<size_t>(3);
+	const __m256d one = _mm256_set1_pd(1.0);
+	const __m256d rc2 = _mm256_set1_pd(_rc2);
+	const __m256d uniform_eps_24 = _mm256_set1_pd(_uniformEps24);
+	const __m256d uniform_sig2 = _mm256_set1_pd(_uniformSig2);
+	const __m256d uniform_shift6 = _mm256_set1_pd(_uniformShift6);
+	__m256d sum_upot = _mm256_setzero_pd();
+	__m256d sum_virial = _mm256_setzero_pd();
+
+	static const __m256i memoryMask_first = _mm256_set_epi32(0, 0, 0, 0, 0, 0, 1<<31, 0);
+	static const __m256i memoryMask_first_second = _mm256_set_epi32(0, 0, 0, 0, 1<<31, 0, 1<<31, 0);
+
+	for (size_t i = 0; i < soa1._num_molecules; ++i) {
+		const size_t i_center_idx = NumCenters * i;
+		// in a single cell, the centers j follow the last center of molecule i
+		const size_t i_last_center_idx = i_center_idx + NumCenters - 1;
+		const __m256d m_r_x1 = _mm256_broadcast_sd(p_mol_rx1 + i);
+		const __m256d m_r_y1 = _mm256_broadcast_sd(p_mol_ry1 + i);
+		const __m256d m_r_z1 = _mm256_broadcast_sd(p_mol_rz1 + i);
+
+		__m256d c_r_x1[NumCenters], c_r_y1[NumCenters], c_r_z1[NumCenters];
+		__m256d sum_fx1[NumCenters], sum_fy1[NumCenters], sum_fz1[NumCenters];
+		// MIXTURE: the parameters of the centers of molecule i with both center types
+		__m256d mixture_eps_24_0[NumCenters], mixture_eps_24_1[NumCenters];
+		__m256d mixture_sig2_0[NumCenters], mixture_sig2_1[NumCenters];
+		__m256d mixture_shift6_0[NumCenters], mixture_shift6_1[NumCenters];
+		size_t id_i[NumCenters];
+		for (int k = 0; k < NumCenters; ++k) {
+			c_r_x1[k] = _mm256_broadcast_sd(p_crx1 + i_center_idx + k);
+			c_r_y1[k] = _mm256_broadcast_sd(p_cry1 + i_center_idx + k);
+			c_r_z1[k] = _mm256_broadcast_sd(p_crz1 + i_center_idx + k);
+			sum_fx1[k] = _mm256_setzero_pd();
+			sum_fy1[k] = _mm256_setzero_pd();
+			sum_fz1[k] = _mm256_setzero_pd();
+			id_i[k] = p_cid1[i_center_idx + k];
+			const unsigned type_i = (Parameters == MIXTURE) ? _centerTypes[id_i[k]] : 0;
+			mixture_eps_24_0[k] = _mm256_set1_pd(_mixtureEps24[type_i][0]);
+			mixture_eps_24_1[k] = _mm256_set1_pd(_mixtureEps24[type_i][1]);
+			mixture_sig2_0[k] = _mm256_set1_pd(_mixtureSig2[type_i][0]);
+			mixture_sig2_1[k] = _mm256_set1_pd(_mixtureSig2[type_i][1]);
+			mixture_shift6_0[k] = _mm256_set1_pd(_mixtureShift6[type_i][0]);
+			mixture_shift6_1[k] = _mm256_set1_pd(_mixtureShift6[type_i][1]);
+		}
+
+		size_t j = ForcePolicy::InitJ(i_last_center_idx);
+		__m256d initJ_mask = ForcePolicy::InitJ_Mask(i_last_center_idx);
+		for (; j < end_j; j += 4) {
+			const __m256d m_dx = _mm256_sub_pd(m_r_x1, _mm256_load_pd(p_mrx2 + j));
+			const __m256d m_dy = _mm256_sub_pd(m_r_y1, _mm256_load_pd(p_mry2 + j));
+			const __m256d m_dz = _mm256_sub_pd(m_r_z1, _mm256_load_pd(p_mrz2 + j));
+			const __m256d m_dxdx_dydy = _mm256_add_pd(_mm256_mul_pd(m_dx, m_dx), _mm256_mul_pd(m_dy, m_dy));
+			const __m256d m_r2 = _mm256_add_pd(m_dxdx_dydy, _mm256_mul_pd(m_dz, m_dz));
+			// one force mask for all centers of molecule i
+			const __m256d forceMask = ForcePolicy::GetForceMask(m_r2, rc2, initJ_mask);
+			if (!_mm256_movemask_pd(forceMask)) {
+				continue;
+			}
+			const __m256d macroMask = MacroPolicy::GetMacroMask(forceMask, m_dx, m_dy, m_dz);
+			const bool calculateMacro = _mm256_movemask_pd(macroMask) > 0;
+
+			const size_t id_j0 = p_cid2[j];
+			const size_t id_j1 = p_cid2[j + 1];
+			const size_t id_j2 = p_cid2[j + 2];
+			const size_t id_j3 = p_cid2[j + 3];
+			const __m256d type_j = (Parameters == MIXTURE) ? _mm256_load_pd(p_ctype2 + j) : _mm256_setzero_pd();
+			const __m256d c_r_x2 = _mm256_load_pd(p_crx2 + j);
+			const __m256d c_r_y2 = _mm256_load_pd(p_cry2 + j);
+			const __m256d c_r_z2 = _mm256_load_pd(p_crz2 + j);
+			__m256d f_x2 = _mm256_load_pd(p_cfx2 + j);
+			__m256d f_y2 = _mm256_load_pd(p_cfy2 + j);
+			__m256d f_z2 = _mm256_load_pd(p_cfz2 + j);
+
+			for (int k = 0; k < NumCenters; ++k) {
+				const __m256d c_dx = _mm256_sub_pd(c_r_x1[k], c_r_x2);
+				const __m256d c_dy = _mm256_sub_pd(c_r_y1[k], c_r_y2);
+				const __m256d c_dz = _mm256_sub_pd(c_r_z1[k], c_r_z2);
+				const __m256d c_dxdx_dydy = _mm256_add_pd(_mm256_mul_pd(c_dx, c_dx), _mm256_mul_pd(c_dy, c_dy));
+				const __m256d c_r2 = _mm256_add_pd(c_dxdx_dydy, _mm256_mul_pd(c_dz, c_dz));
+				const __m256d r2_inv = _mm256_and_pd(_mm256_div_pd(one, c_r2), forceMask);
+
+				__m256d eps_24 = uniform_eps_24;
+				__m256d sig2 = uniform_sig2;
+				if (Parameters == MIXTURE) {
+					eps_24 = _mm256_blendv_pd(mixture_eps_24_0[k], mixture_eps_24_1[k], type_j);
+					sig2 = _mm256_blendv_pd(mixture_sig2_0[k], mixture_sig2_1[k], type_j);
+				} else if (Parameters == GENERIC) {
+					const __m256d e0s0 = _mm256_maskload_pd(_eps_sig[id_i[k]] + 2 * id_j0, memoryMask_first_second);
+					const __m256d e1s1 = _mm256_maskload_pd(_eps_sig[id_i[k]] + 2 * id_j1, memoryMask_first_second);
+					const __m256d e2s2 = _mm256_maskload_pd(_eps_sig[id_i[k]] + 2 * id_j2, memoryMask_first_second);
+					const __m256d e3s3 = _mm256_maskload_pd(_eps_sig[id_i[k]] + 2 * id_j3, memoryMask_first_second);
+					const __m256d e0e1 = _mm256_unpacklo_pd(e0s0, e1s1);
+					const __m256d s0s1 = _mm256_unpackhi_pd(e0s0, e1s1);
+					const __m256d e2e3 = _mm256_unpacklo_pd(e2s2, e3s3);
+					const __m256d s2s3 = _mm256_unpackhi_pd(e2s2, e3s3);
+					eps_24 = _mm256_permute2f128_pd(e0e1, e2e3, 1<<5);
+					sig2 = _mm256_permute2f128_pd(s0s1, s2s3, 1<<5);
+				}
+				const __m256d lj2 = _mm256_mul_pd(sig2, r2_inv);
+				const __m256d lj4 = _mm256_mul_pd(lj2, lj2);
+				const __m256d lj6 = _mm256_mul_pd(lj4, lj2);
+				const __m256d lj12 = _mm256_mul_pd(lj6, lj6);
+				const __m256d lj12m6 = _mm256_sub_pd(lj12, lj6);
+				const __m256d eps24r2inv = _mm256_mul_pd(eps_24, r2_inv);
+				const __m256d lj12lj12m6 = _mm256_add_pd(lj12, lj12m6);
+				const __m256d scale = _mm256_mul_pd(eps24r2inv, lj12lj12m6);
+				const __m256d fx = _mm256_mul_pd(c_dx, scale);
+				const __m256d fy = _mm256_mul_pd(c_dy, scale);
+				const __m256d fz = _mm256_mul_pd(c_dz, scale);
+
+				if (calculateMacro) {
+					__m256d shift6 = uniform_shift6;
+					if (Parameters == MIXTURE) {
+						shift6 = _mm256_blendv_pd(mixture_shift6_0[k], mixture_shift6_1[k], type_j);
+					} else if (Parameters == GENERIC) {
+						const __m256d sh0 = _mm256_maskload_pd(_shift6[id_i[k]] + id_j0, memoryMask_first);
+						const __m256d sh1 = _mm256_maskload_pd(_shift6[id_i[k]] + id_j1, memoryMask_first);
+						const __m256d sh2 = _mm256_maskload_pd(_shift6[id_i[k]] + id_j2, memoryMask_first);
+						const __m256d sh3 = _mm256_maskload_pd(_shift6[id_i[k]] + id_j3, memoryMask_first);
+						shift6 = _mm256_permute2f128_pd(_mm256_unpacklo_pd(sh0, sh1), _mm256_unpacklo_pd(sh2, sh3), 1<<5);
+					}
+					const __m256d upot_sh = _mm256_add_pd(shift6, _mm256_mul_pd(eps_24, lj12m6));
+					sum_upot = _mm256_add_pd(sum_upot, _mm256_and_pd(upot_sh, macroMask));
+					const __m256d vir_xy = _mm256_add_pd(_mm256_mul_pd(m_dx, fx), _mm256_mul_pd(m_dy, fy));
+					const __m256d virial = _mm256_add_pd(vir_xy, _mm256_mul_pd(m_dz, fz));
+					sum_virial = _mm256_add_pd(sum_virial, _mm256_and_pd(virial, macroMask));
+				}
+				f_x2 = _mm256_sub_pd(f_x2, fx);
+				f_y2 = _mm256_sub_pd(f_y2, fy);
+				f_z2 = _mm256_sub_pd(f_z2, fz);
+				sum_fx1[k] = _mm256_add_pd(sum_fx1[k], fx);
+				sum_fy1[k] = _mm256_add_pd(sum_fy1[k], fy);
+				sum_fz1[k] = _mm256_add_pd(sum_fz1[k], fz);
+			}
+			_mm256_store_pd(p_cfx2 + j, f_x2);
+			_mm256_store_pd(p_cfy2 + j, f_y2);
+			_mm256_store_pd(p_cfz2 + j, f_z2);
+		}
+		for (int k = 0; k < NumCenters; ++k) {
+			const __m256d sum_fx1_t2 = _mm256_hadd_pd(sum_fx1[k], _mm256_permute2f128_pd(sum_fx1[k], sum_fx1[k], 0x1));
+			const __m256d sum_fy1_t2 = _mm256_hadd_pd(sum_fy1[k], _mm256_permute2f128_pd(sum_fy1[k], sum_fy1[k], 0x1));
+			const __m256d sum_fz1_t2 = _mm256_hadd_pd(sum_fz1[k], _mm256_permute2f128_pd(sum_fz1[k], sum_fz1[k], 0x1));
+			_mm256_maskstore_pd(p_cfx1 + i_center_idx + k, memoryMask_first,
+					_mm256_add_pd(_mm256_hadd_pd(sum_fx1_t2, sum_fx1_t2), _mm256_maskload_pd(p_cfx1 + i_center_idx + k, memoryMask_first)));
+			_mm256_maskstore_pd(p_cfy1 + i_center_idx + k, memoryMask_first,
+					_mm256_add_pd(_mm256_hadd_pd(sum_fy1_t2, sum_fy1_t2), _mm256_maskload_pd(p_cfy1 + i_center_idx + k, memoryMask_first)));
+			_mm256_maskstore_pd(p_cfz1 + i_center_idx + k, memoryMask_first,
+					_mm256_add_pd(_mm256_hadd_pd(sum_fz1_t2, sum_fz1_t2), _mm256_maskload_pd(p_cfz1 + i_center_idx + k, memoryMask_first)));
+		}
+
+		// Unvectorized calculation for leftover pairs.
+		for (j = std::max(j, end_j); j < soa2._num_ljcenters; ++j) {
+			const double m_dx = soa1._mol_pos_x[i] - soa2._m_r_x[j];
+			const double m_dy = soa1._mol_pos_y[i] - soa2._m_r_y[j];
+			const double m_dz = soa1._mol_pos_z[i] - soa2._m_r_z[j];
+			const double m_r2 = m_dx * m_dx + m_dy * m_dy + m_dz * m_dz;
+			if (!ForcePolicy::Condition(m_r2, _rc2) || (ForcePolicy::DetectSingleCell() && j <= i_last_center_idx)) {
+				continue;
+			}
+			for (int k = 0; k < NumCenters; ++k) {
+				_loopBodyNovec<ForcePolicy, MacroPolicy, Parameters>(soa1, i_center_idx + k, soa2, j, &computePair);
+			}
+		}
+	}
+	const __m256d sum_upot_t2 = _mm256_hadd_pd(sum_upot, _mm256_permute2f128_pd(sum_upot, sum_upot, 0x1));
+	_mm256_maskstore_pd(&_upot6lj, memoryMask_first,
+			_mm256_add_pd(_mm256_hadd_pd(sum_upot_t2, sum_upot_t2), _mm256_maskload_pd(&_upot6lj, memoryMask_first)));
+	const __m256d sum_virial_t2 = _mm256_hadd_pd(sum_virial, _mm256_permute2f128_pd(sum_virial, sum_virial, 0x1));
+	_mm256_maskstore_pd(&_virial, memoryMask_first,
+			_mm256_add_pd(_mm256_hadd_pd(sum_virial_t2, sum_virial_t2), _mm256_maskload_pd(&_virial, memoryMask_first)));
+#endif
+}
+
 void VectorizedCellProcessor::processCell(ParticleCell & c) {
 	assert(c.getCellDataSoA());
 	if (c.isHaloCell() || (c.getCellDataSoA()->_num_ljcenters < 2))
 		return;
 
-	_calculatePairs<SingleCellPolicy_, AllMacroPolicy_>(*(c.getCellDataSoA()), *(c.getCellDataSoA()));
+	if (_forcesOnly) {
+		_calculatePairs<SingleCellPolicy_, NoMacroPolicy_>(*(c.getCellDataSoA()), *(c.getCellDataSoA()));
+	} else {
+		_calculatePairs<SingleCellPolicy_, AllMacroPolicy_>(*(c.getCellDataSoA()), *(c.getCellDataSoA()));
+	}
 }
 
 double VectorizedCellProcessor::processSingleMolecule(Molecule* m1, ParticleCell& cell2)
@@ -775,6 +1473,232 @@ double VectorizedCellProcessor::processSingleMolecule(Molecule* m1, ParticleCell
 	return 666;
 }
 
+void VectorizedCellProcessor::_loadTrialCell(ParticleCell& cell)
+{
+	if (cell.getCellDataSoA()) {
+		return;
+	}
+	// Load the SoA once, it is kept until the cell is invalidated.
+	if (_particleCellDataVector.empty()) {
+		_particleCellDataVector.push_back(new CellDataSoA(64,64));
+	}
+	preprocessCell(cell);
+	_trialCells.push_back(&cell);
+}
+
+double VectorizedCellProcessor::_trialCenterEnergy6(const double m_r[3], const double c_r[3], size_t id1, const CellDataSoA& soa2)
+{
+	const double* const eps_sig = _eps_sig[id1];
+	const double* const shift6 = _shift6[id1];
+	double upot6lj = 0.0;
+	size_t j = 0;
+
+#if VLJCP_VEC_TYPE==VLJCP_VEC_AVX
+	static const __m256i memoryMask_first = _mm256_set_epi32(0, 0, 0, 0, 0, 0, 1<<31, 0);
+	static const __m256i memoryMask_first_second = _mm256_set_epi32(0, 0, 0, 0, 1<<31, 0, 1<<31, 0);
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256d one = _mm256_set1_pd(1.0);
+	const __m256d rc2 = _mm256_set1_pd(_rc2);
+	const __m256d m_r_x1 = _mm256_set1_pd(m_r[0]);
+	const __m256d m_r_y1 = _mm256_set1_pd(m_r[1]);
+	const __m256d m_r_z1 = _mm256_set1_pd(m_r[2]);
+	const __m256d c_r_x1 = _mm256_set1_pd(c_r[0]);
+	const __m256d c_r_y1 = _mm256_set1_pd(c_r[1]);
+	const __m256d c_r_z1 = _mm256_set1_pd(c_r[2]);
+	__m256d sum_upot = _mm256_setzero_pd();
+
+	const size_t end_j = soa2._num_ljcenters & ~static_cast<size_t>(3);
+	for (; j < end_j; j += 4) {
+		const __m256d m_dx = _mm256_sub_pd(m_r_x1, _mm256_load_pd(soa2._m_r_x + j));
+		const __m256d m_dy = _mm256_sub_pd(m_r_y1, _mm256_load_pd(soa2._m_r_y + j));
+		const __m256d m_dz = _mm256_sub_pd(m_r_z1, _mm256_load_pd(soa2._m_r_z + j));
+		const __m256d m_r2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m_dx, m_dx), _mm256_mul_pd(m_dy, m_dy)), _mm256_mul_pd(m_dz, m_dz));
+		// m_r2 == 0: the test molecule itself (trial deletion)
+		const __m256d mask = _mm256_and_pd(_mm256_cmp_pd(m_r2, rc2, _CMP_LT_OS), _mm256_cmp_pd(m_r2, zero, _CMP_NEQ_OS));
+		if (_mm256_movemask_pd(mask) == 0) {
+			continue;
+		}
+		const __m256d c_dx = _mm256_sub_pd(c_r_x1, _mm256_load_pd(soa2._ljc_r_x + j));
+		const __m256d c_dy = _mm256_sub_pd(c_r_y1, _mm256_load_pd(soa2._ljc_r_y + j));
+		const __m256d c_dz = _mm256_sub_pd(c_r_z1, _mm256_load_pd(soa2._ljc_r_z + j));
+		const __m256d c_r2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(c_dx, c_dx), _mm256_mul_pd(c_dy, c_dy)), _mm256_mul_pd(c_dz, c_dz));
+		const __m256d r2_inv = _mm256_and_pd(_mm256_div_pd(one, c_r2), mask);
+
+		const size_t id_j0 = soa2._ljc_id[j];
+		const size_t id_j1 = soa2._ljc_id[j + 1];
+		const size_t id_j2 = soa2._ljc_id[j + 2];
+		const size_t id_j3 = soa2._ljc_id[j + 3];
+
+		const __m256d e0s0 = _mm256_maskload_pd(eps_sig + 2 * id_j0, memoryMask_first_second);
+		const __m256d e1s1 = _mm256_maskload_pd(eps_sig + 2 * id_j1, memoryMask_first_second);
+		const __m256d e2s2 = _mm256_maskload_pd(eps_sig + 2 * id_j2, memoryMask_first_second);
+		const __m256d e3s3 = _mm256_maskload_pd(eps_sig + 2 * id_j3, memoryMask_first_second);
+		const __m256d e0e1 = _mm256_unpacklo_pd(e0s0, e1s1);
+		const __m256d s0s1 = _mm256_unpackhi_pd(e0s0, e1s1);
+		const __m256d e2e3 = _mm256_unpacklo_pd(e2s2, e3s3);
+		const __m256d s2s3 = _mm256_unpackhi_pd(e2s2, e3s3);
+		const __m256d eps_24 = _mm256_permute2f128_pd(e0e1, e2e3, 1<<5);
+		const __m256d sig2 = _mm256_permute2f128_pd(s0s1, s2s3, 1<<5);
+
+		const __m256d sh0 = _mm256_maskload_pd(shift6 + id_j0, memoryMask_first);
+		const __m256d sh1 = _mm256_maskload_pd(shift6 + id_j1, memoryMask_first);
+		const __m256d sh2 = _mm256_maskload_pd(shift6 + id_j2, memoryMask_first);
+		const __m256d sh3 = _mm256_maskload_pd(shift6 + id_j3, memoryMask_first);
+		const __m256d shift = _mm256_permute2f128_pd(_mm256_unpacklo_pd(sh0, sh1), _mm256_unpacklo_pd(sh2, sh3), 1<<5);
+
+		const __m256d lj2 = _mm256_mul_pd(sig2, r2_inv);
+		const __m256d lj6 = _mm256_mul_pd(_mm256_mul_pd(lj2, lj2), lj2);
+		const __m256d lj12m6 = _mm256_sub_pd(_mm256_mul_pd(lj6, lj6), lj6);
+		const __m256d upot = _mm256_add_pd(_mm256_mul_pd(eps_24, lj12m6), shift);
+		sum_upot = _mm256_add_pd(sum_upot, _mm256_and_pd(upot, mask));
+	}
+	const __m256d sum_upot_t1 = _mm256_hadd_pd(sum_upot, sum_upot);
+	const __m128d sum_upot_t2 = _mm_add_pd(_mm256_castpd256_pd128(sum_upot_t1), _mm256_extractf128_pd(sum_upot_t1, 1));
+	upot6lj = _mm_cvtsd_f64(sum_upot_t2);
+
+#elif VLJCP_VEC_TYPE==VLJCP_VEC_SSE3
+	const __m128d zero = _mm_setzero_pd();
+	const __m128d one = _mm_set1_pd(1.0);
+	const __m128d rc2 = _mm_set1_pd(_rc2);
+	const __m128d m_r_x1 = _mm_set1_pd(m_r[0]);
+	const __m128d m_r_y1 = _mm_set1_pd(m_r[1]);
+	const __m128d m_r_z1 = _mm_set1_pd(m_r[2]);
+	const __m128d c_r_x1 = _mm_set1_pd(c_r[0]);
+	const __m128d c_r_y1 = _mm_set1_pd(c_r[1]);
+	const __m128d c_r_z1 = _mm_set1_pd(c_r[2]);
+	__m128d sum_upot = _mm_setzero_pd();
+
+	const size_t end_j = soa2._num_ljcenters & ~static_cast<size_t>(1);
+	for (; j < end_j; j += 2) {
+		const __m128d m_dx = _mm_sub_pd(m_r_x1, _mm_load_pd(soa2._m_r_x + j));
+		const __m128d m_dy = _mm_sub_pd(m_r_y1, _mm_load_pd(soa2._m_r_y + j));
+		const __m128d m_dz = _mm_sub_pd(m_r_z1, _mm_load_pd(soa2._m_r_z + j));
+		const __m128d m_r2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(m_dx, m_dx), _mm_mul_pd(m_dy, m_dy)), _mm_mul_pd(m_dz, m_dz));
+		// m_r2 == 0: the test molecule itself (trial deletion)
+		const __m128d mask = _mm_and_pd(_mm_cmplt_pd(m_r2, rc2), _mm_cmpneq_pd(m_r2, zero));
+		if (_mm_movemask_pd(mask) == 0) {
+			continue;
+		}
+		const __m128d c_dx = _mm_sub_pd(c_r_x1, _mm_load_pd(soa2._ljc_r_x + j));
+		const __m128d c_dy = _mm_sub_pd(c_r_y1, _mm_load_pd(soa2._ljc_r_y + j));
+		const __m128d c_dz = _mm_sub_pd(c_r_z1, _mm_load_pd(soa2._ljc_r_z + j));
+		const __m128d c_r2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(c_dx, c_dx), _mm_mul_pd(c_dy, c_dy)), _mm_mul_pd(c_dz, c_dz));
+		const __m128d r2_inv = _mm_and_pd(_mm_div_pd(one, c_r2), mask);
+
+		const size_t id_j0 = soa2._ljc_id[j];
+		const size_t id_j1 = soa2._ljc_id[j + 1];
+		const __m128d e0s0 = _mm_load_pd(eps_sig + 2 * id_j0);
+		const __m128d e1s1 = _mm_load_pd(eps_sig + 2 * id_j1);
+		const __m128d eps_24 = _mm_unpacklo_pd(e0s0, e1s1);
+		const __m128d sig2 = _mm_unpackhi_pd(e0s0, e1s1);
+		const __m128d shift = _mm_set_pd(shift6[id_j1], shift6[id_j0]);
+
+		const __m128d lj2 = _mm_mul_pd(sig2, r2_inv);
+		const __m128d lj6 = _mm_mul_pd(_mm_mul_pd(lj2, lj2), lj2);
+		const __m128d lj12m6 = _mm_sub_pd(_mm_mul_pd(lj6, lj6), lj6);
+		const __m128d upot = _mm_add_pd(_mm_mul_pd(eps_24, lj12m6), shift);
+		sum_upot = _mm_add_pd(sum_upot, _mm_and_pd(upot, mask));
+	}
+	upot6lj = _mm_cvtsd_f64(_mm_hadd_pd(sum_upot, sum_upot));
+#endif
+
+	// remainder (all centers without vectorization)
+	for (; j < soa2._num_ljcenters; ++j) {
+		const double m_dx = m_r[0] - soa2._m_r_x[j];
+		const double m_dy = m_r[1] - soa2._m_r_y[j];
+		const double m_dz = m_r[2] - soa2._m_r_z[j];
+		const double m_r2 = m_dx * m_dx + m_dy * m_dy + m_dz * m_dz;
+		if (!SingleCellPolicy_::Condition(m_r2, _rc2)) {
+			continue;
+		}
+		const double c_dx = c_r[0] - soa2._ljc_r_x[j];
+		const double c_dy = c_r[1] - soa2._ljc_r_y[j];
+		const double c_dz = c_r[2] - soa2._ljc_r_z[j];
+		const double r2_inv = 1.0 / (c_dx * c_dx + c_dy * c_dy + c_dz * c_dz);
+
+		const double eps_24 = eps_sig[2 * soa2._ljc_id[j]];
+		const double sig2 = eps_sig[2 * soa2._ljc_id[j] + 1];
+
+		const double lj2 = sig2 * r2_inv;
+		const double lj6 = lj2 * lj2 * lj2;
+		upot6lj += eps_24 * (lj6 * lj6 - lj6) + shift6[soa2._ljc_id[j]];
+	}
+	return upot6lj;
+}
+
+double VectorizedCellProcessor::_trialEnergy(Molecule* m1, const std::vector<ParticleCell*>& cells)
+{
+	const double m_r[3] = { m1->r(0), m1->r(1), m1->r(2) };
+	const size_t nLJC1 = m1->numLJcenters();
+	const size_t id1 = _compIDs[m1->componentid()];
+
+	double upot6lj = 0.0;
+	for (size_t c = 0; c < cells.size(); ++c) {
+		const CellDataSoA& soa2 = *cells[c]->getCellDataSoA();
+		for (size_t i = 0; i < nLJC1; ++i) {
+			const double* const d1 = m1->ljcenter_d(i);
+			const double c_r[3] = { m_r[0] + d1[0], m_r[1] + d1[1], m_r[2] + d1[2] };
+			upot6lj += _trialCenterEnergy6(m_r, c_r, id1 + i, soa2);
+		}
+	}
+	return upot6lj / 6.0;
+}
+
+double VectorizedCellProcessor::trialEnergy(Molecule* m1, const std::vector<ParticleCell*>& cells)
+{
+	for (size_t c = 0; c < cells.size(); ++c) {
+		_loadTrialCell(*cells[c]);
+	}
+	return _trialEnergy(m1, cells);
+}
+
+void VectorizedCellProcessor::trialEnergies(const std::vector<Molecule*>& molecules,
+		const std::vector<std::vector<ParticleCell*> >& cells, std::vector<double>& energies)
+{
+	// First load all cells, so the kernel runs without interruption afterwards.
+	for (size_t m = 0; m < cells.size(); ++m) {
+		for (size_t c = 0; c < cells[m].size(); ++c) {
+			_loadTrialCell(*cells[m][c]);
+		}
+	}
+	energies.resize(molecules.size());
+	for (size_t m = 0; m < molecules.size(); ++m) {
+		energies[m] = _trialEnergy(molecules[m], cells[m]);
+	}
+}
+
+void VectorizedCellProcessor::invalidateTrialCell(ParticleCell& cell)
+{
+	CellDataSoA* soa = cell.getCellDataSoA();
+	if (!soa) {
+		return;
+	}
+	// No postprocessCell(): the trials do not produce any forces.
+	_particleCellDataVector.push_back(soa);
+	cell.setCellDataSoA(0);
+	_trialCells.erase(std::find(_trialCells.begin(), _trialCells.end(), &cell));
+}
+
+void VectorizedCellProcessor::endTrials()
+{
+	for (size_t i = 0; i < _trialCells.size(); ++i) {
+		_particleCellDataVector.push_back(_trialCells[i]->getCellDataSoA());
+		_trialCells[i]->setCellDataSoA(0);
+	}
+	_trialCells.clear();
+}
+
+double VectorizedCellProcessor::boundingBoxDistance2(const CellDataSoA& soa1, const CellDataSoA& soa2) {
+	double dist2 = 0.0;
+	for (int d = 0; d < 3; ++d) {
+		const double gap = std::max(soa1._mol_pos_min[d] - soa2._mol_pos_max[d], soa2._mol_pos_min[d] - soa1._mol_pos_max[d]);
+		if (gap > 0.0) {
+			dist2 += gap * gap;
+		}
+	}
+	return dist2;
+}
+
 void VectorizedCellProcessor::processCellPair(ParticleCell & c1,
 		ParticleCell & c2) {
 	assert(&c1 != &c2);
@@ -785,7 +1709,16 @@ void VectorizedCellProcessor::processCellPair(ParticleCell & c1,
 		return;
 	}
 
-	if (!(c1.isHaloCell() || c2.isHaloCell())) {
+	if (_boundingBoxCulling && boundingBoxDistance2(*c1.getCellDataSoA(), *c2.getCellDataSoA()) > _rc2 * BOUNDING_BOX_TOLERANCE) {
+		return;
+	}
+
+	if (_forcesOnly) {
+		// pairs of two halo cells are skipped as below, there are no values to split
+		if (!(c1.isHaloCell() && c2.isHaloCell())) {
+			_calculatePairs<CellPairPolicy_, NoMacroPolicy_>(*(c1.getCellDataSoA()), *(c2.getCellDataSoA()));
+		}
+	} else if (!(c1.isHaloCell() || c2.isHaloCell())) {
 		_calculatePairs<CellPairPolicy_, AllMacroPolicy_>(*(c1.getCellDataSoA()), *(c2.getCellDataSoA()));
 	} else if (c1.isHaloCell() == (!c2.isHaloCell())) {
 		_calculatePairs<CellPairPolicy_, SomeMacroPolicy_>(*(c1.getCellDataSoA()), *(c2.getCellDataSoA()));
@@ -53,6 +53,7 @@ class Domain;
 class Comp2Param;
 class Molecule;
 class CellDataSoA;
+class RDF;
 
 /**
  * \brief Vectorized calculation of Lennard Jones force.
@@ -89,6 +90,100 @@ public:
 
 	double processSingleMolecule(Molecule* m1, ParticleCell& cell2);
 
+	/**
+	 * \brief LJ energy of a test molecule with the molecules of the cells.
+	 * \details The SoA of a cell is loaded when the cell is used in a trial<br>
+	 * for the first time and kept for all further trials of the step.
+	 */
+	double trialEnergy(Molecule* m1, const std::vector<ParticleCell*>& cells);
+	/**
+	 * \brief LJ energies of several test molecules.
+	 * \details All cells are loaded before the energies are calculated.
+	 */
+	void trialEnergies(const std::vector<Molecule*>& molecules,
+			const std::vector<std::vector<ParticleCell*> >& cells, std::vector<double>& energies);
+	/**
+	 * \brief Free the SoA of a cell whose molecules have changed.
+	 */
+	void invalidateTrialCell(ParticleCell& cell);
+	/**
+	 * \brief Free the SoAs of all cells used in the trials.
+	 */
+	void endTrials();
+
+	/**
+	 * \brief Sample the RDF in the force calculation.
+	 * \details Only traversals while the RDF is sampling (see RDF::tickRDF) pay for it.
+	 */
+	void setRDF(RDF* rdf) {
+		_rdf = rdf;
+	}
+
+	/**
+	 * \brief Calculate the forces only (NoMacroPolicy_) if the macroscopic values are not needed.
+	 * \details While the RDF is sampled, all values are calculated nevertheless.
+	 */
+	void setComputeMacroscopicValues(bool compute) {
+		_computeMacroscopicValues = compute;
+	}
+
+	/**
+	 * \brief Skip cell pairs whose molecule bounding boxes are farther apart than the cutoff.
+	 * \details Enabled by default. Such pairs have no molecule pair within the cutoff,<br>
+	 * so the results do not change. It pays off when a cell is smaller than the cutoff<br>
+	 * (cellsInCutoff > 1) or the density is low.
+	 */
+	void setBoundingBoxCulling(bool culling) {
+		_boundingBoxCulling = culling;
+	}
+
+	/**
+	 * \brief The kernel specializations of _calculatePairs.
+	 * \details A kernel combines the handling of the LJ parameters (the lower two bits) with<br>
+	 * the layout of the centers (the next two bits).<br>
+	 * UNIFORM_LJ: all pairs of LJ centers share epsilon, sigma and shift, so these<br>
+	 * are kept in registers instead of being gathered from the parameter tables per pair.<br>
+	 * MIXTURE: the LJ centers are of at most two types (e.g. the components of a binary<br>
+	 * mixture), the parameters of the center i with both types are kept in registers and<br>
+	 * selected per pair by the type of the center j.<br>
+	 * SINGLE_CENTER: each molecule has at most one LJ center in its center of mass, so<br>
+	 * the force mask follows from the center distance and is not stored beforehand.<br>
+	 * TWO_CENTERS, THREE_CENTERS: each molecule has exactly two (three) LJ centers, so the<br>
+	 * centers of molecule i are known at compile time and the force mask of each center j<br>
+	 * is calculated once for all of them.
+	 */
+	enum Kernel {
+		GENERIC = 0,
+		UNIFORM_LJ = 1,
+		MIXTURE = 2,
+		SINGLE_CENTER = 4,
+		TWO_CENTERS = 8,
+		THREE_CENTERS = 12,
+		UNIFORM_LJ_SINGLE_CENTER = UNIFORM_LJ | SINGLE_CENTER,
+		MIXTURE_SINGLE_CENTER = MIXTURE | SINGLE_CENTER,
+		UNIFORM_LJ_TWO_CENTERS = UNIFORM_LJ | TWO_CENTERS,
+		MIXTURE_TWO_CENTERS = MIXTURE | TWO_CENTERS,
+		UNIFORM_LJ_THREE_CENTERS = UNIFORM_LJ | THREE_CENTERS,
+		MIXTURE_THREE_CENTERS = MIXTURE | THREE_CENTERS,
+		PARAMETERS_MASK = 3,
+		CENTERS_MASK = 12
+	};
+
+	Kernel getKernel() const {
+		return _kernel;
+	}
+
+	/**
+	 * \brief Whether the components fulfill the conditions of the kernel.
+	 */
+	bool isKernelApplicable(Kernel kernel) const;
+
+	/**
+	 * \brief Replace the kernel chosen from the components, e.g. by GENERIC for comparisons.
+	 * \details The specializations are only allowed if the components fulfill their conditions.
+	 */
+	void setKernel(Kernel kernel);
+
 	/**
 	 * \brief Free the LennardJonesSoA for cell.
 	 */
@@ -122,6 +217,10 @@ private:
 	 * between two centers.
 	 */
 	std::vector<size_t> _compIDs;
+	/**
+	 * \brief The component ID for each LJ center index (inverse of _compIDs).
+	 */
+	std::vector<unsigned> _centerCompIDs;
 	/**
 	 * \brief Epsilon and sigma for pairs of LJcenters.
 	 * \details Each DoubleArray contains parameters for one center combined with all centers.<br>
@@ -134,6 +233,36 @@ private:
 	 * with all centers.
 	 */
 	std::vector<DoubleArray> _shift6;
+	/**
+	 * \brief The kernel used for the force calculation, chosen from the components.
+	 */
+	Kernel _kernel;
+	/**
+	 * \brief Whether the components allow the UNIFORM_LJ, MIXTURE and SINGLE_CENTER kernels.
+	 */
+	bool _uniformLJ;
+	bool _mixture;
+	bool _singleCenter;
+	/**
+	 * \brief The number of LJ centers of all components, 0 if it differs between them.
+	 */
+	int _centersPerMolecule;
+	/**
+	 * \brief epsilon*24.0, sigma^2 and shift*6.0 of all pairs for the UNIFORM_LJ kernels.
+	 */
+	double _uniformEps24;
+	double _uniformSig2;
+	double _uniformShift6;
+	/**
+	 * \brief The type (0 or 1) of each LJ center index for the MIXTURE kernels.
+	 */
+	std::vector<unsigned> _centerTypes;
+	/**
+	 * \brief epsilon*24.0, sigma^2 and shift*6.0 for the pairs of center types.
+	 */
+	double _mixtureEps24[2][2];
+	double _mixtureSig2[2][2];
+	double _mixtureShift6[2][2];
 	/**
 	 * \brief Sum of all potentials.
 	 * \details Multiplied by 6.0 for performance reasons.
@@ -148,15 +277,70 @@ private:
 	// managing free objects
 	std::vector<CellDataSoA*> _particleCellDataVector;
 
+	// cells whose SoA is kept between the trials of a grand canonical step
+	std::vector<ParticleCell*> _trialCells;
+
 	// lookup array for the distance molecule-molecule on a molecule-center basis.
 	DoubleArray _center_dist_lookup;
 
+	// squared molecule-molecule distances on a molecule-center basis, only stored
+	// while the RDF is sampled
+	DoubleArray _center_dist2_lookup;
+
+	/**
+	 * \brief The RDF to sample, NULL if none.
+	 */
+	RDF* _rdf;
+	/**
+	 * \brief Whether the RDF is sampled in the current traversal.
+	 */
+	bool _rdfActive;
+	/**
+	 * \brief Whether potential energy and virial are requested (see setComputeMacroscopicValues).
+	 */
+	bool _computeMacroscopicValues;
+	/**
+	 * \brief Whether only the forces are calculated in the current traversal.
+	 */
+	bool _forcesOnly;
+	/**
+	 * \brief Whether cell pairs are culled by the bounding boxes of their molecules.
+	 */
+	bool _boundingBoxCulling;
+
+	/**
+	 * \brief Squared distance between the molecule bounding boxes of two loaded cells.
+	 */
+	static double boundingBoxDistance2(const CellDataSoA& soa1, const CellDataSoA& soa2);
+
 	/**
 	 * \brief The body of the inner loop of the non-vectorized force calculation.
 	 */
-	template<class ForcePolicy, class MacroPolicy>
+	template<class ForcePolicy, class MacroPolicy, int Parameters>
 		void _loopBodyNovec(const CellDataSoA & soa1, size_t i, const CellDataSoA & soa2, size_t j, const double *const forceMask);
 
+	/**
+	 * \brief Load the SoA of a cell for the trials, if not loaded yet.
+	 */
+	void _loadTrialCell(ParticleCell& cell);
+
+	/**
+	 * \brief Energy (times 6) of a test molecule with the molecules of the loaded cells.
+	 */
+	double _trialEnergy(Molecule* m1, const std::vector<ParticleCell*>& cells);
+
+	/**
+	 * \brief LJ potential (times 6) of one center of a test molecule with all centers of soa2.
+	 * \details m_r is the position of the test molecule, c_r the one of the center,<br>
+	 * id1 its index in the parameter tables.
+	 */
+	double _trialCenterEnergy6(const double m_r[3], const double c_r[3], size_t id1, const CellDataSoA& soa2);
+
+	/**
+	 * \brief Whether the LJ centers a and b have the same parameters with all centers.
+	 */
+	bool _equalCenters(size_t a, size_t b) const;
+
 	/**
 	 * \brief Force calculation with abstraction of cell pairs.
 	 * \details The differences between single cell and cell pair calculation<br>
@@ -182,12 +366,96 @@ private:
 	 * If the code is to be vectorized:<br>
 	 * static __m128d GetMacroMask(__m128d forceMask, __m128d m_dx, __m128d m_dy, __m128d m_dz);
 	 * <br> Returns the mask indicating for which pairs to store macroscopic values in<br>
-	 * the vectorized code.
+	 * the vectorized code.<br>
+	 * <br>
+	 * Parameters (GENERIC, UNIFORM_LJ or MIXTURE) and SingleCenter select the kernel<br>
+	 * specializations (see Kernel).<br>
+	 * <br>
+	 * With CalculateRDF, the molecule distances of the cutoff check are kept and<br>
+	 * binned by _observeRDF.
 	 *
 	 */
-	template<class ForcePolicy, class MacroPolicy>
+	template<class ForcePolicy, class MacroPolicy, int Parameters, bool SingleCenter, bool CalculateRDF>
 	void _calculatePairs(const CellDataSoA & soa1, const CellDataSoA & soa2);
 
+	/**
+	 * \brief Force calculation for molecules with NumCenters LJ centers each.
+	 * \details The centers of molecule i are NumCenters * i, ..., NumCenters * i + NumCenters - 1.<br>
+	 * All of them are paired with a vector of centers j at once, so the force mask of the<br>
+	 * molecule distance is calculated once instead of being stored for each center j,<br>
+	 * and the forces on the centers j are loaded and stored once. The RDF is not sampled.
+	 */
+	template<class ForcePolicy, class MacroPolicy, int Parameters, int NumCenters>
+	void _calculatePairsFixedCenters(const CellDataSoA & soa1, const CellDataSoA & soa2);
+
+	/**
+	 * \brief Dispatch to _calculatePairs with or without RDF sampling.
+	 */
+	template<class ForcePolicy, class MacroPolicy, int Parameters, bool SingleCenter>
+	void _calculatePairs(const CellDataSoA & soa1, const CellDataSoA & soa2) {
+		if (_rdfActive) {
+			_calculatePairs<ForcePolicy, MacroPolicy, Parameters, SingleCenter, true>(soa1, soa2);
+		} else {
+			_calculatePairs<ForcePolicy, MacroPolicy, Parameters, SingleCenter, false>(soa1, soa2);
+		}
+	}
+
+	/**
+	 * \brief Dispatch to the center layout of the kernel chosen in the constructor.
+	 * \details While the RDF is sampled, the fixed center kernels are replaced by the<br>
+	 * kernel for any number of centers, which stores the molecule distances.
+	 */
+	template<class ForcePolicy, class MacroPolicy, int Parameters>
+	void _calculatePairs(const CellDataSoA & soa1, const CellDataSoA & soa2) {
+		switch (_kernel & CENTERS_MASK) {
+		case SINGLE_CENTER:
+			_calculatePairs<ForcePolicy, MacroPolicy, Parameters, true>(soa1, soa2);
+			break;
+		case TWO_CENTERS:
+			if (_rdfActive) {
+				_calculatePairs<ForcePolicy, MacroPolicy, Parameters, false, true>(soa1, soa2);
+			} else {
+				_calculatePairsFixedCenters<ForcePolicy, MacroPolicy, Parameters, 2>(soa1, soa2);
+			}
+			break;
+		case THREE_CENTERS:
+			if (_rdfActive) {
+				_calculatePairs<ForcePolicy, MacroPolicy, Parameters, false, true>(soa1, soa2);
+			} else {
+				_calculatePairsFixedCenters<ForcePolicy, MacroPolicy, Parameters, 3>(soa1, soa2);
+			}
+			break;
+		default:
+			_calculatePairs<ForcePolicy, MacroPolicy, Parameters, false>(soa1, soa2);
+		}
+	}
+
+	/**
+	 * \brief Dispatch to the parameter handling of the kernel chosen in the constructor.
+	 */
+	template<class ForcePolicy, class MacroPolicy>
+	void _calculatePairs(const CellDataSoA & soa1, const CellDataSoA & soa2) {
+		switch (_kernel & PARAMETERS_MASK) {
+		case UNIFORM_LJ:
+			_calculatePairs<ForcePolicy, MacroPolicy, UNIFORM_LJ>(soa1, soa2);
+			break;
+		case MIXTURE:
+			_calculatePairs<ForcePolicy, MacroPolicy, MIXTURE>(soa1, soa2);
+			break;
+		default:
+			_calculatePairs<ForcePolicy, MacroPolicy, GENERIC>(soa1, soa2);
+		}
+	}
+
+	/**
+	 * \brief Count the pairs of molecule i of soa1 with the molecules of soa2 in the RDF.
+	 * \details Uses the force mask and the molecule distances stored by the cutoff check<br>
+	 * of _calculatePairs. Only pairs contributing to the macroscopic values are counted,<br>
+	 * like in the legacy cell processor. The site RDF is sampled for the LJ centers.
+	 */
+	template<class ForcePolicy, class MacroPolicy>
+	void _observeRDF(const CellDataSoA & soa1, size_t i, size_t i_center_idx, const CellDataSoA & soa2);
+
 	/**
 	 * \brief Policy class for single cell force calculation.
 	 */
@@ -384,6 +652,30 @@ private:
 
 			return _mm256_and_pd(t4, forceMask);
 		}
+#endif
+	};
+	/**
+	 * \brief A MacroPolicy for force-only traversals.
+	 * \details No macroscopic values are added up at all, which removes the<br>
+	 * potential and virial terms from the kernel.
+	 */
+	class NoMacroPolicy_ {
+	public:
+		static bool MacroscopicValueCondition(double, double, double)
+		{
+			return false;
+		}
+#if VLJCP_VEC_TYPE==VLJCP_VEC_SSE3 || VLJCP_VEC_TYPE==VLJCP_VEC_AVX
+		static __m128d GetMacroMask(__m128d, __m128d, __m128d, __m128d)
+		{
+			return _mm_setzero_pd();
+		}
+#endif
+#if VLJCP_VEC_TYPE==VLJCP_VEC_AVX
+		inline static __m256d GetMacroMask(const __m256d&, const __m256d&, const __m256d&, const __m256d&)
+		{
+			return _mm256_setzero_pd();
+		}
 #endif
 	};
 };
@@ -17,6 +17,7 @@ class AdaptiveSubCellsTest : public ParticleContainerTest{
 	TEST_METHOD(testInsertion);
 	TEST_METHOD(testMoleculeIteration);
 	TEST_METHOD(testUpdateAndDeleteOuterParticles);
+	TEST_METHOD(testRepeatedUpdate);
 	TEST_SUITE_END();
 
 public:
@@ -46,6 +47,13 @@ public:
 		AdaptiveSubCells container(boundings_min, boundings_max, 2.5, 2.5);
 		this->ParticleContainerTest::testUpdateAndDeleteOuterParticles(&container);
 	}
+
+	void testRepeatedUpdate() {
+		double boundings_min[] = {0, 0, 0};
+		double boundings_max[] = {10.0, 10.0, 10.0 };
+		AdaptiveSubCells container(boundings_min, boundings_max, 2.5, 2.5);
+		this->ParticleContainerTest::testRepeatedUpdate(&container);
+	}
 };
 
 #endif /* ADAPTIVESUBCELLSTEST_H_ */
@@ -6,6 +6,14 @@
  */
 
 #include "LinkedCellsTest.h"
+#include "parallel/DomainDecompBase.h"
+#include "particleContainer/adapter/LegacyCellProcessor.h"
+#include "particleContainer/adapter/ParticlePairs2PotForceAdapter.h"
+#include "particleContainer/adapter/VectorizedCellProcessor.h"
+
+#include <cmath>
+#include <list>
+#include <vector>
 
 TEST_SUITE_REGISTRATION(LinkedCellsTest);
 
@@ -16,3 +24,136 @@ LinkedCellsTest::LinkedCellsTest() {
 LinkedCellsTest::~LinkedCellsTest() {
 }
 
+
+void LinkedCellsTest::testPeriodicImages() {
+	double boundings_min[] = {0, 0, 0};
+	double boundings_max[] = {10.0, 10.0, 10.0 };
+	LinkedCells container(boundings_min, boundings_max, 2.5, 2.5, 1);
+	container.setPeriodicImages(true);
+	ASSERT_TRUE(container.usesPeriodicImages());
+
+	Component component(0);
+	component.addLJcenter(0,0,0,1,1,1,0,false);
+	//(id, cid, x, y, z, vx, vy, vz, q0, q1, q2, q3, Dx, Dy, Dz)
+	Molecule boundaryMolecule(1, &component, 0.5,5.0,5.0,0,0,0, 0, 0, 0, 0, 0, 0, 0);
+	container.addParticle(boundaryMolecule);
+	Molecule innerMolecule(2, &component, 5.0,5.0,5.0,0,0,0, 0, 0, 0, 0, 0, 0, 0);
+	container.addParticle(innerMolecule);
+	container.update();
+
+	// the molecule near the lower x boundary has its image in the upper halo
+	std::list<Molecule*> haloParticles;
+	container.getHaloParticles(haloParticles);
+	ASSERT_EQUAL((size_t) 1, haloParticles.size());
+	ASSERT_EQUAL(1ul, haloParticles.front()->id());
+	ASSERT_EQUAL(2ul, container.getNumberOfParticles());
+	ParticleCell image = container.getCell(container.getCellIndexOfMolecule(haloParticles.front()) + 4);
+	ASSERT_TRUE(image.isHaloCell());
+	ASSERT_EQUAL(1, image.getMoleculeCount());
+	ASSERT_DOUBLES_EQUAL(10.0, image.getPeriodicShift()[0], 0.0);
+	ASSERT_DOUBLES_EQUAL(0.0, image.getPeriodicShift()[1], 0.0);
+
+	// no copies are needed after the halo is cleared and the molecule left the bounding box
+	container.deleteOuterParticles();
+	ASSERT_EQUAL(2ul, container.getNumberOfParticles());
+	Molecule* molecule = container.begin();
+	while (molecule != container.end()) {
+		if (molecule->id() == 1) {
+			molecule->setr(0, -0.2);
+		}
+		molecule = container.next();
+	}
+	container.update();
+	ASSERT_EQUAL(2ul, container.getNumberOfParticles());
+	haloParticles.clear();
+	container.getHaloParticles(haloParticles);
+	ASSERT_EQUAL((size_t) 1, haloParticles.size());
+	ASSERT_DOUBLES_EQUAL(9.8, haloParticles.front()->r(0), 1e-12);
+
+	// the image is now in the lower halo, shifted to the position of the former copy
+	ParticleCell lowerImage = container.getCell(container.getCellIndexOfMolecule(haloParticles.front()) - 4);
+	ASSERT_TRUE(lowerImage.isHaloCell());
+	ASSERT_EQUAL(1, lowerImage.getMoleculeCount());
+	ASSERT_DOUBLES_EQUAL(-10.0, lowerImage.getPeriodicShift()[0], 0.0);
+}
+
+void LinkedCellsTest::testTrialEnergy() {
+	const double cutoff = 2.5;
+	LinkedCells* container = static_cast<LinkedCells*>(
+			initializeFromFile(ParticleContainerFactory::LinkedCell, "lj-mixture.inp", cutoff));
+	_domainDecomposition->balanceAndExchange(false, container, _domain);
+	container->updateMoleculeCaches();
+
+	ParticlePairs2PotForceAdapter handler(*_domain);
+	LegacyCellProcessor legacy(cutoff, cutoff, cutoff, &handler);
+	VectorizedCellProcessor vectorized(*_domain, cutoff);
+
+	// test deletions of every 5th molecule and test insertions of copies displaced from it
+	const double shift[3] = { 0.61, -0.37, 0.23 };
+	std::vector<Molecule*> deletions;
+	std::vector<Molecule> insertions;
+	for (Molecule* m = container->begin(); m != container->end(); m = container->next()) {
+		double r[3] = { m->r(0), m->r(1), m->r(2) };
+		if (m->id() % 5 != 0 || !container->isInBoundingBox(r)) {
+			continue;
+		}
+		deletions.push_back(m);
+		for (int d = 0; d < 3; d++) {
+			r[d] += shift[d];
+		}
+		if (container->isInBoundingBox(r)) {
+			insertions.push_back(*m);
+			for (int d = 0; d < 3; d++) {
+				insertions.back().setr(d, r[d]);
+			}
+			insertions.back().setid(100000 + m->id());
+			insertions.back().upd_cache();
+		}
+	}
+	ASSERT_TRUE(deletions.size() > 10);
+	ASSERT_TRUE(insertions.size() > 10);
+	std::vector<Molecule*> trials(deletions);
+	for (size_t i = 0; i < insertions.size(); i++) {
+		trials.push_back(&insertions[i]);
+	}
+
+	vectorized.initTrials();
+	for (size_t i = 0; i < trials.size(); i++) {
+		const double expected = container->getEnergy(&handler, trials[i], legacy);
+		const double actual = container->getEnergy(&handler, trials[i], vectorized);
+		ASSERT_DOUBLES_EQUAL(expected, actual, 1e-10 * (1.0 + fabs(expected)));
+		// the second trial is calculated from the cached cells
+		ASSERT_EQUAL(actual, container->getEnergy(&handler, trials[i], vectorized));
+	}
+
+	// accept a test insertion next to a molecule: the cached cell does not contain the
+	// inserted molecule until it is invalidated
+	Molecule* probe = deletions[deletions.size() / 2];
+	const double before = container->getEnergy(&handler, probe, vectorized);
+	Molecule inserted(*probe);
+	double r[3] = { probe->r(0) + 1.1, probe->r(1), probe->r(2) };
+	if (!container->isInBoundingBox(r)) {
+		r[0] = probe->r(0) - 1.1;
+	}
+	for (int d = 0; d < 3; d++) {
+		inserted.setr(d, r[d]);
+	}
+	inserted.setid(200000);
+	inserted.upd_cache();
+	ParticleCell& cell = container->_cells[container->getCellIndexOfMolecule(&inserted)];
+	cell.addParticle(&inserted);
+	const double after = container->getEnergy(&handler, probe, legacy);
+	ASSERT_TRUE(fabs(after - before) > 1e-3 * (1.0 + fabs(before)));
+	ASSERT_EQUAL(before, container->getEnergy(&handler, probe, vectorized));
+	vectorized.invalidateTrialCell(cell);
+	ASSERT_TRUE(cell.getCellDataSoA() == NULL);
+	ASSERT_DOUBLES_EQUAL(after, container->getEnergy(&handler, probe, vectorized), 1e-10 * (1.0 + fabs(after)));
+
+	// all cells are released at the end of the trials
+	vectorized.endTrials();
+	for (size_t i = 0; i < container->_cells.size(); i++) {
+		ASSERT_TRUE(container->_cells[i].getCellDataSoA() == NULL);
+	}
+	ASSERT_TRUE(cell.deleteMolecule(inserted.id()));
+	delete container;
+}
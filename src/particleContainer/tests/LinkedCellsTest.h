@@ -17,6 +17,9 @@ class LinkedCellsTest: public ParticleContainerTest {
 	TEST_METHOD(testInsertion);
 	TEST_METHOD(testMoleculeIteration);
 	TEST_METHOD(testUpdateAndDeleteOuterParticles);
+	TEST_METHOD(testRepeatedUpdate);
+	TEST_METHOD(testPeriodicImages);
+	TEST_METHOD(testTrialEnergy);
 	TEST_SUITE_END();
 
 public:
@@ -45,6 +48,28 @@ public:
 		LinkedCells container(boundings_min, boundings_max, 2.5, 2.5, 1);
 		this->ParticleContainerTest::testUpdateAndDeleteOuterParticles(&container);
 	}
+
+	void testRepeatedUpdate() {
+		double boundings_min[] = {0, 0, 0};
+		double boundings_max[] = {10.0, 10.0, 10.0 };
+		LinkedCells container(boundings_min, boundings_max, 2.5, 2.5, 1);
+		this->ParticleContainerTest::testRepeatedUpdate(&container);
+	}
+
+	/**
+	 * Test the periodic images in the halo cells: molecules which left the bounding box
+	 * are moved to the opposite side and the halo cells reference the molecules of
+	 * the boundary cells with the periodic shift, without copies of the molecules.
+	 */
+	void testPeriodicImages();
+
+	/**
+	 * Test the trial energies of the grand canonical ensemble: the energies the
+	 * VectorizedCellProcessor calculates from its cached cells have to match those
+	 * of the LegacyCellProcessor for test deletions and insertions, and a cell has
+	 * to be reloaded after it was invalidated because a molecule was inserted.
+	 */
+	void testTrialEnergy();
 };
 
 #endif /* LINKEDCELLSTEST_H_ */
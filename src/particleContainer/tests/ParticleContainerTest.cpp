@@ -9,6 +9,8 @@
 #include "particleContainer/ParticleContainer.h"
 #include "molecules/Molecule.h"
 
+#include <list>
+
 ParticleContainerTest::ParticleContainerTest() {
 	Component dummyComponent(0);
 	dummyComponent.addLJcenter(0,0,0,1,1,1,0,false);
@@ -142,3 +144,52 @@ void ParticleContainerTest::testUpdateAndDeleteOuterParticles(ParticleContainer*
 		}
 	}
 }
+
+
+void ParticleContainerTest::testRepeatedUpdate(ParticleContainer* container) {
+	setupMolecules(container);
+	container->update();
+
+	// move molecule 4 from [5.1/5.1/5.1] next to molecule 1
+	Molecule* molecule = container->begin();
+	while (molecule != container->end()) {
+		if (molecule->id() == 4) {
+			for (int d = 0; d < 3; d++) {
+				molecule->setr(d, 1.5);
+			}
+		}
+		molecule = container->next();
+	}
+	container->update();
+
+	// the cells around this region do not contain the old position of molecule 4
+	double lowCorner[] = {0.0, 0.0, 0.0};
+	double highCorner[] = {1.6, 1.6, 1.6};
+	std::list<Molecule*> particlePtrs;
+	container->getRegion(lowCorner, highCorner, particlePtrs);
+	ASSERT_EQUAL((size_t) 2, particlePtrs.size());
+	bool ids[] = {false, false, false, false};
+	for (std::list<Molecule*>::iterator it = particlePtrs.begin(); it != particlePtrs.end(); it++) {
+		ids[(*it)->id() - 1] = true;
+	}
+	ASSERT_TRUE(ids[0]);
+	ASSERT_TRUE(ids[3]);
+
+	// delete molecule 1, its cell still points to it until the next update
+	molecule = container->begin();
+	while (molecule != container->end()) {
+		if (molecule->id() == 1) {
+			molecule = container->deleteCurrent();
+		}
+		else {
+			molecule = container->next();
+		}
+	}
+	container->update();
+	ASSERT_EQUAL(3ul, container->getNumberOfParticles());
+
+	particlePtrs.clear();
+	container->getRegion(lowCorner, highCorner, particlePtrs);
+	ASSERT_EQUAL((size_t) 1, particlePtrs.size());
+	ASSERT_EQUAL(4ul, particlePtrs.front()->id());
+}
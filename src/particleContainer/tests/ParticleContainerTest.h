@@ -60,6 +60,18 @@ public:
 	 */
 	void testUpdateAndDeleteOuterParticles(ParticleContainer* container);
 
+	/**
+	 * Test repeated updates of the particle container:
+	 * - moves a particle far enough after an update, so it has to change its cell
+	 * - checks with getRegion() that the next update moved it to its new cell
+	 * - deletes a particle with deleteCurrent() and checks the following update
+	 *
+	 * Precondition: testUpdateAndDeleteOuterParticles has to be successful.
+	 *
+	 * @param container ParticleContainer with corner points [0;0;0] x [10;10;10] and cutoff=2.5
+	 */
+	void testRepeatedUpdate(ParticleContainer* container);
+
 private:
 
 	/**
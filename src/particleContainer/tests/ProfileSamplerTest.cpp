@@ -0,0 +1,71 @@
+/**
+ * \file
+ * \brief Tests for ProfileSampler.
+ */
+
+#include "ProfileSamplerTest.h"
+#include "Domain.h"
+#include "particleContainer/ParticleContainer.h"
+#include "particleContainer/adapter/ProfileSampler.h"
+
+using namespace std;
+
+TEST_SUITE_REGISTRATION(ProfileSamplerTest);
+
+ProfileSamplerTest::ProfileSamplerTest() { }
+
+ProfileSamplerTest::~ProfileSamplerTest() { }
+
+
+void ProfileSamplerTest::assertEqualProfiles(const ProfileSampler& expected, const ProfileSampler& actual) {
+	ASSERT_EQUAL(expected.numBins(), actual.numBins());
+	for (unsigned bin = 0; bin < expected.numBins(); bin++) {
+		ASSERT_DOUBLES_EQUAL((double) expected.N(bin), (double) actual.N(bin), 1e-12);
+		for (int d = 0; d < 3; d++) {
+			ASSERT_DOUBLES_EQUAL((double) expected.v(d, bin), (double) actual.v(d, bin), 1e-10);
+		}
+		ASSERT_DOUBLES_EQUAL((double) expected.DOF(bin), (double) actual.DOF(bin), 1e-12);
+		ASSERT_DOUBLES_EQUAL((double) expected.kinetic(bin), (double) actual.kinetic(bin), 1e-10);
+	}
+}
+
+void ProfileSamplerTest::testCellwiseSampling() {
+	ParticleContainer* container = initializeFromFile(ParticleContainerFactory::LinkedCell, "1clj-regular-12x12x12.inp", 1.8);
+	double globalLength[3];
+	for (int d = 0; d < 3; d++) {
+		globalLength[d] = _domain->getGlobalLength(d);
+	}
+
+	// one bin per dimension covers all cells, 5 and 7 bins cut through the cells
+	const unsigned binnings[3][3] = { { 1, 1, 1 }, { 1, 5, 1 }, { 2, 7, 3 } };
+	for (int i = 0; i < 3; i++) {
+		ProfileSampler cellwise, moleculewise;
+		cellwise.setup(binnings[i], globalLength);
+		moleculewise.setup(binnings[i], globalLength);
+		cellwise.considerComponent(0);
+		moleculewise.considerComponent(0);
+
+		container->sampleProfile(cellwise);
+		for (Molecule* m = container->begin(); m != container->end(); m = container->next()) {
+			moleculewise.sampleMolecule(m);
+		}
+		assertEqualProfiles(moleculewise, cellwise);
+
+		double N = 0.0;
+		for (unsigned bin = 0; bin < cellwise.numBins(); bin++) {
+			N += cellwise.N(bin);
+		}
+		ASSERT_DOUBLES_EQUAL((double) container->getNumberOfParticles(), N, 1e-12);
+	}
+
+	// components which are not profiled are not recorded
+	ProfileSampler other;
+	other.setup(binnings[1], globalLength);
+	other.considerComponent(1);
+	container->sampleProfile(other);
+	for (unsigned bin = 0; bin < other.numBins(); bin++) {
+		ASSERT_DOUBLES_EQUAL(0.0, (double) other.N(bin), 1e-12);
+	}
+
+	delete container;
+}
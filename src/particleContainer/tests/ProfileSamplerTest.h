@@ -0,0 +1,37 @@
+/**
+ * \file
+ * \brief Tests for ProfileSampler.
+ */
+
+#ifndef PROFILESAMPLERTEST_H_
+#define PROFILESAMPLERTEST_H_
+
+#include "utils/TestWithSimulationSetup.h"
+
+class ProfileSampler;
+
+/**
+ * Tests the cell-wise sampling of the profiles against the sampling of the
+ * single molecules.
+ */
+class ProfileSamplerTest: public utils::TestWithSimulationSetup {
+
+	TEST_SUITE(ProfileSamplerTest);
+	TEST_METHOD(testCellwiseSampling);
+	TEST_SUITE_END();
+
+public:
+
+	ProfileSamplerTest();
+
+	virtual ~ProfileSamplerTest();
+
+	//! cell-wise and molecule-wise sampling give the same profiles, for bins
+	//! aligned with the cells as well as for bins cutting through cells
+	void testCellwiseSampling();
+
+private:
+	void assertEqualProfiles(const ProfileSampler& expected, const ProfileSampler& actual);
+};
+
+#endif /* PROFILESAMPLERTEST_H_ */
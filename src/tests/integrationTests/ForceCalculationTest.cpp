@@ -7,13 +7,63 @@
 
 #include "ForceCalculationTest.h"
 #include "Domain.h"
+#include "Simulation.h"
+#include "ensemble/EnsembleBase.h"
+#include "io/RDF.h"
 #include "parallel/DomainDecompBase.h"
 #include "particleContainer/ParticleContainer.h"
 #include "particleContainer/adapter/ParticlePairs2PotForceAdapter.h"
 #include "particleContainer/adapter/LegacyCellProcessor.h"
+#include "particleContainer/adapter/VectorizedCellProcessor.h"
+
+#include <cmath>
+#include <vector>
 
 TEST_SUITE_REGISTRATION(ForceCalculationTest);
 
+namespace {
+
+/** forwards to a ParticlePairs2PotForceAdapter, hiding its type from the LegacyCellProcessor */
+class ForwardingPairsHandler : public ParticlePairsHandler {
+public:
+	ForwardingPairsHandler(ParticlePairsHandler& handler) : _handler(handler) {}
+	void init() { _handler.init(); }
+	void finish() { _handler.finish(); }
+	double processPair(Molecule& particle1, Molecule& particle2, double distanceVector[3], PairType pairType, double dd, bool calculateLJ) {
+		return _handler.processPair(particle1, particle2, distanceVector, pairType, dd, calculateLJ);
+	}
+	void preprocessTersoffPair(Molecule& particle1, Molecule& particle2, bool pairType) {
+		_handler.preprocessTersoffPair(particle1, particle2, pairType);
+	}
+	void processTersoffAtom(Molecule& particle1, double params[15], double delta_r) {
+		_handler.processTersoffAtom(particle1, params, delta_r);
+	}
+private:
+	ParticlePairsHandler& _handler;
+};
+
+/** forwards a traversal to another cell processor, but only the single cells or only the cell pairs */
+class CellPolicyFilter : public CellProcessor {
+public:
+	CellPolicyFilter(CellProcessor& processor, bool cellPairs) : _processor(processor), _cellPairs(cellPairs) {}
+	void initTraversal(const size_t numCells) { _processor.initTraversal(numCells); }
+	void preprocessCell(ParticleCell& cell) { _processor.preprocessCell(cell); }
+	void processCellPair(ParticleCell& cell1, ParticleCell& cell2) {
+		if (_cellPairs) _processor.processCellPair(cell1, cell2);
+	}
+	void processCell(ParticleCell& cell) {
+		if (!_cellPairs) _processor.processCell(cell);
+	}
+	double processSingleMolecule(Molecule* m1, ParticleCell& cell2) { return _processor.processSingleMolecule(m1, cell2); }
+	void postprocessCell(ParticleCell& cell) { _processor.postprocessCell(cell); }
+	void endTraversal() { _processor.endTraversal(); }
+private:
+	CellProcessor& _processor;
+	bool _cellPairs;
+};
+
+}
+
 ForceCalculationTest::ForceCalculationTest() {
 }
 
@@ -93,3 +143,242 @@ void ForceCalculationTest::testForcePotentialCalculationF0() {
 
 	delete container;
 }
+
+void ForceCalculationTest::testSpecializedKernel() {
+	if (_domainDecomposition->getNumProcs() != 1) {
+		test_log->info() << "ForceCalculationTest::testSpecializedKernel()"
+				<< " not executed (rerun with only 1 Process!)" << std::endl;
+		return;
+	}
+
+	const double cutoff = 3.0;
+	ParticleContainer* container = initializeFromFile(ParticleContainerFactory::LinkedCell, "polar-mixture.inp", cutoff);
+	_domainDecomposition->balanceAndExchange(false, container, _domain);
+	container->updateMoleculeCaches();
+
+	ParticlePairs2PotForceAdapter forceAdapter(*_domain);
+	ForwardingPairsHandler genericHandler(forceAdapter);
+
+	// reference with the generic pair handler
+	LegacyCellProcessor genericProcessor(cutoff, cutoff, 0.0, &genericHandler);
+	container->traverseCells(genericProcessor);
+	const double upot = _domain->getLocalUpot();
+	const double virial = _domain->getLocalVirial();
+	std::vector<double> forces;
+	for (Molecule* m = container->begin(); m != container->end(); m = container->next()) {
+		for (int d = 0; d < 3; d++) {
+			forces.push_back(m->F(d));
+			forces.push_back(m->M(d));
+		}
+	}
+	ASSERT_TRUE(upot != 0.0);
+
+	container->updateMoleculeCaches();
+	LegacyCellProcessor specializedProcessor(cutoff, cutoff, 0.0, &forceAdapter);
+	container->traverseCells(specializedProcessor);
+	ASSERT_DOUBLES_EQUAL(upot, _domain->getLocalUpot(), 1e-10 * fabs(upot));
+	ASSERT_DOUBLES_EQUAL(virial, _domain->getLocalVirial(), 1e-10 * fabs(virial));
+	size_t i = 0;
+	for (Molecule* m = container->begin(); m != container->end(); m = container->next()) {
+		for (int d = 0; d < 3; d++) {
+			ASSERT_DOUBLES_EQUAL(forces[i++], m->F(d), 1e-10);
+			ASSERT_DOUBLES_EQUAL(forces[i++], m->M(d), 1e-10);
+		}
+	}
+
+	delete container;
+}
+
+void ForceCalculationTest::testBoundingBoxCulling() {
+	if (_domainDecomposition->getNumProcs() != 1) {
+		test_log->info() << "ForceCalculationTest::testBoundingBoxCulling()"
+				<< " not executed (rerun with only 1 Process!)" << std::endl;
+		return;
+	}
+
+	const double cutoff = 2.5;
+	ParticleContainer* container = initializeFromFile(ParticleContainerFactory::LinkedCell, "1clj-regular-12x12x12.inp", cutoff);
+	_domainDecomposition->balanceAndExchange(false, container, _domain);
+	container->updateMoleculeCaches();
+
+	// reference without culling
+	VectorizedCellProcessor processor(*_domain, cutoff);
+	processor.setBoundingBoxCulling(false);
+	container->traverseCells(processor);
+	const double upot = _domain->getLocalUpot();
+	const double virial = _domain->getLocalVirial();
+	std::vector<double> forces;
+	for (Molecule* m = container->begin(); m != container->end(); m = container->next()) {
+		for (int d = 0; d < 3; d++) {
+			forces.push_back(m->F(d));
+		}
+	}
+	ASSERT_TRUE(upot != 0.0);
+
+	// the culled pairs have no molecules within the cutoff, so the results are identical
+	container->updateMoleculeCaches();
+	processor.setBoundingBoxCulling(true);
+	container->traverseCells(processor);
+	ASSERT_EQUAL(upot, _domain->getLocalUpot());
+	ASSERT_EQUAL(virial, _domain->getLocalVirial());
+	size_t i = 0;
+	for (Molecule* m = container->begin(); m != container->end(); m = container->next()) {
+		for (int d = 0; d < 3; d++) {
+			ASSERT_EQUAL(forces[i++], m->F(d));
+		}
+	}
+
+	delete container;
+}
+
+void ForceCalculationTest::calculateVectorized(ParticleContainer* container, VectorizedCellProcessor& processor,
+		bool cellPairs, std::vector<double>& results) {
+	CellPolicyFilter filter(processor, cellPairs);
+	calculateVectorized(container, filter, results);
+}
+
+void ForceCalculationTest::calculateVectorized(ParticleContainer* container, CellProcessor& processor,
+		std::vector<double>& results) {
+	for (Molecule* m = container->begin(); m != container->end(); m = container->next()) {
+		m->clearFM();
+	}
+	container->traverseCells(processor);
+	results.clear();
+	for (Molecule* m = container->begin(); m != container->end(); m = container->next()) {
+		for (int d = 0; d < 3; d++) {
+			results.push_back(m->F(d));
+		}
+		for (unsigned s = 0; s < m->numSites(); s++) {
+			results.insert(results.end(), m->site_F(s), m->site_F(s) + 3);
+		}
+	}
+	results.push_back(_domain->getLocalUpot());
+	results.push_back(_domain->getLocalVirial());
+}
+
+void ForceCalculationTest::testSingleCenterKernels() {
+	checkKernelSpecializations("1clj-regular-12x12x12.inp", 2.5, VectorizedCellProcessor::UNIFORM_LJ_SINGLE_CENTER);
+}
+
+void ForceCalculationTest::testUniformLJKernel() {
+	checkKernelSpecializations("Ethan_equilibrated.inp", 32.1254, VectorizedCellProcessor::UNIFORM_LJ_TWO_CENTERS);
+}
+
+void ForceCalculationTest::testThreeCenterKernels() {
+	checkKernelSpecializations("3clj-regular.inp", 2.5, VectorizedCellProcessor::MIXTURE_THREE_CENTERS);
+}
+
+void ForceCalculationTest::testMixtureKernels() {
+	checkKernelSpecializations("lj-mixture.inp", 2.5, VectorizedCellProcessor::MIXTURE);
+}
+
+void ForceCalculationTest::testSingleCenterMixtureKernels() {
+	checkKernelSpecializations("1clj-mixture.inp", 2.5, VectorizedCellProcessor::MIXTURE_SINGLE_CENTER);
+}
+
+void ForceCalculationTest::testTwoCenterMixtureKernels() {
+	checkKernelSpecializations("2clj-mixture.inp", 2.5, VectorizedCellProcessor::MIXTURE_TWO_CENTERS);
+}
+
+void ForceCalculationTest::checkKernelSpecializations(const std::string& file, double cutoff, int expectedKernel) {
+	if (_domainDecomposition->getNumProcs() != 1) {
+		test_log->info() << "ForceCalculationTest::checkKernelSpecializations()"
+				<< " not executed (rerun with only 1 Process!)" << std::endl;
+		return;
+	}
+
+	ParticleContainer* container = initializeFromFile(ParticleContainerFactory::LinkedCell, file.c_str(), cutoff);
+	Molecule* m = container->begin();
+	while (m != container->end()) {
+		m = (m->id() % 7 == 0) ? container->deleteCurrent() : container->next();
+	}
+	container->update();
+	_domainDecomposition->balanceAndExchange(false, container, _domain);
+	// only once, as each update normalizes the orientations again
+	container->updateMoleculeCaches();
+
+	VectorizedCellProcessor processor(*_domain, cutoff);
+	ASSERT_EQUAL(expectedKernel, static_cast<int>(processor.getKernel()));
+	const VectorizedCellProcessor::Kernel kernels[] = {
+		VectorizedCellProcessor::UNIFORM_LJ, VectorizedCellProcessor::MIXTURE,
+		VectorizedCellProcessor::SINGLE_CENTER, VectorizedCellProcessor::UNIFORM_LJ_SINGLE_CENTER,
+		VectorizedCellProcessor::MIXTURE_SINGLE_CENTER, VectorizedCellProcessor::TWO_CENTERS,
+		VectorizedCellProcessor::UNIFORM_LJ_TWO_CENTERS, VectorizedCellProcessor::MIXTURE_TWO_CENTERS,
+		VectorizedCellProcessor::THREE_CENTERS, VectorizedCellProcessor::UNIFORM_LJ_THREE_CENTERS,
+		VectorizedCellProcessor::MIXTURE_THREE_CENTERS
+	};
+	std::vector<VectorizedCellProcessor::Kernel> specializations;
+	for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+		if (processor.isKernelApplicable(kernels[k])) {
+			specializations.push_back(kernels[k]);
+		}
+	}
+
+	for (int cellPairs = 0; cellPairs < 2; cellPairs++) {
+		std::vector<double> reference, results;
+		processor.setKernel(VectorizedCellProcessor::GENERIC);
+		calculateVectorized(container, processor, cellPairs, reference);
+		ASSERT_TRUE(reference[reference.size() - 2] != 0.0);
+
+		for (size_t k = 0; k < specializations.size(); k++) {
+			processor.setKernel(specializations[k]);
+			calculateVectorized(container, processor, cellPairs, results);
+			ASSERT_EQUAL(reference.size(), results.size());
+			// the fixed center kernels add up the potential and virial of the pairs in another
+			// order, and the compiler may contract their operations differently (e.g. to fused
+			// multiply-adds); all other kernels share the operations of the GENERIC kernel
+			const int centers = specializations[k] & VectorizedCellProcessor::CENTERS_MASK;
+			const bool fixedCenters = (centers == VectorizedCellProcessor::TWO_CENTERS)
+					|| (centers == VectorizedCellProcessor::THREE_CENTERS);
+			for (size_t i = 0; i < reference.size(); i++) {
+				std::stringstream str;
+				str << file << ": kernel " << specializations[k] << (cellPairs ? ", cell pairs" : ", single cells")
+						<< ", value " << i << std::endl;
+				if (fixedCenters) {
+					ASSERT_DOUBLES_EQUAL_MSG(str.str(), reference[i], results[i], 1e-12 * (1.0 + fabs(reference[i])));
+				} else {
+					ASSERT_EQUAL_MSG(str.str(), reference[i], results[i]);
+				}
+			}
+		}
+	}
+	delete container;
+}
+
+void ForceCalculationTest::testForcesOnly() {
+	const double cutoff = 2.5;
+	ParticleContainer* container = initializeFromFile(ParticleContainerFactory::LinkedCell, "lj-mixture.inp", cutoff);
+	_domainDecomposition->balanceAndExchange(false, container, _domain);
+	container->updateMoleculeCaches();
+
+	VectorizedCellProcessor processor(*_domain, cutoff);
+	std::vector<double> reference, results;
+	processor.setComputeMacroscopicValues(true);
+	calculateVectorized(container, processor, reference);
+	const double upot = reference[reference.size() - 2];
+	const double virial = reference[reference.size() - 1];
+	ASSERT_TRUE(upot != 0.0);
+
+	// the potential energy and the virial are not calculated
+	processor.setComputeMacroscopicValues(false);
+	calculateVectorized(container, processor, results);
+	ASSERT_EQUAL(reference.size(), results.size());
+	ASSERT_EQUAL(0.0, results[results.size() - 2]);
+	ASSERT_EQUAL(0.0, results[results.size() - 1]);
+	// the compiler may contract the operations of the kernels differently (e.g. to fused multiply-adds)
+	for (size_t i = 0; i < reference.size() - 2; i++) {
+		ASSERT_DOUBLES_EQUAL(reference[i], results[i], 1e-12 * (1.0 + fabs(reference[i])));
+	}
+
+	// the RDF needs the full kernel
+	RDF rdf(0.025, 100, global_simulation->getEnsemble()->components());
+	processor.setRDF(&rdf);
+	rdf.tickRDF();
+	calculateVectorized(container, processor, results);
+	ASSERT_DOUBLES_EQUAL(upot, results[results.size() - 2], 1e-12 * fabs(upot));
+	ASSERT_DOUBLES_EQUAL(virial, results[results.size() - 1], 1e-12 * fabs(virial));
+	for (size_t i = 0; i < reference.size() - 2; i++) {
+		ASSERT_DOUBLES_EQUAL(reference[i], results[i], 1e-12 * (1.0 + fabs(reference[i])));
+	}
+	delete container;
+}
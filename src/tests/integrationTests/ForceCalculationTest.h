@@ -10,6 +10,12 @@
 
 #include "utils/TestWithSimulationSetup.h"
 
+#include <string>
+#include <vector>
+
+class CellProcessor;
+class VectorizedCellProcessor;
+
 /**
  * This class tests the iteration over the 4 1CLJ-molecules and the calculation
  * of the force and potential, respectively.
@@ -19,6 +25,15 @@ class ForceCalculationTest : public utils::TestWithSimulationSetup {
 	TEST_SUITE(ForceCalculationTest);
 	TEST_METHOD(testForcePotentialCalculationU0);
 	TEST_METHOD(testForcePotentialCalculationF0);
+	TEST_METHOD(testSpecializedKernel);
+	TEST_METHOD(testBoundingBoxCulling);
+	TEST_METHOD(testSingleCenterKernels);
+	TEST_METHOD(testUniformLJKernel);
+	TEST_METHOD(testThreeCenterKernels);
+	TEST_METHOD(testMixtureKernels);
+	TEST_METHOD(testSingleCenterMixtureKernels);
+	TEST_METHOD(testTwoCenterMixtureKernels);
+	TEST_METHOD(testForcesOnly);
 	TEST_SUITE_END();
 
 public:
@@ -46,6 +61,102 @@ public:
 	 */
 	void testForcePotentialCalculationF0();
 
+	/**
+	 * Compares the forces, torques, potential and virial of a mixture of
+	 * molecules with LJ centers, charges, dipoles and quadrupoles calculated
+	 * by the LegacyCellProcessor with the specialised pair kernel and with
+	 * the generic (virtual) pair handler interface.
+	 */
+	void testSpecializedKernel();
+
+	/**
+	 * Checks that skipping the cell pairs whose molecule bounding boxes are
+	 * beyond the cutoff does not change the forces, potential and virial
+	 * calculated by the VectorizedCellProcessor.
+	 */
+	void testBoundingBoxCulling();
+
+	/**
+	 * Compares the forces, potential and virial of the kernels with uniform LJ
+	 * parameters, two center types and a single center of the VectorizedCellProcessor
+	 * with the GENERIC kernel for a 1CLJ fluid.
+	 *
+	 * @see checkKernelSpecializations
+	 */
+	void testSingleCenterKernels();
+
+	/**
+	 * Compares the kernels for uniform LJ parameters, two center types and two
+	 * centers per molecule with the GENERIC kernel for a 2CLJ fluid.
+	 *
+	 * @see checkKernelSpecializations
+	 */
+	void testUniformLJKernel();
+
+	/**
+	 * Compares the kernels for two center types and three centers per molecule
+	 * with the GENERIC kernel for a 3CLJ fluid with two types of sites.
+	 *
+	 * @see checkKernelSpecializations
+	 */
+	void testThreeCenterKernels();
+
+	/**
+	 * Compares the kernel for two center types with the GENERIC kernel for a
+	 * binary mixture of a 1CLJ and a 2CLJ fluid.
+	 *
+	 * @see checkKernelSpecializations
+	 */
+	void testMixtureKernels();
+
+	/**
+	 * Compares the kernels for two center types and a single center with the
+	 * GENERIC kernel for a binary mixture of 1CLJ fluids.
+	 *
+	 * @see checkKernelSpecializations
+	 */
+	void testSingleCenterMixtureKernels();
+
+	/**
+	 * Compares the kernels for two center types and two centers per molecule with
+	 * the GENERIC kernel for a binary mixture of 2CLJ fluids.
+	 *
+	 * @see checkKernelSpecializations
+	 */
+	void testTwoCenterMixtureKernels();
+
+	/**
+	 * Checks that the traversal without the macroscopic values (NoMacroPolicy_) of the
+	 * VectorizedCellProcessor calculates the same forces as the full traversal, and
+	 * that the full traversal is used nevertheless while the RDF is sampled.
+	 */
+	void testForcesOnly();
+
+private:
+
+	/**
+	 * Checks that the VectorizedCellProcessor chooses the kernel expectedKernel for the
+	 * components of the file and compares all specialised kernels, which apply to them,
+	 * with the GENERIC kernel, separately for the single cells and the cell pairs. Some
+	 * molecules are removed, so that the cells hold numbers of centers which do not
+	 * fill the vector registers.
+	 */
+	void checkKernelSpecializations(const std::string& file, double cutoff, int expectedKernel);
+
+	/**
+	 * Traverse the cells, passing only the single cells or only the cell pairs to
+	 * the processor, and store the forces and site forces of the molecules followed by
+	 * the potential energy and the virial in results.
+	 */
+	void calculateVectorized(ParticleContainer* container, VectorizedCellProcessor& processor,
+			bool cellPairs, std::vector<double>& results);
+
+	/**
+	 * Traverse all cells with the processor and store the results as above.
+	 */
+	void calculateVectorized(ParticleContainer* container, CellProcessor& processor,
+			std::vector<double>& results);
+
 };
 
 #endif /* FORCECALCULATIONTEST_H_ */
@@ -1,6 +1,7 @@
 #include "thermostats/VelocityScalingThermostat.h"
 
 #include "Domain.h"
+#include "ensemble/EnsembleBase.h"
 #include "molecules/Molecule.h"
 #include "Simulation.h"
 #include "utils/Logger.h"
@@ -10,6 +11,9 @@ using Log::global_log;
 
 VelocityScalingThermostat::VelocityScalingThermostat() : _globalBetaTrans(1), _globalBetaRot(1), _globalVelocity(NULL), _componentwise(false) {
 	_globalVelocity = new double[3];
+	for(int d = 0; d < 3; d++) {
+		_globalVelocity[d] = 0.0;
+	}
 }
 
 VelocityScalingThermostat::~VelocityScalingThermostat() {
@@ -38,46 +42,33 @@ void VelocityScalingThermostat::setVelocity(int componentId, double v[3]) {
 	}
 }
 
-void VelocityScalingThermostat::apply(ParticleContainer *moleculeContainer) {
-	Molecule *molecule;
+void VelocityScalingThermostat::prepare() {
+	const unsigned numComponents = _simulation.getEnsemble()->components()->size();
+	_componentScaling.resize(numComponents);
 	if(_componentwise ) {
-		for (molecule = moleculeContainer->begin(); molecule != moleculeContainer->end(); molecule = moleculeContainer->next()) {
-			int thermostatId;
-			double betaTrans = _globalBetaTrans;
-			double betaRot = _globalBetaRot;
-			int cid = molecule->componentid();
-			thermostatId = _simulation.getDomain()->getThermostat(cid);
-			betaTrans = _componentBetaTrans[thermostatId];
-			betaRot   = _componentBetaRot[thermostatId];
-
-			map<int, double*>::iterator vIter;
-			if( (vIter = _componentVelocity.find(thermostatId)) != _componentVelocity.end()) {
-				molecule->scale_v(betaTrans);
-			}
-			else {
-				double *v = vIter->second;
-				molecule->vsub(v[0], v[1], v[2]);
-				molecule->scale_v(betaTrans);
-				molecule->vadd(v[0], v[1], v[2]);
-			}
-			molecule->scale_D(betaRot);
+		for (unsigned cid = 0; cid < numComponents; cid++) {
+			int thermostatId = _simulation.getDomain()->getThermostat(cid);
+			_componentScaling[cid].betaTrans = _componentBetaTrans[thermostatId];
+			_componentScaling[cid].betaRot = _componentBetaRot[thermostatId];
+			// the componentwise thermostats scale the full velocity
+			_componentScaling[cid].velocity = NULL;
 		}
 	}
 	else {
-		double betaTrans = _globalBetaTrans;
-		double betaRot = _globalBetaRot;
-		global_log->debug() << "Beta rot: " << betaRot << endl;
-		global_log->debug() << "Beta trans: " << betaTrans << endl;
-		for (molecule = moleculeContainer->begin(); molecule != moleculeContainer->end(); molecule = moleculeContainer->next()) {
-			if(_globalVelocity == NULL) {
-				molecule->scale_v(betaTrans);
-			}
-			else {
-				molecule->vsub(_globalVelocity[0], _globalVelocity[1], _globalVelocity[2]);
-				molecule->scale_v(betaTrans);
-				molecule->vadd(_globalVelocity[0], _globalVelocity[1], _globalVelocity[2]);
-			}
-			molecule->scale_D(betaRot);
+		global_log->debug() << "Beta rot: " << _globalBetaRot << endl;
+		global_log->debug() << "Beta trans: " << _globalBetaTrans << endl;
+		for (unsigned cid = 0; cid < numComponents; cid++) {
+			_componentScaling[cid].betaTrans = _globalBetaTrans;
+			_componentScaling[cid].betaRot = _globalBetaRot;
+			_componentScaling[cid].velocity = _globalVelocity;
 		}
 	}
 }
+
+void VelocityScalingThermostat::apply(ParticleContainer *moleculeContainer) {
+	prepare();
+	Molecule *molecule;
+	for (molecule = moleculeContainer->begin(); molecule != moleculeContainer->end(); molecule = moleculeContainer->next()) {
+		apply(molecule);
+	}
+}
@@ -2,8 +2,10 @@
 #define VELOCITY_SCALING_THERMOSTAT_H
 
 #include "particleContainer/ParticleContainer.h"
+#include "molecules/Molecule.h"
 
 #include <map>
+#include <vector>
 
 
 class VelocityScalingThermostat {
@@ -26,7 +28,33 @@ public:
 	void setVelocity(int componentId, double v[3]);
 	void apply(ParticleContainer *moleculeContainer);
 
+	/** Look up the scaling factors of all components, has to be called before apply(Molecule*)
+	 * whenever the factors have changed. */
+	void prepare();
+
+	/** Scale velocity and angular momentum of a single molecule with the factors of its component. */
+	void apply(Molecule *molecule) {
+		const ComponentScaling& scaling = _componentScaling[molecule->componentid()];
+		if (scaling.velocity == NULL) {
+			molecule->scale_v(scaling.betaTrans);
+		}
+		else {
+			const double *v = scaling.velocity;
+			molecule->vsub(v[0], v[1], v[2]);
+			molecule->scale_v(scaling.betaTrans);
+			molecule->vadd(v[0], v[1], v[2]);
+		}
+		molecule->scale_D(scaling.betaRot);
+	}
+
 private:
+	struct ComponentScaling {
+		double betaTrans;
+		double betaRot;
+		//! directed velocity which is excluded from the scaling, NULL if there is none
+		const double *velocity;
+	};
+
 	double _globalBetaTrans;
 	double _globalBetaRot;
 	double *_globalVelocity;
@@ -35,6 +63,9 @@ private:
 	std::map<int, double> _componentBetaTrans;
 	std::map<int, double> _componentBetaRot;
 	std::map<int, double*> _componentVelocity;
+
+	//! scaling factors indexed by component id, see prepare()
+	std::vector<ComponentScaling> _componentScaling;
 };
 
 #endif /* VELOCITY_SCALING_THERMOSTAT_H */
@@ -0,0 +1,64 @@
+#include "utils/CounterRandom.h"
+
+static const uint32_t PHILOX_M0 = 0xD2511F53;
+static const uint32_t PHILOX_M1 = 0xCD9E8D57;
+static const uint32_t PHILOX_W0 = 0x9E3779B9;
+static const uint32_t PHILOX_W1 = 0xBB67AE85;
+
+CounterRandom::CounterRandom(uint64_t seed) {
+	init(seed);
+}
+
+void CounterRandom::init(uint64_t seed) {
+	_key[0] = (uint32_t) seed;
+	_key[1] = (uint32_t) (seed >> 32);
+	setStream(0, 0);
+}
+
+void CounterRandom::setStream(uint64_t index, uint32_t stream) {
+	_counter[0] = 0;
+	_counter[1] = stream;
+	_counter[2] = (uint32_t) index;
+	_counter[3] = (uint32_t) (index >> 32);
+	_used = 4;
+}
+
+void CounterRandom::philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t result[4]) {
+	uint32_t c[4] = { counter[0], counter[1], counter[2], counter[3] };
+	uint32_t k[2] = { key[0], key[1] };
+	for (int round = 0; round < 10; round++) {
+		uint64_t p0 = (uint64_t) PHILOX_M0 * c[0];
+		uint64_t p1 = (uint64_t) PHILOX_M1 * c[2];
+		uint32_t hi0 = (uint32_t) (p0 >> 32), lo0 = (uint32_t) p0;
+		uint32_t hi1 = (uint32_t) (p1 >> 32), lo1 = (uint32_t) p1;
+		c[0] = hi1 ^ c[1] ^ k[0];
+		c[1] = lo1;
+		c[2] = hi0 ^ c[3] ^ k[1];
+		c[3] = lo0;
+		k[0] += PHILOX_W0;
+		k[1] += PHILOX_W1;
+	}
+	for (int i = 0; i < 4; i++) {
+		result[i] = c[i];
+	}
+}
+
+uint32_t CounterRandom::rnd32() {
+	if (_used == 4) {
+		philox4x32(_counter, _key, _block);
+		_counter[0]++;
+		_used = 0;
+	}
+	return _block[_used++];
+}
+
+float CounterRandom::rnd() {
+	/* 24 bit mantissa, centered in the interval so 0 and 1 are never returned */
+	return ((rnd32() >> 8) + 0.5f) * (1.0f / 16777216.0f);
+}
+
+double CounterRandom::rndDouble() {
+	uint64_t hi = rnd32() >> 5; /* 27 bit */
+	uint64_t lo = rnd32() >> 6; /* 26 bit */
+	return ((hi << 26 | lo) + 0.5) * (1.0 / 9007199254740992.0);
+}
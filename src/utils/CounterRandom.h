@@ -0,0 +1,48 @@
+#ifndef COUNTERRANDOM_H
+#define COUNTERRANDOM_H
+
+#include <stdint.h>
+
+/** Counter-based uniform random number generator (Philox4x32-10).
+ *
+ * In contrast to Random, the numbers are not produced by advancing an internal
+ * state, but by a bijection of a 128 bit counter, keyed by a 64 bit seed
+ * (see Salmon et al.: Parallel random numbers: as easy as 1, 2, 3, SC 2011).
+ * Each (index, stream) pair selects an independent random stream, so e.g. the
+ * random numbers of a lattice site or a particle can be drawn on whichever
+ * process or thread handles it, without drawing the numbers of all others.
+ */
+class CounterRandom {
+public:
+	/** @param seed key of the generator */
+	CounterRandom(uint64_t seed = 8624);
+
+	void init(uint64_t seed);
+
+	/** Select the random stream and start at its beginning.
+	 * @param index  e.g. global index of a lattice site or trial
+	 * @param stream additional stream identifier, e.g. time step or purpose
+	 */
+	void setStream(uint64_t index, uint32_t stream = 0);
+
+	/** uniform random number in (0,1) */
+	float rnd();
+
+	/** uniform random number in (0,1) with double precision */
+	double rndDouble();
+
+	/** next 32 random bits of the stream */
+	uint32_t rnd32();
+
+	/** Philox4x32 bijection with 10 rounds */
+	static void philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t result[4]);
+
+private:
+	uint32_t _key[2];
+	/** [0]: block within the stream, [1]: stream, [2..3]: index */
+	uint32_t _counter[4];
+	uint32_t _block[4];
+	int _used; /**< number of values of _block already returned */
+};
+
+#endif /* COUNTERRANDOM_H */
@@ -0,0 +1,144 @@
+/** \file PerfCounters.cpp
+  * \brief Hardware performance counters via the Linux perf_event_open interface
+*/
+
+#include "PerfCounters.h"
+#include "Logger.h"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using Log::global_log;
+
+
+PerfCounters::PerfCounters() : _groupfd(-1), _openAttempted(false), _cyclesIndex(-1), _instructionsIndex(-1)
+{
+#ifdef __linux__
+	_cyclesIndex=_events.size();
+	addEvent("cycles",PERF_TYPE_HARDWARE,PERF_COUNT_HW_CPU_CYCLES,0.);
+	_instructionsIndex=_events.size();
+	addEvent("instructions",PERF_TYPE_HARDWARE,PERF_COUNT_HW_INSTRUCTIONS,0.);
+	addEvent("cachemisses",PERF_TYPE_HARDWARE,PERF_COUNT_HW_CACHE_MISSES,0.);
+	addEvent("branchmisses",PERF_TYPE_HARDWARE,PERF_COUNT_HW_BRANCH_MISSES,0.);
+	addEvent("taskclock",PERF_TYPE_SOFTWARE,PERF_COUNT_SW_TASK_CLOCK,0.);
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#ifdef __linux__
+	for(size_t i=0;i<_events.size();++i)
+		if(_events[i].fd>=0) close(_events[i].fd);
+#endif
+}
+
+void PerfCounters::addEvent(const string& label, unsigned int type, unsigned long long config, double flopsPerEvent)
+{
+	Event event;
+	event.label=label;
+	event.type=type;
+	event.config=config;
+	event.flopsPerEvent=flopsPerEvent;
+	event.fd=-1;
+	_events.push_back(event);
+}
+
+void PerfCounters::addRawEvent(const string& label, unsigned long long config, double flopsPerEvent)
+{
+	if(_openAttempted)
+	{
+		global_log->warning() << "PerfCounters: event " << label << " added after the counters have been started, ignored." << endl;
+		return;
+	}
+#ifdef __linux__
+	addEvent(label,PERF_TYPE_RAW,config,flopsPerEvent);
+#endif
+}
+
+bool PerfCounters::open()
+{
+	if(_openAttempted) return isOpen();
+	_openAttempted=true;
+#ifdef __linux__
+	int numavailable=0;
+	for(size_t i=0;i<_events.size();++i)
+	{
+		struct perf_event_attr attr;
+		memset(&attr,0,sizeof(attr));
+		attr.size=sizeof(attr);
+		attr.type=_events[i].type;
+		attr.config=_events[i].config;
+		attr.exclude_kernel=1;
+		attr.exclude_hv=1;
+		attr.read_format=PERF_FORMAT_GROUP|PERF_FORMAT_TOTAL_TIME_ENABLED|PERF_FORMAT_TOTAL_TIME_RUNNING;
+		// the group leader starts disabled and enables the whole group at once
+		attr.disabled=(_groupfd<0);
+		int fd=syscall(__NR_perf_event_open,&attr,0,-1,_groupfd,0);
+		if(fd<0)
+		{
+			global_log->warning() << "PerfCounters: event " << _events[i].label << " not available (" << strerror(errno) << ")" << endl;
+			_groupPosition.push_back(-1);
+			continue;
+		}
+		_events[i].fd=fd;
+		if(_groupfd<0) _groupfd=fd;
+		_groupPosition.push_back(numavailable++);
+	}
+	if(_groupfd<0) return false;
+	ioctl(_groupfd,PERF_EVENT_IOC_RESET,PERF_IOC_FLAG_GROUP);
+	ioctl(_groupfd,PERF_EVENT_IOC_ENABLE,PERF_IOC_FLAG_GROUP);
+	return true;
+#else
+	global_log->warning() << "PerfCounters: perf_event_open is only available on Linux." << endl;
+	return false;
+#endif
+}
+
+int PerfCounters::index(const string& label) const
+{
+	for(size_t i=0;i<_events.size();++i)
+		if(_events[i].label==label) return i;
+	return -1;
+}
+
+void PerfCounters::read(vector<double>& values) const
+{
+	values.assign(_events.size(),0.);
+#ifdef __linux__
+	if(_groupfd<0) return;
+	// layout for PERF_FORMAT_GROUP: nr, time_enabled, time_running, value[nr]
+	vector<unsigned long long> buffer(3+_events.size());
+	ssize_t numbytes=::read(_groupfd,&buffer[0],buffer.size()*sizeof(unsigned long long));
+	if(numbytes<(ssize_t)(3*sizeof(unsigned long long)) || buffer[2]==0) return;
+	double scale=(double)buffer[1]/(double)buffer[2];
+	for(size_t i=0;i<_events.size();++i)
+	{
+		int position=_groupPosition[i];
+		if(position>=0 && position<(int)buffer[0])
+			values[i]=scale*(double)buffer[3+position];
+	}
+#endif
+}
+
+double PerfCounters::flops(const vector<double>& values) const
+{
+	double result=0.;
+	for(size_t i=0;i<_events.size() && i<values.size();++i)
+		result+=_events[i].flopsPerEvent*values[i];
+	return result;
+}
+
+bool PerfCounters::countsFlops() const
+{
+	for(size_t i=0;i<_events.size();++i)
+		if(_events[i].flopsPerEvent>0. && available(i)) return true;
+	return false;
+}
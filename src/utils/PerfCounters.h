@@ -0,0 +1,91 @@
+/** \file PerfCounters.h
+  * \brief Hardware performance counters via the Linux perf_event_open interface
+*/
+
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <string>
+#include <vector>
+
+/** @brief Counts hardware events of the calling thread with perf_event_open(2).
+ *
+ * The generic events cycles, instructions, cache misses and branch misses and
+ * the task clock are always requested; processor specific events (e.g. the
+ * floating point operations, which have no generic perf event) can be added
+ * as raw event codes before open() is called. All events are opened as one
+ * group, so they are scheduled together and can be read with a single system
+ * call. If the counters are multiplexed by the kernel, the values are scaled
+ * to the total time the group has been enabled.
+ *
+ * Events which are not supported by the processor or the kernel (or not
+ * permitted by /proc/sys/kernel/perf_event_paranoid) are dropped with a
+ * warning; available() tells which ones are counted. On other systems than
+ * Linux no event is available.
+ */
+class PerfCounters {
+public:
+	PerfCounters();
+	~PerfCounters();
+
+	/** add a processor specific event (PERF_TYPE_RAW) before calling open()
+	 * @param label          name of the event
+	 * @param config         raw event code, e.g. 0x10c7 for FP_ARITH_INST_RETIRED.256B_PACKED_DOUBLE on Intel processors
+	 * @param flopsPerEvent  number of floating point operations per event, 0 if the event does not count floating point operations
+	 */
+	void addRawEvent(const std::string& label, unsigned long long config, double flopsPerEvent = 0.0);
+
+	/** open and start all events; only the first call has an effect
+	 * @return true if at least one event is counted
+	 */
+	bool open();
+
+	bool isOpen() const { return _groupfd >= 0; }
+
+	unsigned int numEvents() const { return _events.size(); }
+	const std::string& label(unsigned int index) const { return _events[index].label; }
+	bool available(unsigned int index) const { return _events[index].fd >= 0; }
+	/** index of the event with the given label, -1 if there is none */
+	int index(const std::string& label) const;
+
+	/** read the number of events counted since open(); unavailable events are 0 */
+	void read(std::vector<double>& values) const;
+
+	/** @name derived quantities of values returned by read() */
+	//@{
+	double cycles(const std::vector<double>& values) const { return value(values, _cyclesIndex); }
+	double instructions(const std::vector<double>& values) const { return value(values, _instructionsIndex); }
+	/** weighted sum of all events counting floating point operations */
+	double flops(const std::vector<double>& values) const;
+	/** true if any of the available events counts floating point operations */
+	bool countsFlops() const;
+	//@}
+
+private:
+	PerfCounters(const PerfCounters&);
+	PerfCounters& operator=(const PerfCounters&);
+
+	struct Event {
+		std::string label;
+		unsigned int type;
+		unsigned long long config;
+		double flopsPerEvent;
+		int fd;
+	};
+
+	void addEvent(const std::string& label, unsigned int type, unsigned long long config, double flopsPerEvent);
+
+	double value(const std::vector<double>& values, int index) const {
+		return (index >= 0 && index < (int) values.size()) ? values[index] : 0.0;
+	}
+
+	std::vector<Event> _events;
+	/** position of each available event in the group read buffer */
+	std::vector<int> _groupPosition;
+	int _groupfd;
+	bool _openAttempted;
+	int _cyclesIndex;
+	int _instructionsIndex;
+};
+
+#endif
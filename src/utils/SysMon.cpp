@@ -73,6 +73,7 @@ void SysMon::updateExpressionValues(bool resetMinMax)
 	if(_variableset->existVariableGroup("procselfstatm")) updateVariables_procselfstatm();
 	if(_variableset->existVariableGroup("procselfschedstat")) updateVariables_procselfschedstat();
 	if(_variableset->existVariableGroup("procselfsched")) updateVariables_procselfsched();
+	if(_variableset->existVariableGroup("perfevent")) updateVariables_perfevent();
 	
 	size_t i=0;
 	for(std::list<Expression>::const_iterator exprit=_expressions.begin();exprit!=_expressions.end();++exprit)
@@ -453,3 +454,31 @@ unsigned int SysMon::updateVariables_procselfschedstat()
 	return numvalues;
 }
 
+const PerfCounters* SysMon::getPerfCounters()
+{
+	if(_perfcounters==NULL && _variableset->existVariableGroup("perfevent")) perfCounters();
+	return (_perfcounters!=NULL && _perfcounters->open()) ? _perfcounters : NULL;
+}
+
+unsigned int SysMon::updateVariables_perfevent()
+{
+	unsigned int numvalues=0;
+#ifdef SYSMON_ENABLE_PERFEVENT
+	PerfCounters* counters=perfCounters();
+	if(!counters->open()) return 0;
+	vector<double> values;
+	counters->read(values);
+	for(unsigned int i=0;i<counters->numEvents();++i)
+	{
+		if(!counters->available(i)) continue;
+		_variableset->setVariable("perfevent",counters->label(i),values[i]);
+		++numvalues;
+	}
+	if(counters->countsFlops())
+	{
+		_variableset->setVariable("perfevent","flops",counters->flops(values));
+		++numvalues;
+	}
+#endif
+	return numvalues;
+}
@@ -17,6 +17,9 @@
 #define SYSMON_ENABLE_PROCSELFSTATM
 #define SYSMON_ENABLE_PROCSELFSCHED
 //#define SYSMON_ENABLE_PROCSELFSCHEDSTAT
+#ifdef __linux__
+#define SYSMON_ENABLE_PERFEVENT
+#endif
 
 #include <string>
 #include <vector>
@@ -47,6 +50,7 @@
 
 
 #include "Expression.h"
+#include "PerfCounters.h"
 
 // SysMon ------------------------------------------------------------------------------------------
 class SysMon{
@@ -61,11 +65,11 @@ private:	// Singleton
 	static SysMon* s_sysmoninstance;
 	SysMon(const SysMon&);
 #ifdef MPI_VERSION
-	SysMon(MPI_Comm mpicomm=MPI_COMM_WORLD) : _mpicomm(mpicomm) { _variableset=new Expression::VariableSet(); }
+	SysMon(MPI_Comm mpicomm=MPI_COMM_WORLD) : _perfcounters(NULL), _mpicomm(mpicomm) { _variableset=new Expression::VariableSet(); }
 #else
-	SysMon() { _variableset=new Expression::VariableSet(); }
+	SysMon() : _perfcounters(NULL) { _variableset=new Expression::VariableSet(); }
 #endif
-	~SysMon() { clear(); delete(_variableset); s_sysmoninstance=NULL; }
+	~SysMon() { clear(); delete(_variableset); delete(_perfcounters); s_sysmoninstance=NULL; }
 	
 public:
 	static SysMon* getSysMon()
@@ -107,7 +111,19 @@ public:
 	}
 	operator std::string() const { return InfoString(); }
 	
+	// hardware performance counters, provided as variables "perfevent:<label>"
+	// (e.g. perfevent:instructions/perfevent:cycles) and "perfevent:flops"
+	void addPerfEvent(const std::string& label, unsigned long long config, double flopsPerEvent=0.)
+		{ perfCounters()->addRawEvent(label,config,flopsPerEvent); }
+	// started performance counters, NULL if they have neither been used in an
+	// expression nor been added with addPerfEvent, or if none could be opened.
+	// The counters of the expressions are created here if no values have been updated yet.
+	const PerfCounters* getPerfCounters();
+	
 private:
+	PerfCounters* perfCounters()
+		{ if(_perfcounters==NULL) _perfcounters=new PerfCounters(); return _perfcounters; }
+	
 	Expression::VariableSet* _variableset;
 	std::list<Expression> _expressions;
 	std::vector<Tvalue> _values;
@@ -115,6 +131,7 @@ private:
 	// *valuesMaxMin* stores for each value (i) the
 	//  maximum (2*i) and negative minimum (=maximum of negative value) (2*i+1)
 	std::vector<Tvalue> _valuesMaxMinPeak;
+	PerfCounters* _perfcounters;
 #ifdef MPI_VERSION
 	std::vector<Tvalue> _valuesMaxMin;
 	MPI_Comm _mpicomm;
@@ -130,6 +147,7 @@ private:
 	unsigned int updateVariables_procselfstatm();
 	unsigned int updateVariables_procselfschedstat();
 	unsigned int updateVariables_procselfsched();
+	unsigned int updateVariables_perfevent();
 };
 // ------------------------------------------------------------------------------------------ SysMon
 
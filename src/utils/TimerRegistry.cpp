@@ -0,0 +1,322 @@
+#include "utils/TimerRegistry.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+#ifdef ENABLE_MPI
+#include <mpi.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "parallel/DomainDecompBase.h"
+#include "utils/Logger.h"
+#include "utils/PerfCounters.h"
+
+using namespace std;
+using Log::global_log;
+
+
+TimerRegistry::TimerRegistry() : _numProcs(1), _perfCounters(NULL) {
+}
+
+void TimerRegistry::setPerfCounters(const PerfCounters* counters) {
+	if (!_running.empty()) {
+		global_log->error() << "TimerRegistry: performance counters attached while region '" << path(_running.back())
+				<< "' is running" << endl;
+		exit(1);
+	}
+	_perfCounters = counters;
+}
+
+void TimerRegistry::readPerfCounters(double& cycles, double& instructions, double& flops) {
+	_perfCounters->read(_counterValues);
+	cycles = _perfCounters->cycles(_counterValues);
+	instructions = _perfCounters->instructions(_counterValues);
+	flops = _perfCounters->flops(_counterValues);
+}
+
+double TimerRegistry::wallTime() {
+#ifdef ENABLE_MPI
+	return MPI_Wtime();
+#else
+	struct timeval tmp_time;
+	gettimeofday(&tmp_time, NULL);
+	return (double) tmp_time.tv_sec + 1.0e-6 * (double) tmp_time.tv_usec;
+#endif
+}
+
+int TimerRegistry::child(const string& name) {
+	const vector<int>& siblings = _running.empty() ? _topLevel : _regions[_running.back()].children;
+	for (size_t i = 0; i < siblings.size(); i++) {
+		if (_regions[siblings[i]].name == name) {
+			return siblings[i];
+		}
+	}
+
+	Region region;
+	region.name = name;
+	region.parent = _running.empty() ? -1 : _running.back();
+	region.time = 0.0;
+	region.startTime = 0.0;
+	region.calls = 0;
+	region.cycles = region.instructions = region.flops = 0.0;
+	region.startCycles = region.startInstructions = region.startFlops = 0.0;
+	int index = _regions.size();
+	_regions.push_back(region);
+	if (region.parent < 0) {
+		_topLevel.push_back(index);
+	} else {
+		_regions[region.parent].children.push_back(index);
+	}
+	return index;
+}
+
+void TimerRegistry::start(const string& name) {
+	int region = child(name);
+	_regions[region].calls++;
+	_running.push_back(region);
+	if (_perfCounters != NULL) {
+		Region& r = _regions[region];
+		readPerfCounters(r.startCycles, r.startInstructions, r.startFlops);
+	}
+	_regions[region].startTime = wallTime();
+}
+
+void TimerRegistry::stop(const string& name) {
+	double now = wallTime();
+	if (_running.empty() || _regions[_running.back()].name != name) {
+		global_log->error() << "TimerRegistry: cannot stop region '" << name << "', the innermost running region is '"
+				<< (_running.empty() ? string("") : path(_running.back())) << "'" << endl;
+		exit(1);
+	}
+	Region& region = _regions[_running.back()];
+	region.time += now - region.startTime;
+	if (_perfCounters != NULL) {
+		double cycles, instructions, flops;
+		readPerfCounters(cycles, instructions, flops);
+		region.cycles += cycles - region.startCycles;
+		region.instructions += instructions - region.startInstructions;
+		region.flops += flops - region.startFlops;
+	}
+	_running.pop_back();
+}
+
+void TimerRegistry::addTime(const string& name, double seconds) {
+	int region = child(name);
+	_regions[region].time += seconds;
+	_regions[region].calls++;
+}
+
+void TimerRegistry::reset() {
+	double now = wallTime();
+	for (size_t i = 0; i < _regions.size(); i++) {
+		_regions[i].time = 0.0;
+		_regions[i].calls = 0;
+		_regions[i].cycles = _regions[i].instructions = _regions[i].flops = 0.0;
+	}
+	for (size_t i = 0; i < _running.size(); i++) {
+		Region& region = _regions[_running[i]];
+		region.startTime = now;
+		if (_perfCounters != NULL) {
+			readPerfCounters(region.startCycles, region.startInstructions, region.startFlops);
+		}
+	}
+}
+
+string TimerRegistry::path(int region) const {
+	string result = _regions[region].name;
+	for (int parent = _regions[region].parent; parent >= 0; parent = _regions[parent].parent) {
+		result = _regions[parent].name + "/" + result;
+	}
+	return result;
+}
+
+int TimerRegistry::depth(int region) const {
+	int result = 0;
+	for (int parent = _regions[region].parent; parent >= 0; parent = _regions[parent].parent) {
+		result++;
+	}
+	return result;
+}
+
+int TimerRegistry::find(const string& regionPath) const {
+	for (int i = 0; i < numRegions(); i++) {
+		if (path(i) == regionPath) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+double TimerRegistry::elapsed(int region) const {
+	double result = _regions[region].time;
+	if (std::find(_running.begin(), _running.end(), region) != _running.end()) {
+		result += wallTime() - _regions[region].startTime;
+	}
+	return result;
+}
+
+double TimerRegistry::time(const string& regionPath) const {
+	int region = find(regionPath);
+	return (region < 0) ? -1.0 : elapsed(region);
+}
+
+unsigned long TimerRegistry::calls(const string& regionPath) const {
+	int region = find(regionPath);
+	return (region < 0) ? 0 : _regions[region].calls;
+}
+
+double TimerRegistry::imbalance(int region) const {
+	return (_avg[region] > 0.0) ? _max[region] / _avg[region] : 1.0;
+}
+
+double TimerRegistry::ipc(int region) const {
+	return (_sumCycles[region] > 0.0) ? _sumInstructions[region] / _sumCycles[region] : 0.0;
+}
+
+double TimerRegistry::gflops(int region) const {
+	return (_avg[region] > 0.0) ? 1e-9 * _sumFlops[region] / _avg[region] : 0.0;
+}
+
+bool TimerRegistry::collectStatistics(DomainDecompBase* domainDecomp, int root) {
+	const int n = numRegions();
+	_numProcs = domainDecomp->getNumProcs();
+	_min.resize(n);
+	_avg.resize(n);
+	_max.resize(n);
+	_avgCalls.resize(n);
+	_sumCycles.resize(n);
+	_sumInstructions.resize(n);
+	_sumFlops.resize(n);
+
+	// checksum of the region paths, small enough to be represented exactly by a double
+	unsigned long long checksum = 0;
+	for (int i = 0; i < n; i++) {
+		string p = path(i);
+		for (size_t c = 0; c < p.size(); c++) {
+			checksum = (31 * checksum + (unsigned char) p[c]) % (1ULL << 48);
+		}
+	}
+
+	// minima are determined as maxima of the negative values, so a single
+	// reduction yields the time bounds and the consistency check
+	vector<double> bounds(2 * n + 4);
+	for (int i = 0; i < n; i++) {
+		double t = elapsed(i);
+		bounds[i] = t;
+		bounds[n + i] = -t;
+	}
+	bounds[2 * n] = n;
+	bounds[2 * n + 1] = -n;
+	bounds[2 * n + 2] = (double) checksum;
+	bounds[2 * n + 3] = -(double) checksum;
+	vector<double> localTimes(bounds.begin(), bounds.begin() + n);
+	domainDecomp->reduceArrayMax(&bounds[0], &bounds[0], bounds.size(), root);
+
+	int consistent = (bounds[2 * n] == -bounds[2 * n + 1]) && (bounds[2 * n + 2] == -bounds[2 * n + 3]);
+	domainDecomp->collCommInit(1);
+	domainDecomp->collCommAppendInt(consistent);
+	domainDecomp->collCommBroadcast(root);
+	consistent = domainDecomp->collCommGetInt();
+	domainDecomp->collCommFinalize();
+
+	if (!consistent) {
+		global_log->warning() << "TimerRegistry: processes have different timing regions, reporting local times only." << endl;
+		for (int i = 0; i < n; i++) {
+			_min[i] = _avg[i] = _max[i] = localTimes[i];
+			_avgCalls[i] = _regions[i].calls;
+			_sumCycles[i] = _regions[i].cycles;
+			_sumInstructions[i] = _regions[i].instructions;
+			_sumFlops[i] = _regions[i].flops;
+		}
+		_numProcs = 1;
+		return false;
+	}
+
+	vector<double> sums(5 * n);
+	for (int i = 0; i < n; i++) {
+		sums[i] = localTimes[i];
+		sums[n + i] = _regions[i].calls;
+		sums[2 * n + i] = _regions[i].cycles;
+		sums[3 * n + i] = _regions[i].instructions;
+		sums[4 * n + i] = _regions[i].flops;
+	}
+	if (n > 0) {
+		domainDecomp->reduceArraySum(&sums[0], &sums[0], sums.size(), root);
+	}
+	for (int i = 0; i < n; i++) {
+		_max[i] = bounds[i];
+		_min[i] = -bounds[n + i];
+		_avg[i] = sums[i] / _numProcs;
+		_avgCalls[i] = sums[n + i] / _numProcs;
+		_sumCycles[i] = sums[2 * n + i];
+		_sumInstructions[i] = sums[3 * n + i];
+		_sumFlops[i] = sums[4 * n + i];
+	}
+	return true;
+}
+
+void TimerRegistry::printRegion(ostream& out, int region, size_t nameWidth, bool withIpc, bool withFlops) const {
+	int indent = 2 * depth(region);
+	out << "\t" << string(indent, ' ') << left << setw(nameWidth - indent) << _regions[region].name << right
+			<< setw(14) << _min[region] << setw(14) << _avg[region] << setw(14) << _max[region]
+			<< setw(11) << imbalance(region) << setw(12) << _avgCalls[region];
+	if (withIpc) {
+		out << setw(9) << ipc(region);
+	}
+	if (withFlops) {
+		out << setw(11) << gflops(region);
+	}
+	out << endl;
+	for (size_t i = 0; i < _regions[region].children.size(); i++) {
+		printRegion(out, _regions[region].children[i], nameWidth, withIpc, withFlops);
+	}
+}
+
+void TimerRegistry::printStatistics(DomainDecompBase* domainDecomp) {
+	collectStatistics(domainDecomp);
+	if (domainDecomp->getRank() != 0) {
+		return;
+	}
+
+	size_t nameWidth = 6;
+	for (int i = 0; i < numRegions(); i++) {
+		nameWidth = max(nameWidth, 2 * depth(i) + _regions[i].name.size());
+	}
+	nameWidth += 2;
+
+	// the hardware event columns are only shown if the events have been counted
+	bool withIpc = false;
+	bool withFlops = false;
+	for (int i = 0; i < numRegions(); i++) {
+		withIpc = withIpc || (_sumCycles[i] > 0.0);
+		withFlops = withFlops || (_sumFlops[i] > 0.0);
+	}
+
+	ostringstream out;
+	out << "Timing statistics over " << _numProcs << " processes (times in s, imbalance = max/avg):" << endl;
+	out << "\t" << left << setw(nameWidth) << "region" << right << setw(14) << "min" << setw(14) << "avg"
+			<< setw(14) << "max" << setw(11) << "imbalance" << setw(12) << "calls";
+	if (withIpc) {
+		out << setw(9) << "IPC";
+	}
+	if (withFlops) {
+		out << setw(11) << "GFLOP/s";
+	}
+	out << endl;
+	out << fixed << setprecision(4);
+	for (size_t i = 0; i < _topLevel.size(); i++) {
+		printRegion(out, _topLevel[i], nameWidth, withIpc, withFlops);
+	}
+	global_log->info() << out.str();
+}
+
+void TimerRegistry::writeStatistics(ostream& out, unsigned long simstep) const {
+	for (int i = 0; i < numRegions(); i++) {
+		out << simstep << "\t" << path(i) << "\t" << _avgCalls[i] << "\t" << _min[i] << "\t" << _avg[i] << "\t"
+				<< _max[i] << "\t" << imbalance(i) << "\t" << ipc(i) << "\t" << gflops(i) << endl;
+	}
+}
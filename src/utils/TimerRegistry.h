@@ -0,0 +1,142 @@
+#ifndef TIMERREGISTRY_H_
+#define TIMERREGISTRY_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+class DomainDecompBase;
+class PerfCounters;
+
+/** @brief Collects the wall clock time spent in named, nested regions of the code.
+ *
+ * A region is entered with start() and left with stop(). Regions started
+ * while another one is running become its children, so the same name may
+ * appear in different places of the hierarchy (e.g. "loop/output/profile").
+ * The path of a region consists of the names of all enclosing regions
+ * separated by '/'.
+ *
+ * In contrast to Timer, starting and stopping a region never synchronises
+ * the processes, so the times show the load imbalance between the processes
+ * instead of hiding it in the next barrier. collectStatistics() determines
+ * minimum, average and maximum of each region over all processes; it is a
+ * collective operation and requires all processes to have registered the
+ * same regions in the same order.
+ *
+ * If hardware performance counters are attached with setPerfCounters(),
+ * the cycles, instructions and floating point operations of the calling
+ * process are recorded for every region entered with start(), which yields
+ * the instructions per cycle and the achieved GFLOP/s of each region.
+ */
+class TimerRegistry {
+public:
+	TimerRegistry();
+
+	/** enter the region name within the innermost running region */
+	void start(const std::string& name);
+
+	/** leave the innermost running region, which has to be name */
+	void stop(const std::string& name);
+
+	/** add time which has been measured elsewhere (e.g. accumulated in a
+	 * loop) to the region name within the innermost running region */
+	void addTime(const std::string& name, double seconds);
+
+	/** set all times and counts to zero, the regions are kept */
+	void reset();
+
+	/** record the hardware events of all regions started from now on.
+	 * Must not be called while a region is running. */
+	void setPerfCounters(const PerfCounters* counters);
+
+	int numRegions() const { return _regions.size(); }
+
+	/** path of the region, e.g. "loop/decomposition/halo_exchange" */
+	std::string path(int region) const;
+
+	/** nesting depth of the region, 0 for top level regions */
+	int depth(int region) const;
+
+	/** local time spent in the region so far (including the current call
+	 * if the region is running), -1 if there is no such region */
+	double time(const std::string& path) const;
+
+	/** number of times the region has been entered, 0 if there is no such region */
+	unsigned long calls(const std::string& path) const;
+
+	/** reduce the times of all processes. The results are only valid on the root process.
+	 * @return false if the processes do not know the same regions; in this case
+	 *         the local times are used as minimum, average and maximum
+	 */
+	bool collectStatistics(DomainDecompBase* domainDecomp, int root = 0);
+
+	/** @name results of the last collectStatistics() */
+	//@{
+	double minTime(int region) const { return _min[region]; }
+	double avgTime(int region) const { return _avg[region]; }
+	double maxTime(int region) const { return _max[region]; }
+	/** ratio of the maximum and the average time, 1 for perfect balance */
+	double imbalance(int region) const;
+	double avgCalls(int region) const { return _avgCalls[region]; }
+	/** instructions per cycle, 0 if not measured */
+	double ipc(int region) const;
+	/** floating point operations per second of all processes together in units of 1e9, 0 if not measured */
+	double gflops(int region) const;
+	//@}
+
+	/** collect the statistics and log them as a tree on the root process */
+	void printStatistics(DomainDecompBase* domainDecomp);
+
+	/** write the results of the last collectStatistics() with one line per region:
+	 * simstep, path, average number of calls, min, avg, max time, imbalance, IPC and GFLOP/s */
+	void writeStatistics(std::ostream& out, unsigned long simstep) const;
+
+	/** current wall clock time in seconds */
+	static double wallTime();
+
+private:
+	struct Region {
+		std::string name;
+		int parent;
+		std::vector<int> children;
+		double time;
+		double startTime;
+		unsigned long calls;
+		// hardware events, accumulated and at the last start()
+		double cycles, instructions, flops;
+		double startCycles, startInstructions, startFlops;
+	};
+
+	/** read the hardware events into cycles, instructions and flops */
+	void readPerfCounters(double& cycles, double& instructions, double& flops);
+
+	/** find the child name of the innermost running region, create it if necessary */
+	int child(const std::string& name);
+
+	int find(const std::string& path) const;
+
+	double elapsed(int region) const;
+
+	/** printStatistics() for region and all its descendants */
+	void printRegion(std::ostream& out, int region, size_t nameWidth, bool withIpc, bool withFlops) const;
+
+	std::vector<Region> _regions;
+	std::vector<int> _topLevel;
+
+	/** running regions, the innermost one last */
+	std::vector<int> _running;
+
+	std::vector<double> _min;
+	std::vector<double> _avg;
+	std::vector<double> _max;
+	std::vector<double> _avgCalls;
+	std::vector<double> _sumCycles;
+	std::vector<double> _sumInstructions;
+	std::vector<double> _sumFlops;
+	int _numProcs;
+
+	const PerfCounters* _perfCounters;
+	std::vector<double> _counterValues;
+};
+
+#endif /* TIMERREGISTRY_H_ */
@@ -20,6 +20,32 @@ void Generator::init(Lattice& lattice, Basis& basis, double origin[3]) {
 		_origin[d] = origin[d];
 	}
 	_baseCount = 0;
+	_moleculeIndex = -1;
+}
+
+void Generator::setBoundingBox(double bBoxMin[3], double bBoxMax[3]) {
+	/* enlarge the box by the extent of the basis */
+	double boxMin[3], boxMax[3];
+	for(int d = 0; d < 3; d++) {
+		double basisMin = 0.0, basisMax = 0.0;
+		for(int i = 0; i < _basis.numMolecules(); i++) {
+			double r = _basis.getMolecule(i).r[d];
+			if(r < basisMin) basisMin = r;
+			if(r > basisMax) basisMax = r;
+		}
+		boxMin[d] = bBoxMin[d] - _origin[d] - basisMax;
+		boxMax[d] = bBoxMax[d] - _origin[d] - basisMin;
+	}
+	_lattice.restrictToBox(boxMin, boxMax);
+	_baseCount = 0;
+}
+
+long Generator::moleculeIndex() {
+	return _moleculeIndex;
+}
+
+long Generator::numMolecules() {
+	return _lattice.numPoints() * _basis.numMolecules();
 }
 
 int Generator::getMolecule(molecule_t* molecule) {
@@ -36,6 +62,7 @@ int Generator::getMolecule(molecule_t* molecule) {
 		molecule->r[d] = _origin[d] + _lattice_point[d] + molecule_base.r[d];
 	}
 	molecule->cid = molecule_base.cid;
+	_moleculeIndex = _lattice.pointIndex() * _basis.numMolecules() + _baseCount;
 
 	_baseCount = (_baseCount + 1) % _basis.numMolecules();
 
@@ -57,3 +84,15 @@ void generator_init(generator_t* generator, lattice_t* lattice, basis_t* basis,
 int generator_getMolecule(generator_t* generator, molecule_t* molecule) {
     return generator->getMolecule(molecule);
 }
+
+void generator_setBoundingBox(generator_t* generator, double bBoxMin[3], double bBoxMax[3]) {
+    generator->setBoundingBox(bBoxMin, bBoxMax);
+}
+
+long generator_moleculeIndex(generator_t* generator) {
+    return generator->moleculeIndex();
+}
+
+long generator_numMolecules(generator_t* generator) {
+    return generator->numMolecules();
+}
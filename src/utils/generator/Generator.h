@@ -27,6 +27,9 @@ generator_t* generator_create();
 void generator_destroy(generator_t* generator);
 void generator_init(generator_t* generator, lattice_t* lattice, basis_t* basis, double origin[3]);
 int generator_getMolecule(generator_t* generator, molecule_t *molecule);
+void generator_setBoundingBox(generator_t* generator, double bBoxMin[3], double bBoxMax[3]);
+long generator_moleculeIndex(generator_t* generator);
+long generator_numMolecules(generator_t* generator);
 
 #ifdef __cplusplus
 }
@@ -55,6 +58,22 @@ public:
 	 */
     int getMolecule(molecule_t *molecule);
 
+	/** Restrict the molecules returned by getMolecule to the lattice cells
+	 * which may contain molecules inside the given box, e.g. the bounding box
+	 * of a process. Molecules close to the box may still be returned.
+	 * @param[in]  bBoxMin  lower corner of the box
+	 * @param[in]  bBoxMax  upper corner of the box
+	 */
+	void setBoundingBox(double bBoxMin[3], double bBoxMax[3]);
+
+	/** Global index of the molecule returned by the last call to getMolecule.
+	 * The index does not depend on the bounding box, so it can be used as id.
+	 */
+	long moleculeIndex();
+
+	/** Total number of molecules of the lattice */
+	long numMolecules();
+
 private:
     Lattice _lattice;
     Basis _basis;
@@ -62,6 +81,7 @@ private:
 
 	/* Internal values/counters used during the creation by getMolecule */
 	long _baseCount;
+	long _moleculeIndex;
 	double _lattice_point[3];
 };
 
@@ -10,6 +10,7 @@
 
 #include "Lattice.h"
 
+#include <cmath>
 #include <iostream>
 using namespace std;
 
@@ -75,23 +76,93 @@ void Lattice::init(LatticeSystem system, LatticeCentering centering, double a[3]
 		_b[d] = b[d];
 		_c[d] = c[d];
 		_dims[d] = dims[d];
+		_start[d] = 0;
+		_end[d] = dims[d];
 		_pos[d] = 0;
 	}
 	_centeringCounter = 0;
 }
 
+void Lattice::setRange(long start[3], long end[3]) {
+	for(int d = 0; d < 3; d++) {
+		_start[d] = (start[d] < 0) ? 0 : start[d];
+		_end[d] = (end[d] > _dims[d]) ? _dims[d] : end[d];
+		_pos[d] = _start[d];
+	}
+	_centeringCounter = 0;
+}
+
+void Lattice::restrictToBox(double boxMin[3], double boxMax[3]) {
+	/* inverse of the matrix with the lattice vectors as columns */
+	double m[3][3] = {
+		{ _a[0], _b[0], _c[0] },
+		{ _a[1], _b[1], _c[1] },
+		{ _a[2], _b[2], _c[2] }
+	};
+	double det = m[0][0] * (m[1][1]*m[2][2] - m[1][2]*m[2][1])
+	           - m[0][1] * (m[1][0]*m[2][2] - m[1][2]*m[2][0])
+	           + m[0][2] * (m[1][0]*m[2][1] - m[1][1]*m[2][0]);
+	if(det == 0.0) {
+		return;
+	}
+	double inv[3][3];
+	for(int i = 0; i < 3; i++) {
+		for(int j = 0; j < 3; j++) {
+			/* cofactor of m[j][i] */
+			int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+			int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+			inv[i][j] = (m[j1][i1]*m[j2][i2] - m[j1][i2]*m[j2][i1]) / det;
+		}
+	}
+
+	/* map all box corners into lattice coordinates */
+	double lmin[3], lmax[3];
+	for(int corner = 0; corner < 8; corner++) {
+		double r[3];
+		for(int d = 0; d < 3; d++) {
+			r[d] = (corner & (1 << d)) ? boxMax[d] : boxMin[d];
+		}
+		for(int i = 0; i < 3; i++) {
+			double l = inv[i][0]*r[0] + inv[i][1]*r[1] + inv[i][2]*r[2];
+			if(corner == 0 || l < lmin[i]) lmin[i] = l;
+			if(corner == 0 || l > lmax[i]) lmax[i] = l;
+		}
+	}
+	/* the centering points lie within one cell, so extend the range by one cell */
+	long start[3], end[3];
+	for(int i = 0; i < 3; i++) {
+		start[i] = (long) floor(lmin[i]) - 1;
+		end[i] = (long) ceil(lmax[i]) + 1;
+	}
+	setRange(start, end);
+}
+
+long Lattice::pointIndex() {
+	return ((_pos[2] * _dims[1] + _pos[1]) * _dims[0] + _pos[0]) * LatticeCenteringNums[_centering] + _centeringCounter - 1;
+}
+
+long Lattice::numPoints() {
+	return _dims[0] * _dims[1] * _dims[2] * LatticeCenteringNums[_centering];
+}
+
 int Lattice::getPoint(double* r) {
 
+	for(int d = 0; d < 3; d++) {
+		if(_pos[d] >= _end[d]) {
+			return 0;
+		}
+	}
+
 	if(_centeringCounter >= LatticeCenteringNums[_centering]) {
 		_centeringCounter = 0;
 		_pos[0]++;
-		if(_pos[0] >= _dims[0]) {
-			_pos[0] = 0;
+		if(_pos[0] >= _end[0]) {
+			_pos[0] = _start[0];
 			_pos[1]++;
-			if(_pos[1] >= _dims[1]) {
-				_pos[1] = 0;
+			if(_pos[1] >= _end[1]) {
+				_pos[1] = _start[1];
 				_pos[2]++;
-				if(_pos[2] >= _dims[2]) {
+				if(_pos[2] >= _end[2]) {
 					return 0;
 				}
 			}
@@ -197,6 +268,22 @@ int lattice_getPoint(lattice_t* lattice, double r[3]) {
     return lattice->getPoint(r);
 }
 
+void lattice_setRange(lattice_t* lattice, long start[3], long end[3]) {
+    lattice->setRange(start, end);
+}
+
+void lattice_restrictToBox(lattice_t* lattice, double boxMin[3], double boxMax[3]) {
+    lattice->restrictToBox(boxMin, boxMax);
+}
+
+long lattice_pointIndex(lattice_t* lattice) {
+    return lattice->pointIndex();
+}
+
+long lattice_numPoints(lattice_t* lattice) {
+    return lattice->numPoints();
+}
+
 int lattice_checkValidits(lattice_t *lattice) {
     return lattice->checkValidity();
 }
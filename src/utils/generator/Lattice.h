@@ -48,6 +48,10 @@ lattice_t* lattice_create();
 void lattice_destroy(lattice_t* lattice);
 void lattice_init(lattice_t* lattice, LatticeSystem system, LatticeCentering centering, double a[3], double b[3], double c[3], long dims[3]);
 int lattice_getPoint(lattice_t* lattice, double* r);
+void lattice_setRange(lattice_t* lattice, long start[3], long end[3]);
+void lattice_restrictToBox(lattice_t* lattice, double boxMin[3], double boxMax[3]);
+long lattice_pointIndex(lattice_t* lattice);
+long lattice_numPoints(lattice_t* lattice);
 int lattice_checkValidity(lattice_t* lattice);
 const char* lattice_systemName(lattice_t* lattice);
 const char* lattice_centeringName(lattice_t* lattice);
@@ -85,6 +89,27 @@ public:
 	 */
 	int getPoint(double* r);
 
+	/** Restrict the points returned by getPoint to the lattice cells with
+	 * start[d] <= cell[d] < end[d] and restart the point output.
+	 * @param[in]  start  first lattice cell in multiples of a, b and c
+	 * @param[in]  end    end of the range (exclusive)
+	 */
+	void setRange(long start[3], long end[3]);
+
+	/** Restrict the points returned by getPoint to the lattice cells which
+	 * may contain points inside the given box (box relative to the lattice origin).
+	 * Points of the returned cells may still lie outside of the box.
+	 */
+	void restrictToBox(double boxMin[3], double boxMax[3]);
+
+	/** Global index of the point returned by the last call to getPoint.
+	 * The index does not depend on the range set with setRange.
+	 */
+	long pointIndex();
+
+	/** Total number of points in the lattice */
+	long numPoints();
+
 	/** Check if lattice specifications represent a valid Bravais lattice
 	 * @return 1 if valid Bravais lattice, 0 otherwise
 	 */
@@ -107,6 +132,8 @@ private:
 	long _dims[3];
 
 	/* internal counter for current point output */
+	long _start[3]; /* First lattice cell of the output range */
+	long _end[3]; /* End of the output range */
 	long _pos[3]; /* Current lattice cell */
 	int _centeringCounter; /* Next centering in lattice cell */
 };
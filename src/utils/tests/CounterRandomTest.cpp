@@ -0,0 +1,71 @@
+/**
+ * \file
+ * \brief Tests for CounterRandom.
+ */
+
+#include "CounterRandomTest.h"
+#include "utils/CounterRandom.h"
+
+TEST_SUITE_REGISTRATION(CounterRandomTest);
+
+CounterRandomTest::CounterRandomTest() {
+}
+
+CounterRandomTest::~CounterRandomTest() {
+}
+
+void CounterRandomTest::testKnownAnswers() {
+	uint32_t result[4];
+
+	uint32_t zeroCounter[4] = { 0, 0, 0, 0 };
+	uint32_t zeroKey[2] = { 0, 0 };
+	CounterRandom::philox4x32(zeroCounter, zeroKey, result);
+	ASSERT_EQUAL((uint32_t) 0x6627e8d5, result[0]);
+	ASSERT_EQUAL((uint32_t) 0xe169c58d, result[1]);
+	ASSERT_EQUAL((uint32_t) 0xbc57ac4c, result[2]);
+	ASSERT_EQUAL((uint32_t) 0x9b00dbd8, result[3]);
+
+	uint32_t onesCounter[4] = { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff };
+	uint32_t onesKey[2] = { 0xffffffff, 0xffffffff };
+	CounterRandom::philox4x32(onesCounter, onesKey, result);
+	ASSERT_EQUAL((uint32_t) 0x408f276d, result[0]);
+	ASSERT_EQUAL((uint32_t) 0x41c83b0e, result[1]);
+	ASSERT_EQUAL((uint32_t) 0xa20bc7c6, result[2]);
+	ASSERT_EQUAL((uint32_t) 0x6d5451fd, result[3]);
+
+	uint32_t piCounter[4] = { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 };
+	uint32_t piKey[2] = { 0xa4093822, 0x299f31d0 };
+	CounterRandom::philox4x32(piCounter, piKey, result);
+	ASSERT_EQUAL((uint32_t) 0xd16cfe09, result[0]);
+	ASSERT_EQUAL((uint32_t) 0x94fdcceb, result[1]);
+	ASSERT_EQUAL((uint32_t) 0x5001e420, result[2]);
+	ASSERT_EQUAL((uint32_t) 0x24126ea1, result[3]);
+}
+
+void CounterRandomTest::testStreams() {
+	CounterRandom rng(42);
+	float first[10];
+	rng.setStream(12345, 3);
+	for (int i = 0; i < 10; i++) {
+		first[i] = rng.rnd();
+		ASSERT_TRUE(first[i] > 0.0f && first[i] < 1.0f);
+	}
+
+	/* draw from another stream in between */
+	rng.setStream(12346, 3);
+	double sum = 0.0;
+	for (int i = 0; i < 1000; i++) {
+		double r = rng.rndDouble();
+		ASSERT_TRUE(r > 0.0 && r < 1.0);
+		sum += r;
+	}
+	ASSERT_DOUBLES_EQUAL(0.5, sum / 1000, 0.05);
+
+	CounterRandom other(42);
+	other.setStream(12345, 3);
+	for (int i = 0; i < 10; i++) {
+		ASSERT_EQUAL(first[i], other.rnd());
+	}
+	other.setStream(12345, 4);
+	ASSERT_TRUE(first[0] != other.rnd());
+}
@@ -0,0 +1,30 @@
+/**
+ * \file
+ * \brief Tests for CounterRandom.
+ */
+
+#ifndef COUNTERRANDOMTEST_H_
+#define COUNTERRANDOMTEST_H_
+
+#include "../Testing.h"
+
+class CounterRandomTest : public utils::Test {
+
+	TEST_SUITE(CounterRandomTest);
+	TEST_METHOD(testKnownAnswers);
+	TEST_METHOD(testStreams);
+	TEST_SUITE_END();
+
+public:
+	CounterRandomTest();
+
+	virtual ~CounterRandomTest();
+
+	/** compare with the known answer tests of the Random123 library */
+	void testKnownAnswers();
+
+	/** streams have to be reproducible, independent of the order in which they are used */
+	void testStreams();
+};
+
+#endif /* COUNTERRANDOMTEST_H_ */
@@ -0,0 +1,48 @@
+/**
+ * \file
+ * \brief Tests for PerfCounters.
+ */
+
+#include "PerfCountersTest.h"
+#include "utils/PerfCounters.h"
+
+#include <vector>
+
+TEST_SUITE_REGISTRATION(PerfCountersTest);
+
+PerfCountersTest::PerfCountersTest() {
+}
+
+PerfCountersTest::~PerfCountersTest() {
+}
+
+void PerfCountersTest::testCounting() {
+	PerfCounters counters;
+	bool opened = counters.open();
+	ASSERT_EQUAL(opened, counters.isOpen());
+
+	std::vector<double> before, after;
+	counters.read(before);
+	volatile double sum = 0.0;
+	for (int i = 0; i < 1000000; i++) {
+		sum += 1e-6 * i;
+	}
+	counters.read(after);
+
+	ASSERT_EQUAL((size_t) counters.numEvents(), after.size());
+	for (unsigned int i = 0; i < counters.numEvents(); i++) {
+		if (!counters.available(i)) {
+			ASSERT_DOUBLES_EQUAL(0.0, after[i], 0.0);
+		}
+	}
+	int taskclock = counters.index("taskclock");
+	if (taskclock >= 0 && counters.available(taskclock)) {
+		ASSERT_TRUE(after[taskclock] > before[taskclock]);
+	}
+	if (counters.index("instructions") >= 0 && counters.available(counters.index("instructions"))) {
+		ASSERT_TRUE(counters.instructions(after) > counters.instructions(before) + 1e6);
+	}
+	// no floating point events have been added
+	ASSERT_TRUE(!counters.countsFlops());
+	ASSERT_DOUBLES_EQUAL(0.0, counters.flops(after), 0.0);
+}
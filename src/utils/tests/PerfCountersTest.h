@@ -0,0 +1,27 @@
+/**
+ * \file
+ * \brief Tests for PerfCounters.
+ */
+
+#ifndef PERFCOUNTERSTEST_H_
+#define PERFCOUNTERSTEST_H_
+
+#include "../Testing.h"
+
+class PerfCountersTest : public utils::Test {
+
+	TEST_SUITE(PerfCountersTest);
+	TEST_METHOD(testCounting);
+	TEST_SUITE_END();
+
+public:
+	PerfCountersTest();
+
+	virtual ~PerfCountersTest();
+
+	/** available events have to increase, unavailable ones have to read 0
+	 * (depending on the system, none of the events may be available) */
+	void testCounting();
+};
+
+#endif /* PERFCOUNTERSTEST_H_ */
@@ -0,0 +1,69 @@
+/**
+ * \file
+ * \brief Tests for TimerRegistry.
+ */
+
+#include "TimerRegistryTest.h"
+#include "parallel/DomainDecompBase.h"
+#include "utils/TimerRegistry.h"
+
+TEST_SUITE_REGISTRATION(TimerRegistryTest);
+
+TimerRegistryTest::TimerRegistryTest() {
+}
+
+TimerRegistryTest::~TimerRegistryTest() {
+}
+
+void TimerRegistryTest::testNesting() {
+	TimerRegistry timers;
+	for (int i = 0; i < 3; i++) {
+		timers.start("loop");
+		timers.start("forces");
+		timers.addTime("inner", 1.0);
+		timers.stop("forces");
+		timers.start("output");
+		timers.start("forces");
+		timers.stop("forces");
+		timers.stop("output");
+		timers.stop("loop");
+	}
+	timers.addTime("final", 0.5);
+
+	ASSERT_EQUAL(6, timers.numRegions());
+	ASSERT_EQUAL(std::string("loop/forces/inner"), timers.path(2));
+	ASSERT_EQUAL(std::string("loop/output/forces"), timers.path(4));
+	ASSERT_EQUAL(2, timers.depth(2));
+	ASSERT_EQUAL(0, timers.depth(5));
+
+	ASSERT_EQUAL(3ul, timers.calls("loop"));
+	ASSERT_EQUAL(3ul, timers.calls("loop/output/forces"));
+	ASSERT_EQUAL(0ul, timers.calls("forces"));
+	ASSERT_DOUBLES_EQUAL(3.0, timers.time("loop/forces/inner"), 1e-15);
+	ASSERT_DOUBLES_EQUAL(0.5, timers.time("final"), 1e-15);
+	ASSERT_DOUBLES_EQUAL(-1.0, timers.time("forces"), 1e-15);
+	ASSERT_TRUE(timers.time("loop") >= timers.time("loop/forces"));
+
+	timers.reset();
+	ASSERT_EQUAL(6, timers.numRegions());
+	ASSERT_EQUAL(0ul, timers.calls("loop"));
+	ASSERT_DOUBLES_EQUAL(0.0, timers.time("loop/forces/inner"), 1e-15);
+}
+
+void TimerRegistryTest::testStatistics() {
+	TimerRegistry timers;
+	int rank = _domainDecomposition->getRank();
+	int numProcs = _domainDecomposition->getNumProcs();
+	timers.start("loop");
+	timers.addTime("forces", rank + 1.0);
+	timers.stop("loop");
+
+	ASSERT_TRUE(timers.collectStatistics(_domainDecomposition));
+	if (rank == 0) {
+		ASSERT_DOUBLES_EQUAL(1.0, timers.minTime(1), 1e-15);
+		ASSERT_DOUBLES_EQUAL(0.5 * (numProcs + 1), timers.avgTime(1), 1e-12);
+		ASSERT_DOUBLES_EQUAL((double) numProcs, timers.maxTime(1), 1e-15);
+		ASSERT_DOUBLES_EQUAL(2.0 * numProcs / (numProcs + 1), timers.imbalance(1), 1e-12);
+		ASSERT_DOUBLES_EQUAL(1.0, timers.avgCalls(0), 1e-15);
+	}
+}
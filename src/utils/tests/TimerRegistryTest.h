@@ -0,0 +1,30 @@
+/**
+ * \file
+ * \brief Tests for TimerRegistry.
+ */
+
+#ifndef TIMERREGISTRYTEST_H_
+#define TIMERREGISTRYTEST_H_
+
+#include "utils/TestWithSimulationSetup.h"
+
+class TimerRegistryTest : public utils::TestWithSimulationSetup {
+
+	TEST_SUITE(TimerRegistryTest);
+	TEST_METHOD(testNesting);
+	TEST_METHOD(testStatistics);
+	TEST_SUITE_END();
+
+public:
+	TimerRegistryTest();
+
+	virtual ~TimerRegistryTest();
+
+	/** regions started within other regions have to be their children */
+	void testNesting();
+
+	/** min, avg and max over all processes */
+	void testStatistics();
+};
+
+#endif /* TIMERREGISTRYTEST_H_ */
@@ -0,0 +1,75 @@
+#include "io/BinaryPhaseSpaceFormat.h"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+/**
+ * Converter from text phase space files (e.g. checkpoints) to the binary
+ * phase space format read by InputBinary.
+ *
+ * usage: bpsconv <input.inp> <output.bps> [-l aos|soa]
+ *        bpsconv -i <file.bps>
+ *   -l  layout of the molecule records: array of structures (default) or
+ *       structure of arrays
+ *   -i  print the header of a binary phase space file
+ */
+
+static int printInfo(const string& fileName) {
+	ifstream in(fileName.c_str(), ios::binary);
+	bps::FileHeader header;
+	in.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!in.good() || memcmp(header.magic, bps::fileMagic, sizeof(header.magic)) != 0) {
+		cerr << fileName << " is not a binary MarDyn phase space file." << endl;
+		return 2;
+	}
+	static const char* formatNames[] = { "ICRVQD", "ICRV", "IRV" };
+	cout << "molecules: " << header.numMolecules << endl;
+	cout << "format: " << (header.moleculeFormat <= bps::IRV ? formatNames[header.moleculeFormat] : "unknown") << endl;
+	cout << "layout: " << (header.layout == bps::SOA ? "soa" : "aos") << endl;
+	cout << "components: " << header.numComponents << endl;
+	cout << "box: " << header.box[0] << " " << header.box[1] << " " << header.box[2] << endl;
+	string text(header.headerTextLength, ' ');
+	in.read(&text[0], text.size());
+	cout << "text header:" << endl << text;
+	return 0;
+}
+
+int main(int argc, char** argv) {
+	const char* usage = "usage: bpsconv <input.inp> <output.bps> [-l aos|soa]\n       bpsconv -i <file.bps>\n";
+	if (argc == 3 && string(argv[1]) == "-i") {
+		return printInfo(argv[2]);
+	}
+	if (argc != 3 && argc != 5) {
+		cout << usage;
+		return 1;
+	}
+	uint32_t layout = bps::AOS;
+	if (argc == 5) {
+		string option(argv[3]), value(argv[4]);
+		if (option != "-l" || (value != "aos" && value != "soa")) {
+			cout << usage;
+			return 1;
+		}
+		layout = (value == "soa") ? bps::SOA : bps::AOS;
+	}
+
+	ifstream in(argv[1]);
+	if (!in.is_open()) {
+		cerr << "Could not open file " << argv[1] << endl;
+		return 2;
+	}
+	ofstream out(argv[2], ios::binary);
+	if (!out.is_open()) {
+		cerr << "Could not open file " << argv[2] << endl;
+		return 2;
+	}
+	string error;
+	if (!bps::convertText(in, out, layout, error)) {
+		cerr << "Conversion of " << argv[1] << " failed: " << error << endl;
+		return 3;
+	}
+	return 0;
+}
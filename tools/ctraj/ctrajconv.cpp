@@ -0,0 +1,195 @@
+#include "io/CompressedTrajectoryCodec.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Reader and converter for compressed trajectories (*.ctraj) written by the
+ * CompressedTrajectoryWriter output plugin.
+ *
+ * usage: ctrajconv <file.ctraj> [-i] [-f xyz|vis] [-o <prefix>]
+ *   -i  print the header and a summary of all frames
+ *   -f  output format: one multi frame xyz file (default) or one vis file per frame
+ *   -o  prefix of the output files (default: name of the input file)
+ */
+
+struct Header {
+	unsigned flags;
+	double precision;
+	double orientationPrecision;
+	double velocityPrecision;
+	double box[3];
+	unsigned numComponents;
+};
+
+template<typename T>
+static bool readValue(istream& in, T& value) {
+	in.read(reinterpret_cast<char*>(&value), sizeof(T));
+	return in.good();
+}
+
+static bool readHeader(istream& in, Header& header) {
+	char magic[8];
+	in.read(magic, sizeof(magic));
+	if (!in.good() || memcmp(magic, ctraj::fileMagic, sizeof(magic)) != 0) {
+		return false;
+	}
+	uint32_t flags, numComponents;
+	readValue(in, flags);
+	readValue(in, header.precision);
+	readValue(in, header.orientationPrecision);
+	readValue(in, header.velocityPrecision);
+	for (int d = 0; d < 3; d++) {
+		readValue(in, header.box[d]);
+	}
+	readValue(in, numComponents);
+	header.flags = flags;
+	header.numComponents = numComponents;
+	return in.good();
+}
+
+/** read the next frame and decode all its blocks, returns false at the end of the file */
+static bool readFrame(istream& in, const Header& header, uint64_t& simstep, double& time,
+		vector<ctraj::Record>& records, uint64_t& compressedBytes) {
+	char magic[4];
+	in.read(magic, sizeof(magic));
+	if (!in.good()) {
+		return false;
+	}
+	if (memcmp(magic, ctraj::frameMagic, sizeof(magic)) != 0) {
+		cerr << "Corrupt frame marker." << endl;
+		return false;
+	}
+	uint32_t numBlocks;
+	readValue(in, simstep);
+	readValue(in, time);
+	readValue(in, numBlocks);
+	records.clear();
+	compressedBytes = 0;
+	vector<unsigned char> block;
+	for (uint32_t b = 0; b < numBlocks; b++) {
+		uint64_t numMolecules, numBytes;
+		readValue(in, numMolecules);
+		readValue(in, numBytes);
+		block.resize(numBytes);
+		if (numBytes > 0) {
+			in.read(reinterpret_cast<char*>(&block[0]), numBytes);
+		}
+		if (!in.good()) {
+			cerr << "Unexpected end of file in frame of step " << simstep << endl;
+			return false;
+		}
+		compressedBytes += numBytes;
+		ctraj::BitReader bits(numBytes > 0 ? &block[0] : NULL, numBytes);
+		ctraj::BlockCoder coder(header.flags, header.precision, header.orientationPrecision, header.velocityPrecision);
+		ctraj::Record rec;
+		for (uint64_t i = 0; i < numMolecules; i++) {
+			coder.decode(bits, rec);
+			records.push_back(rec);
+		}
+	}
+	return true;
+}
+
+static const char* elementName(unsigned cid) {
+	static const char* names[] = { "Ar", "Xe", "C", "O" };
+	return (cid < 4) ? names[cid] : "H";
+}
+
+int main(int argc, char** argv) {
+	const char* usage = "usage: ctrajconv <file.ctraj> [-i] [-f xyz|vis] [-o <prefix>]\n";
+	if (argc < 2) {
+		cout << usage;
+		return 1;
+	}
+	string inputFile(argv[1]);
+	string format("xyz");
+	string prefix(inputFile);
+	bool info = false;
+	for (int i = 2; i < argc; i++) {
+		string arg(argv[i]);
+		if (arg == "-i") {
+			info = true;
+		}
+		else if (arg == "-f" && i + 1 < argc) {
+			format = argv[++i];
+		}
+		else if (arg == "-o" && i + 1 < argc) {
+			prefix = argv[++i];
+		}
+		else {
+			cout << usage;
+			return 1;
+		}
+	}
+	if (format != "xyz" && format != "vis") {
+		cerr << "Unknown output format " << format << endl;
+		return 1;
+	}
+
+	ifstream in(inputFile.c_str(), ios::binary);
+	if (!in.is_open()) {
+		cerr << "Could not open file " << inputFile << endl;
+		return 2;
+	}
+	Header header;
+	if (!readHeader(in, header)) {
+		cerr << inputFile << " is not a compressed MarDyn trajectory." << endl;
+		return 2;
+	}
+	if (info) {
+		cout << "box: " << header.box[0] << " " << header.box[1] << " " << header.box[2] << endl;
+		cout << "components: " << header.numComponents << endl;
+		cout << "precision: " << header.precision << endl;
+		cout << "orientation: " << ((header.flags & ctraj::ORIENTATION) ? "yes" : "no") << endl;
+		cout << "velocity: " << ((header.flags & ctraj::VELOCITY) ? "yes" : "no") << endl;
+	}
+
+	ofstream xyz;
+	if (!info && format == "xyz") {
+		xyz.open((prefix + ".xyz").c_str());
+	}
+
+	uint64_t simstep;
+	double time;
+	uint64_t compressedBytes;
+	vector<ctraj::Record> records;
+	unsigned long frame = 0;
+	while (readFrame(in, header, simstep, time, records, compressedBytes)) {
+		if (info) {
+			cout << "frame " << frame << ": step " << simstep << " t = " << time << ", "
+			     << records.size() << " molecules, "
+			     << (records.size() > 0 ? 8.0 * compressedBytes / records.size() : 0.0)
+			     << " bits per molecule" << endl;
+		}
+		else if (format == "xyz") {
+			xyz << records.size() << "\n" << "step " << simstep << " t = " << time << "\n";
+			for (size_t i = 0; i < records.size(); i++) {
+				xyz << elementName(records[i].cid) << " " << records[i].r[0] << "\t" << records[i].r[1] << "\t" << records[i].r[2] << "\n";
+			}
+		}
+		else {
+			stringstream filename;
+			filename << prefix << "-" << setw(6) << setfill('0') << frame << ".vis";
+			ofstream vis(filename.str().c_str());
+			vis << "      id t          x          y          z     q0     q1     q2     q3        c\n";
+			for (size_t i = 0; i < records.size(); i++) {
+				const ctraj::Record& r = records[i];
+				vis << setiosflags(ios::fixed) << setw(8) << r.id << setw(2) << r.cid << setprecision(3);
+				for (int d = 0; d < 3; d++) vis << setw(11) << r.r[d];
+				vis << setprecision(3) << setw(7) << r.q[0] << setw(7) << r.q[1] << setw(7) << r.q[2]
+				    << setw(7) << r.q[3] << setw(9) << r.cid << "\n";
+			}
+		}
+		frame++;
+	}
+	return 0;
+}